@@ -0,0 +1,320 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// C++ counterpart of ProtoBench.java.
+//
+// For each pair of message type and data file given on the command line,
+// measures how fast the C++ runtime can parse, serialize, compute the
+// ByteSize() of and CopyFrom() that message, and parse it through
+// reflection (WireFormat::ParseAndMergePartial()).  Throughput is reported
+// in MB/s of serialized data, along with the number of heap allocations per
+// operation.
+//
+// Message types are looked up among the types compiled into this binary
+// (google_size.proto and google_speed.proto, plus anything added to
+// benchmark_protos in Makefile.am).  Other types can be loaded at runtime
+// with --proto, in which case DynamicMessage is used.  See readme.txt.
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <google/protobuf/compiler/importer.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/dynamic_message.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/message.h>
+#include <google/protobuf/wire_format.h>
+#include <google/protobuf/stubs/common.h>
+#include <google/protobuf/stubs/strutil.h>
+
+// Every heap allocation made by the process goes through these, so that the
+// benchmark can report allocations per operation.
+namespace {
+google::protobuf::uint64 allocation_count = 0;
+}  // namespace
+
+#if __cplusplus >= 201103L
+#define BENCHMARK_THROW_BAD_ALLOC
+#define BENCHMARK_NOTHROW noexcept
+#else
+#define BENCHMARK_THROW_BAD_ALLOC throw(std::bad_alloc)
+#define BENCHMARK_NOTHROW throw()
+#endif
+
+void* operator new(size_t size) BENCHMARK_THROW_BAD_ALLOC {
+  ++allocation_count;
+  void* result = malloc(size == 0 ? 1 : size);
+  if (result == NULL) throw std::bad_alloc();
+  return result;
+}
+
+void* operator new[](size_t size) BENCHMARK_THROW_BAD_ALLOC {
+  return operator new(size);
+}
+
+void operator delete(void* pointer) BENCHMARK_NOTHROW {
+  free(pointer);
+}
+
+void operator delete[](void* pointer) BENCHMARK_NOTHROW {
+  free(pointer);
+}
+
+namespace google {
+namespace protobuf {
+namespace {
+
+// Prints parse errors in --proto files.
+class ErrorPrinter : public compiler::MultiFileErrorCollector {
+ public:
+  ErrorPrinter() {}
+  ~ErrorPrinter() {}
+
+  // implements MultiFileErrorCollector --------------------------------
+  void AddError(const string& filename, int line, int column,
+                const string& message) {
+    cerr << filename << ":" << (line + 1) << ":" << (column + 1) << ": "
+         << message << endl;
+  }
+};
+
+// Measures every operation on one message type and data file.
+class Benchmark {
+ public:
+  Benchmark(const Message& prototype, const string& data, double min_seconds)
+      : prototype_(prototype), data_(data), min_seconds_(min_seconds),
+        byte_size_(0) {}
+
+  // Returns false if the data cannot be parsed as the message type.
+  bool Run();
+
+ private:
+  enum Operation {
+    PARSE,
+    SERIALIZE,
+    BYTE_SIZE,
+    COPY_FROM,
+    REFLECTION_PARSE
+  };
+
+  // Performs |operation| once.  Returns false on a parse error.
+  bool RunOnce(Operation operation);
+
+  // Repeats |operation| for at least min_seconds_ and prints the results.
+  void Measure(const char* name, Operation operation);
+
+  const Message& prototype_;
+  const string& data_;
+  const double min_seconds_;
+
+  scoped_ptr<Message> message_;   // Parse target and CopyFrom() source.
+  scoped_ptr<Message> copy_;      // CopyFrom() target.
+  string serialized_;             // Serialize() target.
+  int byte_size_;                 // Sink for ByteSize().
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(Benchmark);
+};
+
+bool Benchmark::Run() {
+  message_.reset(prototype_.New());
+  copy_.reset(prototype_.New());
+  if (!message_->ParseFromString(data_)) return false;
+
+  Measure("Parse", PARSE);
+  Measure("Serialize", SERIALIZE);
+  Measure("ByteSize", BYTE_SIZE);
+  Measure("CopyFrom", COPY_FROM);
+  Measure("Reflection parse", REFLECTION_PARSE);
+  return true;
+}
+
+bool Benchmark::RunOnce(Operation operation) {
+  switch (operation) {
+    case PARSE:
+      return message_->ParseFromString(data_);
+    case SERIALIZE:
+      return message_->SerializeToString(&serialized_);
+    case BYTE_SIZE:
+      byte_size_ += message_->ByteSize();
+      return true;
+    case COPY_FROM:
+      copy_->CopyFrom(*message_);
+      return true;
+    case REFLECTION_PARSE: {
+      message_->Clear();
+      io::CodedInputStream input(
+          reinterpret_cast<const uint8*>(data_.data()), data_.size());
+      return internal::WireFormat::ParseAndMergePartial(&input,
+                                                        message_.get());
+    }
+  }
+  return false;
+}
+
+void Benchmark::Measure(const char* name, Operation operation) {
+  // Warm up caches (and reach the steady-state capacity of message_'s
+  // fields) before measuring.
+  RunOnce(operation);
+
+  uint64 allocations_before = allocation_count;
+  clock_t start = clock();
+  clock_t end;
+  int64 iterations = 0;
+  do {
+    // Check the clock only every few iterations, since some operations
+    // take only nanoseconds.
+    for (int i = 0; i < 16; i++) {
+      RunOnce(operation);
+    }
+    iterations += 16;
+    end = clock();
+  } while (end - start < min_seconds_ * CLOCKS_PER_SEC);
+  uint64 allocations = allocation_count - allocations_before;
+
+  double seconds = static_cast<double>(end - start) / CLOCKS_PER_SEC;
+  double megabytes = static_cast<double>(data_.size()) * iterations /
+                     (1024 * 1024);
+  printf("  %-18s %10.2f MB/s %10.0f ns/op %8.2f allocs/op\n", name,
+         megabytes / seconds, seconds * 1e9 / iterations,
+         static_cast<double>(allocations) / iterations);
+  fflush(stdout);
+}
+
+bool ReadFile(const string& filename, string* contents) {
+  ifstream in(filename.c_str(), ios::in | ios::binary);
+  if (!in) return false;
+  contents->assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+  return !in.bad();
+}
+
+void PrintUsage(const char* program) {
+  cerr << "Usage: " << program << " [OPTIONS] MESSAGE_TYPE DATA_FILE "
+          "[MESSAGE_TYPE DATA_FILE ...]\n"
+          "Options:\n"
+          "  --seconds=N        Spend N seconds on each measurement "
+          "(default 1).\n"
+          "  --proto_path=PATH  Directory in which to look for --proto "
+          "files (default .).\n"
+          "  --proto=FILE       Load FILE at runtime; its message types are "
+          "benchmarked\n"
+          "                     as DynamicMessages.  May be repeated.\n"
+       << endl;
+}
+
+int Main(int argc, char* argv[]) {
+  double min_seconds = 1.0;
+  string proto_path = ".";
+  vector<string> proto_files;
+  vector<string> arguments;
+  for (int i = 1; i < argc; i++) {
+    string arg = argv[i];
+    if (HasPrefixString(arg, "--seconds=")) {
+      min_seconds = strtod(arg.c_str() + strlen("--seconds="), NULL);
+    } else if (HasPrefixString(arg, "--proto_path=")) {
+      proto_path = arg.substr(strlen("--proto_path="));
+    } else if (HasPrefixString(arg, "--proto=")) {
+      proto_files.push_back(arg.substr(strlen("--proto=")));
+    } else if (HasPrefixString(arg, "--")) {
+      cerr << "Unknown option: " << arg << endl;
+      PrintUsage(argv[0]);
+      return 1;
+    } else {
+      arguments.push_back(arg);
+    }
+  }
+  if (arguments.empty() || arguments.size() % 2 != 0) {
+    PrintUsage(argv[0]);
+    return 1;
+  }
+
+  compiler::DiskSourceTree source_tree;
+  source_tree.MapPath("", proto_path);
+  ErrorPrinter error_printer;
+  compiler::Importer importer(&source_tree, &error_printer);
+  for (int i = 0; i < proto_files.size(); i++) {
+    if (importer.Import(proto_files[i]) == NULL) return 1;
+  }
+  DynamicMessageFactory dynamic_factory(importer.pool());
+
+  for (int i = 0; i < arguments.size(); i += 2) {
+    const string& type_name = arguments[i];
+    const string& filename = arguments[i + 1];
+
+    const Message* prototype = NULL;
+    const char* kind = "generated";
+    const Descriptor* descriptor =
+        DescriptorPool::generated_pool()->FindMessageTypeByName(type_name);
+    if (descriptor != NULL) {
+      prototype = MessageFactory::generated_factory()->GetPrototype(descriptor);
+    } else {
+      descriptor = importer.pool()->FindMessageTypeByName(type_name);
+      if (descriptor != NULL) {
+        prototype = dynamic_factory.GetPrototype(descriptor);
+        kind = "dynamic";
+      }
+    }
+    if (prototype == NULL) {
+      cerr << "Unknown message type: " << type_name << endl;
+      return 1;
+    }
+
+    string data;
+    if (!ReadFile(filename, &data)) {
+      cerr << filename << ": " << strerror(errno) << endl;
+      return 1;
+    }
+
+    printf("%s (%s) with %s (%d bytes)\n", type_name.c_str(), kind,
+           filename.c_str(), static_cast<int>(data.size()));
+    Benchmark benchmark(*prototype, data, min_seconds);
+    if (!benchmark.Run()) {
+      cerr << filename << ": Could not parse as " << type_name << "." << endl;
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+}  // namespace
+}  // namespace protobuf
+}  // namespace google
+
+int main(int argc, char* argv[]) {
+  return google::protobuf::Main(argc, argv);
+}
@@ -0,0 +1,208 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Throughput benchmark for DelimitedMessageWriter and DelimitedMessageReader.
+//
+// Builds a stream of size-delimited records, then measures writing it with
+// DelimitedMessageWriter, reading it back with DelimitedMessageReader into
+// one reused message, and skipping over it with SkipMessage().  For
+// comparison, it also measures the usual hand-written framing:  serializing
+// each message to a temporary string before appending it, and creating a
+// CodedInputStream per record so that its total bytes limit never trips.
+// Each is run with small records (the FieldDescriptorProtos of
+// descriptor.proto) and larger ones (its DescriptorProtos).  Results are in
+// MB/s of framed data.
+//
+// Usage:  delimited_stream_benchmark [seconds per measurement]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string>
+#include <vector>
+
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/delimited_message_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+namespace {
+
+// Each stream holds this many records, cycling through the sample messages.
+const int kRecordsPerStream = 10000;
+
+double Seconds(clock_t start) {
+  return static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+}
+
+// The records of one stream, and the stream itself.
+template <typename MessageType>
+struct Records {
+  vector<const MessageType*> messages;
+  string data;
+};
+
+// Each Run* function processes the whole stream once and returns a value
+// depending on the result, so that the work cannot be optimized away.
+
+template <typename MessageType>
+int RunWrite(const Records<MessageType>& records, string* buffer) {
+  buffer->clear();
+  io::StringOutputStream output(buffer);
+  io::DelimitedMessageWriter writer(&output);
+  for (int i = 0; i < records.messages.size(); i++) {
+    writer.WriteMessage(*records.messages[i]);
+  }
+  writer.Flush();
+  return writer.ByteCount();
+}
+
+template <typename MessageType>
+int RunWriteByHand(const Records<MessageType>& records, string* buffer) {
+  buffer->clear();
+  io::StringOutputStream output(buffer);
+  io::CodedOutputStream coded_output(&output);
+  string serialized;
+  for (int i = 0; i < records.messages.size(); i++) {
+    records.messages[i]->SerializeToString(&serialized);
+    coded_output.WriteVarint32(serialized.size());
+    coded_output.WriteString(serialized);
+  }
+  return coded_output.ByteCount();
+}
+
+template <typename MessageType>
+int RunRead(const Records<MessageType>& records, string* buffer) {
+  io::ArrayInputStream input(records.data.data(), records.data.size());
+  io::DelimitedMessageReader reader(&input);
+  MessageType message;
+  int count = 0;
+  while (reader.ReadMessage(&message)) ++count;
+  return count;
+}
+
+template <typename MessageType>
+int RunReadByHand(const Records<MessageType>& records, string* buffer) {
+  io::ArrayInputStream input(records.data.data(), records.data.size());
+  MessageType message;
+  int count = 0;
+  while (true) {
+    io::CodedInputStream coded_input(&input);
+    uint32 size;
+    if (!coded_input.ReadVarint32(&size)) break;
+    io::CodedInputStream::Limit limit = coded_input.PushLimit(size);
+    if (!message.ParseFromCodedStream(&coded_input)) break;
+    coded_input.PopLimit(limit);
+    ++count;
+  }
+  return count;
+}
+
+template <typename MessageType>
+int RunSkip(const Records<MessageType>& records, string* buffer) {
+  io::ArrayInputStream input(records.data.data(), records.data.size());
+  io::DelimitedMessageReader reader(&input);
+  int count = 0;
+  while (reader.SkipMessage()) ++count;
+  return count;
+}
+
+// Prints the throughput of |run| on |records| in MB/s.
+template <typename MessageType>
+void Measure(int (*run)(const Records<MessageType>&, string*),
+             const Records<MessageType>& records, double min_seconds) {
+  string buffer;
+  int checksum = 0;
+  int iterations = 0;
+  clock_t start = clock();
+  double seconds;
+  do {
+    checksum += run(records, &buffer);
+    ++iterations;
+    seconds = Seconds(start);
+  } while (seconds < min_seconds);
+  if (checksum == 0) printf("?");  // Never true; keeps checksum live.
+  printf(" %9.1f", records.data.size() * static_cast<double>(iterations) /
+                   seconds / (1 << 20));
+  fflush(stdout);
+}
+
+template <typename MessageType>
+void Run(const char* name, const vector<const MessageType*>& samples,
+         double min_seconds) {
+  Records<MessageType> records;
+  for (int i = 0; i < kRecordsPerStream; i++) {
+    records.messages.push_back(samples[i % samples.size()]);
+  }
+  RunWrite(records, &records.data);
+
+  printf("%-7s %9d", name,
+         static_cast<int>(records.data.size() / kRecordsPerStream));
+  Measure(&RunWrite<MessageType>, records, min_seconds);
+  Measure(&RunWriteByHand<MessageType>, records, min_seconds);
+  Measure(&RunRead<MessageType>, records, min_seconds);
+  Measure(&RunReadByHand<MessageType>, records, min_seconds);
+  Measure(&RunSkip<MessageType>, records, min_seconds);
+  printf("\n");
+}
+
+void RunAll(double min_seconds) {
+  FileDescriptorProto file;
+  FileDescriptorProto::descriptor()->file()->CopyTo(&file);
+
+  vector<const DescriptorProto*> messages;
+  vector<const FieldDescriptorProto*> fields;
+  for (int i = 0; i < file.message_type_size(); i++) {
+    messages.push_back(&file.message_type(i));
+    for (int j = 0; j < file.message_type(i).field_size(); j++) {
+      fields.push_back(&file.message_type(i).field(j));
+    }
+  }
+
+  printf("MB/s of delimited records\n\n");
+  printf("%-7s %9s %9s %9s %9s %9s %9s\n", "records", "avg size", "write",
+         "by hand", "read", "by hand", "skip");
+  Run("small", fields, min_seconds);
+  Run("large", messages, min_seconds);
+}
+
+}  // namespace
+}  // namespace protobuf
+}  // namespace google
+
+int main(int argc, char* argv[]) {
+  double min_seconds = argc > 1 ? atof(argv[1]) : 0.5;
+  google::protobuf::RunAll(min_seconds);
+  return 0;
+}
@@ -0,0 +1,182 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// Micro-benchmark for ExtensionSet, the storage behind a message's
+// extensions.
+//
+// For sets of several sizes, measures building a set of int32 extensions and
+// destroying it, looking each extension up, copying the set with
+// MergeFrom(), and parsing the extensions from the wire as generated code
+// does.  Results are in nanoseconds per extension.  To compare two versions
+// of ExtensionSet, run the benchmark against each.
+//
+// Usage:  extension_set_benchmark [seconds per measurement]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string>
+
+#include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/extension_set.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/wire_format_lite_inl.h>
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+namespace {
+
+using internal::ExtensionSet;
+using internal::WireFormatLite;
+
+// Extension numbers are kFirstNumber, kFirstNumber + 1, ...  FieldOptions
+// stands in for the extended message; the benchmark registers extensions
+// of it in its extension range so that ParseField() can find them.
+const int kFirstNumber = 50000;
+const int kMaxExtensions = 1000;
+
+const MessageLite* ContainingType() {
+  return &FieldOptions::default_instance();
+}
+
+double Seconds(clock_t start) {
+  return static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+}
+
+void Fill(int count, ExtensionSet* extensions) {
+  for (int i = 0; i < count; i++) {
+    extensions->SetInt32(kFirstNumber + i, WireFormatLite::TYPE_INT32, i + 1,
+                         NULL);
+  }
+}
+
+// Each Run* function performs the operation once on a set of |count|
+// extensions and returns a value depending on the result, so that the work
+// cannot be optimized away.
+
+int RunCreate(int count, const ExtensionSet& full, const string& data) {
+  ExtensionSet extensions;
+  Fill(count, &extensions);
+  return extensions.NumExtensions();
+}
+
+int RunLookUp(int count, const ExtensionSet& full, const string& data) {
+  int sum = 0;
+  for (int i = 0; i < count; i++) {
+    sum += full.GetInt32(kFirstNumber + i, 0);
+  }
+  return sum;
+}
+
+int RunCopy(int count, const ExtensionSet& full, const string& data) {
+  ExtensionSet extensions;
+  extensions.MergeFrom(full);
+  return extensions.NumExtensions();
+}
+
+int RunParse(int count, const ExtensionSet& full, const string& data) {
+  ExtensionSet extensions;
+  io::CodedInputStream input(reinterpret_cast<const uint8*>(data.data()),
+                             data.size());
+  uint32 tag;
+  while ((tag = input.ReadTag()) != 0) {
+    if (!extensions.ParseField(tag, &input, ContainingType())) {
+      fprintf(stderr, "Parse error.\n");
+      exit(1);
+    }
+  }
+  return extensions.NumExtensions();
+}
+
+typedef int RunFunction(int count, const ExtensionSet& full,
+                        const string& data);
+
+// Prints the time |run| takes per extension in nanoseconds.
+void Measure(RunFunction* run, int count, double min_seconds) {
+  ExtensionSet full;
+  Fill(count, &full);
+  string data;
+  {
+    full.ByteSize();
+    io::StringOutputStream output(&data);
+    io::CodedOutputStream coded_output(&output);
+    full.SerializeWithCachedSizes(kFirstNumber, kFirstNumber + count,
+                                  &coded_output);
+  }
+
+  // Check the clock only every 10000 extensions or so; it is slow next to
+  // the operations measured.
+  const int batch = 10000 / count + 1;
+  int checksum = 0;
+  int iterations = 0;
+  clock_t start = clock();
+  double seconds;
+  do {
+    for (int i = 0; i < batch; i++) {
+      checksum += run(count, full, data);
+    }
+    iterations += batch;
+    seconds = Seconds(start);
+  } while (seconds < min_seconds);
+  if (checksum == 0) printf("?");  // Never true; keeps checksum live.
+  printf(" %9.1f", seconds * 1e9 / iterations / count);
+  fflush(stdout);
+}
+
+void Run(double min_seconds) {
+  for (int i = 0; i < kMaxExtensions; i++) {
+    ExtensionSet::RegisterExtension(ContainingType(), kFirstNumber + i,
+                                    WireFormatLite::TYPE_INT32, false, false);
+  }
+
+  static const int kCounts[] = { 1, 5, 20, 100, 1000 };
+  printf("Nanoseconds per extension\n\n");
+  printf("%-10s %9s %9s %9s %9s\n", "extensions", "create", "look up",
+         "copy", "parse");
+  for (int i = 0; i < GOOGLE_ARRAYSIZE(kCounts); i++) {
+    printf("%-10d", kCounts[i]);
+    Measure(&RunCreate, kCounts[i], min_seconds);
+    Measure(&RunLookUp, kCounts[i], min_seconds);
+    Measure(&RunCopy, kCounts[i], min_seconds);
+    Measure(&RunParse, kCounts[i], min_seconds);
+    printf("\n");
+  }
+}
+
+}  // namespace
+}  // namespace protobuf
+}  // namespace google
+
+int main(int argc, char* argv[]) {
+  double min_seconds = argc > 1 ? atof(argv[1]) : 0.5;
+  google::protobuf::Run(min_seconds);
+  return 0;
+}
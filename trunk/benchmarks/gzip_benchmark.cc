@@ -0,0 +1,154 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Throughput benchmark for GzipOutputStream on several threads.
+//
+// Compresses 16MB of text (descriptor.proto in text format, repeated) on
+// the calling thread as usual, then with num_threads set to 2, 4 and 8 and
+// a few block sizes.  Results are in MB/s of input, measured in wall-clock
+// time, and the compressed size as a percentage of the input.  More threads
+// only help up to the number of CPUs.
+//
+// Usage:  gzip_benchmark [seconds per measurement]
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <algorithm>
+#include <string>
+
+#if HAVE_ZLIB
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/io/gzip_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+namespace {
+
+const int kDataSize = 16 << 20;
+
+// Threads run at the same time, so CPU time (clock()) would not do.
+double WallSeconds() {
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  return now.tv_sec + now.tv_usec / 1e6;
+}
+
+// Compresses data into *output and returns its size.
+int Compress(const string& data, const io::GzipOutputStream::Options& options,
+             string* output) {
+  output->clear();
+  io::StringOutputStream string_output(output);
+  io::GzipOutputStream gzout(&string_output, options);
+  const char* input = data.data();
+  int remaining = data.size();
+  while (remaining > 0) {
+    void* buffer;
+    int size;
+    if (!gzout.Next(&buffer, &size)) break;
+    int n = min(size, remaining);
+    memcpy(buffer, input, n);
+    if (n < size) gzout.BackUp(size - n);
+    input += n;
+    remaining -= n;
+  }
+  gzout.Close();
+  return output->size();
+}
+
+void Measure(const string& data, int num_threads, int block_size,
+             double min_seconds) {
+  io::GzipOutputStream::Options options;
+  options.num_threads = num_threads;
+  if (block_size > 0) options.block_size = block_size;
+
+  string output;
+  int iterations = 0;
+  double start = WallSeconds();
+  double seconds;
+  do {
+    Compress(data, options, &output);
+    ++iterations;
+    seconds = WallSeconds() - start;
+  } while (seconds < min_seconds);
+
+  if (block_size > 0) {
+    printf("%7d %7dkB", num_threads, block_size >> 10);
+  } else {
+    printf("%7d %9s", num_threads, "-");
+  }
+  printf(" %9.1f %9.2f\n",
+         data.size() * static_cast<double>(iterations) / seconds / (1 << 20),
+         100.0 * output.size() / data.size());
+  fflush(stdout);
+}
+
+void RunAll(double min_seconds) {
+  FileDescriptorProto file;
+  FileDescriptorProto::descriptor()->file()->CopyTo(&file);
+  string text = file.DebugString();
+  string data;
+  while (data.size() < kDataSize) data += text;
+  data.resize(kDataSize);
+
+  printf("Compressing %dMB of text\n\n", kDataSize >> 20);
+  printf("%7s %9s %9s %9s\n", "threads", "block", "MB/s", "size %");
+  Measure(data, 1, 0, min_seconds);
+  Measure(data, 2, 128 << 10, min_seconds);
+  Measure(data, 4, 128 << 10, min_seconds);
+  Measure(data, 8, 128 << 10, min_seconds);
+  Measure(data, 4, 32 << 10, min_seconds);
+  Measure(data, 4, 1 << 20, min_seconds);
+}
+
+}  // namespace
+}  // namespace protobuf
+}  // namespace google
+
+int main(int argc, char* argv[]) {
+  double min_seconds = argc > 1 ? atof(argv[1]) : 0.5;
+  google::protobuf::RunAll(min_seconds);
+  return 0;
+}
+
+#else  // HAVE_ZLIB
+
+int main(int argc, char* argv[]) {
+  printf("Protocol Buffers were built without zlib.\n");
+  return 0;
+}
+
+#endif  // HAVE_ZLIB
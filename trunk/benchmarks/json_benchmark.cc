@@ -0,0 +1,162 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Throughput benchmark for JsonFormat.
+//
+// Prints and parses the standard benchmark messages as JSON with
+// JsonFormat, and as text with TextFormat, the usual way of getting a
+// readable form of a message.  Results are in microseconds per message.
+//
+// Usage:  json_benchmark [seconds per measurement] [data directory]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <fstream>
+#include <string>
+
+#include "google_speed.pb.h"
+#include <google/protobuf/json_format.h>
+#include <google/protobuf/text_format.h>
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+namespace {
+
+double Seconds(clock_t start) {
+  return static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+}
+
+// Each Run* function handles the message once and returns a value
+// depending on the result, so that the work cannot be optimized away.
+
+int RunTextPrint(const Message& message, const string& text,
+                 Message* output) {
+  string result;
+  TextFormat::PrintToString(message, &result);
+  return result.size();
+}
+
+int RunJsonPrint(const Message& message, const string& json,
+                 Message* output) {
+  string result;
+  JsonFormat::PrintToString(message, &result);
+  return result.size();
+}
+
+int RunTextParse(const Message& message, const string& text,
+                 Message* output) {
+  return TextFormat::ParseFromString(text, output);
+}
+
+int RunJsonParse(const Message& message, const string& json,
+                 Message* output) {
+  return JsonFormat::ParseFromString(json, output);
+}
+
+// Prints the time per call of run in microseconds, and returns it.
+double Measure(int (*run)(const Message&, const string&, Message*),
+               const Message& message, const string& input, Message* output,
+               double min_seconds) {
+  int checksum = 0;
+  int iterations = 0;
+  clock_t start = clock();
+  double seconds;
+  do {
+    checksum += run(message, input, output);
+    ++iterations;
+    seconds = Seconds(start);
+  } while (seconds < min_seconds);
+  if (checksum == 0) printf("?");  // Never true; keeps checksum live.
+  double micros = seconds * 1e6 / iterations;
+  printf(" %9.1f", micros);
+  fflush(stdout);
+  return micros;
+}
+
+bool ReadFile(const string& filename, string* contents) {
+  ifstream in(filename.c_str(), ios::in | ios::binary);
+  if (!in) return false;
+  contents->assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+  return !in.bad();
+}
+
+void Run(const char* name, const string& filename, Message* message,
+         double min_seconds) {
+  string data;
+  if (!ReadFile(filename, &data)) {
+    printf("(%s not found)\n", filename.c_str());
+    return;
+  }
+  GOOGLE_CHECK(message->ParseFromString(data));
+  string text;
+  string json;
+  GOOGLE_CHECK(TextFormat::PrintToString(*message, &text));
+  GOOGLE_CHECK(JsonFormat::PrintToString(*message, &json));
+  scoped_ptr<Message> output(message->New());
+
+  printf("%-8s %7d %7d", name, static_cast<int>(text.size()),
+         static_cast<int>(json.size()));
+  double text_print =
+      Measure(&RunTextPrint, *message, text, output.get(), min_seconds);
+  double json_print =
+      Measure(&RunJsonPrint, *message, json, output.get(), min_seconds);
+  double text_parse =
+      Measure(&RunTextParse, *message, text, output.get(), min_seconds);
+  double json_parse =
+      Measure(&RunJsonParse, *message, json, output.get(), min_seconds);
+  printf("   %5.1fx %5.1fx\n", text_print / json_print,
+         text_parse / json_parse);
+}
+
+void RunAll(double min_seconds, const string& data_dir) {
+  printf("microseconds per message\n\n");
+  printf("%-8s %7s %7s %9s %9s %9s %9s   %6s %6s\n", "message", "text",
+         "json", "print", "print", "parse", "parse", "print", "parse");
+  printf("%-8s %7s %7s %9s %9s %9s %9s   %6s %6s\n", "", "bytes", "bytes",
+         "text", "json", "text", "json", "gain", "gain");
+
+  benchmarks::SpeedMessage1 message1;
+  Run("message1", data_dir + "/google_message1.dat", &message1, min_seconds);
+  benchmarks::SpeedMessage2 message2;
+  Run("message2", data_dir + "/google_message2.dat", &message2, min_seconds);
+}
+
+}  // namespace
+}  // namespace protobuf
+}  // namespace google
+
+int main(int argc, char* argv[]) {
+  double min_seconds = argc > 1 ? atof(argv[1]) : 0.5;
+  const char* data_dir = argc > 2 ? argv[2] : ".";
+  google::protobuf::RunAll(min_seconds, data_dir);
+  return 0;
+}
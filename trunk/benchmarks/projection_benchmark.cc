@@ -0,0 +1,260 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Throughput benchmark for FieldProjection.
+//
+// Measures parsing three fields out of wide records with FieldProjection,
+// next to parsing the records whole.  The first set of records has 200
+// fields, of which one in four is a submessage; its type is built at run
+// time, so both parses go into a DynamicMessage.  The second set is
+// google_message2.dat parsed into the generated SpeedMessage2, selecting
+// three of its top-level fields and leaving out the large repeated group.
+// Results are in MB/s of serialized records.
+//
+// Usage:  projection_benchmark [seconds per measurement] [google_message2.dat]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "google_speed.pb.h"
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/dynamic_message.h>
+#include <google/protobuf/field_projection.h>
+#include <google/protobuf/stubs/common.h>
+#include <google/protobuf/stubs/strutil.h>
+
+namespace google {
+namespace protobuf {
+namespace {
+
+const int kWideFields = 200;
+const int kWideRecords = 1000;
+
+double Seconds(clock_t start) {
+  return static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+}
+
+// Builds the wide record type:  fields f1 to f200, cycling through int64,
+// string, double and a small submessage.
+const Descriptor* BuildWideType(DescriptorPool* pool) {
+  FileDescriptorProto file;
+  file.set_name("wide.proto");
+  DescriptorProto* inner = file.add_message_type();
+  inner->set_name("Inner");
+  FieldDescriptorProto* field = inner->add_field();
+  field->set_name("a");
+  field->set_number(1);
+  field->set_label(FieldDescriptorProto::LABEL_OPTIONAL);
+  field->set_type(FieldDescriptorProto::TYPE_INT32);
+  field = inner->add_field();
+  field->set_name("b");
+  field->set_number(2);
+  field->set_label(FieldDescriptorProto::LABEL_OPTIONAL);
+  field->set_type(FieldDescriptorProto::TYPE_STRING);
+  field = inner->add_field();
+  field->set_name("c");
+  field->set_number(3);
+  field->set_label(FieldDescriptorProto::LABEL_REPEATED);
+  field->set_type(FieldDescriptorProto::TYPE_INT64);
+
+  DescriptorProto* wide = file.add_message_type();
+  wide->set_name("Wide");
+  for (int i = 1; i <= kWideFields; i++) {
+    field = wide->add_field();
+    field->set_name("f" + SimpleItoa(i));
+    field->set_number(i);
+    field->set_label(FieldDescriptorProto::LABEL_OPTIONAL);
+    switch (i % 4) {
+      case 1: field->set_type(FieldDescriptorProto::TYPE_INT64);  break;
+      case 2: field->set_type(FieldDescriptorProto::TYPE_STRING); break;
+      case 3: field->set_type(FieldDescriptorProto::TYPE_DOUBLE); break;
+      case 0:
+        field->set_type(FieldDescriptorProto::TYPE_MESSAGE);
+        field->set_type_name("Inner");
+        break;
+    }
+  }
+  return pool->BuildFile(file)->FindMessageTypeByName("Wide");
+}
+
+// Sets every field of a wide record to a value depending on seed.
+void FillWide(int seed, Message* message) {
+  message->Clear();
+  const Reflection* reflection = message->GetReflection();
+  const Descriptor* descriptor = message->GetDescriptor();
+  for (int i = 0; i < descriptor->field_count(); i++) {
+    const FieldDescriptor* field = descriptor->field(i);
+    int64 value = seed * 1000 + i;
+    switch (field->cpp_type()) {
+      case FieldDescriptor::CPPTYPE_INT64:
+        reflection->SetInt64(message, field, value * 12345);
+        break;
+      case FieldDescriptor::CPPTYPE_STRING:
+        reflection->SetString(message, field,
+                              "value " + SimpleItoa(value) + " of field");
+        break;
+      case FieldDescriptor::CPPTYPE_DOUBLE:
+        reflection->SetDouble(message, field, value * 0.5);
+        break;
+      default: {
+        Message* inner = reflection->MutableMessage(message, field);
+        const Reflection* inner_reflection = inner->GetReflection();
+        const Descriptor* inner_descriptor = inner->GetDescriptor();
+        inner_reflection->SetInt32(inner, inner_descriptor->field(0), value);
+        inner_reflection->SetString(inner, inner_descriptor->field(1),
+                                    "inner " + SimpleItoa(value));
+        for (int j = 0; j < 4; j++) {
+          inner_reflection->AddInt64(inner, inner_descriptor->field(2),
+                                     value << j);
+        }
+        break;
+      }
+    }
+  }
+}
+
+struct Records {
+  vector<string> data;
+  int64 total_size;
+};
+
+// Each Run* function parses all records once and returns a value depending
+// on the result, so that the work cannot be optimized away.
+
+int RunFull(const Records& records, const FieldProjection& projection,
+            Message* message) {
+  int total = 0;
+  for (int i = 0; i < records.data.size(); i++) {
+    total += message->ParsePartialFromString(records.data[i]);
+  }
+  return total;
+}
+
+int RunProjected(const Records& records, const FieldProjection& projection,
+                 Message* message) {
+  int total = 0;
+  for (int i = 0; i < records.data.size(); i++) {
+    total += projection.ParsePartialFromString(records.data[i], message);
+  }
+  return total;
+}
+
+// Prints the throughput of run in MB/s, and returns it.
+double Measure(int (*run)(const Records&, const FieldProjection&, Message*),
+               const Records& records, const FieldProjection& projection,
+               Message* message, double min_seconds) {
+  int checksum = 0;
+  int iterations = 0;
+  clock_t start = clock();
+  double seconds;
+  do {
+    checksum += run(records, projection, message);
+    ++iterations;
+    seconds = Seconds(start);
+  } while (seconds < min_seconds);
+  if (checksum == 0) printf("?");  // Never true; keeps checksum live.
+  double throughput =
+      records.total_size * static_cast<double>(iterations) / seconds /
+      (1 << 20);
+  printf(" %9.1f", throughput);
+  fflush(stdout);
+  return throughput;
+}
+
+void Run(const char* name, const Records& records,
+         const FieldProjection& projection, Message* message,
+         double min_seconds) {
+  printf("%-8s %9d", name,
+         static_cast<int>(records.total_size / records.data.size()));
+  double full = Measure(&RunFull, records, projection, message, min_seconds);
+  double projected =
+      Measure(&RunProjected, records, projection, message, min_seconds);
+  printf(" %8.1fx\n", projected / full);
+}
+
+bool ReadFile(const string& filename, string* contents) {
+  ifstream in(filename.c_str(), ios::in | ios::binary);
+  if (!in) return false;
+  contents->assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+  return !in.bad();
+}
+
+void RunAll(double min_seconds, const string& message2_file) {
+  printf("MB/s of records, parsing 3 fields\n\n");
+  printf("%-8s %9s %9s %9s %9s\n", "records", "avg size", "full",
+         "projected", "speedup");
+
+  DescriptorPool pool;
+  DynamicMessageFactory factory;
+  const Descriptor* wide = BuildWideType(&pool);
+  scoped_ptr<Message> message(factory.GetPrototype(wide)->New());
+  Records records;
+  records.total_size = 0;
+  for (int i = 0; i < kWideRecords; i++) {
+    FillWide(i, message.get());
+    records.data.push_back(message->SerializeAsString());
+    records.total_size += records.data.back().size();
+  }
+  FieldProjection projection(wide);
+  GOOGLE_CHECK(projection.AddPath("f1"));
+  GOOGLE_CHECK(projection.AddPath("f102"));
+  GOOGLE_CHECK(projection.AddPath("f200.a"));
+  Run("wide", records, projection, message.get(), min_seconds);
+
+  Records message2;
+  message2.data.resize(1);
+  if (!ReadFile(message2_file, &message2.data[0])) {
+    printf("(%s not found)\n", message2_file.c_str());
+    return;
+  }
+  message2.total_size = message2.data[0].size();
+  FieldProjection projection2(benchmarks::SpeedMessage2::descriptor());
+  GOOGLE_CHECK(projection2.AddPath("field1"));
+  GOOGLE_CHECK(projection2.AddPath("field3"));
+  GOOGLE_CHECK(projection2.AddPath("field4"));
+  benchmarks::SpeedMessage2 speed_message2;
+  Run("message2", message2, projection2, &speed_message2, min_seconds);
+}
+
+}  // namespace
+}  // namespace protobuf
+}  // namespace google
+
+int main(int argc, char* argv[]) {
+  double min_seconds = argc > 1 ? atof(argv[1]) : 0.5;
+  const char* message2_file = argc > 2 ? argv[2] : "google_message2.dat";
+  google::protobuf::RunAll(min_seconds, message2_file);
+  return 0;
+}
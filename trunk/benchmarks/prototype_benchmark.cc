@@ -0,0 +1,176 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// Contention benchmark for DynamicMessageFactory::GetPrototype().
+//
+// Several threads look up the prototypes of the same set of types, which the
+// factory has already built, as a schema-driven server handling requests
+// would.  The "factory" column calls GetPrototype() directly; the "mutex"
+// column takes a shared mutex around each call, as GetPrototype() itself did
+// before lookups of existing prototypes became lock-free.  Results are
+// lookups per second summed over all threads.
+//
+// Usage:  prototype_benchmark [seconds per measurement] [max threads]
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <vector>
+
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/dynamic_message.h>
+#include <google/protobuf/message.h>
+#include <google/protobuf/stubs/atomicops.h>
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+namespace {
+
+double Now() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+struct SharedState {
+  DynamicMessageFactory* factory;
+  const vector<const Descriptor*>* types;
+  Mutex* mutex;  // NULL to call GetPrototype() without it.
+  internal::AtomicWord stop;
+};
+
+struct ThreadState {
+  SharedState* shared;
+  int offset;  // So that threads don't walk the types in lockstep.
+  uint64 lookups;
+};
+
+void* LookUpPrototypes(void* arg) {
+  ThreadState* state = reinterpret_cast<ThreadState*>(arg);
+  SharedState* shared = state->shared;
+  const vector<const Descriptor*>& types = *shared->types;
+  uint64 lookups = 0;
+  int i = state->offset;
+  while (internal::Acquire_Load(&shared->stop) == 0) {
+    for (int j = 0; j < 1000; j++) {
+      const Descriptor* type = types[i];
+      const Message* prototype;
+      if (shared->mutex != NULL) {
+        MutexLock lock(shared->mutex);
+        prototype = shared->factory->GetPrototype(type);
+      } else {
+        prototype = shared->factory->GetPrototype(type);
+      }
+      if (prototype->GetDescriptor() != type) {
+        fprintf(stderr, "Wrong prototype for %s.\n", type->full_name().c_str());
+        exit(1);
+      }
+      if (++i == types.size()) i = 0;
+    }
+    lookups += 1000;
+  }
+  state->lookups = lookups;
+  return NULL;
+}
+
+// Prints the number of lookups per second made by num_threads threads.
+void Measure(SharedState* shared, int num_threads, double seconds) {
+  vector<ThreadState> states(num_threads);
+  vector<pthread_t> threads(num_threads);
+  internal::Release_Store(&shared->stop, 0);
+  double start = Now();
+  for (int i = 0; i < num_threads; i++) {
+    states[i].shared = shared;
+    states[i].offset = i % shared->types->size();
+    states[i].lookups = 0;
+    pthread_create(&threads[i], NULL, &LookUpPrototypes, &states[i]);
+  }
+  usleep(static_cast<useconds_t>(seconds * 1e6));
+  internal::Release_Store(&shared->stop, 1);
+  uint64 lookups = 0;
+  for (int i = 0; i < num_threads; i++) {
+    pthread_join(threads[i], NULL);
+    lookups += states[i].lookups;
+  }
+  printf(" %14.0f", lookups / (Now() - start));
+  fflush(stdout);
+}
+
+int Run(double seconds, int max_threads) {
+  // Copy descriptor.proto into a pool of its own, so that the factory builds
+  // dynamic implementations of its types.
+  FileDescriptorProto file_proto;
+  FileDescriptorProto::descriptor()->file()->CopyTo(&file_proto);
+  DescriptorPool pool;
+  const FileDescriptor* file = pool.BuildFile(file_proto);
+  if (file == NULL) return 1;
+
+  vector<const Descriptor*> types;
+  for (int i = 0; i < file->message_type_count(); i++) {
+    types.push_back(file->message_type(i));
+  }
+  for (int i = 0; i < types.size(); i++) {
+    for (int j = 0; j < types[i]->nested_type_count(); j++) {
+      types.push_back(types[i]->nested_type(j));
+    }
+  }
+
+  DynamicMessageFactory factory;
+  for (int i = 0; i < types.size(); i++) {
+    factory.GetPrototype(types[i]);
+  }
+  Mutex mutex;
+
+  printf("GetPrototype() lookups per second over %d prebuilt types\n\n",
+         static_cast<int>(types.size()));
+  printf("%-8s %14s %14s\n", "threads", "factory", "mutex");
+  for (int num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+    printf("%-8d", num_threads);
+    SharedState shared = { &factory, &types, NULL, 0 };
+    Measure(&shared, num_threads, seconds);
+    shared.mutex = &mutex;
+    Measure(&shared, num_threads, seconds);
+    printf("\n");
+  }
+  return 0;
+}
+
+}  // namespace
+}  // namespace protobuf
+}  // namespace google
+
+int main(int argc, char* argv[]) {
+  double seconds = argc > 1 ? atof(argv[1]) : 1.0;
+  int max_threads = argc > 2 ? atoi(argv[2]) : 32;
+  return google::protobuf::Run(seconds, max_threads);
+}
@@ -0,0 +1,196 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Benchmark for repeated fields declared with [inline_capacity].
+//
+// Parses records whose repeated fields hold a few elements each, once into
+// SmallRepeatedRecord, whose repeated fields are ordinary, and once into
+// InlineRepeatedRecord, which keeps up to four elements of each repeated
+// field inside the message (see small_repeated.proto).  Each record is
+// parsed either into a new message, or into one message reused for all
+// records.  Reports heap allocations and nanoseconds per record.
+//
+// Usage:  repeated_field_benchmark [seconds per measurement]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "small_repeated.pb.h"
+#include <google/protobuf/stubs/common.h>
+#include <google/protobuf/stubs/strutil.h>
+
+namespace {
+// Heap allocations made so far, by anything in the process.
+google::protobuf::int64 allocation_count = 0;
+}  // namespace
+
+void* operator new(size_t size) {
+  ++allocation_count;
+  void* result = malloc(size == 0 ? 1 : size);
+  if (result == NULL) throw std::bad_alloc();
+  return result;
+}
+
+void operator delete(void* pointer) throw() {
+  free(pointer);
+}
+
+namespace google {
+namespace protobuf {
+namespace {
+
+using benchmarks::InlineRepeatedRecord;
+using benchmarks::SmallRepeatedRecord;
+
+const int kRecords = 10000;
+
+double Seconds(clock_t start) {
+  return static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+}
+
+// Builds serialized records.  Each repeated field of record i holds
+// min_elements to max_elements elements.
+vector<string> BuildRecords(int min_elements, int max_elements) {
+  vector<string> records;
+  srand(301);
+  SmallRepeatedRecord record;
+  for (int i = 0; i < kRecords; i++) {
+    record.Clear();
+    record.set_id(i * 7919LL);
+    int span = max_elements - min_elements + 1;
+    for (int j = min_elements + rand() % span; j > 0; j--) {
+      record.add_sizes(rand() % 5000);
+    }
+    for (int j = min_elements + rand() % span; j > 0; j--) {
+      record.add_weights(rand() / 1000.0);
+    }
+    for (int j = min_elements + rand() % span; j > 0; j--) {
+      record.add_tags("tag" + SimpleItoa(rand() % 100));
+    }
+    for (int j = min_elements + rand() % span; j > 0; j--) {
+      benchmarks::SmallRepeatedPoint* point = record.add_points();
+      point->set_x(rand() % 1000);
+      point->set_y(rand() % 1000);
+    }
+    records.push_back(record.SerializeAsString());
+  }
+  return records;
+}
+
+// Each Parse* function parses all records once and returns a value
+// depending on the result, so that the work cannot be optimized away.
+
+template <typename RecordType>
+int ParseNew(const vector<string>& records, RecordType* unused) {
+  int total = 0;
+  for (int i = 0; i < records.size(); i++) {
+    RecordType record;
+    record.ParseFromString(records[i]);
+    total += record.sizes_size() + record.points_size();
+  }
+  return total;
+}
+
+template <typename RecordType>
+int ParseReused(const vector<string>& records, RecordType* record) {
+  int total = 0;
+  for (int i = 0; i < records.size(); i++) {
+    record->ParseFromString(records[i]);
+    total += record->sizes_size() + record->points_size();
+  }
+  return total;
+}
+
+// Prints the allocations and nanoseconds per record of parse.
+template <typename RecordType>
+void Measure(int (*parse)(const vector<string>&, RecordType*),
+             const vector<string>& records, double min_seconds) {
+  RecordType record;
+  parse(records, &record);  // Warm up, and grow record's fields.
+
+  int64 start_count = allocation_count;
+  int checksum = parse(records, &record);
+  double allocations =
+      static_cast<double>(allocation_count - start_count) / records.size();
+
+  int iterations = 0;
+  clock_t start = clock();
+  double seconds;
+  do {
+    checksum += parse(records, &record);
+    ++iterations;
+    seconds = Seconds(start);
+  } while (seconds < min_seconds);
+  if (checksum == 0) printf("?");  // Never true; keeps checksum live.
+  printf(" %9.2f %9.0f", allocations,
+         seconds * 1e9 / iterations / records.size());
+  fflush(stdout);
+}
+
+void Run(const char* name, const vector<string>& records,
+         bool reuse, double min_seconds) {
+  printf("%-16s", name);
+  if (reuse) {
+    Measure(&ParseReused<SmallRepeatedRecord>, records, min_seconds);
+    Measure(&ParseReused<InlineRepeatedRecord>, records, min_seconds);
+  } else {
+    Measure(&ParseNew<SmallRepeatedRecord>, records, min_seconds);
+    Measure(&ParseNew<InlineRepeatedRecord>, records, min_seconds);
+  }
+  printf("\n");
+}
+
+void RunAll(double min_seconds) {
+  printf("Allocations and ns per record; 4 fields of N elements\n\n");
+  printf("%-16s %9s %9s %9s %9s\n", "", "ordinary", "", "inline", "");
+  printf("%-16s %9s %9s %9s %9s\n", "N, message", "allocs", "ns",
+         "allocs", "ns");
+
+  vector<string> few = BuildRecords(1, 4);
+  Run("1-4, new", few, false, min_seconds);
+  Run("1-4, reused", few, true, min_seconds);
+  vector<string> many = BuildRecords(8, 8);
+  Run("8, new", many, false, min_seconds);
+  Run("8, reused", many, true, min_seconds);
+}
+
+}  // namespace
+}  // namespace protobuf
+}  // namespace google
+
+int main(int argc, char* argv[]) {
+  double min_seconds = argc > 1 ? atof(argv[1]) : 0.5;
+  google::protobuf::RunAll(min_seconds);
+  return 0;
+}
@@ -0,0 +1,185 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Benchmark for the cost of static initialization in generated code.
+//
+// startup_benchmark_eager and startup_benchmark_lazy are both built from
+// this file and link the same generated file with many message types (see
+// Makefile.am).  The first builds the default instances in AddDescriptors()
+// at static initialization time, the second was generated with the
+// lazy_default_instances option and builds them on first use.
+//
+// Run without arguments, the program repeatedly runs itself and reports the
+// time from fork() to main() in the child, the time the child then takes to
+// get the prototype of one of the generated types, and the child's resident
+// memory at both points.
+//
+// Usage:  startup_benchmark_eager [runs]
+//         startup_benchmark_lazy [runs]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/message.h>
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+namespace {
+
+// One of the generated types, looked up by name so that both binaries can
+// share this file.
+const char kTypeName[] = "benchmarks.startup.Message0";
+
+int64 NowMicros() {
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  return static_cast<int64>(now.tv_sec) * 1000000 + now.tv_usec;
+}
+
+long MaxResidentKilobytes() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+// What a child reports to its parent.
+struct ChildReport {
+  int64 main_micros;       // Time main() was entered.
+  int64 prototype_micros;  // Time taken to get the prototype.
+  long main_rss;           // Resident memory at main(), in kB.
+  long prototype_rss;      // Resident memory after getting the prototype.
+};
+
+// Runs in the child, with the time main() was entered.
+int RunChild(int64 main_micros) {
+  ChildReport report;
+  report.main_micros = main_micros;
+  report.main_rss = MaxResidentKilobytes();
+
+  int64 start = NowMicros();
+  const Descriptor* type =
+      DescriptorPool::generated_pool()->FindMessageTypeByName(kTypeName);
+  if (type == NULL ||
+      MessageFactory::generated_factory()->GetPrototype(type) == NULL) {
+    fprintf(stderr, "%s is not linked in.\n", kTypeName);
+    return 1;
+  }
+  report.prototype_micros = NowMicros() - start;
+  report.prototype_rss = MaxResidentKilobytes();
+
+  return write(STDOUT_FILENO, &report, sizeof(report)) == sizeof(report)
+      ? 0 : 1;
+}
+
+// Runs the program once as a child and fills in its report, along with
+// the time fork() was called.
+bool RunOnce(const char* program, int64* fork_micros, ChildReport* report) {
+  int fds[2];
+  if (pipe(fds) != 0) {
+    perror("pipe");
+    return false;
+  }
+  *fork_micros = NowMicros();
+  pid_t pid = fork();
+  if (pid < 0) {
+    perror("fork");
+    return false;
+  }
+  if (pid == 0) {
+    close(fds[0]);
+    dup2(fds[1], STDOUT_FILENO);
+    close(fds[1]);
+    execl(program, program, "--child", static_cast<char*>(NULL));
+    perror("execl");
+    _exit(1);
+  }
+
+  close(fds[1]);
+  int size = 0;
+  while (size < sizeof(*report)) {
+    int n = read(fds[0], reinterpret_cast<char*>(report) + size,
+                 sizeof(*report) - size);
+    if (n <= 0) break;
+    size += n;
+  }
+  close(fds[0]);
+  int status;
+  waitpid(pid, &status, 0);
+  return size == sizeof(*report) && WIFEXITED(status) &&
+         WEXITSTATUS(status) == 0;
+}
+
+int RunAll(const char* program, int runs) {
+  double main_ms = 0;
+  double prototype_ms = 0;
+  long main_rss = 0;
+  long prototype_rss = 0;
+  for (int i = 0; i < runs; i++) {
+    int64 fork_micros;
+    ChildReport report;
+    if (!RunOnce(program, &fork_micros, &report)) {
+      fprintf(stderr, "Child run failed.\n");
+      return 1;
+    }
+    main_ms += (report.main_micros - fork_micros) / 1000.0;
+    prototype_ms += report.prototype_micros / 1000.0;
+    main_rss += report.main_rss;
+    prototype_rss += report.prototype_rss;
+  }
+
+  printf("%-34s %8.2f ms %8ld kB\n", "fork() to main():",
+         main_ms / runs, main_rss / runs);
+  printf("%-34s %8.2f ms %8ld kB\n", "first prototype, after main():",
+         prototype_ms / runs, prototype_rss / runs);
+  return 0;
+}
+
+}  // namespace
+}  // namespace protobuf
+}  // namespace google
+
+int main(int argc, char* argv[]) {
+  // Taken first thing, so that the child's time to main() is mostly loading
+  // and static initialization.
+  google::protobuf::int64 main_micros = google::protobuf::NowMicros();
+  if (argc > 1 && strcmp(argv[1], "--child") == 0) {
+    return google::protobuf::RunChild(main_micros);
+  }
+  int runs = argc > 1 ? atoi(argv[1]) : 20;
+  return google::protobuf::RunAll(argv[0], runs);
+}
@@ -0,0 +1,258 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Micro-benchmark for varint decoding.
+//
+// Compares the bulk varint decoders in google/protobuf/io/varint_decoder.h
+// (portable, SSE2 and AVX2) with each other and with decoding one value at a
+// time through CodedInputStream, over several distributions of values.  The
+// "packed" column parses the same data as a packed repeated int64 field via
+// WireFormatLite::ReadPackedPrimitive(), which uses the best bulk decoder;
+// "packed 1x1" does the same one value at a time, for comparison.
+//
+// Usage:  varint_benchmark [seconds per measurement]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string>
+#include <vector>
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/varint_decoder.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/repeated_field.h>
+#include <google/protobuf/wire_format_lite_inl.h>
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+namespace {
+
+using internal::WireFormatLite;
+
+const int kValuesPerDataSet = 1 << 20;
+
+struct DataSet {
+  const char* name;
+  string encoded;  // kValuesPerDataSet back-to-back varints.
+  string packed;   // The same, prefixed by their length.
+  uint64 checksum;
+};
+
+// A small deterministic generator, so that runs are comparable.
+uint64 NextRandom(uint64* state) {
+  *state = *state * GOOGLE_ULONGLONG(6364136223846793005) +
+           GOOGLE_ULONGLONG(1442695040888963407);
+  return *state >> 16;
+}
+
+void MakeDataSet(const char* name, int kind, DataSet* data_set) {
+  data_set->name = name;
+  data_set->checksum = 0;
+  uint64 state = kind + 1;
+  io::StringOutputStream output(&data_set->encoded);
+  io::CodedOutputStream coded_output(&output);
+  for (int i = 0; i < kValuesPerDataSet; i++) {
+    uint64 random = NextRandom(&state);
+    uint64 value;
+    switch (kind) {
+      case 0:  // One byte.
+        value = random & 0x7f;
+        break;
+      case 1:  // Two bytes.
+        value = 0x80 + random % (0x4000 - 0x80);
+        break;
+      case 2:  // 64-bit values of every length.
+        value = (random << 16 | NextRandom(&state)) >> (random % 64);
+        break;
+      case 3:  // Negative int64, always ten bytes.
+        value = static_cast<uint64>(-static_cast<int64>(random % 100000) - 1);
+        break;
+      default:  // Small sint32 around zero, zigzag encoded.
+        value = WireFormatLite::ZigZagEncode32(
+            static_cast<int32>(random % 20001) - 10000);
+        break;
+    }
+    coded_output.WriteVarint64(value);
+    data_set->checksum += value;
+  }
+}
+
+void MakePackedData(DataSet* data_set) {
+  io::StringOutputStream output(&data_set->packed);
+  io::CodedOutputStream coded_output(&output);
+  coded_output.WriteVarint32(data_set->encoded.size());
+  coded_output.WriteString(data_set->encoded);
+}
+
+double Seconds(clock_t start) {
+  return static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+}
+
+// Each Decode* function decodes the whole data set once and returns the sum
+// of the values, so that the work cannot be optimized away.
+
+uint64 DecodeWithCodedStream(const string& data) {
+  io::CodedInputStream input(reinterpret_cast<const uint8*>(data.data()),
+                             data.size());
+  uint64 sum = 0;
+  uint64 value;
+  while (input.ReadVarint64(&value)) sum += value;
+  return sum;
+}
+
+uint64 DecodeWithBatchDecoder(internal::VarintBatchDecoder* decoder,
+                              const string& data) {
+  const uint8* ptr = reinterpret_cast<const uint8*>(data.data());
+  const uint8* end = ptr + data.size();
+  uint64 values[64];
+  uint64 sum = 0;
+  int bytes_consumed;
+  int count;
+  while ((count = decoder(ptr, end, values, 64, &bytes_consumed)) > 0) {
+    for (int i = 0; i < count; i++) sum += values[i];
+    ptr += bytes_consumed;
+  }
+  return sum;
+}
+
+// Parses |data_set| as a packed repeated int64 field, either one value at a
+// time (as ReadPackedPrimitive() did before bulk decoding) or with
+// ReadPackedPrimitive() itself.
+uint64 DecodeAsPackedField(const DataSet& data_set, bool one_by_one) {
+  static RepeatedField<int64> values;
+  values.Clear();
+  io::CodedInputStream input(
+      reinterpret_cast<const uint8*>(data_set.packed.data()),
+      data_set.packed.size());
+  if (one_by_one) {
+    uint32 length;
+    input.ReadVarint32(&length);
+    io::CodedInputStream::Limit limit = input.PushLimit(length);
+    while (input.BytesUntilLimit() > 0) {
+      int64 value;
+      if (!WireFormatLite::ReadPrimitive<int64, WireFormatLite::TYPE_INT64>(
+              &input, &value)) {
+        break;
+      }
+      values.Add(value);
+    }
+    input.PopLimit(limit);
+  } else {
+    WireFormatLite::ReadPackedPrimitive<int64, WireFormatLite::TYPE_INT64>(
+        &input, &values);
+  }
+  uint64 sum = 0;
+  for (int i = 0; i < values.size(); i++) sum += values.Get(i);
+  return sum;
+}
+
+enum Method { CODED_STREAM, PACKED_ONE_BY_ONE, PACKED, SCALAR, SSE2, AVX2 };
+
+uint64 Decode(Method method, const DataSet& data_set) {
+  const string& data = data_set.encoded;
+  switch (method) {
+    case CODED_STREAM:
+      return DecodeWithCodedStream(data);
+    case PACKED_ONE_BY_ONE:
+      return DecodeAsPackedField(data_set, true);
+    case PACKED:
+      return DecodeAsPackedField(data_set, false);
+    case SCALAR:
+      return DecodeWithBatchDecoder(&internal::DecodeVarint64sScalar, data);
+    case SSE2:
+      return DecodeWithBatchDecoder(&internal::DecodeVarint64sSSE2, data);
+    case AVX2:
+      return DecodeWithBatchDecoder(&internal::DecodeVarint64sAVX2, data);
+  }
+  return 0;
+}
+
+// Prints the throughput of |method| on |data_set| in MB/s, or "n/a".
+void Measure(Method method, bool supported, const DataSet& data_set,
+             double min_seconds) {
+  if (!supported) {
+    printf(" %10s", "n/a");
+    return;
+  }
+  clock_t start = clock();
+  int iterations = 0;
+  do {
+    uint64 sum = Decode(method, data_set);
+    if (sum != data_set.checksum) {
+      fprintf(stderr, "\nWrong result decoding %s.\n", data_set.name);
+      exit(1);
+    }
+    ++iterations;
+  } while (Seconds(start) < min_seconds);
+  double megabytes = static_cast<double>(data_set.encoded.size()) *
+                     iterations / (1024 * 1024);
+  printf(" %10.1f", megabytes / Seconds(start));
+  fflush(stdout);
+}
+
+int Run(double min_seconds) {
+  const char* kNames[] = {
+    "1 byte", "2 bytes", "int64 mixed", "int64 negative", "sint32 zigzag"
+  };
+  vector<DataSet> data_sets(GOOGLE_ARRAYSIZE(kNames));
+  for (int i = 0; i < data_sets.size(); i++) {
+    MakeDataSet(kNames[i], i, &data_sets[i]);
+    MakePackedData(&data_sets[i]);
+  }
+
+  printf("Varint decoding throughput in MB/s of encoded data "
+         "(%d values per data set)\n\n", kValuesPerDataSet);
+  printf("%-16s %10s %10s %10s %10s %10s %10s\n", "data set",
+         "ReadVarint", "packed 1x1", "packed", "scalar", "SSE2", "AVX2");
+  for (int i = 0; i < data_sets.size(); i++) {
+    printf("%-16s", data_sets[i].name);
+    Measure(CODED_STREAM, true, data_sets[i], min_seconds);
+    Measure(PACKED_ONE_BY_ONE, true, data_sets[i], min_seconds);
+    Measure(PACKED, true, data_sets[i], min_seconds);
+    Measure(SCALAR, true, data_sets[i], min_seconds);
+    Measure(SSE2, internal::SupportsSSE2VarintDecoder(), data_sets[i],
+            min_seconds);
+    Measure(AVX2, internal::SupportsAVX2VarintDecoder(), data_sets[i],
+            min_seconds);
+    printf("\n");
+  }
+  return 0;
+}
+
+}  // namespace
+}  // namespace protobuf
+}  // namespace google
+
+int main(int argc, char* argv[]) {
+  double min_seconds = argc > 1 ? atof(argv[1]) : 1.0;
+  return google::protobuf::Run(min_seconds);
+}
@@ -0,0 +1,145 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <google/protobuf/arena.h>
+
+#include <algorithm>
+
+namespace google {
+namespace protobuf {
+
+// Round the header up so that the data following it stays 8-byte aligned.
+const size_t Arena::kHeaderSize = (sizeof(Arena::Block) + 7) & ~7;
+
+Arena::Arena() {
+  Init();
+}
+
+Arena::Arena(const ArenaOptions& options)
+  : options_(options) {
+  Init();
+}
+
+Arena::~Arena() {
+  RunCleanups();
+  FreeBlocks();
+}
+
+void Arena::Init() {
+  blocks_ = NULL;
+  initial_block_ = NULL;
+  cleanups_ = NULL;
+  next_block_size_ = options_.start_block_size;
+  space_allocated_ = 0;
+
+  if (options_.initial_block != NULL &&
+      options_.initial_block_size > kHeaderSize) {
+    // Align the start of the caller's buffer.
+    char* start = options_.initial_block;
+    size_t misalignment = reinterpret_cast<uintptr_t>(start) & 7;
+    size_t skip = misalignment == 0 ? 0 : 8 - misalignment;
+    if (options_.initial_block_size > kHeaderSize + skip) {
+      Block* block = reinterpret_cast<Block*>(start + skip);
+      block->next = NULL;
+      block->size = options_.initial_block_size - skip - kHeaderSize;
+      block->pos = 0;
+      blocks_ = block;
+      initial_block_ = block;
+      space_allocated_ = options_.initial_block_size;
+    }
+  }
+}
+
+uint64 Arena::SpaceUsed() const {
+  uint64 space_used = 0;
+  for (Block* block = blocks_; block != NULL; block = block->next) {
+    space_used += block->pos;
+  }
+  return space_used;
+}
+
+uint64 Arena::Reset() {
+  uint64 space_allocated = space_allocated_;
+  RunCleanups();
+  FreeBlocks();
+  Init();
+  return space_allocated;
+}
+
+void* Arena::AllocateFromNewBlock(size_t n) {
+  size_t size = next_block_size_;
+  if (next_block_size_ < options_.max_block_size) {
+    next_block_size_ = std::min(next_block_size_ * 2, options_.max_block_size);
+  }
+  if (size < n) {
+    // Oversized allocations get a block of their own.
+    size = n;
+  }
+
+  Block* block = reinterpret_cast<Block*>(operator new(kHeaderSize + size));
+  block->size = size;
+  block->pos = n;
+  space_allocated_ += kHeaderSize + size;
+
+  if (blocks_ != NULL && size == n) {
+    // Keep the partially-used current block at the head of the list so that
+    // later small allocations continue to fill it.
+    block->next = blocks_->next;
+    blocks_->next = block;
+  } else {
+    block->next = blocks_;
+    blocks_ = block;
+  }
+  return BlockData(block);
+}
+
+void Arena::RunCleanups() {
+  // Nodes live in the blocks themselves, so they stay valid until
+  // FreeBlocks().
+  for (CleanupNode* node = cleanups_; node != NULL; node = node->next) {
+    node->cleanup(node->object);
+  }
+  cleanups_ = NULL;
+}
+
+void Arena::FreeBlocks() {
+  Block* block = blocks_;
+  while (block != NULL) {
+    Block* next = block->next;
+    if (block != initial_block_) {
+      operator delete(block);
+    }
+    block = next;
+  }
+  blocks_ = NULL;
+}
+
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,289 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// This file defines Arena, a region-based allocator which a tree of protocol
+// message objects can be constructed on.  Objects allocated on an Arena are
+// not freed individually; instead, all of them are destroyed at once when the
+// Arena is destroyed or Reset().  For workloads which build up a large
+// message, use it briefly, and throw it away (e.g. handling a single RPC),
+// this replaces thousands of calls to malloc() and free() with a handful of
+// block allocations.
+//
+// Generated classes only support arenas if the .proto file which defines them
+// sets:
+//   option cc_enable_arenas = true;
+// Such classes can be constructed on an arena with:
+//   Arena arena;
+//   MyMessage* message = Arena::CreateMessage<MyMessage>(&arena);
+// All sub-messages, strings and repeated elements subsequently added to the
+// message are then allocated on the same arena.
+
+#ifndef GOOGLE_PROTOBUF_ARENA_H__
+#define GOOGLE_PROTOBUF_ARENA_H__
+
+#include <new>
+
+#include <google/protobuf/stubs/common.h>
+#include <google/protobuf/stubs/template_util.h>
+
+namespace google {
+namespace protobuf {
+
+class Arena;
+
+namespace internal {
+
+// Cleanup functions registered by Arena::Create() and Arena::Own().
+template <typename T>
+void arena_destruct_object(void* object) {
+  reinterpret_cast<T*>(object)->~T();
+}
+template <typename T>
+void arena_delete_object(void* object) {
+  delete reinterpret_cast<T*>(object);
+}
+
+// is_arena_constructable<T>::value is true if T declares the typedef
+// InternalArenaConstructable_, which generated classes with arena support
+// do.  Such classes have a constructor taking an Arena* and know to allocate
+// all of their sub-objects on that arena.
+template <typename T>
+struct is_arena_constructable {
+  template <typename U>
+  static small_ ArenaConstructable(
+      const typename U::InternalArenaConstructable_*);
+  template <typename U>
+  static big_ ArenaConstructable(...);
+
+  static const bool value =
+      sizeof(ArenaConstructable<T>(NULL)) == sizeof(small_);
+};
+
+}  // namespace internal
+
+// Options which can be passed to Arena's constructor to control how memory
+// is obtained.
+struct LIBPROTOBUF_EXPORT ArenaOptions {
+  // Size of the first block allocated from the heap.  Each following block is
+  // twice the size of the previous one, up to max_block_size.
+  size_t start_block_size;
+  size_t max_block_size;
+
+  // If non-NULL, the arena serves allocations from this caller-owned buffer
+  // before touching the heap.  The buffer must stay valid for the lifetime of
+  // the arena and is never freed by it.
+  char* initial_block;
+  size_t initial_block_size;
+
+  ArenaOptions()
+      : start_block_size(kDefaultStartBlockSize),
+        max_block_size(kDefaultMaxBlockSize),
+        initial_block(NULL),
+        initial_block_size(0) {}
+
+  static const size_t kDefaultStartBlockSize = 256;
+  static const size_t kDefaultMaxBlockSize = 8192;
+};
+
+// An Arena hands out memory from a list of blocks and remembers which objects
+// need their destructors run when it goes away.
+//
+// An Arena is not thread-safe: it must not be used to allocate from more
+// than one thread at a time.  Objects allocated on different arenas (or on
+// an arena and on the heap) may be freely copied between, but pointers to
+// arena-owned objects must never be deleted or handed to code which expects
+// to take ownership of them.
+class LIBPROTOBUF_EXPORT Arena {
+ public:
+  Arena();
+  explicit Arena(const ArenaOptions& options);
+
+  // Runs all registered cleanup functions, then frees every block.
+  ~Arena();
+
+  // Destroys all objects allocated on the arena and releases all memory
+  // except for the caller-provided initial block, so that the arena can be
+  // reused.  Returns the number of bytes which had been allocated.
+  uint64 Reset();
+
+  // Total bytes of blocks obtained by this arena (including any initial
+  // block), and the number of those bytes actually handed out.
+  uint64 SpaceAllocated() const { return space_allocated_; }
+  uint64 SpaceUsed() const;
+
+  // Constructs a T on the arena with T's default (or one-argument)
+  // constructor.  T's destructor will be run when the arena is destroyed.
+  // If arena is NULL, the object is simply allocated with new and the caller
+  // owns it.
+  template <typename T>
+  static T* Create(Arena* arena) {
+    if (arena == NULL) return new T;
+    T* result = new (arena->AllocateAligned(sizeof(T))) T;
+    arena->AddCleanupInternal(result, &internal::arena_destruct_object<T>);
+    return result;
+  }
+  template <typename T, typename Arg>
+  static T* Create(Arena* arena, const Arg& arg) {
+    if (arena == NULL) return new T(arg);
+    T* result = new (arena->AllocateAligned(sizeof(T))) T(arg);
+    arena->AddCleanupInternal(result, &internal::arena_destruct_object<T>);
+    return result;
+  }
+
+  // Allocates an uninitialized array of num_elements T's.  T must be a type
+  // with a trivial destructor, since nothing is registered to run it.  If
+  // arena is NULL, the array is allocated with new[] and owned by the
+  // caller.
+  template <typename T>
+  static T* CreateArray(Arena* arena, size_t num_elements) {
+    if (arena == NULL) return new T[num_elements];
+    return static_cast<T*>(arena->AllocateAligned(sizeof(T) * num_elements));
+  }
+
+  // Constructs a message of a generated type which supports arenas (i.e.
+  // was generated with cc_enable_arenas).  The message and everything it
+  // subsequently allocates live on the arena.  If arena is NULL, this is
+  // equivalent to "new T".
+  template <typename T>
+  static T* CreateMessage(Arena* arena) {
+    if (arena == NULL) return new T;
+    T* result = new (arena->AllocateAligned(sizeof(T))) T(arena);
+    arena->AddCleanupInternal(result, &internal::arena_destruct_object<T>);
+    return result;
+  }
+
+  // Like CreateMessage() if T supports arenas; otherwise allocates T on the
+  // heap and hands ownership to the arena with Own().  Generated code uses
+  // this for sub-message types which may come from files without arena
+  // support.
+  template <typename T>
+  static T* CreateMaybeMessage(Arena* arena) {
+    return CreateMaybeMessageInternal<T>(
+        arena, integral_constant<bool,
+                   internal::is_arena_constructable<T>::value>());
+  }
+
+  // Transfers ownership of a heap-allocated object to the arena: it will be
+  // deleted when the arena is destroyed.  Does nothing if object is NULL.
+  template <typename T>
+  void Own(T* object) {
+    if (object != NULL) {
+      AddCleanupInternal(object, &internal::arena_delete_object<T>);
+    }
+  }
+
+  // Registers object's destructor (but not its storage) to be run when the
+  // arena is destroyed.  Use this for objects placed on arena memory by hand.
+  template <typename T>
+  void OwnDestructor(T* object) {
+    if (object != NULL) {
+      AddCleanupInternal(object, &internal::arena_destruct_object<T>);
+    }
+  }
+
+  // Registers an arbitrary function to be called with object when the arena
+  // is destroyed or reset.  Cleanups run in reverse order of registration.
+  void AddCleanup(void* object, void (*cleanup)(void*)) {
+    AddCleanupInternal(object, cleanup);
+  }
+
+  // Allocates n bytes of raw memory, aligned to 8 bytes.  The memory is
+  // released with the arena; nothing is run on it.
+  void* AllocateAligned(size_t n);
+
+ private:
+  struct Block {
+    Block* next;
+    size_t size;  // Usable bytes following the header.
+    size_t pos;   // Bytes handed out so far.
+  };
+  struct CleanupNode {
+    CleanupNode* next;
+    void* object;
+    void (*cleanup)(void*);
+  };
+
+  template <typename T>
+  static T* CreateMaybeMessageInternal(Arena* arena, true_type) {
+    return CreateMessage<T>(arena);
+  }
+  template <typename T>
+  static T* CreateMaybeMessageInternal(Arena* arena, false_type) {
+    T* result = new T;
+    if (arena != NULL) arena->Own(result);
+    return result;
+  }
+
+  void Init();
+  void AddCleanupInternal(void* object, void (*cleanup)(void*));
+  void* AllocateFromNewBlock(size_t n);
+  void RunCleanups();
+  void FreeBlocks();
+
+  static inline char* BlockData(Block* block) {
+    return reinterpret_cast<char*>(block) + kHeaderSize;
+  }
+
+  static const size_t kHeaderSize;
+
+  ArenaOptions options_;
+  Block* blocks_;           // Most recently allocated block first.
+  Block* initial_block_;    // Carved out of options_.initial_block, if any.
+  CleanupNode* cleanups_;   // Most recently registered first.
+  size_t next_block_size_;
+  uint64 space_allocated_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(Arena);
+};
+
+inline void* Arena::AllocateAligned(size_t n) {
+  n = (n + 7) & ~static_cast<size_t>(7);
+  Block* block = blocks_;
+  if (block != NULL && block->size - block->pos >= n) {
+    void* result = BlockData(block) + block->pos;
+    block->pos += n;
+    return result;
+  }
+  return AllocateFromNewBlock(n);
+}
+
+inline void Arena::AddCleanupInternal(void* object, void (*cleanup)(void*)) {
+  CleanupNode* node =
+      static_cast<CleanupNode*>(AllocateAligned(sizeof(CleanupNode)));
+  node->next = cleanups_;
+  node->object = object;
+  node->cleanup = cleanup;
+  cleanups_ = node;
+}
+
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_ARENA_H__
@@ -0,0 +1,362 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <google/protobuf/arena.h>
+
+#include <string>
+#include <vector>
+
+#include <google/protobuf/stubs/common.h>
+#include <google/protobuf/repeated_field.h>
+#include <google/protobuf/test_util.h>
+#include <google/protobuf/unittest.pb.h>
+#include <google/protobuf/unittest_import.pb.h>
+#include <gtest/gtest.h>
+
+namespace google {
+
+using protobuf_unittest::TestAllTypes;
+using protobuf_unittest::TestAllExtensions;
+using protobuf_unittest::TestOneof2;
+using protobuf_unittest_import::ImportMessage;
+
+namespace protobuf {
+namespace {
+
+// Counts how many times its destructor ran.
+class DestructorCounter {
+ public:
+  explicit DestructorCounter(int* count) : count_(count) {}
+  ~DestructorCounter() { ++*count_; }
+
+ private:
+  int* count_;
+};
+
+TEST(ArenaTest, AllocateAligned) {
+  Arena arena;
+  void* previous = NULL;
+  for (int i = 1; i < 1000; i++) {
+    void* p = arena.AllocateAligned(i);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(p) & 7);
+    EXPECT_NE(previous, p);
+    previous = p;
+  }
+  EXPECT_GE(arena.SpaceAllocated(), arena.SpaceUsed());
+  EXPECT_GT(arena.SpaceUsed(), 0);
+}
+
+TEST(ArenaTest, LargeAllocation) {
+  ArenaOptions options;
+  options.start_block_size = 128;
+  options.max_block_size = 128;
+  Arena arena(options);
+  char* small = static_cast<char*>(arena.AllocateAligned(16));
+  char* large = static_cast<char*>(arena.AllocateAligned(100000));
+  memset(large, 0xaa, 100000);
+  // The small block keeps serving small allocations.
+  char* small2 = static_cast<char*>(arena.AllocateAligned(16));
+  EXPECT_EQ(small + 16, small2);
+}
+
+TEST(ArenaTest, InitialBlock) {
+  char buffer[1024];
+  ArenaOptions options;
+  options.initial_block = buffer;
+  options.initial_block_size = sizeof(buffer);
+  Arena arena(options);
+  char* p = static_cast<char*>(arena.AllocateAligned(64));
+  EXPECT_GE(p, buffer);
+  EXPECT_LT(p, buffer + sizeof(buffer));
+  EXPECT_EQ(sizeof(buffer), arena.SpaceAllocated());
+
+  // Overflow onto the heap, then make sure Reset() returns to the buffer.
+  arena.AllocateAligned(4096);
+  EXPECT_GT(arena.SpaceAllocated(), sizeof(buffer));
+  arena.Reset();
+  EXPECT_EQ(sizeof(buffer), arena.SpaceAllocated());
+  EXPECT_EQ(0, arena.SpaceUsed());
+  p = static_cast<char*>(arena.AllocateAligned(64));
+  EXPECT_GE(p, buffer);
+  EXPECT_LT(p, buffer + sizeof(buffer));
+}
+
+TEST(ArenaTest, CreateRunsDestructors) {
+  int count = 0;
+  {
+    Arena arena;
+    for (int i = 0; i < 10; i++) {
+      Arena::Create<DestructorCounter>(&arena, &count);
+    }
+    EXPECT_EQ(0, count);
+  }
+  EXPECT_EQ(10, count);
+}
+
+TEST(ArenaTest, OwnAndReset) {
+  int count = 0;
+  Arena arena;
+  arena.Own(new DestructorCounter(&count));
+  arena.Own(new DestructorCounter(&count));
+  arena.Own(static_cast<DestructorCounter*>(NULL));
+  uint64 allocated = arena.Reset();
+  EXPECT_GT(allocated, 0);
+  EXPECT_EQ(2, count);
+  EXPECT_EQ(0, arena.SpaceAllocated());
+
+  // The arena is usable again after Reset().
+  arena.Own(new DestructorCounter(&count));
+  arena.Reset();
+  EXPECT_EQ(3, count);
+}
+
+TEST(ArenaTest, CreateWithNullArena) {
+  string* str = Arena::Create<string>(NULL, "foo");
+  EXPECT_EQ("foo", *str);
+  delete str;
+
+  TestAllTypes* message = Arena::CreateMessage<TestAllTypes>(NULL);
+  EXPECT_TRUE(message->GetArena() == NULL);
+  delete message;
+}
+
+TEST(ArenaTest, ArenaConstructable) {
+  EXPECT_TRUE(internal::is_arena_constructable<TestAllTypes>::value);
+  EXPECT_FALSE(internal::is_arena_constructable<ImportMessage>::value);
+  EXPECT_FALSE(internal::is_arena_constructable<string>::value);
+}
+
+TEST(ArenaTest, SetAllFields) {
+  Arena arena;
+  TestAllTypes* message = Arena::CreateMessage<TestAllTypes>(&arena);
+  EXPECT_EQ(&arena, message->GetArena());
+  TestUtil::SetAllFields(message);
+  TestUtil::ExpectAllFieldsSet(*message);
+  EXPECT_EQ(&arena, message->repeated_nested_message().GetArena());
+
+  // Copies to and from the heap.
+  TestAllTypes heap_copy(*message);
+  TestUtil::ExpectAllFieldsSet(heap_copy);
+  TestAllTypes* arena_copy = Arena::CreateMessage<TestAllTypes>(&arena);
+  arena_copy->CopyFrom(heap_copy);
+  TestUtil::ExpectAllFieldsSet(*arena_copy);
+
+  message->Clear();
+  TestUtil::ExpectClear(*message);
+}
+
+TEST(ArenaTest, ParseAndSerialize) {
+  TestAllTypes original;
+  TestUtil::SetAllFields(&original);
+  string data = original.SerializeAsString();
+
+  Arena arena;
+  TestAllTypes* message = Arena::CreateMessage<TestAllTypes>(&arena);
+  ASSERT_TRUE(message->ParseFromString(data));
+  TestUtil::ExpectAllFieldsSet(*message);
+  EXPECT_EQ(data, message->SerializeAsString());
+}
+
+TEST(ArenaTest, ReflectionOnArena) {
+  Arena arena;
+  TestAllTypes* message = Arena::CreateMessage<TestAllTypes>(&arena);
+  TestUtil::ReflectionTester reflection_tester(TestAllTypes::descriptor());
+  reflection_tester.SetAllFieldsViaReflection(message);
+  TestUtil::ExpectAllFieldsSet(*message);
+
+  // Released sub-messages are heap copies the caller can delete.
+  const Reflection* reflection = message->GetReflection();
+  const FieldDescriptor* field =
+      TestAllTypes::descriptor()->FindFieldByName("optional_nested_message");
+  Message* released = reflection->ReleaseMessage(message, field);
+  ASSERT_TRUE(released != NULL);
+  EXPECT_TRUE(released->GetArena() == NULL);
+  delete released;
+  EXPECT_FALSE(message->has_optional_nested_message());
+}
+
+TEST(ArenaTest, NewOnArena) {
+  Arena arena;
+  const Message& prototype = TestAllTypes::default_instance();
+  Message* message = prototype.New(&arena);
+  EXPECT_EQ(&arena, message->GetArena());
+
+  // Types without arena support are still owned by the arena.
+  ImportMessage* import_message =
+      ImportMessage::default_instance().New(&arena);
+  import_message->set_d(1);
+  EXPECT_TRUE(import_message->GetArena() == NULL);
+}
+
+TEST(ArenaTest, ReleaseAndSetAllocated) {
+  Arena arena;
+  TestAllTypes* message = Arena::CreateMessage<TestAllTypes>(&arena);
+
+  message->mutable_optional_nested_message()->set_bb(42);
+  TestAllTypes::NestedMessage* nested =
+      message->release_optional_nested_message();
+  EXPECT_EQ(42, nested->bb());
+  EXPECT_FALSE(message->has_optional_nested_message());
+  // The arena copy stays behind; this one is ours.
+  message->set_allocated_optional_nested_message(nested);
+  EXPECT_EQ(42, message->optional_nested_message().bb());
+
+  message->set_optional_string("hello");
+  string* str = message->release_optional_string();
+  EXPECT_EQ("hello", *str);
+  message->set_allocated_optional_string(str);
+  EXPECT_EQ("hello", message->optional_string());
+
+  // Sub-messages of a type without arena support.
+  message->mutable_optional_import_message()->set_d(7);
+  ImportMessage* import_message = message->release_optional_import_message();
+  EXPECT_EQ(7, import_message->d());
+  delete import_message;
+}
+
+TEST(ArenaTest, RepeatedPtrField) {
+  Arena arena;
+  TestAllTypes* message = Arena::CreateMessage<TestAllTypes>(&arena);
+  for (int i = 0; i < 10; i++) {
+    message->add_repeated_nested_message()->set_bb(i);
+    message->add_repeated_string("x");
+  }
+
+  TestAllTypes::NestedMessage* last =
+      message->mutable_repeated_nested_message()->ReleaseLast();
+  EXPECT_EQ(9, last->bb());
+  delete last;
+
+  message->mutable_repeated_nested_message()->AddAllocated(
+      new TestAllTypes::NestedMessage);
+  EXPECT_EQ(10, message->repeated_nested_message_size());
+
+  TestAllTypes::NestedMessage* extracted[2];
+  message->mutable_repeated_nested_message()->ExtractSubrange(0, 2, extracted);
+  EXPECT_EQ(0, extracted[0]->bb());
+  EXPECT_EQ(1, extracted[1]->bb());
+  delete extracted[0];
+  delete extracted[1];
+  EXPECT_EQ(8, message->repeated_nested_message_size());
+
+  message->mutable_repeated_string()->DeleteSubrange(0, 5);
+  EXPECT_EQ(5, message->repeated_string_size());
+}
+
+TEST(ArenaTest, RepeatedPtrFieldSwapAcrossArenas) {
+  Arena arena1;
+  Arena arena2;
+  RepeatedPtrField<string> field1(&arena1);
+  RepeatedPtrField<string> field2(&arena2);
+  RepeatedPtrField<string> heap_field;
+  field1.Add()->assign("one");
+  field2.Add()->assign("two");
+  field2.Add()->assign("three");
+  heap_field.Add()->assign("four");
+
+  field1.Swap(&field2);
+  ASSERT_EQ(2, field1.size());
+  EXPECT_EQ("two", field1.Get(0));
+  EXPECT_EQ("three", field1.Get(1));
+  ASSERT_EQ(1, field2.size());
+  EXPECT_EQ("one", field2.Get(0));
+  EXPECT_EQ(&arena1, field1.GetArena());
+
+  heap_field.Swap(&field1);
+  ASSERT_EQ(1, field1.size());
+  EXPECT_EQ("four", field1.Get(0));
+  ASSERT_EQ(2, heap_field.size());
+  EXPECT_EQ("two", heap_field.Get(0));
+}
+
+TEST(ArenaTest, SwapAcrossArenas) {
+  Arena arena1;
+  Arena arena2;
+  TestAllTypes* message1 = Arena::CreateMessage<TestAllTypes>(&arena1);
+  TestAllTypes* message2 = Arena::CreateMessage<TestAllTypes>(&arena2);
+  TestUtil::SetAllFields(message1);
+
+  message1->Swap(message2);
+  TestUtil::ExpectAllFieldsSet(*message2);
+  TestUtil::ExpectClear(*message1);
+
+  TestAllTypes heap_message;
+  heap_message.Swap(message2);
+  TestUtil::ExpectAllFieldsSet(heap_message);
+  TestUtil::ExpectClear(*message2);
+
+  // Reflection-based swaps copy as well.
+  const Reflection* reflection = heap_message.GetReflection();
+  reflection->Swap(&heap_message, message1);
+  TestUtil::ExpectAllFieldsSet(*message1);
+
+  vector<const FieldDescriptor*> fields;
+  fields.push_back(
+      TestAllTypes::descriptor()->FindFieldByName("optional_string"));
+  fields.push_back(
+      TestAllTypes::descriptor()->FindFieldByName("repeated_nested_message"));
+  reflection->SwapFields(message1, message2, fields);
+  EXPECT_FALSE(message1->has_optional_string());
+  EXPECT_EQ(0, message1->repeated_nested_message_size());
+  EXPECT_EQ("115", message2->optional_string());
+  EXPECT_EQ(2, message2->repeated_nested_message_size());
+  EXPECT_EQ(218, message2->repeated_nested_message(0).bb());
+}
+
+TEST(ArenaTest, Oneof) {
+  Arena arena;
+  TestOneof2* message = Arena::CreateMessage<TestOneof2>(&arena);
+  message->set_foo_string("foo");
+  message->mutable_foo_message()->set_qux_int(1);
+  EXPECT_FALSE(message->has_foo_string());
+  message->set_foo_bytes("bytes");
+  EXPECT_EQ("bytes", message->foo_bytes());
+
+  string* released = message->release_foo_bytes();
+  EXPECT_EQ("bytes", *released);
+  delete released;
+
+  message->set_allocated_foo_message(new TestOneof2::NestedMessage);
+  message->mutable_foo_message()->set_qux_int(5);
+  TestOneof2::NestedMessage* nested = message->release_foo_message();
+  EXPECT_EQ(5, nested->qux_int());
+  delete nested;
+}
+
+TEST(ArenaTest, Extensions) {
+  Arena arena;
+  TestAllExtensions* message = Arena::CreateMessage<TestAllExtensions>(&arena);
+  TestUtil::SetAllExtensions(message);
+  TestUtil::ExpectAllExtensionsSet(*message);
+}
+
+}  // namespace
+}  // namespace protobuf
+}  // namespace google
@@ -74,6 +74,10 @@ class LIBPROTOC_EXPORT CodeGenerator {
   //
   // Returns true if successful.  Otherwise, sets *error to a description of
   // the problem (e.g. "invalid parameter") and returns false.
+  //
+  // When protoc is run with --jobs, Generate() may be called for several
+  // files at once from different threads, each with its own
+  // GeneratorContext, so it must not modify shared state without locking.
   virtual bool Generate(const FileDescriptor* file,
                         const string& parameter,
                         GeneratorContext* generator_context,
@@ -67,6 +67,7 @@
 #include <google/protobuf/stubs/strutil.h>
 #include <google/protobuf/stubs/substitute.h>
 #include <google/protobuf/stubs/map_util.h>
+#include <google/protobuf/stubs/parallel.h>
 #include <google/protobuf/stubs/stl_util.h>
 
 
@@ -179,6 +180,61 @@ bool TryCreateParentDirectory(const string& prefix, const string& filename) {
   return true;
 }
 
+// Returns true if the file exists and contains exactly the given data.
+bool FileHasContents(const string& filename, const char* data, int size) {
+  int file_descriptor;
+  do {
+    file_descriptor = open(filename.c_str(), O_RDONLY | O_BINARY);
+  } while (file_descriptor < 0 && errno == EINTR);
+  if (file_descriptor < 0) {
+    return false;
+  }
+
+  char buffer[4096];
+  bool same = true;
+  while (same) {
+    int read_result;
+    do {
+      read_result = read(file_descriptor, buffer, sizeof(buffer));
+    } while (read_result < 0 && errno == EINTR);
+
+    if (read_result <= 0) {
+      // End of file, or an error, in which case the file is just rewritten.
+      same = read_result == 0 && size == 0;
+      break;
+    }
+    same = read_result <= size && memcmp(buffer, data, read_result) == 0;
+    data += read_result;
+    size -= read_result;
+  }
+
+  close(file_descriptor);
+  return same;
+}
+
+// Returns the name of the --cache_dir entry for the given key:  its 64-bit
+// FNV-1a hash, in hex.  The entry also contains the key itself, in case two
+// keys have the same hash.
+string CacheEntryName(const string& key) {
+  uint64 hash = GOOGLE_ULONGLONG(14695981039346656037);
+  for (int i = 0; i < key.size(); i++) {
+    hash ^= static_cast<uint8>(key[i]);
+    hash *= GOOGLE_ULONGLONG(1099511628211);
+  }
+  char buffer[kFastToBufferSize];
+  return FastHex64ToBuffer(hash, buffer);
+}
+
+void WriteLengthPrefixed(io::CodedOutputStream* output, const string& value) {
+  output->WriteVarint32(value.size());
+  output->WriteString(value);
+}
+
+bool ReadLengthPrefixed(io::CodedInputStream* input, string* value) {
+  uint32 size;
+  return input->ReadVarint32(&size) && input->ReadString(value, size);
+}
+
 }  // namespace
 
 // A MultiFileErrorCollector that prints errors to stderr.
@@ -240,8 +296,10 @@ class CommandLineInterface::GeneratorContextImpl : public GeneratorContext {
   ~GeneratorContextImpl();
 
   // Write all files in the directory to disk at the given output location,
-  // which must end in a '/'.
-  bool WriteAllToDisk(const string& prefix);
+  // which must end in a '/'.  If stats is not NULL, files which are already
+  // on disk with the same contents are left alone, so that their modification
+  // times don't change, and are counted in *stats along with those written.
+  bool WriteAllToDisk(const string& prefix, CacheStats* stats);
 
   // Write the contents of this directory to a ZIP-format archive with the
   // given name.
@@ -313,7 +371,7 @@ CommandLineInterface::GeneratorContextImpl::~GeneratorContextImpl() {
 }
 
 bool CommandLineInterface::GeneratorContextImpl::WriteAllToDisk(
-    const string& prefix) {
+    const string& prefix, CacheStats* stats) {
   if (had_error_) {
     return false;
   }
@@ -333,6 +391,14 @@ bool CommandLineInterface::GeneratorContextImpl::WriteAllToDisk(
     }
     string filename = prefix + relative_filename;
 
+    if (stats != NULL) {
+      if (FileHasContents(filename, data, size)) {
+        ++stats->files_unchanged;
+        continue;
+      }
+      ++stats->files_written;
+    }
+
     // Create the output file.
     int file_descriptor;
     do {
@@ -578,6 +644,291 @@ CommandLineInterface::MemoryOutputStream::~MemoryOutputStream() {
   }
 }
 
+// -------------------------------------------------------------------
+
+// With --jobs, each code generator invocation (one input file for a compiled-in
+// generator, or one plugin run) writes to a GenerationJob of its own, which
+// just records what was written.  Once all jobs are done, the recorded files
+// are replayed into the shared GeneratorContextImpl in the order the serial
+// loop would have written them, so that insertion points, "written twice"
+// errors and the output itself don't depend on which job finished first.
+class CommandLineInterface::GenerationJob : public GeneratorContext {
+ public:
+  GenerationJob(CommandLineInterface* cli,
+                const vector<const FileDescriptor*>& parsed_files,
+                const OutputDirective* output_directive,
+                const FileDescriptor* file)
+    : cli_(cli),
+      parsed_files_(parsed_files),
+      output_directive_(output_directive),
+      file_(file),
+      success_(false),
+      cache_hit_(false) {
+    if (output_directive->generator == NULL) {
+      plugin_name_ = cli->PluginName(*output_directive);
+    } else {
+      parameter_ = cli->GeneratorParameter(*output_directive);
+    }
+  }
+  ~GenerationJob() {
+    STLDeleteElements(&outputs_);
+  }
+
+  // Makes Run() look for the output in the given --cache_dir first, and save
+  // it there if the generator had to be run.  Only for compiled-in
+  // generators:  protoc can't tell whether a plugin has changed.
+  void UseCache(const string& cache_dir) {
+    GOOGLE_CHECK(output_directive_->generator != NULL);
+    cache_dir_ = cache_dir;
+  }
+
+  bool uses_cache() const { return !cache_dir_.empty(); }
+
+  // Was the output found in the cache?
+  bool cache_hit() const { return cache_hit_; }
+
+  // Runs the generator, recording its output.  This is called on a worker
+  // thread, so it must not touch anything but the job itself.
+  void Run() {
+    string cache_key, cache_filename;
+    if (!cache_dir_.empty()) {
+      cache_key = CacheKey();
+      cache_filename = cache_dir_ + CacheEntryName(cache_key);
+      if (ReadFromCache(cache_filename, cache_key)) {
+        success_ = true;
+        cache_hit_ = true;
+        return;
+      }
+    }
+
+    if (output_directive_->generator == NULL) {
+      success_ = cli_->GeneratePluginOutput(
+          parsed_files_, plugin_name_, output_directive_->parameter, this,
+          &error_);
+    } else {
+      success_ = output_directive_->generator->Generate(
+          file_, parameter_, this, &error_);
+    }
+
+    if (!cache_dir_.empty() && success_) {
+      WriteToCache(cache_filename, cache_key);
+    }
+  }
+
+  // Writes everything the generator wrote, in order, to the given context,
+  // then prints the generator's error, if any, the way GenerateOutput()
+  // would.  Returns false if the generator failed.
+  bool Finish(GeneratorContext* generator_context) {
+    if (!cache_error_.empty()) {
+      // Not fatal; the output is still right.
+      cerr << cache_error_ << endl;
+    }
+
+    for (int i = 0; i < outputs_.size(); i++) {
+      const Output& output = *outputs_[i];
+      scoped_ptr<io::ZeroCopyOutputStream> stream;
+      if (!output.insertion_point.empty()) {
+        stream.reset(generator_context->OpenForInsert(
+            output.filename, output.insertion_point));
+      } else if (output.append_mode) {
+        stream.reset(generator_context->OpenForAppend(output.filename));
+      } else {
+        stream.reset(generator_context->Open(output.filename));
+      }
+      io::CodedOutputStream(stream.get()).WriteString(output.data);
+    }
+
+    if (!success_) {
+      if (output_directive_->generator == NULL) {
+        cerr << output_directive_->name << ": " << error_ << endl;
+      } else {
+        cerr << output_directive_->name << ": " << file_->name() << ": "
+             << error_ << endl;
+      }
+    }
+    return success_;
+  }
+
+  // implements GeneratorContext --------------------------------------
+  io::ZeroCopyOutputStream* Open(const string& filename);
+  io::ZeroCopyOutputStream* OpenForAppend(const string& filename);
+  io::ZeroCopyOutputStream* OpenForInsert(
+      const string& filename, const string& insertion_point);
+  void ListParsedFiles(vector<const FileDescriptor*>* output) {
+    *output = parsed_files_;
+  }
+
+ private:
+  friend class RecordingOutputStream;
+
+  // One call to Open(), OpenForAppend() or OpenForInsert().
+  struct Output {
+    string filename;
+    string insertion_point;
+    bool append_mode;
+    string data;
+  };
+
+  // Returns everything which the generator's output can depend on, given
+  // that it is the same protoc:  the generator and its parameter, the file
+  // and everything it imports, comments included, and the names of the
+  // other files being compiled.
+  string CacheKey() {
+    CodeGeneratorRequest request;
+    request.add_file_to_generate(file_->name());
+    request.set_parameter(parameter_);
+    set<const FileDescriptor*> already_seen;
+    CommandLineInterface::GetTransitiveDependencies(
+        file_, true, &already_seen, request.mutable_proto_file());
+
+    string key = "protoc cache 1\n";
+    key += SimpleItoa(GOOGLE_PROTOBUF_VERSION) + " " + cli_->version_info_;
+    key += "\n" + output_directive_->name + "\n";
+    for (int i = 0; i < parsed_files_.size(); i++) {
+      key += parsed_files_[i]->name() + "\n";
+    }
+    key += "\n";
+    request.AppendToString(&key);
+    return key;
+  }
+
+  // A cache entry is the key, then the outputs.  Returns false if the entry
+  // doesn't exist or can't be read, or is for some other key.
+  bool ReadFromCache(const string& filename, const string& key) {
+    int file_descriptor;
+    do {
+      file_descriptor = open(filename.c_str(), O_RDONLY | O_BINARY);
+    } while (file_descriptor < 0 && errno == EINTR);
+    if (file_descriptor < 0) {
+      return false;
+    }
+
+    io::FileInputStream file_stream(file_descriptor);
+    file_stream.SetCloseOnDelete(true);
+    io::CodedInputStream input(&file_stream);
+    // Generated code can be large.
+    input.SetTotalBytesLimit(kint32max, -1);
+
+    string entry_key;
+    uint32 count;
+    if (!ReadLengthPrefixed(&input, &entry_key) || entry_key != key ||
+        !input.ReadVarint32(&count)) {
+      return false;
+    }
+
+    vector<Output*> outputs;
+    for (int i = 0; i < count; i++) {
+      scoped_ptr<Output> output(new Output);
+      uint32 append_mode;
+      if (!ReadLengthPrefixed(&input, &output->filename) ||
+          !ReadLengthPrefixed(&input, &output->insertion_point) ||
+          !input.ReadVarint32(&append_mode) ||
+          !ReadLengthPrefixed(&input, &output->data)) {
+        // Probably being written by another protoc.
+        STLDeleteElements(&outputs);
+        return false;
+      }
+      output->append_mode = append_mode != 0;
+      outputs.push_back(output.release());
+    }
+
+    outputs_.swap(outputs);
+    return true;
+  }
+
+  // Saves outputs_ to the cache.  Errors are left in cache_error_.
+  void WriteToCache(const string& filename, const string& key) {
+    int file_descriptor;
+    do {
+      file_descriptor =
+        open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0666);
+    } while (file_descriptor < 0 && errno == EINTR);
+    if (file_descriptor < 0) {
+      cache_error_ = filename + ": " + strerror(errno);
+      return;
+    }
+
+    io::FileOutputStream file_stream(file_descriptor);
+    {
+      io::CodedOutputStream output(&file_stream);
+      WriteLengthPrefixed(&output, key);
+      output.WriteVarint32(outputs_.size());
+      for (int i = 0; i < outputs_.size(); i++) {
+        WriteLengthPrefixed(&output, outputs_[i]->filename);
+        WriteLengthPrefixed(&output, outputs_[i]->insertion_point);
+        output.WriteVarint32(outputs_[i]->append_mode);
+        WriteLengthPrefixed(&output, outputs_[i]->data);
+      }
+    }
+    if (!file_stream.Close()) {
+      cache_error_ = filename + ": " + strerror(file_stream.GetErrno());
+    }
+  }
+
+  CommandLineInterface* cli_;
+  const vector<const FileDescriptor*>& parsed_files_;
+  const OutputDirective* output_directive_;
+  const FileDescriptor* file_;   // NULL for plugins, which get all files.
+  string plugin_name_;
+  string parameter_;
+
+  // In the order the streams were closed, which is when MemoryOutputStream
+  // applies them.
+  vector<Output*> outputs_;
+  bool success_;
+  string error_;
+
+  string cache_dir_;    // Empty if not caching.
+  bool cache_hit_;
+  string cache_error_;  // Why the output couldn't be cached, if it couldn't.
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(GenerationJob);
+};
+
+class CommandLineInterface::RecordingOutputStream
+    : public io::ZeroCopyOutputStream {
+ public:
+  RecordingOutputStream(GenerationJob* job, const string& filename,
+                        const string& insertion_point, bool append_mode)
+      : job_(job),
+        output_(new GenerationJob::Output),
+        inner_(new io::StringOutputStream(&output_->data)) {
+    output_->filename = filename;
+    output_->insertion_point = insertion_point;
+    output_->append_mode = append_mode;
+  }
+  virtual ~RecordingOutputStream() {
+    // Make sure all data has been written.
+    inner_.reset();
+    job_->outputs_.push_back(output_.release());
+  }
+
+  // implements ZeroCopyOutputStream ---------------------------------
+  virtual bool Next(void** data, int* size) { return inner_->Next(data, size); }
+  virtual void BackUp(int count)            {        inner_->BackUp(count);    }
+  virtual int64 ByteCount() const           { return inner_->ByteCount();      }
+
+ private:
+  GenerationJob* job_;
+  scoped_ptr<GenerationJob::Output> output_;
+  scoped_ptr<io::StringOutputStream> inner_;
+};
+
+io::ZeroCopyOutputStream* CommandLineInterface::GenerationJob::Open(
+    const string& filename) {
+  return new RecordingOutputStream(this, filename, "", false);
+}
+
+io::ZeroCopyOutputStream* CommandLineInterface::GenerationJob::OpenForAppend(
+    const string& filename) {
+  return new RecordingOutputStream(this, filename, "", true);
+}
+
+io::ZeroCopyOutputStream* CommandLineInterface::GenerationJob::OpenForInsert(
+    const string& filename, const string& insertion_point) {
+  return new RecordingOutputStream(this, filename, insertion_point, false);
+}
+
 // ===================================================================
 
 CommandLineInterface::CommandLineInterface()
@@ -587,7 +938,9 @@ CommandLineInterface::CommandLineInterface()
     imports_in_descriptor_set_(false),
     source_info_in_descriptor_set_(false),
     disallow_services_(false),
-    inputs_are_proto_path_relative_(false) {}
+    inputs_are_proto_path_relative_(false),
+    jobs_(1),
+    print_cache_stats_(false) {}
 CommandLineInterface::~CommandLineInterface() {}
 
 void CommandLineInterface::RegisterGenerator(const string& flag_name,
@@ -670,8 +1023,18 @@ int CommandLineInterface::Run(int argc, const char* const argv[]) {
   typedef hash_map<string, GeneratorContextImpl*> GeneratorContextMap;
   GeneratorContextMap output_directories;
 
+  // --cache_dir counts hits and misses here, and output files written or left
+  // unchanged when writing to disk.
+  CacheStats cache_stats;
+  CacheStats* cache_stats_ptr = cache_dir_.empty() ? NULL : &cache_stats;
+
   // Generate output.
   if (mode_ == MODE_COMPILE) {
+    if (!VerifyDirectoryExists(cache_dir_)) {
+      return 1;
+    }
+
+    vector<GeneratorContextImpl*> generator_contexts;
     for (int i = 0; i < output_directives_.size(); i++) {
       string output_location = output_directives_[i].output_location;
       if (!HasSuffixString(output_location, ".zip") &&
@@ -684,11 +1047,23 @@ int CommandLineInterface::Run(int argc, const char* const argv[]) {
         // First time we've seen this output location.
         *map_slot = new GeneratorContextImpl(parsed_files);
       }
+      generator_contexts.push_back(*map_slot);
+    }
 
-      if (!GenerateOutput(parsed_files, output_directives_[i], *map_slot)) {
+    if (jobs_ > 1 || cache_stats_ptr != NULL) {
+      if (!RunGenerationJobs(parsed_files, generator_contexts,
+                             cache_stats_ptr)) {
         STLDeleteValues(&output_directories);
         return 1;
       }
+    } else {
+      for (int i = 0; i < output_directives_.size(); i++) {
+        if (!GenerateOutput(parsed_files, output_directives_[i],
+                            generator_contexts[i])) {
+          STLDeleteValues(&output_directories);
+          return 1;
+        }
+      }
     }
   }
 
@@ -698,7 +1073,7 @@ int CommandLineInterface::Run(int argc, const char* const argv[]) {
     const string& location = iter->first;
     GeneratorContextImpl* directory = iter->second;
     if (HasSuffixString(location, "/")) {
-      if (!directory->WriteAllToDisk(location)) {
+      if (!directory->WriteAllToDisk(location, cache_stats_ptr)) {
         STLDeleteValues(&output_directories);
         return 1;
       }
@@ -716,6 +1091,12 @@ int CommandLineInterface::Run(int argc, const char* const argv[]) {
 
   STLDeleteValues(&output_directories);
 
+  if (print_cache_stats_) {
+    cout << "Cache: " << cache_stats.hits << " hits, " << cache_stats.misses
+         << " misses.  Files: " << cache_stats.files_written << " written, "
+         << cache_stats.files_unchanged << " unchanged." << endl;
+  }
+
   if (!descriptor_set_name_.empty()) {
     if (!WriteDescriptorSet(parsed_files)) {
       return 1;
@@ -778,6 +1159,9 @@ void CommandLineInterface::Clear() {
   imports_in_descriptor_set_ = false;
   source_info_in_descriptor_set_ = false;
   disallow_services_ = false;
+  jobs_ = 1;
+  cache_dir_.clear();
+  print_cache_stats_ = false;
 }
 
 bool CommandLineInterface::MakeInputsBeProtoPathRelative(
@@ -876,6 +1260,10 @@ CommandLineInterface::ParseArguments(int argc, const char* const argv[]) {
     cerr << "--include_source_info only makes sense when combined with "
             "--descriptor_set_out." << endl;
   }
+  if (print_cache_stats_ && cache_dir_.empty()) {
+    cerr << "--cache_stats only makes sense when combined with --cache_dir."
+         << endl;
+  }
 
   return PARSE_ARGUMENT_DONE_AND_CONTINUE;
 }
@@ -930,7 +1318,8 @@ bool CommandLineInterface::ParseArgument(const char* arg,
       *name == "--include_source_info" ||
       *name == "--version" ||
       *name == "--decode_raw" ||
-      *name == "--print_free_field_numbers") {
+      *name == "--print_free_field_numbers" ||
+      *name == "--cache_stats") {
     // HACK:  These are the only flags that don't take a value.
     //   They probably should not be hard-coded like this but for now it's
     //   not worth doing better.
@@ -1076,6 +1465,29 @@ CommandLineInterface::InterpretArgument(const string& name,
       return PARSE_ARGUMENT_FAIL;
     }
 
+  } else if (name == "--jobs") {
+    int32 jobs;
+    if (!safe_strto32(value, &jobs) || jobs < 1) {
+      cerr << name << " requires a positive number of threads." << endl;
+      return PARSE_ARGUMENT_FAIL;
+    }
+    jobs_ = jobs;
+
+  } else if (name == "--cache_dir") {
+    if (!cache_dir_.empty()) {
+      cerr << name << " may only be passed once." << endl;
+      return PARSE_ARGUMENT_FAIL;
+    }
+    if (value.empty()) {
+      cerr << name << " requires a non-empty value." << endl;
+      return PARSE_ARGUMENT_FAIL;
+    }
+    cache_dir_ = value;
+    AddTrailingSlash(&cache_dir_);
+
+  } else if (name == "--cache_stats") {
+    print_cache_stats_ = true;
+
   } else if (name == "--plugin") {
     if (plugin_prefix_.empty()) {
       cerr << "This compiler does not support plugins." << endl;
@@ -1206,6 +1618,20 @@ void CommandLineInterface::PrintHelpText() {
 "  --error_format=FORMAT       Set the format in which to print errors.\n"
 "                              FORMAT may be 'gcc' (the default) or 'msvs'\n"
 "                              (Microsoft Visual Studio format).\n"
+"  --jobs=N                    Run code generators on up to N threads, one\n"
+"                              input file (or plugin invocation) at a time\n"
+"                              per thread.  The output and any errors are\n"
+"                              the same as without --jobs.\n"
+"  --cache_dir=DIR             Save the output of each code generator for\n"
+"                              each input file in DIR, and reuse it as long\n"
+"                              as the file, its imports, the generator and\n"
+"                              its parameters are the same.  Output files\n"
+"                              whose contents have not changed are not\n"
+"                              rewritten, so keep their modification times.\n"
+"                              Plugins are always run.\n"
+"  --cache_stats               With --cache_dir, print how many generator\n"
+"                              runs were found in the cache and how many\n"
+"                              output files were written.\n"
 "  --print_free_field_numbers  Print the free field numbers of the messages\n"
 "                              defined in the given proto files. Groups share\n"
 "                              the same field number space with the parent \n"
@@ -1242,14 +1668,7 @@ bool CommandLineInterface::GenerateOutput(
   string error;
   if (output_directive.generator == NULL) {
     // This is a plugin.
-    GOOGLE_CHECK(HasPrefixString(output_directive.name, "--") &&
-          HasSuffixString(output_directive.name, "_out"))
-        << "Bad name for plugin generator: " << output_directive.name;
-
-    // Strip the "--" and "_out" and add the plugin prefix.
-    string plugin_name = plugin_prefix_ + "gen-" +
-        output_directive.name.substr(2, output_directive.name.size() - 6);
-
+    string plugin_name = PluginName(output_directive);
     if (!GeneratePluginOutput(parsed_files, plugin_name,
                               output_directive.parameter,
                               generator_context, &error)) {
@@ -1258,13 +1677,7 @@ bool CommandLineInterface::GenerateOutput(
     }
   } else {
     // Regular generator.
-    string parameters = output_directive.parameter;
-    if (!generator_parameters_[output_directive.name].empty()) {
-      if (!parameters.empty()) {
-        parameters.append(",");
-      }
-      parameters.append(generator_parameters_[output_directive.name]);
-    }
+    string parameters = GeneratorParameter(output_directive);
     for (int i = 0; i < parsed_files.size(); i++) {
       if (!output_directive.generator->Generate(parsed_files[i], parameters,
                                                 generator_context, &error)) {
@@ -1279,6 +1692,83 @@ bool CommandLineInterface::GenerateOutput(
   return true;
 }
 
+bool CommandLineInterface::RunGenerationJobs(
+    const vector<const FileDescriptor*>& parsed_files,
+    const vector<GeneratorContextImpl*>& generator_contexts,
+    CacheStats* cache_stats) {
+  // One job per plugin run, or per input file for compiled-in generators, in
+  // the order GenerateOutput() would run them.
+  vector<GenerationJob*> jobs;
+  vector<GeneratorContextImpl*> job_contexts;
+  for (int i = 0; i < output_directives_.size(); i++) {
+    const OutputDirective& output_directive = output_directives_[i];
+    if (output_directive.generator == NULL) {
+      jobs.push_back(
+          new GenerationJob(this, parsed_files, &output_directive, NULL));
+      job_contexts.push_back(generator_contexts[i]);
+    } else {
+      for (int j = 0; j < parsed_files.size(); j++) {
+        jobs.push_back(new GenerationJob(this, parsed_files, &output_directive,
+                                         parsed_files[j]));
+        job_contexts.push_back(generator_contexts[i]);
+        if (cache_stats != NULL) {
+          jobs.back()->UseCache(cache_dir_);
+        }
+      }
+    }
+  }
+
+  vector<Closure*> closures;
+  for (int i = 0; i < jobs.size(); i++) {
+    closures.push_back(NewCallback(jobs[i], &GenerationJob::Run));
+  }
+  internal::RunInParallel(closures, jobs_);
+
+  if (cache_stats != NULL) {
+    for (int i = 0; i < jobs.size(); i++) {
+      if (!jobs[i]->uses_cache()) continue;
+      if (jobs[i]->cache_hit()) {
+        ++cache_stats->hits;
+      } else {
+        ++cache_stats->misses;
+      }
+    }
+  }
+
+  // Unlike the serial loop, every job has run even if an earlier one failed,
+  // but output stops at the first failure just the same.
+  bool success = true;
+  for (int i = 0; i < jobs.size() && success; i++) {
+    success = jobs[i]->Finish(job_contexts[i]);
+  }
+
+  STLDeleteElements(&jobs);
+  return success;
+}
+
+string CommandLineInterface::PluginName(
+    const OutputDirective& output_directive) {
+  GOOGLE_CHECK(HasPrefixString(output_directive.name, "--") &&
+        HasSuffixString(output_directive.name, "_out"))
+      << "Bad name for plugin generator: " << output_directive.name;
+
+  // Strip the "--" and "_out" and add the plugin prefix.
+  return plugin_prefix_ + "gen-" +
+      output_directive.name.substr(2, output_directive.name.size() - 6);
+}
+
+string CommandLineInterface::GeneratorParameter(
+    const OutputDirective& output_directive) {
+  string parameters = output_directive.parameter;
+  if (!generator_parameters_[output_directive.name].empty()) {
+    if (!parameters.empty()) {
+      parameters.append(",");
+    }
+    parameters.append(generator_parameters_[output_directive.name]);
+  }
+  return parameters;
+}
+
 bool CommandLineInterface::GeneratePluginOutput(
     const vector<const FileDescriptor*>& parsed_files,
     const string& plugin_name,
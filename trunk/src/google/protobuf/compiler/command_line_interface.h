@@ -190,6 +190,8 @@ class LIBPROTOC_EXPORT CommandLineInterface {
   class ErrorPrinter;
   class GeneratorContextImpl;
   class MemoryOutputStream;
+  class GenerationJob;
+  class RecordingOutputStream;
 
   // Clear state from previous Run().
   void Clear();
@@ -241,6 +243,39 @@ class LIBPROTOC_EXPORT CommandLineInterface {
                             GeneratorContext* generator_context,
                             string* error);
 
+  // Counts reported by --cache_stats.
+  struct CacheStats {
+    int hits;             // Generator invocations whose output was cached.
+    int misses;           // Those which had to be run.
+    int files_written;    // Output files written to disk.
+    int files_unchanged;  // Output files already on disk as generated.
+
+    CacheStats() : hits(0), misses(0), files_written(0), files_unchanged(0) {}
+  };
+
+  // Implements --jobs.  Does the same work as calling GenerateOutput() for
+  // each of output_directives_ in turn, writing to the corresponding
+  // generator_contexts, but runs each code generator invocation (a directive
+  // and an input file, or a plugin run) as a GenerationJob, on jobs_
+  // threads.  Their output is applied to generator_contexts, and the first
+  // error reported, in the same order as GenerateOutput() would have.
+  //
+  // If cache_stats is not NULL, invocations of compiled-in generators are
+  // looked up in cache_dir_ first, and only run if they are not there, and
+  // are counted in *cache_stats.
+  bool RunGenerationJobs(
+      const vector<const FileDescriptor*>& parsed_files,
+      const vector<GeneratorContextImpl*>& generator_contexts,
+      CacheStats* cache_stats);
+
+  // Returns the name of the plugin executable for a directive whose
+  // generator is NULL.
+  string PluginName(const OutputDirective& output_directive);
+
+  // Returns the parameter to pass to the directive's generator: the one
+  // given with the output flag followed by any given with the option flag.
+  string GeneratorParameter(const OutputDirective& output_directive);
+
   // Implements --encode and --decode.
   bool EncodeOrDecode(const DescriptorPool* pool);
 
@@ -368,6 +403,16 @@ class LIBPROTOC_EXPORT CommandLineInterface {
   // See SetInputsAreProtoPathRelative().
   bool inputs_are_proto_path_relative_;
 
+  // The number of threads on which to run code generators (--jobs).
+  int jobs_;
+
+  // If --cache_dir was given, the directory in which to cache generated
+  // output.  Otherwise, empty.
+  string cache_dir_;
+
+  // Was the --cache_stats flag used?
+  bool print_cache_stats_;
+
   GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(CommandLineInterface);
 };
 
@@ -626,6 +626,238 @@ TEST_F(CommandLineInterfaceTest, Insert) {
       "foo.proto", "Foo");
 }
 
+TEST_F(CommandLineInterfaceTest, JobsMultipleInputs) {
+  // Test running generators and plugins on several threads.
+
+  CreateTempFile("foo.proto",
+    "syntax = \"proto2\";\n"
+    "message Foo {}\n");
+  CreateTempFile("bar.proto",
+    "syntax = \"proto2\";\n"
+    "message Bar {}\n");
+
+  Run("protocol_compiler --jobs=4 --test_out=$tmpdir --plug_out=$tmpdir "
+      "--proto_path=$tmpdir foo.proto bar.proto");
+
+  ExpectNoErrors();
+  ExpectGeneratedWithMultipleInputs("test_generator", "foo.proto,bar.proto",
+                                    "foo.proto", "Foo");
+  ExpectGeneratedWithMultipleInputs("test_generator", "foo.proto,bar.proto",
+                                    "bar.proto", "Bar");
+  ExpectGeneratedWithMultipleInputs("test_plugin", "foo.proto,bar.proto",
+                                    "foo.proto", "Foo");
+  ExpectGeneratedWithMultipleInputs("test_plugin", "foo.proto,bar.proto",
+                                    "bar.proto", "Bar");
+}
+
+TEST_F(CommandLineInterfaceTest, JobsInsert) {
+  // Insertions must still be applied after the output they insert into, and
+  // in the order given, whichever job finishes first.
+
+  CreateTempFile("foo.proto",
+    "syntax = \"proto2\";\n"
+    "message Foo {}\n");
+
+  Run("protocol_compiler --jobs=4 "
+      "--test_out=TestParameter:$tmpdir "
+      "--plug_out=TestPluginParameter:$tmpdir "
+      "--test_out=insert=test_generator,test_plugin:$tmpdir "
+      "--plug_out=insert=test_generator,test_plugin:$tmpdir "
+      "--proto_path=$tmpdir foo.proto");
+
+  ExpectNoErrors();
+  ExpectGeneratedWithInsertions(
+      "test_generator", "TestParameter", "test_generator,test_plugin",
+      "foo.proto", "Foo");
+  ExpectGeneratedWithInsertions(
+      "test_plugin", "TestPluginParameter", "test_generator,test_plugin",
+      "foo.proto", "Foo");
+}
+
+TEST_F(CommandLineInterfaceTest, JobsReportFirstError) {
+  // Only the error the serial order would have hit first is reported, even
+  // though every file was generated.
+
+  CreateTempFile("foo.proto",
+    "syntax = \"proto2\";\n"
+    "package foo;\n"
+    "message MockCodeGenerator_Error {}\n");
+  CreateTempFile("bar.proto",
+    "syntax = \"proto2\";\n"
+    "package bar;\n"
+    "message MockCodeGenerator_Error {}\n");
+
+  Run("protocol_compiler --jobs=4 --test_out=$tmpdir "
+      "--proto_path=$tmpdir foo.proto bar.proto");
+
+  ExpectErrorText(
+      "--test_out: foo.proto: Saw message type MockCodeGenerator_Error.\n");
+}
+
+TEST_F(CommandLineInterfaceTest, InvalidJobs) {
+  CreateTempFile("foo.proto",
+    "syntax = \"proto2\";\n"
+    "message Foo {}\n");
+
+  Run("protocol_compiler --jobs=0 --test_out=$tmpdir "
+      "--proto_path=$tmpdir foo.proto");
+
+  ExpectErrorText("--jobs requires a positive number of threads.\n");
+}
+
+// These check the counts printed by --cache_stats, which needs stdout (see
+// Run()).
+#if !defined(__CYGWIN__)
+
+TEST_F(CommandLineInterfaceTest, CacheDir) {
+  CreateTempFile("foo.proto",
+    "syntax = \"proto2\";\n"
+    "message Foo {}\n");
+  CreateTempDir("cache");
+
+  Run("protocol_compiler --cache_dir=$tmpdir/cache --cache_stats "
+      "--test_out=$tmpdir --proto_path=$tmpdir foo.proto");
+
+  ExpectNoErrors();
+  ExpectGenerated("test_generator", "", "foo.proto", "Foo");
+  ExpectCapturedStdout(
+      "Cache: 0 hits, 1 misses.  Files: 1 written, 0 unchanged.\n");
+
+  // Nothing has changed, so neither generating nor writing is needed.
+  Run("protocol_compiler --cache_dir=$tmpdir/cache --cache_stats "
+      "--test_out=$tmpdir --proto_path=$tmpdir foo.proto");
+
+  ExpectNoErrors();
+  ExpectGenerated("test_generator", "", "foo.proto", "Foo");
+  ExpectCapturedStdout(
+      "Cache: 1 hits, 0 misses.  Files: 0 written, 1 unchanged.\n");
+
+  // A different parameter gives different output.
+  Run("protocol_compiler --cache_dir=$tmpdir/cache --cache_stats "
+      "--test_out=TestParameter:$tmpdir --proto_path=$tmpdir foo.proto");
+
+  ExpectNoErrors();
+  ExpectGenerated("test_generator", "TestParameter", "foo.proto", "Foo");
+  ExpectCapturedStdout(
+      "Cache: 0 hits, 1 misses.  Files: 1 written, 0 unchanged.\n");
+}
+
+TEST_F(CommandLineInterfaceTest, CacheDirImportChanged) {
+  // A file must be generated again if anything it imports changes, even just
+  // a comment, but not if another input does.
+
+  CreateTempFile("foo.proto",
+    "syntax = \"proto2\";\n"
+    "import \"bar.proto\";\n"
+    "message Foo { optional Bar bar = 1; }\n");
+  CreateTempFile("bar.proto",
+    "syntax = \"proto2\";\n"
+    "message Bar {}\n");
+  CreateTempFile("baz.proto",
+    "syntax = \"proto2\";\n"
+    "message Baz {}\n");
+  CreateTempDir("cache");
+
+  Run("protocol_compiler --cache_dir=$tmpdir/cache --cache_stats "
+      "--test_out=$tmpdir --proto_path=$tmpdir foo.proto baz.proto");
+
+  ExpectNoErrors();
+  ExpectCapturedStdout(
+      "Cache: 0 hits, 2 misses.  Files: 2 written, 0 unchanged.\n");
+
+  CreateTempFile("bar.proto",
+    "syntax = \"proto2\";\n"
+    "// A comment.\n"
+    "message Bar {}\n");
+
+  Run("protocol_compiler --cache_dir=$tmpdir/cache --cache_stats "
+      "--test_out=$tmpdir --proto_path=$tmpdir foo.proto baz.proto");
+
+  ExpectNoErrors();
+  ExpectGeneratedWithMultipleInputs("test_generator", "foo.proto,baz.proto",
+                                    "foo.proto", "Foo");
+  ExpectGeneratedWithMultipleInputs("test_generator", "foo.proto,baz.proto",
+                                    "baz.proto", "Baz");
+  // MockCodeGenerator's output doesn't depend on comments, so the file
+  // itself is the same.
+  ExpectCapturedStdout(
+      "Cache: 1 hits, 1 misses.  Files: 0 written, 2 unchanged.\n");
+}
+
+TEST_F(CommandLineInterfaceTest, CacheDirRewritesChangedOutput) {
+  // Output files are compared with what is on disk, not with the cache.
+
+  CreateTempFile("foo.proto",
+    "syntax = \"proto2\";\n"
+    "message Foo {}\n");
+  CreateTempDir("cache");
+
+  Run("protocol_compiler --cache_dir=$tmpdir/cache "
+      "--test_out=$tmpdir --proto_path=$tmpdir foo.proto");
+  ExpectNoErrors();
+
+  CreateTempFile("foo.proto.MockCodeGenerator.test_generator", "Edited.\n");
+
+  Run("protocol_compiler --cache_dir=$tmpdir/cache --cache_stats "
+      "--test_out=$tmpdir --proto_path=$tmpdir foo.proto");
+
+  ExpectNoErrors();
+  ExpectGenerated("test_generator", "", "foo.proto", "Foo");
+  ExpectCapturedStdout(
+      "Cache: 1 hits, 0 misses.  Files: 1 written, 0 unchanged.\n");
+}
+
+TEST_F(CommandLineInterfaceTest, CacheDirPlugin) {
+  // Plugins are always run, but unchanged output is still not rewritten.
+
+  CreateTempFile("foo.proto",
+    "syntax = \"proto2\";\n"
+    "message Foo {}\n");
+  CreateTempDir("cache");
+
+  Run("protocol_compiler --cache_dir=$tmpdir/cache "
+      "--plug_out=$tmpdir --proto_path=$tmpdir foo.proto");
+  ExpectNoErrors();
+
+  Run("protocol_compiler --cache_dir=$tmpdir/cache --cache_stats "
+      "--plug_out=$tmpdir --proto_path=$tmpdir foo.proto");
+
+  ExpectNoErrors();
+  ExpectGenerated("test_plugin", "", "foo.proto", "Foo");
+  ExpectCapturedStdout(
+      "Cache: 0 hits, 0 misses.  Files: 0 written, 1 unchanged.\n");
+}
+
+#endif  // !__CYGWIN__
+
+TEST_F(CommandLineInterfaceTest, CacheDirErrorNotCached) {
+  CreateTempFile("foo.proto",
+    "syntax = \"proto2\";\n"
+    "message MockCodeGenerator_Error {}\n");
+  CreateTempDir("cache");
+
+  Run("protocol_compiler --cache_dir=$tmpdir/cache "
+      "--test_out=$tmpdir --proto_path=$tmpdir foo.proto");
+  ExpectErrorText(
+      "--test_out: foo.proto: Saw message type MockCodeGenerator_Error.\n");
+
+  Run("protocol_compiler --cache_dir=$tmpdir/cache "
+      "--test_out=$tmpdir --proto_path=$tmpdir foo.proto");
+  ExpectErrorText(
+      "--test_out: foo.proto: Saw message type MockCodeGenerator_Error.\n");
+}
+
+TEST_F(CommandLineInterfaceTest, MissingCacheDir) {
+  CreateTempFile("foo.proto",
+    "syntax = \"proto2\";\n"
+    "message Foo {}\n");
+
+  Run("protocol_compiler --cache_dir=$tmpdir/nosuchdir "
+      "--test_out=$tmpdir --proto_path=$tmpdir foo.proto");
+
+  ExpectErrorSubstring("nosuchdir/: No such file or directory");
+}
+
 #if defined(_WIN32)
 
 TEST_F(CommandLineInterfaceTest, WindowsOutputPath) {
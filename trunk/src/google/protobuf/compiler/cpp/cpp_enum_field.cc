@@ -218,8 +218,14 @@ RepeatedEnumFieldGenerator::~RepeatedEnumFieldGenerator() {}
 
 void RepeatedEnumFieldGenerator::
 GeneratePrivateMembers(io::Printer* printer) const {
-  printer->Print(variables_,
-    "::google::protobuf::RepeatedField<int> $name$_;\n");
+  if (descriptor_->options().inline_capacity() > 0) {
+    printer->Print(variables_,
+      "::google::protobuf::InlinedRepeatedField<int, $inline_capacity$ > "
+      "$name$_;\n");
+  } else {
+    printer->Print(variables_,
+      "::google::protobuf::RepeatedField<int> $name$_;\n");
+  }
   if (descriptor_->options().packed()
       && HasGeneratedMethods(descriptor_->file())) {
     printer->Print(variables_,
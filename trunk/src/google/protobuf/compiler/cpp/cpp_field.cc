@@ -41,6 +41,7 @@
 #include <google/protobuf/compiler/cpp/cpp_enum_field.h>
 #include <google/protobuf/compiler/cpp/cpp_message_field.h>
 #include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/generated_message_reflection.h>
 #include <google/protobuf/wire_format.h>
 #include <google/protobuf/io/printer.h>
 #include <google/protobuf/stubs/common.h>
@@ -68,6 +69,8 @@ void SetCommonFieldVariables(const FieldDescriptor* descriptor,
       ? " PROTOBUF_DEPRECATED" : "";
 
   (*variables)["cppget"] = "Get";
+  (*variables)["inline_capacity"] =
+      SimpleItoa(descriptor->options().inline_capacity());
 }
 
 void SetCommonOneofFieldVariables(const FieldDescriptor* descriptor,
@@ -90,6 +93,21 @@ GenerateMergeFromCodedStreamWithPacking(io::Printer* printer) const {
 
 }
 
+void FieldGenerator::
+GenerateSerializeBackward(io::Printer* printer) const {
+  printer->Print(
+    "{\n"
+    "  int total_size = 0;\n");
+  printer->Indent();
+  GenerateByteSize(printer);
+  printer->Print(
+    "::google::protobuf::uint8* target = buffer->Prepend(total_size);\n");
+  GenerateSerializeWithCachedSizesToArray(printer);
+  printer->Outdent();
+  printer->Print(
+    "}\n");
+}
+
 FieldGeneratorMap::FieldGeneratorMap(const Descriptor* descriptor,
                                      const Options& options)
     : descriptor_(descriptor),
@@ -136,12 +154,17 @@ FieldGenerator* FieldGeneratorMap::MakeGenerator(const FieldDescriptor* field,
   } else {
     switch (field->cpp_type()) {
       case FieldDescriptor::CPPTYPE_MESSAGE:
+        if (internal::IsLazyField(field)) {
+          return new LazyMessageFieldGenerator(field, options);
+        }
         return new MessageFieldGenerator(field, options);
       case FieldDescriptor::CPPTYPE_STRING:
         switch (field->options().ctype()) {
           default:  // StringFieldGenerator handles unknown ctypes.
           case FieldOptions::STRING:
             return new StringFieldGenerator(field, options);
+          case FieldOptions::STRING_PIECE:
+            return new StringPieceFieldGenerator(field, options);
         }
       case FieldDescriptor::CPPTYPE_ENUM:
         return new EnumFieldGenerator(field, options);
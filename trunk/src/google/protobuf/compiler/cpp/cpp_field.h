@@ -154,6 +154,14 @@ class FieldGenerator {
   // are placed in the message's ByteSize() method.
   virtual void GenerateByteSize(io::Printer* printer) const = 0;
 
+  // Generate lines to write this field in front of the contents of the
+  // io::BackwardOutputBuffer "buffer", which are placed in the message's
+  // SerializeBackward() method.  The default implementation computes the
+  // field's size with the code from GenerateByteSize() and then writes it
+  // with the code from GenerateSerializeWithCachedSizesToArray(), which is
+  // only correct for fields which do not cache the sizes of sub-messages.
+  virtual void GenerateSerializeBackward(io::Printer* printer) const;
+
  private:
   GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(FieldGenerator);
 };
@@ -130,6 +130,10 @@ void FileGenerator::GenerateHeader(io::Printer* printer) {
     "protoc_version", SimpleItoa(GOOGLE_PROTOBUF_VERSION));
 
   // OK, it's now safe to #include other files.
+  if (SupportsArenas(file_)) {
+    printer->Print(
+      "#include <google/protobuf/arena.h>\n");
+  }
   printer->Print(
     "#include <google/protobuf/generated_message_util.h>\n");
   if (file_->message_type_count() > 0) {
@@ -145,6 +149,16 @@ void FileGenerator::GenerateHeader(io::Printer* printer) {
     "#include <google/protobuf/repeated_field.h>\n"
     "#include <google/protobuf/extension_set.h>\n");
 
+  if (HasStringPieceFields(file_)) {
+    printer->Print(
+      "#include <google/protobuf/string_piece_field.h>\n");
+  }
+
+  if (HasLazyFields(file_)) {
+    printer->Print(
+      "#include <google/protobuf/lazy_field.h>\n");
+  }
+
   if (HasDescriptorMethods(file_) && HasEnumDefinitions(file_)) {
     printer->Print(
       "#include <google/protobuf/generated_enum_reflection.h>\n");
@@ -197,10 +211,15 @@ void FileGenerator::GenerateHeader(io::Printer* printer) {
     // Note that we don't put dllexport_decl on these because they are only
     // called by the .pb.cc file in which they are defined.
     "void $assigndescriptorsname$();\n"
-    "void $shutdownfilename$();\n"
-    "\n",
+    "void $shutdownfilename$();\n",
     "assigndescriptorsname", GlobalAssignDescriptorsName(file_->name()),
     "shutdownfilename", GlobalShutdownFileName(file_->name()));
+  if (LazyDefaultInstances(file_, options_)) {
+    printer->Print(
+      "void $initdefaultsname$_impl();\n",
+      "initdefaultsname", GlobalInitDefaultsName(file_->name()));
+  }
+  printer->Print("\n");
 
   // Generate forward declarations of classes.
   for (int i = 0; i < file_->message_type_count(); i++) {
@@ -343,6 +362,11 @@ void FileGenerator::GenerateSource(io::Printer* printer) {
       "#include <google/protobuf/wire_format.h>\n");
   }
 
+  if (UseTableDrivenParsing()) {
+    printer->Print(
+      "#include <google/protobuf/generated_message_table_driven.h>\n");
+  }
+
   printer->Print(
     "// @@protoc_insertion_point(includes)\n");
 
@@ -376,6 +400,22 @@ void FileGenerator::GenerateSource(io::Printer* printer) {
       "\n");
   }
 
+  // Declare the tables read by the table-driven parser.  They are filled in
+  // along with the default instances.
+  if (UseTableDrivenParsing()) {
+    printer->Print(
+      "\n"
+      "namespace {\n"
+      "\n");
+    for (int i = 0; i < file_->message_type_count(); i++) {
+      message_generators_[i]->GenerateParseTable(printer);
+    }
+    printer->Print(
+      "\n"
+      "}  // namespace\n"
+      "\n");
+  }
+
   // Define our externally-visible BuildDescriptors() function.  (For the lite
   // library, all this does is initialize default instances.)
   GenerateBuildDescriptors(printer);
@@ -435,6 +475,40 @@ void FileGenerator::GenerateBuildDescriptors(io::Printer* printer) {
   // anyone calls descriptor() or GetReflection() on one of the types defined
   // in the file.
 
+  // With the lazy_default_instances option, default instances are instead
+  // built by InitDefaults() the first time default_instance() is called or
+  // the descriptors are assigned.  AddDescriptors() then keeps only what has
+  // to exist before any message is constructed:  the encoded descriptor and
+  // the default values of string fields.  InitDefaults() calls it first in
+  // case it runs during static initialization, before those exist.  (Files
+  // declaring extensions don't get this mode, see LazyDefaultInstances().)
+  const bool lazy_default_instances = LazyDefaultInstances(file_, options_);
+  if (lazy_default_instances) {
+    printer->Print(
+      "\n"
+      "void $initdefaultsname$_impl() {\n"
+      "  $adddescriptorsname$();\n",
+      "initdefaultsname", GlobalInitDefaultsName(file_->name()),
+      "adddescriptorsname", GlobalAddDescriptorsName(file_->name()));
+    printer->Indent();
+    for (int i = 0; i < file_->message_type_count(); i++) {
+      message_generators_[i]->GenerateDefaultInstanceAllocator(printer);
+    }
+    for (int i = 0; i < file_->message_type_count(); i++) {
+      message_generators_[i]->GenerateDefaultInstanceInitializer(printer);
+    }
+    printer->Outdent();
+    printer->Print(
+      "}\n"
+      "\n"
+      "GOOGLE_PROTOBUF_DECLARE_ONCE($initdefaultsname$_once_);\n"
+      "void $initdefaultsname$() {\n"
+      "  ::google::protobuf::GoogleOnceInit(&$initdefaultsname$_once_,\n"
+      "                 &$initdefaultsname$_impl);\n"
+      "}\n",
+      "initdefaultsname", GlobalInitDefaultsName(file_->name()));
+  }
+
   // In optimize_for = LITE_RUNTIME mode, we don't generate AssignDescriptors()
   // and we only use AddDescriptors() to allocate default instances.
   if (HasDescriptorMethods(file_)) {
@@ -451,6 +525,12 @@ void FileGenerator::GenerateBuildDescriptors(io::Printer* printer) {
     printer->Print(
       "$adddescriptorsname$();\n",
       "adddescriptorsname", GlobalAddDescriptorsName(file_->name()));
+    // The reflection objects point at the default instances.
+    if (lazy_default_instances) {
+      printer->Print(
+        "$initdefaultsname$();\n",
+        "initdefaultsname", GlobalInitDefaultsName(file_->name()));
+    }
 
     // Get the file's descriptor from the pool.
     printer->Print(
@@ -599,17 +679,24 @@ void FileGenerator::GenerateBuildDescriptors(io::Printer* printer) {
       "filename", file_->name());
   }
 
-  // Allocate and initialize default instances.  This can't be done lazily
-  // since default instances are returned by simple accessors and are used with
-  // extensions.  Speaking of which, we also register extensions at this time.
-  for (int i = 0; i < file_->message_type_count(); i++) {
-    message_generators_[i]->GenerateDefaultInstanceAllocator(printer);
-  }
-  for (int i = 0; i < file_->extension_count(); i++) {
-    extension_generators_[i]->GenerateRegistration(printer);
-  }
-  for (int i = 0; i < file_->message_type_count(); i++) {
-    message_generators_[i]->GenerateDefaultInstanceInitializer(printer);
+  if (lazy_default_instances) {
+    for (int i = 0; i < file_->message_type_count(); i++) {
+      message_generators_[i]->GenerateFieldDefaultAllocators(printer);
+    }
+  } else {
+    // Allocate and initialize default instances.  This can't be done lazily
+    // since default instances are returned by simple accessors and are used
+    // with extensions.  Speaking of which, we also register extensions at
+    // this time.
+    for (int i = 0; i < file_->message_type_count(); i++) {
+      message_generators_[i]->GenerateDefaultInstanceAllocator(printer);
+    }
+    for (int i = 0; i < file_->extension_count(); i++) {
+      extension_generators_[i]->GenerateRegistration(printer);
+    }
+    for (int i = 0; i < file_->message_type_count(); i++) {
+      message_generators_[i]->GenerateDefaultInstanceInitializer(printer);
+    }
   }
 
   printer->Print(
@@ -641,6 +728,11 @@ void FileGenerator::GenerateBuildDescriptors(io::Printer* printer) {
     "filename", FilenameIdentifier(file_->name()));
 }
 
+bool FileGenerator::UseTableDrivenParsing() const {
+  return options_.table_driven_parsing && HasGeneratedMethods(file_) &&
+         file_->message_type_count() > 0;
+}
+
 void FileGenerator::GenerateNamespaceOpeners(io::Printer* printer) {
   if (package_parts_.size() > 0) printer->Print("\n");
 
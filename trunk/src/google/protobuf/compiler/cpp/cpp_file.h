@@ -77,6 +77,9 @@ class FileGenerator {
   void GenerateNamespaceOpeners(io::Printer* printer);
   void GenerateNamespaceClosers(io::Printer* printer);
 
+  // Are messages in this file parsed by the table-driven parser?
+  bool UseTableDrivenParsing() const;
+
   const FileDescriptor* file_;
 
   scoped_array<scoped_ptr<MessageGenerator> > message_generators_;
@@ -86,6 +86,12 @@ bool CppGenerator::Generate(const FileDescriptor* file,
       file_options.dllexport_decl = options[i].second;
     } else if (options[i].first == "safe_boundary_check") {
       file_options.safe_boundary_check = true;
+    } else if (options[i].first == "table_driven_parsing") {
+      file_options.table_driven_parsing = true;
+    } else if (options[i].first == "unknown_fields_as_bytes") {
+      file_options.unknown_fields_as_bytes = true;
+    } else if (options[i].first == "lazy_default_instances") {
+      file_options.lazy_default_instances = true;
     } else {
       *error = "Unknown generator option: " + options[i].first;
       return false;
@@ -38,6 +38,7 @@
 #include <google/protobuf/stubs/hash.h>
 
 #include <google/protobuf/compiler/cpp/cpp_helpers.h>
+#include <google/protobuf/generated_message_reflection.h>
 #include <google/protobuf/io/printer.h>
 #include <google/protobuf/stubs/common.h>
 #include <google/protobuf/stubs/strutil.h>
@@ -374,6 +375,11 @@ string GlobalShutdownFileName(const string& filename) {
   return "protobuf_ShutdownFile_" + FilenameIdentifier(filename);
 }
 
+// Return the name of the InitDefaults() function for a given file.
+string GlobalInitDefaultsName(const string& filename) {
+  return "protobuf_InitDefaults_" + FilenameIdentifier(filename);
+}
+
 // Return the qualified C++ name for a file level symbol.
 string QualifiedFileLevelSymbol(const string& package, const string& name) {
   if (package.empty()) {
@@ -451,6 +457,31 @@ void PrintHandlingOptionalStaticInitializers(
   }
 }
 
+bool LazyDefaultInstances(const FileDescriptor* file, const Options& options) {
+  if (!options.lazy_default_instances || !HasDescriptorMethods(file) ||
+      file->extension_count() > 0) {
+    return false;
+  }
+  for (int i = 0; i < file->message_type_count(); ++i) {
+    if (HasExtension(file->message_type(i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void PrintHandlingLazyDefaultInstances(
+    const map<string, string>& vars, const FileDescriptor* file,
+    const Options& options, io::Printer* printer,
+    const char* with_static_init, const char* without_static_init) {
+  if (LazyDefaultInstances(file, options)) {
+    printer->Print(vars, without_static_init);
+  } else {
+    PrintHandlingOptionalStaticInitializers(
+        vars, file, printer, with_static_init, without_static_init);
+  }
+}
+
 
 static bool HasEnumDefinitions(const Descriptor* message_type) {
   if (message_type->enum_type_count() > 0) return true;
@@ -468,6 +499,35 @@ bool HasEnumDefinitions(const FileDescriptor* file) {
   return false;
 }
 
+static bool HasFieldsMatching(const Descriptor* message_type,
+                              bool (*predicate)(const FieldDescriptor*)) {
+  for (int i = 0; i < message_type->field_count(); ++i) {
+    if (predicate(message_type->field(i))) return true;
+  }
+  for (int i = 0; i < message_type->nested_type_count(); ++i) {
+    if (HasFieldsMatching(message_type->nested_type(i), predicate)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool HasFieldsMatching(const FileDescriptor* file,
+                              bool (*predicate)(const FieldDescriptor*)) {
+  for (int i = 0; i < file->message_type_count(); ++i) {
+    if (HasFieldsMatching(file->message_type(i), predicate)) return true;
+  }
+  return false;
+}
+
+bool HasStringPieceFields(const FileDescriptor* file) {
+  return HasFieldsMatching(file, &internal::IsStringPieceField);
+}
+
+bool HasLazyFields(const FileDescriptor* file) {
+  return HasFieldsMatching(file, &internal::IsLazyField);
+}
+
 bool IsStringOrMessage(const FieldDescriptor* field) {
   switch (field->cpp_type()) {
     case FieldDescriptor::CPPTYPE_INT32:
@@ -39,6 +39,7 @@
 #include <string>
 #include <google/protobuf/descriptor.h>
 #include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/compiler/cpp/cpp_options.h>
 
 namespace google {
 namespace protobuf {
@@ -121,6 +122,10 @@ string GlobalAddDescriptorsName(const string& filename);
 // Return the name of the AssignDescriptors() function for a given file.
 string GlobalAssignDescriptorsName(const string& filename);
 
+// Return the name of the InitDefaults() function for a given file.  It is
+// only generated with the lazy_default_instances option.
+string GlobalInitDefaultsName(const string& filename);
+
 // Return the qualified C++ name for a file level symbol.
 string QualifiedFileLevelSymbol(const string& package, const string& name);
 
@@ -145,6 +150,12 @@ inline bool UseUnknownFieldSet(const FileDescriptor* file) {
 // Does this file have any enum type definitions?
 bool HasEnumDefinitions(const FileDescriptor* file);
 
+// Does this file have any fields stored as an internal::StringPieceField?
+bool HasStringPieceFields(const FileDescriptor* file);
+
+// Does this file have any fields stored as an internal::LazyField?
+bool HasLazyFields(const FileDescriptor* file);
+
 // Does this file have generated parsing, serialization, and other
 // standard methods for which reflection-based fallback implementations exist?
 inline bool HasGeneratedMethods(const FileDescriptor* file) {
@@ -175,6 +186,12 @@ inline bool HasFastArraySerialization(const FileDescriptor* file) {
   return file->options().optimize_for() == FileOptions::SPEED;
 }
 
+// Can message classes in this file be constructed on an Arena?  If so, their
+// sub-objects are allocated on the arena the message lives on.
+inline bool SupportsArenas(const FileDescriptor* file) {
+  return file->options().cc_enable_arenas();
+}
+
 // Returns whether we have to generate code with static initializers.
 bool StaticInitializersForced(const FileDescriptor* file);
 
@@ -192,6 +209,20 @@ void PrintHandlingOptionalStaticInitializers(
     io::Printer* printer, const char* with_static_init,
     const char* without_static_init);
 
+// Are the default instances of this file's messages built on first use?
+// Lite files already are when GOOGLE_PROTOBUF_NO_STATIC_INITIALIZER is set.
+// Files declaring extensions are not, since registering an extension at
+// static initialization time needs the default instance of its extendee.
+bool LazyDefaultInstances(const FileDescriptor* file, const Options& options);
+
+// Like PrintHandlingOptionalStaticInitializers(), but prints only
+// 'without_static_init' if the file's default instances are built on first
+// use, since code then has to reach them through default_instance().
+void PrintHandlingLazyDefaultInstances(
+    const map<string, string>& vars, const FileDescriptor* file,
+    const Options& options, io::Printer* printer,
+    const char* with_static_init, const char* without_static_init);
+
 
 // Returns true if the field's CPPTYPE is string or message.
 bool IsStringOrMessage(const FieldDescriptor* field);
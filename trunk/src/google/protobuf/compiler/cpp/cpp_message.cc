@@ -47,6 +47,8 @@
 #include <google/protobuf/stubs/strutil.h>
 #include <google/protobuf/io/printer.h>
 #include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/generated_message_reflection.h>
+#include <google/protobuf/generated_message_table_driven.h>
 #include <google/protobuf/wire_format.h>
 #include <google/protobuf/descriptor.pb.h>
 
@@ -553,6 +555,20 @@ GenerateClassDefinition(io::Printer* printer) {
     "}\n"
     "\n");
 
+  if (SupportsArenas(descriptor_->file())) {
+    printer->Print(vars,
+      "// Constructs the message on the given arena.  Use\n"
+      "// ::google::protobuf::Arena::CreateMessage<$classname$>(arena) rather than\n"
+      "// calling this directly.\n"
+      "explicit $classname$(::google::protobuf::Arena* arena);\n"
+      "typedef void InternalArenaConstructable_;\n"
+      "\n"
+      "inline ::google::protobuf::Arena* GetArena() const {\n"
+      "  return GetArenaNoVirtual();\n"
+      "}\n"
+      "\n");
+  }
+
   if (UseUnknownFieldSet(descriptor_->file())) {
     printer->Print(
       "inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {\n"
@@ -613,7 +629,17 @@ GenerateClassDefinition(io::Printer* printer) {
         "\n");
   }
 
-  if (!StaticInitializersForced(descriptor_->file())) {
+  if (LazyDefaultInstances(descriptor_->file(), options_)) {
+    printer->Print(vars,
+      "// Returns the internal default instance pointer. This function can\n"
+      "// return NULL thus should not be used by the user. This is intended\n"
+      "// for Protobuf internal code. Please use default_instance() declared\n"
+      "// above instead.\n"
+      "static inline const $classname$* internal_default_instance() {\n"
+      "  return default_instance_;\n"
+      "}\n"
+      "\n");
+  } else if (!StaticInitializersForced(descriptor_->file())) {
     printer->Print(vars,
       "#ifdef GOOGLE_PROTOBUF_NO_STATIC_INITIALIZER\n"
       "// Returns the internal default instance pointer. This function can\n"
@@ -633,7 +659,8 @@ GenerateClassDefinition(io::Printer* printer) {
     "\n"
     "// implements Message ----------------------------------------------\n"
     "\n"
-    "$classname$* New() const;\n");
+    "$classname$* New() const;\n"
+    "$classname$* New(::google::protobuf::Arena* arena) const;\n");
 
   if (HasGeneratedMethods(descriptor_->file())) {
     if (HasDescriptorMethods(descriptor_->file())) {
@@ -665,6 +692,11 @@ GenerateClassDefinition(io::Printer* printer) {
     if (HasFastArraySerialization(descriptor_->file())) {
       printer->Print(
         "::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;\n");
+      if (!descriptor_->options().message_set_wire_format()) {
+        printer->Print(
+          "void SerializeBackward(\n"
+          "    ::google::protobuf::io::BackwardOutputBuffer* buffer) const;\n");
+      }
     }
   }
 
@@ -698,7 +730,14 @@ GenerateClassDefinition(io::Printer* printer) {
     "private:\n"
     "void SharedCtor();\n"
     "void SharedDtor();\n"
-    "void SetCachedSize(int size) const;\n"
+    "void SetCachedSize(int size) const;\n");
+  if (SupportsArenas(descriptor_->file())) {
+    printer->Print(
+      "inline ::google::protobuf::Arena* GetArenaNoVirtual() const {\n"
+      "  return _arena_ptr_;\n"
+      "}\n");
+  }
+  printer->Print(
     "public:\n");
 
   if (HasDescriptorMethods(descriptor_->file())) {
@@ -808,6 +847,12 @@ GenerateClassDefinition(io::Printer* printer) {
 
   // Members assumed to align to 8 bytes:
 
+  if (SupportsArenas(descriptor_->file())) {
+    printer->Print(
+      "::google::protobuf::Arena* _arena_ptr_;\n"
+      "\n");
+  }
+
   if (descriptor_->extension_range_count() > 0) {
     printer->Print(
       "::google::protobuf::internal::ExtensionSet _extensions_;\n"
@@ -919,11 +964,17 @@ GenerateClassDefinition(io::Printer* printer) {
 
   printer->Print(
     "friend void $assigndescriptorsname$();\n"
-    "friend void $shutdownfilename$();\n"
-    "\n",
+    "friend void $shutdownfilename$();\n",
     "assigndescriptorsname",
       GlobalAssignDescriptorsName(descriptor_->file()->name()),
     "shutdownfilename", GlobalShutdownFileName(descriptor_->file()->name()));
+  if (LazyDefaultInstances(descriptor_->file(), options_)) {
+    printer->Print(
+      "friend void $initdefaultsname$_impl();\n",
+      "initdefaultsname",
+      GlobalInitDefaultsName(descriptor_->file()->name()));
+  }
+  printer->Print("\n");
 
   printer->Print(
     "void InitAsDefaultInstance();\n"
@@ -1001,6 +1052,83 @@ GenerateDescriptorDeclarations(io::Printer* printer) {
   }
 }
 
+bool MessageGenerator::UseTableDrivenParsing() const {
+  return options_.table_driven_parsing &&
+         HasGeneratedMethods(descriptor_->file()) &&
+         !descriptor_->options().message_set_wire_format();
+}
+
+void MessageGenerator::
+GenerateParseTable(io::Printer* printer) {
+  for (int i = 0; i < descriptor_->nested_type_count(); i++) {
+    nested_generators_[i]->GenerateParseTable(printer);
+  }
+  if (!UseTableDrivenParsing()) return;
+
+  // Everything that is known at compile time is written out here; offsets
+  // and pointers to default instances are filled in by
+  // GenerateParseTableInitializer().
+  scoped_array<const FieldDescriptor*> ordered_fields(
+    SortFieldsByNumber(descriptor_));
+
+  if (descriptor_->field_count() > 0) {
+    printer->Print(
+      "::google::protobuf::internal::ParseTableField $classname$_parse_table_fields_[] = {\n",
+      "classname", classname_);
+    printer->Indent();
+    for (int i = 0; i < descriptor_->field_count(); i++) {
+      const FieldDescriptor* field = ordered_fields[i];
+
+      map<string, string> vars;
+      vars["number"] = SimpleItoa(field->number());
+      vars["type"] = ToUpper(field->type_name());
+
+      int flags = 0;
+      int presence_index = field->index();
+      if (field->is_repeated()) {
+        flags |= internal::ParseTableField::kRepeated;
+        presence_index = 0;
+      } else if (field->containing_oneof() != NULL) {
+        flags |= internal::ParseTableField::kOneof;
+        presence_index = field->containing_oneof()->index();
+      }
+      vars["name"] = "NULL";
+      if (field->type() == FieldDescriptor::TYPE_STRING &&
+          HasUtf8Verification(descriptor_->file())) {
+        flags |= internal::ParseTableField::kVerifyUtf8;
+        vars["name"] = "\"" + CEscape(field->name()) + "\"";
+      }
+      if (internal::IsStringPieceField(field)) {
+        flags |= internal::ParseTableField::kStringPiece;
+      }
+      if (internal::IsLazyField(field)) {
+        flags |= internal::ParseTableField::kLazy;
+      }
+      vars["flags"] = SimpleItoa(flags);
+      vars["presence_index"] = SimpleItoa(presence_index);
+      vars["is_valid"] = field->type() == FieldDescriptor::TYPE_ENUM ?
+          "&" + ClassName(field->enum_type(), true) + "_IsValid" : "NULL";
+
+      printer->Print(vars,
+        "{ $number$, ::google::protobuf::internal::WireFormatLite::TYPE_$type$, "
+        "$flags$, $presence_index$, 0, $is_valid$, NULL, $name$ },\n");
+    }
+    printer->Outdent();
+    printer->Print("};\n");
+  }
+
+  map<string, string> vars;
+  vars["classname"] = classname_;
+  vars["fields"] = descriptor_->field_count() > 0 ?
+      classname_ + "_parse_table_fields_" : "NULL";
+  vars["field_count"] = SimpleItoa(descriptor_->field_count());
+  vars["as_bytes"] = options_.unknown_fields_as_bytes ? "true" : "false";
+  printer->Print(vars,
+    "::google::protobuf::internal::ParseTable $classname$_parse_table_ = {\n"
+    "  $fields$, $field_count$, -1, -1, -1, -1, NULL, $as_bytes$\n"
+    "};\n");
+}
+
 void MessageGenerator::
 GenerateDescriptorInitializer(io::Printer* printer, int index) {
   // TODO(kenton):  Passing the index to this method is redundant; just use
@@ -1084,10 +1212,13 @@ GenerateTypeRegistrations(io::Printer* printer) {
 void MessageGenerator::
 GenerateDefaultInstanceAllocator(io::Printer* printer) {
   // Construct the default instances of all fields, as they will be used
-  // when creating the default instance of the entire message.
-  for (int i = 0; i < descriptor_->field_count(); i++) {
-    field_generators_.get(descriptor_->field(i))
-                     .GenerateDefaultInstanceAllocator(printer);
+  // when creating the default instance of the entire message.  With lazy
+  // default instances AddDescriptors() does so instead.
+  if (!LazyDefaultInstances(descriptor_->file(), options_)) {
+    for (int i = 0; i < descriptor_->field_count(); i++) {
+      field_generators_.get(descriptor_->field(i))
+                       .GenerateDefaultInstanceAllocator(printer);
+    }
   }
 
   // Construct the default instance.  We can't call InitAsDefaultInstance() yet
@@ -1116,6 +1247,9 @@ GenerateDefaultInstanceInitializer(io::Printer* printer) {
   printer->Print(
     "$classname$::default_instance_->InitAsDefaultInstance();\n",
     "classname", classname_);
+  if (UseTableDrivenParsing()) {
+    GenerateParseTableInitializer(printer);
+  }
 
   // Register extensions.
   for (int i = 0; i < descriptor_->extension_count(); i++) {
@@ -1128,6 +1262,83 @@ GenerateDefaultInstanceInitializer(io::Printer* printer) {
   }
 }
 
+void MessageGenerator::
+GenerateFieldDefaultAllocators(io::Printer* printer) {
+  for (int i = 0; i < descriptor_->field_count(); i++) {
+    field_generators_.get(descriptor_->field(i))
+                     .GenerateDefaultInstanceAllocator(printer);
+  }
+
+  // Handle nested types.
+  for (int i = 0; i < descriptor_->nested_type_count(); i++) {
+    nested_generators_[i]->GenerateFieldDefaultAllocators(printer);
+  }
+}
+
+string MessageGenerator::
+InternalDefaultInstance(const FieldDescriptor* field) {
+  // Default instances of this file are all allocated before any is
+  // initialized, but those of other files may not have been built yet.
+  string type = FieldMessageTypeName(field);
+  if (LazyDefaultInstances(descriptor_->file(), options_) &&
+      field->message_type()->file() != descriptor_->file()) {
+    return "&" + type + "::default_instance()";
+  }
+  return type + "::internal_default_instance()";
+}
+
+void MessageGenerator::
+GenerateParseTableInitializer(io::Printer* printer) {
+  map<string, string> vars;
+  vars["classname"] = classname_;
+  vars["table"] = classname_ + "_parse_table_";
+  printer->Print(vars,
+    "$table$.has_bits_offset =\n"
+    "  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET($classname$, _has_bits_[0]);\n"
+    "$table$.unknown_fields_offset =\n"
+    "  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET($classname$, _unknown_fields_);\n");
+  if (descriptor_->oneof_decl_count() > 0) {
+    printer->Print(vars,
+      "$table$.oneof_case_offset =\n"
+      "  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET($classname$, _oneof_case_[0]);\n");
+  }
+  if (descriptor_->extension_range_count() > 0) {
+    printer->Print(vars,
+      "$table$.extensions_offset =\n"
+      "  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET($classname$, _extensions_);\n");
+  }
+  printer->Print(vars,
+    "$table$.default_instance = $classname$::default_instance_;\n");
+
+  scoped_array<const FieldDescriptor*> ordered_fields(
+    SortFieldsByNumber(descriptor_));
+  string with_static_init;
+  string without_static_init;
+  for (int i = 0; i < descriptor_->field_count(); i++) {
+    const FieldDescriptor* field = ordered_fields[i];
+    vars["index"] = SimpleItoa(i);
+    vars["member"] = field->containing_oneof() != NULL ?
+        field->containing_oneof()->name() + "_" : FieldName(field) + "_";
+    printer->Print(vars,
+      "$classname$_parse_table_fields_[$index$].offset =\n"
+      "  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET($classname$, $member$);\n");
+
+    if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+      // Prototypes are looked up the same way InitAsDefaultInstance() does.
+      string prefix = classname_ + "_parse_table_fields_[" +
+                      SimpleItoa(i) + "].prototype =\n  ";
+      string type = FieldMessageTypeName(field);
+      with_static_init += prefix + "&" + type + "::default_instance();\n";
+      without_static_init += prefix + InternalDefaultInstance(field) + ";\n";
+    }
+  }
+  if (!with_static_init.empty()) {
+    PrintHandlingLazyDefaultInstances(
+      map<string, string>(), descriptor_->file(), options_, printer,
+      with_static_init.c_str(), without_static_init.c_str());
+  }
+}
+
 void MessageGenerator::
 GenerateShutdownCode(io::Printer* printer) {
   printer->Print(
@@ -1215,6 +1426,11 @@ GenerateClassMethods(io::Printer* printer) {
     if (HasFastArraySerialization(descriptor_->file())) {
       GenerateSerializeWithCachedSizesToArray(printer);
       printer->Print("\n");
+
+      if (!descriptor_->options().message_set_wire_format()) {
+        GenerateSerializeBackward(printer);
+        printer->Print("\n");
+      }
     }
 
     GenerateByteSize(printer);
@@ -1331,6 +1547,15 @@ GenerateSharedDestructorCode(io::Printer* printer) {
     "void $classname$::SharedDtor() {\n",
     "classname", classname_);
   printer->Indent();
+  if (SupportsArenas(descriptor_->file())) {
+    // Strings and sub-messages were allocated on the arena and are destroyed
+    // along with it.
+    printer->Print(
+      "if (GetArenaNoVirtual() != NULL) {\n"
+      "  return;\n"
+      "}\n"
+      "\n");
+  }
   // Write the destructors for each field except oneof members.
   for (int i = 0; i < descriptor_->field_count(); i++) {
     if (!descriptor_->field(i)->containing_oneof()) {
@@ -1365,7 +1590,11 @@ GenerateSharedDestructorCode(io::Printer* printer) {
     if (!field->is_repeated() &&
         field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
       // Skip oneof members
-      if (!field->containing_oneof()) {
+      if (internal::IsLazyField(field)) {
+        printer->Print(
+            "  $name$_.Destroy();\n",
+            "name", FieldName(field));
+      } else if (!field->containing_oneof()) {
         printer->Print(
             "  delete $name$_;\n",
             "name", FieldName(field));
@@ -1380,20 +1609,65 @@ GenerateSharedDestructorCode(io::Printer* printer) {
     "\n");
 }
 
+void MessageGenerator::
+GenerateArenaConstructor(io::Printer* printer) {
+  printer->Print(
+    "\n"
+    "$classname$::$classname$(::google::protobuf::Arena* arena)\n"
+    "  : $superclass$(),\n"
+    "    _arena_ptr_(arena)",
+    "classname", classname_,
+    "superclass", SuperClassName(descriptor_));
+
+  // Repeated string and message fields allocate their elements on the arena
+  // too.  List them in declaration order, i.e. after OptimizePadding().
+  vector<const FieldDescriptor*> fields;
+  for (int i = 0; i < descriptor_->field_count(); i++) {
+    if (!descriptor_->field(i)->containing_oneof()) {
+      fields.push_back(descriptor_->field(i));
+    }
+  }
+  OptimizePadding(&fields);
+  for (int i = 0; i < fields.size(); i++) {
+    if (fields[i]->is_repeated() && IsStringOrMessage(fields[i])) {
+      printer->Print(
+        ",\n"
+        "    $name$_(arena)",
+        "name", FieldName(fields[i]));
+    }
+  }
+
+  printer->Print(
+    " {\n"
+    "  SharedCtor();\n"
+    "  // @@protoc_insertion_point(arena_constructor:$full_name$)\n"
+    "}\n",
+    "full_name", descriptor_->full_name());
+}
+
 void MessageGenerator::
 GenerateStructors(io::Printer* printer) {
   string superclass = SuperClassName(descriptor_);
+  // Messages with arena support must initialize _arena_ptr_ in every
+  // constructor.
+  map<string, string> vars;
+  vars["classname"] = classname_;
+  vars["superclass"] = superclass;
+  vars["full_name"] = descriptor_->full_name();
+  vars["arena_initializer"] =
+      SupportsArenas(descriptor_->file()) ? ", _arena_ptr_(NULL)" : "";
 
   // Generate the default constructor.
-  printer->Print(
+  printer->Print(vars,
     "$classname$::$classname$()\n"
-    "  : $superclass$() {\n"
+    "  : $superclass$()$arena_initializer$ {\n"
     "  SharedCtor();\n"
     "  // @@protoc_insertion_point(constructor:$full_name$)\n"
-    "}\n",
-    "classname", classname_,
-    "superclass", superclass,
-    "full_name", descriptor_->full_name());
+    "}\n");
+
+  if (SupportsArenas(descriptor_->file())) {
+    GenerateArenaConstructor(printer);
+  }
 
   printer->Print(
     "\n"
@@ -1418,16 +1692,26 @@ GenerateStructors(io::Printer* printer) {
         name = classname_ + "_default_oneof_instance_->";
       }
       name += FieldName(field);
-      PrintHandlingOptionalStaticInitializers(
-        descriptor_->file(), printer,
+      map<string, string> field_vars;
+      field_vars["name"] = name;
+      field_vars["type"] = FieldMessageTypeName(field);
+      field_vars["default_instance"] = InternalDefaultInstance(field);
+      if (internal::IsLazyField(field)) {
+        PrintHandlingLazyDefaultInstances(
+          field_vars, descriptor_->file(), options_, printer,
+          // With static initializers.
+          "  $name$_.InitAsDefault(&$type$::default_instance());\n",
+          // Without.
+          "  $name$_.InitAsDefault($default_instance$);\n");
+        continue;
+      }
+      PrintHandlingLazyDefaultInstances(
+        field_vars, descriptor_->file(), options_, printer,
         // With static initializers.
         "  $name$_ = const_cast< $type$*>(&$type$::default_instance());\n",
         // Without.
         "  $name$_ = const_cast< $type$*>(\n"
-        "      $type$::internal_default_instance());\n",
-        // Vars.
-        "name", name,
-        "type", FieldMessageTypeName(field));
+        "      $default_instance$);\n");
     } else if (field->containing_oneof() &&
                HasDescriptorMethods(descriptor_->file())) {
       field_generators_.get(descriptor_->field(i))
@@ -1439,17 +1723,14 @@ GenerateStructors(io::Printer* printer) {
     "\n");
 
   // Generate the copy constructor.
-  printer->Print(
+  printer->Print(vars,
     "$classname$::$classname$(const $classname$& from)\n"
-    "  : $superclass$() {\n"
+    "  : $superclass$()$arena_initializer$ {\n"
     "  SharedCtor();\n"
     "  MergeFrom(from);\n"
     "  // @@protoc_insertion_point(copy_constructor:$full_name$)\n"
     "}\n"
-    "\n",
-    "classname", classname_,
-    "superclass", superclass,
-    "full_name", descriptor_->full_name());
+    "\n");
 
   // Generate the shared constructor code.
   GenerateSharedConstructorCode(printer);
@@ -1494,15 +1775,24 @@ GenerateStructors(io::Printer* printer) {
     "const $classname$& $classname$::default_instance() {\n",
     "classname", classname_);
 
-  PrintHandlingOptionalStaticInitializers(
-    descriptor_->file(), printer,
-    // With static initializers.
-    "  if (default_instance_ == NULL) $adddescriptorsname$();\n",
-    // Without.
-    "  $adddescriptorsname$();\n",
-    // Vars.
-    "adddescriptorsname",
-    GlobalAddDescriptorsName(descriptor_->file()->name()));
+  if (LazyDefaultInstances(descriptor_->file(), options_)) {
+    // default_instance_ is set before the instance is initialized, so only
+    // the once can tell whether it is ready.
+    printer->Print(
+      "  $initdefaultsname$();\n",
+      "initdefaultsname",
+      GlobalInitDefaultsName(descriptor_->file()->name()));
+  } else {
+    PrintHandlingOptionalStaticInitializers(
+      descriptor_->file(), printer,
+      // With static initializers.
+      "  if (default_instance_ == NULL) $adddescriptorsname$();\n",
+      // Without.
+      "  $adddescriptorsname$();\n",
+      // Vars.
+      "adddescriptorsname",
+      GlobalAddDescriptorsName(descriptor_->file()->name()));
+  }
 
   printer->Print(
     "  return *default_instance_;\n"
@@ -1518,6 +1808,26 @@ GenerateStructors(io::Printer* printer) {
     "}\n",
     "classname", classname_);
 
+  if (SupportsArenas(descriptor_->file())) {
+    printer->Print(
+      "\n"
+      "$classname$* $classname$::New(::google::protobuf::Arena* arena) const {\n"
+      "  return ::google::protobuf::Arena::CreateMessage<$classname$>(arena);\n"
+      "}\n",
+      "classname", classname_);
+  } else {
+    printer->Print(
+      "\n"
+      "$classname$* $classname$::New(::google::protobuf::Arena* arena) const {\n"
+      "  $classname$* n = new $classname$;\n"
+      "  if (arena != NULL) {\n"
+      "    arena->Own(n);\n"
+      "  }\n"
+      "  return n;\n"
+      "}\n",
+      "classname", classname_);
+  }
+
 }
 
 // Return the number of bits set in n, a non-negative integer.
@@ -1756,6 +2066,19 @@ GenerateSwap(io::Printer* printer) {
   printer->Indent();
 
   if (HasGeneratedMethods(descriptor_->file())) {
+    if (SupportsArenas(descriptor_->file())) {
+      // Sub-objects owned by different arenas can't trade places, so fall
+      // back to copying.
+      printer->Print(
+        "if (GetArenaNoVirtual() != other->GetArenaNoVirtual()) {\n"
+        "  $classname$ temp;\n"
+        "  temp.MergeFrom(*this);\n"
+        "  CopyFrom(*other);\n"
+        "  other->CopyFrom(temp);\n"
+        "  return;\n"
+        "}\n",
+        "classname", classname_);
+    }
     for (int i = 0; i < descriptor_->field_count(); i++) {
       const FieldDescriptor* field = descriptor_->field(i);
       field_generators_.get(field).GenerateSwappingCode(printer);
@@ -1976,22 +2299,54 @@ GenerateMergeFromCodedStream(io::Printer* printer) {
       "    ::google::protobuf::io::CodedInputStream* input) {\n",
       "classname", classname_);
 
-    PrintHandlingOptionalStaticInitializers(
-      descriptor_->file(), printer,
+    PrintHandlingLazyDefaultInstances(
+      map<string, string>(), descriptor_->file(), options_, printer,
       // With static initializers.
       "  return _extensions_.ParseMessageSet(input, default_instance_,\n"
       "                                      mutable_unknown_fields());\n",
       // Without.
       "  return _extensions_.ParseMessageSet(input, &default_instance(),\n"
-      "                                      mutable_unknown_fields());\n",
-      // Vars.
-      "classname", classname_);
+      "                                      mutable_unknown_fields());\n");
 
     printer->Print(
       "}\n");
     return;
   }
 
+  if (UseTableDrivenParsing()) {
+    // The parse table is filled in along with the default instances, which
+    // are only built on demand when static initializers are disabled or with
+    // lazy default instances.
+    printer->Print(
+      "bool $classname$::MergePartialFromCodedStream(\n"
+      "    ::google::protobuf::io::CodedInputStream* input) {\n",
+      "classname", classname_);
+    if (LazyDefaultInstances(descriptor_->file(), options_)) {
+      printer->Print(
+        "  $initdefaultsname$();\n",
+        "initdefaultsname",
+        GlobalInitDefaultsName(descriptor_->file()->name()));
+    } else {
+      PrintHandlingOptionalStaticInitializers(
+        descriptor_->file(), printer,
+        // With static initializers.
+        "",
+        // Without.
+        "  $adddescriptorsname$();\n",
+        // Vars.
+        "adddescriptorsname",
+        GlobalAddDescriptorsName(descriptor_->file()->name()));
+    }
+    printer->Print(
+      "  return ::google::protobuf::internal::$function$(\n"
+      "      this, $classname$_parse_table_, input);\n"
+      "}\n",
+      "function", UseUnknownFieldSet(descriptor_->file()) ?
+          "MergePartialFromCodedStream" : "MergePartialFromCodedStreamLite",
+      "classname", classname_);
+    return;
+  }
+
   printer->Print(
     "bool $classname$::MergePartialFromCodedStream(\n"
     "    ::google::protobuf::io::CodedInputStream* input) {\n"
@@ -2172,8 +2527,8 @@ GenerateMergeFromCodedStream(io::Printer* printer) {
     }
     printer->Print(") {\n");
     if (UseUnknownFieldSet(descriptor_->file())) {
-      PrintHandlingOptionalStaticInitializers(
-        descriptor_->file(), printer,
+      PrintHandlingLazyDefaultInstances(
+        map<string, string>(), descriptor_->file(), options_, printer,
         // With static initializers.
         "  DO_(_extensions_.ParseField(tag, input, default_instance_,\n"
         "                              mutable_unknown_fields()));\n",
@@ -2181,8 +2536,8 @@ GenerateMergeFromCodedStream(io::Printer* printer) {
         "  DO_(_extensions_.ParseField(tag, input, &default_instance(),\n"
         "                              mutable_unknown_fields()));\n");
     } else {
-      PrintHandlingOptionalStaticInitializers(
-        descriptor_->file(), printer,
+      PrintHandlingLazyDefaultInstances(
+        map<string, string>(), descriptor_->file(), options_, printer,
         // With static initializers.
         "  DO_(_extensions_.ParseField(tag, input, default_instance_,\n"
         "                              &unknown_fields_stream));\n",
@@ -2196,7 +2551,12 @@ GenerateMergeFromCodedStream(io::Printer* printer) {
   }
 
   // We really don't recognize this tag.  Skip it.
-  if (UseUnknownFieldSet(descriptor_->file())) {
+  if (UseUnknownFieldSet(descriptor_->file()) &&
+      options_.unknown_fields_as_bytes) {
+    printer->Print(
+      "DO_(::google::protobuf::internal::WireFormat::SkipFieldAsBytes(\n"
+      "      input, tag, mutable_unknown_fields()));\n");
+  } else if (UseUnknownFieldSet(descriptor_->file())) {
     printer->Print(
       "DO_(::google::protobuf::internal::WireFormat::SkipField(\n"
       "      input, tag, mutable_unknown_fields()));\n");
@@ -2229,7 +2589,8 @@ GenerateMergeFromCodedStream(io::Printer* printer) {
 }
 
 void MessageGenerator::GenerateSerializeOneField(
-    io::Printer* printer, const FieldDescriptor* field, bool to_array) {
+    io::Printer* printer, const FieldDescriptor* field,
+    SerializeTarget target) {
   PrintFieldComment(printer, field);
 
   if (!field->is_repeated()) {
@@ -2239,11 +2600,17 @@ void MessageGenerator::GenerateSerializeOneField(
     printer->Indent();
   }
 
-  if (to_array) {
-    field_generators_.get(field).GenerateSerializeWithCachedSizesToArray(
-        printer);
-  } else {
-    field_generators_.get(field).GenerateSerializeWithCachedSizes(printer);
+  switch (target) {
+    case SERIALIZE_TO_STREAM:
+      field_generators_.get(field).GenerateSerializeWithCachedSizes(printer);
+      break;
+    case SERIALIZE_TO_ARRAY:
+      field_generators_.get(field).GenerateSerializeWithCachedSizesToArray(
+          printer);
+      break;
+    case SERIALIZE_BACKWARD:
+      field_generators_.get(field).GenerateSerializeBackward(printer);
+      break;
   }
 
   if (!field->is_repeated()) {
@@ -2255,20 +2622,27 @@ void MessageGenerator::GenerateSerializeOneField(
 
 void MessageGenerator::GenerateSerializeOneExtensionRange(
     io::Printer* printer, const Descriptor::ExtensionRange* range,
-    bool to_array) {
+    SerializeTarget target) {
   map<string, string> vars;
   vars["start"] = SimpleItoa(range->start);
   vars["end"] = SimpleItoa(range->end);
   printer->Print(vars,
     "// Extension range [$start$, $end$)\n");
-  if (to_array) {
-    printer->Print(vars,
-      "target = _extensions_.SerializeWithCachedSizesToArray(\n"
-      "    $start$, $end$, target);\n\n");
-  } else {
-    printer->Print(vars,
-      "_extensions_.SerializeWithCachedSizes(\n"
-      "    $start$, $end$, output);\n\n");
+  switch (target) {
+    case SERIALIZE_TO_STREAM:
+      printer->Print(vars,
+        "_extensions_.SerializeWithCachedSizes(\n"
+        "    $start$, $end$, output);\n\n");
+      break;
+    case SERIALIZE_TO_ARRAY:
+      printer->Print(vars,
+        "target = _extensions_.SerializeWithCachedSizesToArray(\n"
+        "    $start$, $end$, target);\n\n");
+      break;
+    case SERIALIZE_BACKWARD:
+      printer->Print(vars,
+        "_extensions_.SerializeBackward($start$, $end$, buffer);\n\n");
+      break;
   }
 }
 
@@ -2300,7 +2674,7 @@ GenerateSerializeWithCachedSizes(io::Printer* printer) {
     "// @@protoc_insertion_point(serialize_start:$full_name$)\n",
     "full_name", descriptor_->full_name());
 
-  GenerateSerializeWithCachedSizesBody(printer, false);
+  GenerateSerializeWithCachedSizesBody(printer, SERIALIZE_TO_STREAM);
 
   printer->Print(
     "// @@protoc_insertion_point(serialize_end:$full_name$)\n",
@@ -2342,7 +2716,7 @@ GenerateSerializeWithCachedSizesToArray(io::Printer* printer) {
     "// @@protoc_insertion_point(serialize_to_array_start:$full_name$)\n",
     "full_name", descriptor_->full_name());
 
-  GenerateSerializeWithCachedSizesBody(printer, true);
+  GenerateSerializeWithCachedSizesBody(printer, SERIALIZE_TO_ARRAY);
 
   printer->Print(
     "// @@protoc_insertion_point(serialize_to_array_end:$full_name$)\n",
@@ -2355,7 +2729,23 @@ GenerateSerializeWithCachedSizesToArray(io::Printer* printer) {
 }
 
 void MessageGenerator::
-GenerateSerializeWithCachedSizesBody(io::Printer* printer, bool to_array) {
+GenerateSerializeBackward(io::Printer* printer) {
+  printer->Print(
+    "void $classname$::SerializeBackward(\n"
+    "    ::google::protobuf::io::BackwardOutputBuffer* buffer) const {\n",
+    "classname", classname_);
+  printer->Indent();
+
+  GenerateSerializeWithCachedSizesBody(printer, SERIALIZE_BACKWARD);
+
+  printer->Outdent();
+  printer->Print(
+    "}\n");
+}
+
+void MessageGenerator::
+GenerateSerializeWithCachedSizesBody(io::Printer* printer,
+                                     SerializeTarget target) {
   scoped_array<const FieldDescriptor*> ordered_fields(
       SortFieldsByNumber(descriptor_));
 
@@ -2367,42 +2757,83 @@ GenerateSerializeWithCachedSizesBody(io::Printer* printer, bool to_array) {
        ExtensionRangeSorter());
 
   // Merge the fields and the extension ranges, both sorted by field number.
+  // Each entry holds either a field or an extension range.
+  vector<pair<const FieldDescriptor*, const Descriptor::ExtensionRange*> >
+      ordered_parts;
   int i, j;
   for (i = 0, j = 0;
        i < descriptor_->field_count() || j < sorted_extensions.size();
        ) {
     if (i == descriptor_->field_count()) {
-      GenerateSerializeOneExtensionRange(printer,
-                                         sorted_extensions[j++],
-                                         to_array);
+      ordered_parts.push_back(make_pair(
+          static_cast<const FieldDescriptor*>(NULL), sorted_extensions[j++]));
     } else if (j == sorted_extensions.size()) {
-      GenerateSerializeOneField(printer, ordered_fields[i++], to_array);
+      ordered_parts.push_back(make_pair(
+          ordered_fields[i++],
+          static_cast<const Descriptor::ExtensionRange*>(NULL)));
     } else if (ordered_fields[i]->number() < sorted_extensions[j]->start) {
-      GenerateSerializeOneField(printer, ordered_fields[i++], to_array);
+      ordered_parts.push_back(make_pair(
+          ordered_fields[i++],
+          static_cast<const Descriptor::ExtensionRange*>(NULL)));
     } else {
-      GenerateSerializeOneExtensionRange(printer,
-                                         sorted_extensions[j++],
-                                         to_array);
+      ordered_parts.push_back(make_pair(
+          static_cast<const FieldDescriptor*>(NULL), sorted_extensions[j++]));
     }
   }
 
+  // When writing back to front, the unknown fields, which come last, are
+  // written first, and the fields follow in reverse order.
+  if (target == SERIALIZE_BACKWARD) {
+    GenerateSerializeUnknownFields(printer, target);
+    printer->Print("\n");
+    reverse(ordered_parts.begin(), ordered_parts.end());
+  }
+
+  for (int k = 0; k < ordered_parts.size(); k++) {
+    if (ordered_parts[k].first != NULL) {
+      GenerateSerializeOneField(printer, ordered_parts[k].first, target);
+    } else {
+      GenerateSerializeOneExtensionRange(printer, ordered_parts[k].second,
+                                         target);
+    }
+  }
+
+  if (target != SERIALIZE_BACKWARD) {
+    GenerateSerializeUnknownFields(printer, target);
+  }
+}
+
+void MessageGenerator::
+GenerateSerializeUnknownFields(io::Printer* printer, SerializeTarget target) {
   if (UseUnknownFieldSet(descriptor_->file())) {
     printer->Print("if (!unknown_fields().empty()) {\n");
     printer->Indent();
-    if (to_array) {
-      printer->Print(
-        "target = "
-            "::google::protobuf::internal::WireFormat::SerializeUnknownFieldsToArray(\n"
-        "    unknown_fields(), target);\n");
-    } else {
-      printer->Print(
-        "::google::protobuf::internal::WireFormat::SerializeUnknownFields(\n"
-        "    unknown_fields(), output);\n");
+    switch (target) {
+      case SERIALIZE_TO_STREAM:
+        printer->Print(
+          "::google::protobuf::internal::WireFormat::SerializeUnknownFields(\n"
+          "    unknown_fields(), output);\n");
+        break;
+      case SERIALIZE_TO_ARRAY:
+        printer->Print(
+          "target = "
+              "::google::protobuf::internal::WireFormat::SerializeUnknownFieldsToArray(\n"
+          "    unknown_fields(), target);\n");
+        break;
+      case SERIALIZE_BACKWARD:
+        printer->Print(
+          "::google::protobuf::internal::WireFormat::PrependUnknownFields(\n"
+          "    unknown_fields(), buffer);\n");
+        break;
     }
     printer->Outdent();
 
     printer->Print(
       "}\n");
+  } else if (target == SERIALIZE_BACKWARD) {
+    printer->Print(
+      "buffer->PrependRaw(unknown_fields().data(),\n"
+      "                   unknown_fields().size());\n");
   } else {
     printer->Print(
       "output->WriteRaw(unknown_fields().data(),\n"
@@ -104,6 +104,16 @@ class MessageGenerator {
   // allocated before any can be initialized.
   void GenerateDefaultInstanceInitializer(io::Printer* printer);
 
+  // Generates code that allocates the default values which every instance's
+  // fields point at, such as non-empty string defaults.  These are part of
+  // the above, except with lazy default instances:  they cannot wait for
+  // first use since any constructor needs them.
+  void GenerateFieldDefaultAllocators(io::Printer* printer);
+
+  // Generates the field table read by the table-driven parser, if this
+  // message uses it.
+  void GenerateParseTable(io::Printer* printer);
+
   // Generates code that should be run when ShutdownProtobufLibrary() is called,
   // to delete all dynamically-allocated objects.
   void GenerateShutdownCode(io::Printer* printer);
@@ -119,9 +129,17 @@ class MessageGenerator {
   // Generate the field offsets array.
   void GenerateOffsets(io::Printer* printer);
 
+  // Returns the expression through which InitAsDefaultInstance() and the
+  // parse table reach the default instance of the type of a message field
+  // while default instances are being built on demand.
+  string InternalDefaultInstance(const FieldDescriptor* field);
+
   // Generate constructors and destructor.
   void GenerateStructors(io::Printer* printer);
 
+  // Generate the constructor taking an Arena*, for files with arena support.
+  void GenerateArenaConstructor(io::Printer* printer);
+
   // The compiler typically generates multiple copies of each constructor and
   // destructor: http://gcc.gnu.org/bugs.html#nonbugs_cxx
   // Placing common code in a separate method reduces the generated code size.
@@ -135,23 +153,41 @@ class MessageGenerator {
   void GenerateClear(io::Printer* printer);
   void GenerateOneofClear(io::Printer* printer);
   void GenerateMergeFromCodedStream(io::Printer* printer);
+
+  // What the code from GenerateSerializeWithCachedSizesBody() writes to.
+  enum SerializeTarget {
+    SERIALIZE_TO_STREAM,  // The io::CodedOutputStream "output".
+    SERIALIZE_TO_ARRAY,   // The array "target", which it advances.
+    SERIALIZE_BACKWARD    // The io::BackwardOutputBuffer "buffer", back to
+                          // front, without using cached sizes.
+  };
+
   void GenerateSerializeWithCachedSizes(io::Printer* printer);
   void GenerateSerializeWithCachedSizesToArray(io::Printer* printer);
+  void GenerateSerializeBackward(io::Printer* printer);
   void GenerateSerializeWithCachedSizesBody(io::Printer* printer,
-                                            bool to_array);
+                                            SerializeTarget target);
   void GenerateByteSize(io::Printer* printer);
   void GenerateMergeFrom(io::Printer* printer);
   void GenerateCopyFrom(io::Printer* printer);
   void GenerateSwap(io::Printer* printer);
   void GenerateIsInitialized(io::Printer* printer);
 
+  // Is MergePartialFromCodedStream() implemented by the table-driven parser?
+  bool UseTableDrivenParsing() const;
+  // Generates code which fills in the parts of the parse table that are only
+  // known at run time.  Called from GenerateDefaultInstanceInitializer().
+  void GenerateParseTableInitializer(io::Printer* printer);
+
   // Helpers for GenerateSerializeWithCachedSizes().
   void GenerateSerializeOneField(io::Printer* printer,
                                  const FieldDescriptor* field,
-                                 bool unbounded);
+                                 SerializeTarget target);
   void GenerateSerializeOneExtensionRange(
       io::Printer* printer, const Descriptor::ExtensionRange* range,
-      bool unbounded);
+      SerializeTarget target);
+  void GenerateSerializeUnknownFields(io::Printer* printer,
+                                      SerializeTarget target);
 
 
   const Descriptor* descriptor_;
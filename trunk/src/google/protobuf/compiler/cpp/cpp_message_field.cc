@@ -59,6 +59,13 @@ void SetMessageVariables(const FieldDescriptor* descriptor,
       SafeFunctionName(descriptor->containing_type(),
                        descriptor, "release_");
   (*variables)["full_name"] = descriptor->full_name();
+  (*variables)["arena"] = SupportsArenas(descriptor->file()) ?
+      "GetArenaNoVirtual()" : "NULL";
+  // With lazy_default_instances, default_instance_ is only set once something
+  // has asked for it.
+  (*variables)["default_instance"] =
+      LazyDefaultInstances(descriptor->file(), options) ?
+      "default_instance()." : "default_instance_->";
 }
 
 }  // namespace
@@ -97,10 +104,51 @@ GenerateInlineAccessorDefinitions(io::Printer* printer) const {
   PrintHandlingOptionalStaticInitializers(
     variables_, descriptor_->file(), printer,
     // With static initializers.
-    "  return $name$_ != NULL ? *$name$_ : *default_instance_->$name$_;\n",
+    "  return $name$_ != NULL ? *$name$_ : *$default_instance$$name$_;\n",
     // Without.
     "  return $name$_ != NULL ? *$name$_ : *default_instance().$name$_;\n");
 
+  if (SupportsArenas(descriptor_->file())) {
+    // The sub-message lives on the same arena as its parent.  Pointers
+    // handed out by release_ and taken by set_allocated_ are always owned by
+    // the heap, so those copy or transfer ownership when on an arena.
+    printer->Print(variables_,
+      "}\n"
+      "inline $type$* $classname$::mutable_$name$() {\n"
+      "  set_has_$name$();\n"
+      "  if ($name$_ == NULL) {\n"
+      "    $name$_ = ::google::protobuf::Arena::CreateMaybeMessage< $type$ >(\n"
+      "        GetArenaNoVirtual());\n"
+      "  }\n"
+      "  // @@protoc_insertion_point(field_mutable:$full_name$)\n"
+      "  return $name$_;\n"
+      "}\n"
+      "inline $type$* $classname$::$release_name$() {\n"
+      "  clear_has_$name$();\n"
+      "  $type$* temp = $name$_;\n"
+      "  $name$_ = NULL;\n"
+      "  if (temp != NULL && GetArenaNoVirtual() != NULL) {\n"
+      "    temp = new $type$(*temp);\n"
+      "  }\n"
+      "  return temp;\n"
+      "}\n"
+      "inline void $classname$::set_allocated_$name$($type$* $name$) {\n"
+      "  if (GetArenaNoVirtual() == NULL) {\n"
+      "    delete $name$_;\n"
+      "  } else {\n"
+      "    GetArenaNoVirtual()->Own($name$);\n"
+      "  }\n"
+      "  $name$_ = $name$;\n"
+      "  if ($name$) {\n"
+      "    set_has_$name$();\n"
+      "  } else {\n"
+      "    clear_has_$name$();\n"
+      "  }\n"
+      "  // @@protoc_insertion_point(field_set_allocated:$full_name$)\n"
+      "}\n");
+    return;
+  }
+
   printer->Print(variables_,
     "}\n"
     "inline $type$* $classname$::mutable_$name$() {\n"
@@ -185,6 +233,13 @@ GenerateByteSize(io::Printer* printer) const {
     "    this->$name$());\n");
 }
 
+void MessageFieldGenerator::
+GenerateSerializeBackward(io::Printer* printer) const {
+  printer->Print(variables_,
+    "::google::protobuf::internal::WireFormatLite::\n"
+    "  Prepend$declared_type$NoVirtual($number$, this->$name$(), buffer);\n");
+}
+
 // ===================================================================
 
 MessageOneofFieldGenerator::
@@ -198,6 +253,48 @@ MessageOneofFieldGenerator::~MessageOneofFieldGenerator() {}
 
 void MessageOneofFieldGenerator::
 GenerateInlineAccessorDefinitions(io::Printer* printer) const {
+  if (SupportsArenas(descriptor_->file())) {
+    printer->Print(variables_,
+      "inline const $type$& $classname$::$name$() const {\n"
+      "  return has_$name$() ? *$oneof_prefix$$name$_\n"
+      "                      : $type$::default_instance();\n"
+      "}\n"
+      "inline $type$* $classname$::mutable_$name$() {\n"
+      "  if (!has_$name$()) {\n"
+      "    clear_$oneof_name$();\n"
+      "    set_has_$name$();\n"
+      "    $oneof_prefix$$name$_ =\n"
+      "        ::google::protobuf::Arena::CreateMaybeMessage< $type$ >(\n"
+      "            GetArenaNoVirtual());\n"
+      "  }\n"
+      "  return $oneof_prefix$$name$_;\n"
+      "}\n"
+      "inline $type$* $classname$::$release_name$() {\n"
+      "  if (has_$name$()) {\n"
+      "    clear_has_$oneof_name$();\n"
+      "    $type$* temp = $oneof_prefix$$name$_;\n"
+      "    $oneof_prefix$$name$_ = NULL;\n"
+      "    if (GetArenaNoVirtual() != NULL) {\n"
+      "      temp = new $type$(*temp);\n"
+      "    }\n"
+      "    return temp;\n"
+      "  } else {\n"
+      "    return NULL;\n"
+      "  }\n"
+      "}\n"
+      "inline void $classname$::set_allocated_$name$($type$* $name$) {\n"
+      "  clear_$oneof_name$();\n"
+      "  if ($name$) {\n"
+      "    if (GetArenaNoVirtual() != NULL) {\n"
+      "      GetArenaNoVirtual()->Own($name$);\n"
+      "    }\n"
+      "    set_has_$name$();\n"
+      "    $oneof_prefix$$name$_ = $name$;\n"
+      "  }\n"
+      "}\n");
+    return;
+  }
+
   printer->Print(variables_,
     "inline const $type$& $classname$::$name$() const {\n"
     "  return has_$name$() ? *$oneof_prefix$$name$_\n"
@@ -233,8 +330,15 @@ GenerateInlineAccessorDefinitions(io::Printer* printer) const {
 void MessageOneofFieldGenerator::
 GenerateClearingCode(io::Printer* printer) const {
   // if it is the active field, it cannot be NULL.
-  printer->Print(variables_,
-    "delete $oneof_prefix$$name$_;\n");
+  if (SupportsArenas(descriptor_->file())) {
+    printer->Print(variables_,
+      "if (GetArenaNoVirtual() == NULL) {\n"
+      "  delete $oneof_prefix$$name$_;\n"
+      "}\n");
+  } else {
+    printer->Print(variables_,
+      "delete $oneof_prefix$$name$_;\n");
+  }
 }
 
 void MessageOneofFieldGenerator::
@@ -250,6 +354,106 @@ GenerateConstructorCode(io::Printer* printer) const {
 
 // ===================================================================
 
+LazyMessageFieldGenerator::
+LazyMessageFieldGenerator(const FieldDescriptor* descriptor,
+                          const Options& options)
+  : MessageFieldGenerator(descriptor, options) {
+  variables_["prototype"] = variables_["type"] + "::default_instance()";
+}
+
+LazyMessageFieldGenerator::~LazyMessageFieldGenerator() {}
+
+void LazyMessageFieldGenerator::
+GeneratePrivateMembers(io::Printer* printer) const {
+  printer->Print(variables_,
+    "::google::protobuf::internal::LazyField $name$_;\n");
+}
+
+void LazyMessageFieldGenerator::
+GenerateInlineAccessorDefinitions(io::Printer* printer) const {
+  // LazyField hands the message to the arena, if any, and gives release_ a
+  // heap copy, so these look the same with and without arena support.
+  printer->Print(variables_,
+    "inline const $type$& $classname$::$name$() const {\n"
+    "  // @@protoc_insertion_point(field_get:$full_name$)\n"
+    "  return static_cast<const $type$&>($name$_.Get($prototype$));\n"
+    "}\n"
+    "inline $type$* $classname$::mutable_$name$() {\n"
+    "  set_has_$name$();\n"
+    "  // @@protoc_insertion_point(field_mutable:$full_name$)\n"
+    "  return static_cast<$type$*>($name$_.Mutable($prototype$, $arena$));\n"
+    "}\n"
+    "inline $type$* $classname$::$release_name$() {\n"
+    "  clear_has_$name$();\n"
+    "  return static_cast<$type$*>($name$_.Release($prototype$, $arena$));\n"
+    "}\n"
+    "inline void $classname$::set_allocated_$name$($type$* $name$) {\n"
+    "  $name$_.SetAllocated($name$, $arena$);\n"
+    "  if ($name$) {\n"
+    "    set_has_$name$();\n"
+    "  } else {\n"
+    "    clear_has_$name$();\n"
+    "  }\n"
+    "  // @@protoc_insertion_point(field_set_allocated:$full_name$)\n"
+    "}\n");
+}
+
+void LazyMessageFieldGenerator::
+GenerateClearingCode(io::Printer* printer) const {
+  printer->Print(variables_, "$name$_.Clear();\n");
+}
+
+void LazyMessageFieldGenerator::
+GenerateMergingCode(io::Printer* printer) const {
+  printer->Print(variables_,
+    "set_has_$name$();\n"
+    "$name$_.MergeFrom(from.$name$_, $prototype$, $arena$);\n");
+}
+
+void LazyMessageFieldGenerator::
+GenerateSwappingCode(io::Printer* printer) const {
+  printer->Print(variables_, "$name$_.Swap(&other->$name$_);\n");
+}
+
+void LazyMessageFieldGenerator::
+GenerateConstructorCode(io::Printer* printer) const {
+  printer->Print(variables_, "$name$_.Init();\n");
+}
+
+void LazyMessageFieldGenerator::
+GenerateMergeFromCodedStream(io::Printer* printer) const {
+  printer->Print(variables_,
+    "set_has_$name$();\n"
+    "DO_($name$_.MergeFromCodedStream(input, $prototype$, $arena$));\n");
+}
+
+void LazyMessageFieldGenerator::
+GenerateSerializeWithCachedSizes(io::Printer* printer) const {
+  printer->Print(variables_,
+    "$name$_.WriteMessage($number$, output);\n");
+}
+
+void LazyMessageFieldGenerator::
+GenerateSerializeWithCachedSizesToArray(io::Printer* printer) const {
+  printer->Print(variables_,
+    "target = $name$_.WriteMessageToArray($number$, target);\n");
+}
+
+void LazyMessageFieldGenerator::
+GenerateByteSize(io::Printer* printer) const {
+  printer->Print(variables_,
+    "total_size += $tag_size$ + $name$_.MessageSize();\n");
+}
+
+void LazyMessageFieldGenerator::
+GenerateSerializeBackward(io::Printer* printer) const {
+  // A LazyField which has not been parsed is copied as is; otherwise the
+  // size of the message is computed first.
+  FieldGenerator::GenerateSerializeBackward(printer);
+}
+
+// ===================================================================
+
 RepeatedMessageFieldGenerator::
 RepeatedMessageFieldGenerator(const FieldDescriptor* descriptor,
                               const Options& options)
@@ -261,8 +465,14 @@ RepeatedMessageFieldGenerator::~RepeatedMessageFieldGenerator() {}
 
 void RepeatedMessageFieldGenerator::
 GeneratePrivateMembers(io::Printer* printer) const {
-  printer->Print(variables_,
-    "::google::protobuf::RepeatedPtrField< $type$ > $name$_;\n");
+  if (descriptor_->options().inline_capacity() > 0) {
+    printer->Print(variables_,
+      "::google::protobuf::InlinedRepeatedPtrField< $type$, "
+      "$inline_capacity$ > $name$_;\n");
+  } else {
+    printer->Print(variables_,
+      "::google::protobuf::RepeatedPtrField< $type$ > $name$_;\n");
+  }
 }
 
 void RepeatedMessageFieldGenerator::
@@ -369,6 +579,15 @@ GenerateByteSize(io::Printer* printer) const {
     "}\n");
 }
 
+void RepeatedMessageFieldGenerator::
+GenerateSerializeBackward(io::Printer* printer) const {
+  printer->Print(variables_,
+    "for (int i = this->$name$_size() - 1; i >= 0; i--) {\n"
+    "  ::google::protobuf::internal::WireFormatLite::\n"
+    "    Prepend$declared_type$NoVirtual($number$, this->$name$(i), buffer);\n"
+    "}\n");
+}
+
 }  // namespace cpp
 }  // namespace compiler
 }  // namespace protobuf
@@ -62,6 +62,7 @@ class MessageFieldGenerator : public FieldGenerator {
   void GenerateSerializeWithCachedSizes(io::Printer* printer) const;
   void GenerateSerializeWithCachedSizesToArray(io::Printer* printer) const;
   void GenerateByteSize(io::Printer* printer) const;
+  void GenerateSerializeBackward(io::Printer* printer) const;
 
  protected:
   const FieldDescriptor* descriptor_;
@@ -87,6 +88,33 @@ class MessageOneofFieldGenerator : public MessageFieldGenerator {
   GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(MessageOneofFieldGenerator);
 };
 
+// Generates a singular message field declared with [lazy=true], which is
+// stored as an internal::LazyField (see lazy_field.h) and keeps its encoded
+// bytes until it is first accessed.  The accessors are the same as for any
+// other message field.
+class LazyMessageFieldGenerator : public MessageFieldGenerator {
+ public:
+  explicit LazyMessageFieldGenerator(const FieldDescriptor* descriptor,
+                                     const Options& options);
+  ~LazyMessageFieldGenerator();
+
+  // implements FieldGenerator ---------------------------------------
+  void GeneratePrivateMembers(io::Printer* printer) const;
+  void GenerateInlineAccessorDefinitions(io::Printer* printer) const;
+  void GenerateClearingCode(io::Printer* printer) const;
+  void GenerateMergingCode(io::Printer* printer) const;
+  void GenerateSwappingCode(io::Printer* printer) const;
+  void GenerateConstructorCode(io::Printer* printer) const;
+  void GenerateMergeFromCodedStream(io::Printer* printer) const;
+  void GenerateSerializeWithCachedSizes(io::Printer* printer) const;
+  void GenerateSerializeWithCachedSizesToArray(io::Printer* printer) const;
+  void GenerateByteSize(io::Printer* printer) const;
+  void GenerateSerializeBackward(io::Printer* printer) const;
+
+ private:
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(LazyMessageFieldGenerator);
+};
+
 class RepeatedMessageFieldGenerator : public FieldGenerator {
  public:
   explicit RepeatedMessageFieldGenerator(const FieldDescriptor* descriptor,
@@ -105,6 +133,7 @@ class RepeatedMessageFieldGenerator : public FieldGenerator {
   void GenerateSerializeWithCachedSizes(io::Printer* printer) const;
   void GenerateSerializeWithCachedSizesToArray(io::Printer* printer) const;
   void GenerateByteSize(io::Printer* printer) const;
+  void GenerateSerializeBackward(io::Printer* printer) const;
 
  private:
   const FieldDescriptor* descriptor_;
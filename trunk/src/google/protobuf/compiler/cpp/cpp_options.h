@@ -43,10 +43,20 @@ namespace cpp {
 
 // Generator options:
 struct Options {
-  Options() : safe_boundary_check(false) {
+  Options() : safe_boundary_check(false), table_driven_parsing(false),
+              unknown_fields_as_bytes(false), lazy_default_instances(false) {
   }
   string dllexport_decl;
   bool safe_boundary_check;
+  // Implement MergePartialFromCodedStream() with a per-message field table
+  // interpreted by the runtime library instead of generated code.
+  bool table_driven_parsing;
+  // Keep unknown fields as serialized bytes until they are looked at, rather
+  // than parsing each of them into its own UnknownField.
+  bool unknown_fields_as_bytes;
+  // Build default instances the first time one of the file's types needs
+  // them, rather than in AddDescriptors() at static initialization time.
+  bool lazy_default_instances;
 };
 
 }  // namespace cpp
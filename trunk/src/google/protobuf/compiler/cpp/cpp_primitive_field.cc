@@ -269,8 +269,14 @@ RepeatedPrimitiveFieldGenerator::~RepeatedPrimitiveFieldGenerator() {}
 
 void RepeatedPrimitiveFieldGenerator::
 GeneratePrivateMembers(io::Printer* printer) const {
-  printer->Print(variables_,
-    "::google::protobuf::RepeatedField< $type$ > $name$_;\n");
+  if (descriptor_->options().inline_capacity() > 0) {
+    printer->Print(variables_,
+      "::google::protobuf::InlinedRepeatedField< $type$, "
+      "$inline_capacity$ > $name$_;\n");
+  } else {
+    printer->Print(variables_,
+      "::google::protobuf::RepeatedField< $type$ > $name$_;\n");
+  }
   if (descriptor_->options().packed() && HasGeneratedMethods(descriptor_->file())) {
     printer->Print(variables_,
       "mutable int _$name$_cached_byte_size_;\n");
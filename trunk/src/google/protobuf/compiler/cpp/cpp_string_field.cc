@@ -63,6 +63,22 @@ void SetStringVariables(const FieldDescriptor* descriptor,
       SafeFunctionName(descriptor->containing_type(),
                        descriptor, "release_");
   (*variables)["full_name"] = descriptor->full_name();
+  (*variables)["arena"] = SupportsArenas(descriptor->file()) ?
+      "GetArenaNoVirtual()" : "NULL";
+
+  // Strings of messages with arena support are allocated on the message's
+  // arena.
+  if (SupportsArenas(descriptor->file())) {
+    (*variables)["new_string"] =
+        "::google::protobuf::Arena::Create< ::std::string>(GetArenaNoVirtual())";
+    (*variables)["new_default_string"] =
+        "::google::protobuf::Arena::Create< ::std::string>(GetArenaNoVirtual(), *" +
+        (*variables)["default_variable"] + ")";
+  } else {
+    (*variables)["new_string"] = "new ::std::string";
+    (*variables)["new_default_string"] =
+        "new ::std::string(*" + (*variables)["default_variable"] + ")";
+  }
 }
 
 }  // namespace
@@ -94,12 +110,10 @@ void StringFieldGenerator::
 GenerateAccessorDeclarations(io::Printer* printer) const {
   // If we're using StringFieldGenerator for a field with a ctype, it's
   // because that ctype isn't actually implemented.  In particular, this is
-  // true of ctype=CORD and ctype=STRING_PIECE in the open source release.
-  // We aren't releasing Cord because it has too many Google-specific
-  // dependencies and we aren't releasing StringPiece because it's hardly
-  // useful outside of Google and because it would get confusing to have
-  // multiple instances of the StringPiece class in different libraries (PCRE
-  // already includes it for their C++ bindings, which came from Google).
+  // true of ctype=CORD in the open source release, and of ctype=STRING_PIECE
+  // for repeated fields and oneof members; singular STRING_PIECE fields are
+  // handled by StringPieceFieldGenerator.  We aren't releasing Cord because
+  // it has too many Google-specific dependencies.
   //
   // In any case, we make all the accessors private while still actually
   // using a string to represent the field internally.  This way, we can
@@ -144,7 +158,7 @@ GenerateInlineAccessorDefinitions(io::Printer* printer) const {
     "inline void $classname$::set_$name$(const ::std::string& value) {\n"
     "  set_has_$name$();\n"
     "  if ($name$_ == $default_variable$) {\n"
-    "    $name$_ = new ::std::string;\n"
+    "    $name$_ = $new_string$;\n"
     "  }\n"
     "  $name$_->assign(value);\n"
     "  // @@protoc_insertion_point(field_set:$full_name$)\n"
@@ -152,7 +166,7 @@ GenerateInlineAccessorDefinitions(io::Printer* printer) const {
     "inline void $classname$::set_$name$(const char* value) {\n"
     "  set_has_$name$();\n"
     "  if ($name$_ == $default_variable$) {\n"
-    "    $name$_ = new ::std::string;\n"
+    "    $name$_ = $new_string$;\n"
     "  }\n"
     "  $name$_->assign(value);\n"
     "  // @@protoc_insertion_point(field_set_char:$full_name$)\n"
@@ -161,7 +175,7 @@ GenerateInlineAccessorDefinitions(io::Printer* printer) const {
     "void $classname$::set_$name$(const $pointer_type$* value, size_t size) {\n"
     "  set_has_$name$();\n"
     "  if ($name$_ == $default_variable$) {\n"
-    "    $name$_ = new ::std::string;\n"
+    "    $name$_ = $new_string$;\n"
     "  }\n"
     "  $name$_->assign(reinterpret_cast<const char*>(value), size);\n"
     "  // @@protoc_insertion_point(field_set_pointer:$full_name$)\n"
@@ -171,10 +185,10 @@ GenerateInlineAccessorDefinitions(io::Printer* printer) const {
     "  if ($name$_ == $default_variable$) {\n");
   if (descriptor_->default_value_string().empty()) {
     printer->Print(variables_,
-      "    $name$_ = new ::std::string;\n");
+      "    $name$_ = $new_string$;\n");
   } else {
     printer->Print(variables_,
-      "    $name$_ = new ::std::string(*$default_variable$);\n");
+      "    $name$_ = $new_default_string$;\n");
   }
   printer->Print(variables_,
     "  }\n"
@@ -187,15 +201,36 @@ GenerateInlineAccessorDefinitions(io::Printer* printer) const {
     "    return NULL;\n"
     "  } else {\n"
     "    ::std::string* temp = $name$_;\n"
-    "    $name$_ = const_cast< ::std::string*>($default_variable$);\n"
+    "    $name$_ = const_cast< ::std::string*>($default_variable$);\n");
+  if (SupportsArenas(descriptor_->file())) {
+    // The arena keeps ownership of its string; hand out a heap copy.
+    printer->Print(variables_,
+      "    if (GetArenaNoVirtual() != NULL) {\n"
+      "      temp = new ::std::string(*temp);\n"
+      "    }\n");
+  }
+  printer->Print(variables_,
     "    return temp;\n"
     "  }\n"
     "}\n"
-    "inline void $classname$::set_allocated_$name$(::std::string* $name$) {\n"
-    "  if ($name$_ != $default_variable$) {\n"
-    "    delete $name$_;\n"
-    "  }\n"
-    "  if ($name$) {\n"
+    "inline void $classname$::set_allocated_$name$(::std::string* $name$) {\n");
+  if (SupportsArenas(descriptor_->file())) {
+    printer->Print(variables_,
+      "  if ($name$_ != $default_variable$ && GetArenaNoVirtual() == NULL) {\n"
+      "    delete $name$_;\n"
+      "  }\n"
+      "  if ($name$) {\n"
+      "    if (GetArenaNoVirtual() != NULL) {\n"
+      "      GetArenaNoVirtual()->Own($name$);\n"
+      "    }\n");
+  } else {
+    printer->Print(variables_,
+      "  if ($name$_ != $default_variable$) {\n"
+      "    delete $name$_;\n"
+      "  }\n"
+      "  if ($name$) {\n");
+  }
+  printer->Print(variables_,
     "    set_has_$name$();\n"
     "    $name$_ = $name$;\n"
     "  } else {\n"
@@ -356,7 +391,7 @@ GenerateInlineAccessorDefinitions(io::Printer* printer) const {
     "  if (!has_$name$()) {\n"
     "    clear_$oneof_name$();\n"
     "    set_has_$name$();\n"
-    "    $oneof_prefix$$name$_ = new ::std::string;\n"
+    "    $oneof_prefix$$name$_ = $new_string$;\n"
     "  }\n"
     "  $oneof_prefix$$name$_->assign(value);\n"
     "}\n"
@@ -364,7 +399,7 @@ GenerateInlineAccessorDefinitions(io::Printer* printer) const {
     "  if (!has_$name$()) {\n"
     "    clear_$oneof_name$();\n"
     "    set_has_$name$();\n"
-    "    $oneof_prefix$$name$_ = new ::std::string;\n"
+    "    $oneof_prefix$$name$_ = $new_string$;\n"
     "  }\n"
     "  $oneof_prefix$$name$_->assign(value);\n"
     "}\n"
@@ -373,7 +408,7 @@ GenerateInlineAccessorDefinitions(io::Printer* printer) const {
     "  if (!has_$name$()) {\n"
     "    clear_$oneof_name$();\n"
     "    set_has_$name$();\n"
-    "    $oneof_prefix$$name$_ = new ::std::string;\n"
+    "    $oneof_prefix$$name$_ = $new_string$;\n"
     "  }\n"
     "  $oneof_prefix$$name$_->assign(\n"
     "      reinterpret_cast<const char*>(value), size);\n"
@@ -384,10 +419,10 @@ GenerateInlineAccessorDefinitions(io::Printer* printer) const {
     "    set_has_$name$();\n");
   if (descriptor_->default_value_string().empty()) {
     printer->Print(variables_,
-      "    $oneof_prefix$$name$_ = new ::std::string;\n");
+      "    $oneof_prefix$$name$_ = $new_string$;\n");
   } else {
     printer->Print(variables_,
-      "    $oneof_prefix$$name$_ = new ::std::string(*$default_variable$);\n");
+      "    $oneof_prefix$$name$_ = $new_default_string$;\n");
   }
   printer->Print(variables_,
     "  }\n"
@@ -397,7 +432,14 @@ GenerateInlineAccessorDefinitions(io::Printer* printer) const {
     "  if (has_$name$()) {\n"
     "    clear_has_$oneof_name$();\n"
     "    ::std::string* temp = $oneof_prefix$$name$_;\n"
-    "    $oneof_prefix$$name$_ = NULL;\n"
+    "    $oneof_prefix$$name$_ = NULL;\n");
+  if (SupportsArenas(descriptor_->file())) {
+    printer->Print(variables_,
+      "    if (GetArenaNoVirtual() != NULL) {\n"
+      "      temp = new ::std::string(*temp);\n"
+      "    }\n");
+  }
+  printer->Print(variables_,
     "    return temp;\n"
     "  } else {\n"
     "    return NULL;\n"
@@ -405,7 +447,14 @@ GenerateInlineAccessorDefinitions(io::Printer* printer) const {
     "}\n"
     "inline void $classname$::set_allocated_$name$(::std::string* $name$) {\n"
     "  clear_$oneof_name$();\n"
-    "  if ($name$) {\n"
+    "  if ($name$) {\n");
+  if (SupportsArenas(descriptor_->file())) {
+    printer->Print(variables_,
+      "    if (GetArenaNoVirtual() != NULL) {\n"
+      "      GetArenaNoVirtual()->Own($name$);\n"
+      "    }\n");
+  }
+  printer->Print(variables_,
     "    set_has_$name$();\n"
     "    $oneof_prefix$$name$_ = $name$;\n"
     "  }\n"
@@ -414,8 +463,15 @@ GenerateInlineAccessorDefinitions(io::Printer* printer) const {
 
 void StringOneofFieldGenerator::
 GenerateClearingCode(io::Printer* printer) const {
+  if (SupportsArenas(descriptor_->file())) {
+    printer->Print(variables_,
+      "if (GetArenaNoVirtual() == NULL) {\n"
+      "  delete $oneof_prefix$$name$_;\n"
+      "}\n");
+  } else {
     printer->Print(variables_,
       "delete $oneof_prefix$$name$_;\n");
+  }
 }
 
 void StringOneofFieldGenerator::
@@ -446,6 +502,175 @@ GenerateDestructorCode(io::Printer* printer) const {
 
 // ===================================================================
 
+StringPieceFieldGenerator::
+StringPieceFieldGenerator(const FieldDescriptor* descriptor,
+                          const Options& options)
+  : StringFieldGenerator(descriptor, options) {}
+
+StringPieceFieldGenerator::~StringPieceFieldGenerator() {}
+
+void StringPieceFieldGenerator::
+GeneratePrivateMembers(io::Printer* printer) const {
+  printer->Print(variables_,
+    "::google::protobuf::internal::StringPieceField $name$_;\n");
+}
+
+void StringPieceFieldGenerator::
+GenerateAccessorDeclarations(io::Printer* printer) const {
+  printer->Print(variables_,
+    "inline ::google::protobuf::StringPiece $name$() const$deprecation$;\n"
+    "inline void set_$name$(const ::std::string& value)$deprecation$;\n"
+    "inline void set_$name$(const char* value)$deprecation$;\n"
+    "inline void set_$name$(const $pointer_type$* value, size_t size)"
+                 "$deprecation$;\n"
+    "inline void set_$name$(::google::protobuf::StringPiece value)$deprecation$;\n"
+    "inline void set_alias_$name$(const $pointer_type$* value, size_t size)"
+                 "$deprecation$;\n"
+    "inline ::std::string* mutable_$name$()$deprecation$;\n"
+    "inline ::std::string* $release_name$()$deprecation$;\n"
+    "inline void set_allocated_$name$(::std::string* $name$)$deprecation$;\n");
+}
+
+void StringPieceFieldGenerator::
+GenerateInlineAccessorDefinitions(io::Printer* printer) const {
+  printer->Print(variables_,
+    "inline ::google::protobuf::StringPiece $classname$::$name$() const {\n"
+    "  // @@protoc_insertion_point(field_get:$full_name$)\n"
+    "  return $name$_.Get();\n"
+    "}\n"
+    "inline void $classname$::set_$name$(const ::std::string& value) {\n"
+    "  set_has_$name$();\n"
+    "  $name$_.Set(value.data(), static_cast<int>(value.size()), $arena$);\n"
+    "  // @@protoc_insertion_point(field_set:$full_name$)\n"
+    "}\n"
+    "inline void $classname$::set_$name$(const char* value) {\n"
+    "  set_has_$name$();\n"
+    "  $name$_.Set(value, static_cast<int>(strlen(value)), $arena$);\n"
+    "  // @@protoc_insertion_point(field_set_char:$full_name$)\n"
+    "}\n"
+    "inline "
+    "void $classname$::set_$name$(const $pointer_type$* value, size_t size) {\n"
+    "  set_has_$name$();\n"
+    "  $name$_.Set(reinterpret_cast<const char*>(value),\n"
+    "              static_cast<int>(size), $arena$);\n"
+    "  // @@protoc_insertion_point(field_set_pointer:$full_name$)\n"
+    "}\n"
+    "inline void $classname$::set_$name$(::google::protobuf::StringPiece value) {\n"
+    "  set_has_$name$();\n"
+    "  $name$_.Set(value.data(), value.size(), $arena$);\n"
+    "  // @@protoc_insertion_point(field_set_string_piece:$full_name$)\n"
+    "}\n"
+    "inline void $classname$::set_alias_$name$(\n"
+    "    const $pointer_type$* value, size_t size) {\n"
+    "  set_has_$name$();\n"
+    "  $name$_.SetAliased(reinterpret_cast<const char*>(value),\n"
+    "                     static_cast<int>(size));\n"
+    "  // @@protoc_insertion_point(field_set_alias:$full_name$)\n"
+    "}\n"
+    "inline ::std::string* $classname$::mutable_$name$() {\n"
+    "  set_has_$name$();\n"
+    "  // @@protoc_insertion_point(field_mutable:$full_name$)\n"
+    "  return $name$_.Mutable($arena$);\n"
+    "}\n"
+    "inline ::std::string* $classname$::$release_name$() {\n"
+    "  clear_has_$name$();\n"
+    "  return $name$_.Release(*$default_variable$, $arena$);\n"
+    "}\n"
+    "inline void $classname$::set_allocated_$name$(::std::string* $name$) {\n"
+    "  if ($name$) {\n"
+    "    set_has_$name$();\n"
+    "  } else {\n"
+    "    clear_has_$name$();\n"
+    "  }\n"
+    "  $name$_.SetAllocated($name$, *$default_variable$, $arena$);\n"
+    "  // @@protoc_insertion_point(field_set_allocated:$full_name$)\n"
+    "}\n");
+}
+
+void StringPieceFieldGenerator::
+GenerateClearingCode(io::Printer* printer) const {
+  printer->Print(variables_,
+    "$name$_.ClearToDefault(*$default_variable$);\n");
+}
+
+void StringPieceFieldGenerator::
+GenerateMergingCode(io::Printer* printer) const {
+  // Copies rather than aliasing from's buffer.
+  printer->Print(variables_, "set_$name$(from.$name$());\n");
+}
+
+void StringPieceFieldGenerator::
+GenerateSwappingCode(io::Printer* printer) const {
+  printer->Print(variables_, "$name$_.Swap(&other->$name$_);\n");
+}
+
+void StringPieceFieldGenerator::
+GenerateConstructorCode(io::Printer* printer) const {
+  printer->Print(variables_, "$name$_.Init(*$default_variable$);\n");
+}
+
+void StringPieceFieldGenerator::
+GenerateDestructorCode(io::Printer* printer) const {
+  printer->Print(variables_, "$name$_.Destroy();\n");
+}
+
+void StringPieceFieldGenerator::
+GenerateMergeFromCodedStream(io::Printer* printer) const {
+  printer->Print(variables_,
+    "set_has_$name$();\n"
+    "DO_(::google::protobuf::internal::WireFormatLite::ReadStringPiece(\n"
+    "      input, &$name$_, $arena$));\n");
+  if (HasUtf8Verification(descriptor_->file()) &&
+      descriptor_->type() == FieldDescriptor::TYPE_STRING) {
+    printer->Print(variables_,
+      "::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(\n"
+      "  this->$name$().data(), this->$name$().length(),\n"
+      "  ::google::protobuf::internal::WireFormat::PARSE,\n"
+      "  \"$name$\");\n");
+  }
+}
+
+void StringPieceFieldGenerator::
+GenerateSerializeWithCachedSizes(io::Printer* printer) const {
+  if (HasUtf8Verification(descriptor_->file()) &&
+      descriptor_->type() == FieldDescriptor::TYPE_STRING) {
+    printer->Print(variables_,
+      "::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(\n"
+      "  this->$name$().data(), this->$name$().length(),\n"
+      "  ::google::protobuf::internal::WireFormat::SERIALIZE,\n"
+      "  \"$name$\");\n");
+  }
+  printer->Print(variables_,
+    "::google::protobuf::internal::WireFormatLite::WriteStringPiece(\n"
+    "  $number$, this->$name$_, output);\n");
+}
+
+void StringPieceFieldGenerator::
+GenerateSerializeWithCachedSizesToArray(io::Printer* printer) const {
+  if (HasUtf8Verification(descriptor_->file()) &&
+      descriptor_->type() == FieldDescriptor::TYPE_STRING) {
+    printer->Print(variables_,
+      "::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(\n"
+      "  this->$name$().data(), this->$name$().length(),\n"
+      "  ::google::protobuf::internal::WireFormat::SERIALIZE,\n"
+      "  \"$name$\");\n");
+  }
+  printer->Print(variables_,
+    "target =\n"
+    "  ::google::protobuf::internal::WireFormatLite::WriteStringPieceToArray(\n"
+    "    $number$, this->$name$_, target);\n");
+}
+
+void StringPieceFieldGenerator::
+GenerateByteSize(io::Printer* printer) const {
+  printer->Print(variables_,
+    "total_size += $tag_size$ +\n"
+    "  ::google::protobuf::internal::WireFormatLite::StringPieceSize(\n"
+    "    this->$name$_);\n");
+}
+
+// ===================================================================
+
 RepeatedStringFieldGenerator::
 RepeatedStringFieldGenerator(const FieldDescriptor* descriptor,
                              const Options& options)
@@ -457,8 +682,14 @@ RepeatedStringFieldGenerator::~RepeatedStringFieldGenerator() {}
 
 void RepeatedStringFieldGenerator::
 GeneratePrivateMembers(io::Printer* printer) const {
-  printer->Print(variables_,
-    "::google::protobuf::RepeatedPtrField< ::std::string> $name$_;\n");
+  if (descriptor_->options().inline_capacity() > 0) {
+    printer->Print(variables_,
+      "::google::protobuf::InlinedRepeatedPtrField< ::std::string, "
+      "$inline_capacity$ > $name$_;\n");
+  } else {
+    printer->Print(variables_,
+      "::google::protobuf::RepeatedPtrField< ::std::string> $name$_;\n");
+  }
 }
 
 void RepeatedStringFieldGenerator::
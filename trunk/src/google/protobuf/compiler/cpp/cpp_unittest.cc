@@ -53,6 +53,7 @@
 #include <google/protobuf/unittest_optimize_for.pb.h>
 #include <google/protobuf/unittest_embed_optimize_for.pb.h>
 #include <google/protobuf/unittest_no_generic_services.pb.h>
+#include <google/protobuf/unittest_lazy_default_instances.pb.h>
 #include <google/protobuf/test_util.h>
 #include <google/protobuf/compiler/cpp/cpp_helpers.h>
 #include <google/protobuf/compiler/cpp/cpp_test_bad_identifiers.pb.h>
@@ -614,6 +615,63 @@ TEST(GeneratedMessageTest, PackedFieldsSerializationToArray) {
   TestUtil::ExpectPackedFieldsSet(packed_message2);
 }
 
+// Test that the single-pass, back-to-front serializer produces exactly the
+// same bytes as the usual two-pass one.
+TEST(GeneratedMessageTest, SerializationSinglePass) {
+  unittest::TestAllTypes message1, message2;
+  TestUtil::SetAllFields(&message1);
+  message1.mutable_unknown_fields()->AddVarint(12345, 67);
+  message1.mutable_unknown_fields()->AddLengthDelimited(12346, "foo");
+
+  string data;
+  EXPECT_TRUE(message1.SerializeToStringSinglePass(&data));
+  EXPECT_EQ(message1.SerializeAsString(), data);
+  EXPECT_TRUE(message2.ParseFromString(data));
+  TestUtil::ExpectAllFieldsSet(message2);
+  EXPECT_EQ(2, message2.unknown_fields().field_count());
+}
+
+TEST(GeneratedMessageTest, PackedFieldsSerializationSinglePass) {
+  unittest::TestPackedTypes packed_message;
+  TestUtil::SetPackedFields(&packed_message);
+  string data;
+  EXPECT_TRUE(packed_message.SerializeToStringSinglePass(&data));
+  EXPECT_EQ(packed_message.SerializeAsString(), data);
+}
+
+TEST(GeneratedMessageTest, ExtensionsSerializationSinglePass) {
+  unittest::TestAllExtensions message;
+  TestUtil::SetAllExtensions(&message);
+  string data;
+  EXPECT_TRUE(message.SerializeToStringSinglePass(&data));
+  EXPECT_EQ(message.SerializeAsString(), data);
+
+  // Extensions interleaved with regular fields must stay in field order.
+  unittest::TestFieldOrderings orderings;
+  TestUtil::SetAllFieldsAndExtensions(&orderings);
+  EXPECT_TRUE(orderings.SerializeToStringSinglePass(&data));
+  EXPECT_EQ(orderings.SerializeAsString(), data);
+}
+
+TEST(GeneratedMessageTest, NestedMessagesSerializationSinglePass) {
+  // Sub-messages several levels deep, none of whose sizes were cached.
+  unittest::TestRecursiveMessage message;
+  unittest::TestRecursiveMessage* inner = &message;
+  for (int i = 0; i < 100; i++) {
+    inner->set_i(i);
+    inner = inner->mutable_a();
+  }
+  string data;
+  EXPECT_TRUE(message.SerializeToStringSinglePass(&data));
+  EXPECT_EQ(message.SerializeAsString(), data);
+
+  // The partial variant accepts messages with required fields missing.
+  unittest::TestRequired required;
+  EXPECT_FALSE(required.IsInitialized());
+  EXPECT_TRUE(required.SerializePartialToStringSinglePass(&data));
+  EXPECT_EQ(required.SerializePartialAsString(), data);
+}
+
 // Test the generated SerializeWithCachedSizes() by forcing the buffer to write
 // one byte at a time.
 TEST(GeneratedMessageTest, SerializationToStream) {
@@ -654,6 +712,111 @@ TEST(GeneratedMessageTest, PackedFieldsSerializationToStream) {
 }
 
 
+// Returns true if data points into the object message.
+template <typename MessageType>
+bool IsInside(const void* data, const MessageType& message) {
+  const char* begin = reinterpret_cast<const char*>(&message);
+  return begin <= data && data < begin + sizeof(message);
+}
+
+TEST(GeneratedMessageTest, InlineRepeatedFields) {
+  unittest::TestInlineRepeated message;
+  for (int i = 0; i < 4; i++) {
+    message.add_repeated_int32(i);
+    message.add_repeated_string(SimpleItoa(i));
+  }
+  message.add_repeated_double(1.5);
+  message.add_repeated_enum(unittest::FOREIGN_BAR);
+  message.add_repeated_message()->set_c(1);
+  message.add_packed_int32(-1);
+  EXPECT_TRUE(IsInside(message.repeated_int32().data(), message));
+  EXPECT_TRUE(IsInside(message.repeated_string().data(), message));
+  EXPECT_TRUE(IsInside(message.repeated_double().data(), message));
+  EXPECT_TRUE(IsInside(message.repeated_enum().data(), message));
+  EXPECT_TRUE(IsInside(message.repeated_message().data(), message));
+  EXPECT_TRUE(IsInside(message.packed_int32().data(), message));
+
+  message.add_repeated_int32(4);
+  EXPECT_FALSE(IsInside(message.repeated_int32().data(), message));
+  ASSERT_EQ(5, message.repeated_int32_size());
+  for (int i = 0; i < 5; i++) {
+    EXPECT_EQ(i, message.repeated_int32(i));
+  }
+
+  unittest::TestInlineRepeated parsed;
+  ASSERT_TRUE(parsed.ParseFromString(message.SerializeAsString()));
+  EXPECT_EQ(message.SerializeAsString(), parsed.SerializeAsString());
+  EXPECT_TRUE(IsInside(parsed.repeated_string().data(), parsed));
+  EXPECT_TRUE(IsInside(parsed.packed_int32().data(), parsed));
+}
+
+TEST(GeneratedMessageTest, InlineRepeatedFieldsSwap) {
+  unittest::TestInlineRepeated message1;
+  unittest::TestInlineRepeated message2;
+  message1.add_repeated_string("foo");
+  message1.add_repeated_message()->set_c(1);
+  for (int i = 0; i < 10; i++) {
+    message2.add_repeated_int32(i);
+    message2.add_repeated_message()->set_c(i);
+  }
+  string serialized1 = message1.SerializeAsString();
+  string serialized2 = message2.SerializeAsString();
+
+  message1.Swap(&message2);
+  EXPECT_EQ(serialized2, message1.SerializeAsString());
+  EXPECT_EQ(serialized1, message2.SerializeAsString());
+
+#ifndef PROTOBUF_TEST_NO_DESCRIPTORS
+  const Reflection* reflection = message1.GetReflection();
+  const Descriptor* descriptor = message1.GetDescriptor();
+  vector<const FieldDescriptor*> fields;
+  for (int i = 0; i < descriptor->field_count(); i++) {
+    fields.push_back(descriptor->field(i));
+  }
+  reflection->SwapFields(&message1, &message2, fields);
+  EXPECT_EQ(serialized1, message1.SerializeAsString());
+  EXPECT_EQ(serialized2, message2.SerializeAsString());
+#endif  // !PROTOBUF_TEST_NO_DESCRIPTORS
+}
+
+#ifndef PROTOBUF_TEST_NO_DESCRIPTORS
+TEST(GeneratedMessageTest, InlineRepeatedFieldsReflection) {
+  unittest::TestInlineRepeated message;
+  const Reflection* reflection = message.GetReflection();
+  const Descriptor* descriptor = message.GetDescriptor();
+  const FieldDescriptor* int32_field =
+      descriptor->FindFieldByName("repeated_int32");
+  const FieldDescriptor* string_field =
+      descriptor->FindFieldByName("repeated_string");
+  const FieldDescriptor* message_field =
+      descriptor->FindFieldByName("repeated_message");
+
+  RepeatedField<int32>* int32s =
+      reflection->MutableRepeatedField<int32>(&message, int32_field);
+  EXPECT_EQ(message.mutable_repeated_int32(), int32s);
+  int32s->Add(1);
+  reflection->AddInt32(&message, int32_field, 2);
+  reflection->AddString(&message, string_field, "foo");
+  reflection->AddMessage(&message, message_field);
+  reflection->SetRepeatedInt32(&message, int32_field, 0, 3);
+
+  ASSERT_EQ(2, message.repeated_int32_size());
+  EXPECT_EQ(3, message.repeated_int32(0));
+  EXPECT_EQ(2, message.repeated_int32(1));
+  EXPECT_EQ(2, reflection->FieldSize(message, int32_field));
+  EXPECT_EQ("foo", reflection->GetRepeatedString(message, string_field, 0));
+  EXPECT_EQ(1, reflection->GetRepeatedPtrField<string>(
+      message, string_field).size());
+  EXPECT_EQ(1, message.repeated_message_size());
+  EXPECT_TRUE(IsInside(message.repeated_int32().data(), message));
+
+  unittest::TestInlineRepeated copy;
+  copy.CopyFrom(message);
+  EXPECT_EQ(message.SerializeAsString(), copy.SerializeAsString());
+  EXPECT_EQ(message.SpaceUsed(), copy.SpaceUsed());
+}
+#endif  // !PROTOBUF_TEST_NO_DESCRIPTORS
+
 TEST(GeneratedMessageTest, Required) {
   // Test that IsInitialized() returns false if required fields are missing.
   unittest::TestRequired message;
@@ -1060,6 +1223,129 @@ TEST(GeneratedEnumTest, IsProtoEnumTypeTrait) {
 
 #endif  // PROTOBUF_TEST_NO_DESCRIPTORS
 
+// ===================================================================
+
+// unittest_lazy_default_instances.proto is compiled with the
+// lazy_default_instances option.
+namespace lazy_defaults = ::protobuf_unittest_lazy_default_instances;
+
+TEST(LazyDefaultInstancesTest, BuiltOnFirstUse) {
+  // Nothing has needed the default instances of the file yet.
+  EXPECT_TRUE(lazy_defaults::TestLazyDefaults::internal_default_instance() ==
+              NULL);
+  EXPECT_TRUE(
+      lazy_defaults::TestLazyDefaultsChild::internal_default_instance() ==
+      NULL);
+
+  // A message can be used before they exist.
+  lazy_defaults::TestLazyDefaults message;
+  message.set_optional_int32(1);
+  message.set_optional_string("foo");
+  EXPECT_EQ("foo", message.optional_string());
+  message.clear_optional_string();
+  EXPECT_EQ("hello", message.optional_string());
+
+  // All of the file's default instances are built when the first is needed.
+  const lazy_defaults::TestLazyDefaults& default_instance =
+      lazy_defaults::TestLazyDefaults::default_instance();
+  EXPECT_EQ(&default_instance,
+            lazy_defaults::TestLazyDefaults::internal_default_instance());
+  EXPECT_EQ(&lazy_defaults::TestLazyDefaultsChild::default_instance(),
+            lazy_defaults::TestLazyDefaultsChild::internal_default_instance());
+}
+
+TEST(LazyDefaultInstancesTest, Defaults) {
+  lazy_defaults::TestLazyDefaults message;
+
+  EXPECT_EQ(41, message.optional_int32());
+  EXPECT_EQ("hello", message.optional_string());
+  EXPECT_EQ("world", message.optional_bytes());
+  EXPECT_EQ("nested", message.optional_nested_message().name());
+  EXPECT_EQ(42, message.optional_child().value());
+  EXPECT_EQ(42, message.optional_lazy_child().value());
+  EXPECT_EQ(0, message.optional_foreign_message().c());
+  EXPECT_EQ("oneof", message.oneof_string());
+  EXPECT_EQ("nested", message.oneof_nested_message().name());
+
+  // Unset sub-messages are the default instances of their types, both of
+  // this file and of others.
+  EXPECT_EQ(&lazy_defaults::TestLazyDefaults::NestedMessage::default_instance(),
+            &message.optional_nested_message());
+  EXPECT_EQ(&lazy_defaults::TestLazyDefaultsChild::default_instance(),
+            &message.optional_child());
+  EXPECT_EQ(&lazy_defaults::TestLazyDefaults::default_instance(),
+            &message.optional_child().parent());
+  EXPECT_EQ(&unittest::ForeignMessage::default_instance(),
+            &message.optional_foreign_message());
+}
+
+TEST(LazyDefaultInstancesTest, CopyAndParse) {
+  lazy_defaults::TestLazyDefaults message;
+  message.set_optional_string("foo");
+  message.mutable_optional_child()->mutable_parent()->set_optional_int32(1);
+  message.mutable_optional_lazy_child()->set_value(2);
+  message.mutable_optional_foreign_message()->set_c(3);
+  message.add_repeated_child()->set_value(4);
+  message.mutable_oneof_nested_message()->set_name("bar");
+
+  lazy_defaults::TestLazyDefaults parsed;
+  ASSERT_TRUE(parsed.ParseFromString(message.SerializeAsString()));
+  EXPECT_EQ(message.SerializeAsString(), parsed.SerializeAsString());
+
+  lazy_defaults::TestLazyDefaults copy(parsed);
+  EXPECT_EQ("foo", copy.optional_string());
+  EXPECT_EQ(1, copy.optional_child().parent().optional_int32());
+  EXPECT_EQ(2, copy.optional_lazy_child().value());
+  EXPECT_EQ(3, copy.optional_foreign_message().c());
+  EXPECT_EQ(4, copy.repeated_child(0).value());
+  EXPECT_EQ("bar", copy.oneof_nested_message().name());
+
+  copy.Clear();
+  EXPECT_EQ("hello", copy.optional_string());
+  EXPECT_EQ(0, copy.repeated_child_size());
+  EXPECT_EQ(lazy_defaults::TestLazyDefaults::ONEOF_FIELD_NOT_SET,
+            copy.oneof_field_case());
+}
+
+#ifndef PROTOBUF_TEST_NO_DESCRIPTORS
+
+TEST(LazyDefaultInstancesTest, Reflection) {
+  const Descriptor* descriptor =
+      lazy_defaults::TestLazyDefaults::descriptor();
+  EXPECT_EQ(&lazy_defaults::TestLazyDefaults::default_instance(),
+            MessageFactory::generated_factory()->GetPrototype(descriptor));
+
+  lazy_defaults::TestLazyDefaults message;
+  const Reflection* reflection = message.GetReflection();
+  EXPECT_EQ("hello", reflection->GetString(
+      message, descriptor->FindFieldByName("optional_string")));
+  EXPECT_EQ(&lazy_defaults::TestLazyDefaultsChild::default_instance(),
+            &reflection->GetMessage(
+                message, descriptor->FindFieldByName("optional_child")));
+  EXPECT_EQ("oneof", reflection->GetString(
+      message, descriptor->FindFieldByName("oneof_string")));
+
+  reflection->SetString(
+      &message, descriptor->FindFieldByName("optional_string"), "foo");
+  EXPECT_EQ("foo", message.optional_string());
+}
+
+TEST(LazyDefaultInstancesTest, OnlyWithoutExtensions) {
+  Options options;
+  options.lazy_default_instances = true;
+  EXPECT_TRUE(LazyDefaultInstances(
+      lazy_defaults::TestLazyDefaults::descriptor()->file(), options));
+  // Registering extensions needs the default instances at static
+  // initialization time.
+  EXPECT_FALSE(LazyDefaultInstances(
+      unittest::TestAllTypes::descriptor()->file(), options));
+  EXPECT_FALSE(LazyDefaultInstances(
+      lazy_defaults::TestLazyDefaults::descriptor()->file(), Options()));
+}
+
+#endif  // !PROTOBUF_TEST_NO_DESCRIPTORS
+
+
 // ===================================================================
 
 #ifndef PROTOBUF_TEST_NO_DESCRIPTORS
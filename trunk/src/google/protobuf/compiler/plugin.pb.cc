@@ -225,6 +225,14 @@ CodeGeneratorRequest* CodeGeneratorRequest::New() const {
   return new CodeGeneratorRequest;
 }
 
+CodeGeneratorRequest* CodeGeneratorRequest::New(::google::protobuf::Arena* arena) const {
+  CodeGeneratorRequest* n = new CodeGeneratorRequest;
+  if (arena != NULL) {
+    arena->Own(n);
+  }
+  return n;
+}
+
 void CodeGeneratorRequest::Clear() {
   if (has_parameter()) {
     if (parameter_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
@@ -394,6 +402,58 @@ void CodeGeneratorRequest::SerializeWithCachedSizes(
   return target;
 }
 
+void CodeGeneratorRequest::SerializeBackward(
+    ::google::protobuf::io::BackwardOutputBuffer* buffer) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::PrependUnknownFields(
+        unknown_fields(), buffer);
+  }
+
+  // repeated .google.protobuf.FileDescriptorProto proto_file = 15;
+  for (int i = this->proto_file_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      PrependMessageNoVirtual(15, this->proto_file(i), buffer);
+  }
+
+  // optional string parameter = 2;
+  if (has_parameter()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::StringSize(
+          this->parameter());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
+        this->parameter().data(), this->parameter().length(),
+        ::google::protobuf::internal::WireFormat::SERIALIZE,
+        "parameter");
+      target =
+        ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
+          2, this->parameter(), target);
+    }
+  }
+
+  // repeated string file_to_generate = 1;
+  {
+    int total_size = 0;
+    total_size += 1 * this->file_to_generate_size();
+    for (int i = 0; i < this->file_to_generate_size(); i++) {
+      total_size += ::google::protobuf::internal::WireFormatLite::StringSize(
+        this->file_to_generate(i));
+    }
+    ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+    for (int i = 0; i < this->file_to_generate_size(); i++) {
+      ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
+        this->file_to_generate(i).data(), this->file_to_generate(i).length(),
+        ::google::protobuf::internal::WireFormat::SERIALIZE,
+        "file_to_generate");
+      target = ::google::protobuf::internal::WireFormatLite::
+        WriteStringToArray(1, this->file_to_generate(i), target);
+    }
+  }
+
+}
+
 int CodeGeneratorRequest::ByteSize() const {
   int total_size = 0;
 
@@ -567,6 +627,14 @@ CodeGeneratorResponse_File* CodeGeneratorResponse_File::New() const {
   return new CodeGeneratorResponse_File;
 }
 
+CodeGeneratorResponse_File* CodeGeneratorResponse_File::New(::google::protobuf::Arena* arena) const {
+  CodeGeneratorResponse_File* n = new CodeGeneratorResponse_File;
+  if (arena != NULL) {
+    arena->Own(n);
+  }
+  return n;
+}
+
 void CodeGeneratorResponse_File::Clear() {
   if (_has_bits_[0 / 32] & 7) {
     if (has_name()) {
@@ -755,6 +823,69 @@ void CodeGeneratorResponse_File::SerializeWithCachedSizes(
   return target;
 }
 
+void CodeGeneratorResponse_File::SerializeBackward(
+    ::google::protobuf::io::BackwardOutputBuffer* buffer) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::PrependUnknownFields(
+        unknown_fields(), buffer);
+  }
+
+  // optional string content = 15;
+  if (has_content()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::StringSize(
+          this->content());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
+        this->content().data(), this->content().length(),
+        ::google::protobuf::internal::WireFormat::SERIALIZE,
+        "content");
+      target =
+        ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
+          15, this->content(), target);
+    }
+  }
+
+  // optional string insertion_point = 2;
+  if (has_insertion_point()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::StringSize(
+          this->insertion_point());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
+        this->insertion_point().data(), this->insertion_point().length(),
+        ::google::protobuf::internal::WireFormat::SERIALIZE,
+        "insertion_point");
+      target =
+        ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
+          2, this->insertion_point(), target);
+    }
+  }
+
+  // optional string name = 1;
+  if (has_name()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::StringSize(
+          this->name());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
+        this->name().data(), this->name().length(),
+        ::google::protobuf::internal::WireFormat::SERIALIZE,
+        "name");
+      target =
+        ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
+          1, this->name(), target);
+    }
+  }
+
+}
+
 int CodeGeneratorResponse_File::ByteSize() const {
   int total_size = 0;
 
@@ -921,6 +1052,14 @@ CodeGeneratorResponse* CodeGeneratorResponse::New() const {
   return new CodeGeneratorResponse;
 }
 
+CodeGeneratorResponse* CodeGeneratorResponse::New(::google::protobuf::Arena* arena) const {
+  CodeGeneratorResponse* n = new CodeGeneratorResponse;
+  if (arena != NULL) {
+    arena->Own(n);
+  }
+  return n;
+}
+
 void CodeGeneratorResponse::Clear() {
   if (has_error()) {
     if (error_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
@@ -1049,6 +1188,39 @@ void CodeGeneratorResponse::SerializeWithCachedSizes(
   return target;
 }
 
+void CodeGeneratorResponse::SerializeBackward(
+    ::google::protobuf::io::BackwardOutputBuffer* buffer) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::PrependUnknownFields(
+        unknown_fields(), buffer);
+  }
+
+  // repeated .google.protobuf.compiler.CodeGeneratorResponse.File file = 15;
+  for (int i = this->file_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      PrependMessageNoVirtual(15, this->file(i), buffer);
+  }
+
+  // optional string error = 1;
+  if (has_error()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::StringSize(
+          this->error());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
+        this->error().data(), this->error().length(),
+        ::google::protobuf::internal::WireFormat::SERIALIZE,
+        "error");
+      target =
+        ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
+          1, this->error(), target);
+    }
+  }
+
+}
+
 int CodeGeneratorResponse::ByteSize() const {
   int total_size = 0;
 
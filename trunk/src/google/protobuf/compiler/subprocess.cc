@@ -37,12 +37,14 @@
 
 #ifndef _WIN32
 #include <errno.h>
+#include <fcntl.h>
 #include <sys/select.h>
 #include <sys/wait.h>
 #include <signal.h>
 #endif
 
 #include <google/protobuf/stubs/common.h>
+#include <google/protobuf/stubs/once.h>
 #include <google/protobuf/message.h>
 #include <google/protobuf/stubs/substitute.h>
 
@@ -50,6 +52,34 @@ namespace google {
 namespace protobuf {
 namespace compiler {
 
+namespace {
+
+// protoc --jobs may run several plugins at once.  Children are started one at
+// a time under this lock, so that no child inherits the pipes of another
+// child which is being started concurrently (which could keep that child from
+// ever seeing EOF on its stdin).  On POSIX it also guards the process-wide
+// SIGPIPE handler.
+Mutex* subprocess_mutex_ = NULL;
+GOOGLE_PROTOBUF_DECLARE_ONCE(subprocess_mutex_once_);
+
+void DeleteSubprocessMutex() {
+  delete subprocess_mutex_;
+  subprocess_mutex_ = NULL;
+}
+
+void InitSubprocessMutex() {
+  subprocess_mutex_ = new Mutex;
+  internal::OnShutdown(&DeleteSubprocessMutex);
+}
+
+Mutex* SubprocessMutex() {
+  ::google::protobuf::GoogleOnceInit(&subprocess_mutex_once_,
+                                     &InitSubprocessMutex);
+  return subprocess_mutex_;
+}
+
+}  // namespace
+
 #ifdef _WIN32
 
 static void CloseHandleOrDie(HANDLE handle) {
@@ -73,6 +103,8 @@ Subprocess::~Subprocess() {
 }
 
 void Subprocess::Start(const string& program, SearchMode search_mode) {
+  MutexLock lock(SubprocessMutex());
+
   // Create the pipes.
   HANDLE stdin_pipe_read;
   HANDLE stdin_pipe_write;
@@ -275,6 +307,18 @@ string Subprocess::Win32ErrorMessage(DWORD error_code) {
 
 #else  // _WIN32
 
+namespace {
+
+// The "sighandler_t" typedef is GNU-specific, so define our own.
+typedef void SignalHandler(int);
+
+// The number of Communicate() calls in progress, and the SIGPIPE handler from
+// before the first of them started.  Guarded by SubprocessMutex().
+int communicating_count_ = 0;
+SignalHandler* old_pipe_handler_ = NULL;
+
+}  // namespace
+
 Subprocess::Subprocess()
     : child_pid_(-1), child_stdin_(-1), child_stdout_(-1) {}
 
@@ -288,8 +332,10 @@ Subprocess::~Subprocess() {
 }
 
 void Subprocess::Start(const string& program, SearchMode search_mode) {
-  // Note that we assume that there are no other threads, thus we don't have to
-  // do crazy stuff like using socket pairs or avoiding libc locks.
+  // Note that the child only calls async-signal-safe functions between fork()
+  // and exec(), so other threads are harmless, as long as they don't fork at
+  // the same time; see SubprocessMutex().
+  MutexLock lock(SubprocessMutex());
 
   // [0] is read end, [1] is write end.
   int stdin_pipe[2];
@@ -298,6 +344,10 @@ void Subprocess::Start(const string& program, SearchMode search_mode) {
   GOOGLE_CHECK(pipe(stdin_pipe) != -1);
   GOOGLE_CHECK(pipe(stdout_pipe) != -1);
 
+  // Our ends of the pipes must not leak into children started later.
+  GOOGLE_CHECK(fcntl(stdin_pipe[1], F_SETFD, FD_CLOEXEC) != -1);
+  GOOGLE_CHECK(fcntl(stdout_pipe[0], F_SETFD, FD_CLOEXEC) != -1);
+
   char* argv[2] = { strdup(program.c_str()), NULL };
 
   child_pid_ = fork();
@@ -349,11 +399,14 @@ bool Subprocess::Communicate(const Message& input, Message* output,
 
   GOOGLE_CHECK_NE(child_stdin_, -1) << "Must call Start() first.";
 
-  // The "sighandler_t" typedef is GNU-specific, so define our own.
-  typedef void SignalHandler(int);
-
   // Make sure SIGPIPE is disabled so that if the child dies it doesn't kill us.
-  SignalHandler* old_pipe_handler = signal(SIGPIPE, SIG_IGN);
+  // The first of any concurrent calls disables it and the last restores it.
+  {
+    MutexLock lock(SubprocessMutex());
+    if (communicating_count_++ == 0) {
+      old_pipe_handler_ = signal(SIGPIPE, SIG_IGN);
+    }
+  }
 
   string input_data = input.SerializeAsString();
   string output_data;
@@ -429,7 +482,12 @@ bool Subprocess::Communicate(const Message& input, Message* output,
   }
 
   // Restore SIGPIPE handling.
-  signal(SIGPIPE, old_pipe_handler);
+  {
+    MutexLock lock(SubprocessMutex());
+    if (--communicating_count_ == 0) {
+      signal(SIGPIPE, old_pipe_handler_);
+    }
+  }
 
   if (WIFEXITED(status)) {
     if (WEXITSTATUS(status) != 0) {
@@ -54,6 +54,7 @@
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 #include <google/protobuf/stubs/common.h>
 #include <google/protobuf/stubs/once.h>
+#include <google/protobuf/stubs/published_map.h>
 #include <google/protobuf/stubs/strutil.h>
 #include <google/protobuf/stubs/substitute.h>
 #include <google/protobuf/stubs/map_util.h>
@@ -314,6 +315,24 @@ typedef hash_map<const char*, const FileDescriptor*,
 typedef hash_map<PointerStringPair, const FieldDescriptor*,
                  PointerStringPairHash, PointerStringPairEqual>
   FieldsByNameMap;
+
+// hash<const char*> is not usable on every platform (see hash.h), so the
+// lock-free maps below hash names themselves.
+struct CStringHash {
+  inline size_t operator()(const char* str) const {
+    size_t result = 0;
+    for (; *str != '\0'; str++) {
+      result = 5 * result + *str;
+    }
+    return result;
+  }
+};
+
+typedef internal::PublishedMap<const char*, Symbol, CStringHash, streq>
+  PublishedSymbolsMap;
+typedef internal::PublishedMap<const char*, const FileDescriptor*,
+                               CStringHash, streq>
+  PublishedFilesMap;
 typedef hash_map<DescriptorIntPair, const FieldDescriptor*,
                  PointerIntegerPairHash<DescriptorIntPair> >
   FieldsByNumberMap;
@@ -396,6 +415,14 @@ class DescriptorPool::Tables {
   // set of extensions numbers from fallback_database_.
   hash_set<const Descriptor*> extensions_loaded_from_db_;
 
+  // Copies of symbols_by_name_ and files_by_name_ which can be read without
+  // locking.  Symbols and files are added to them once the build which added
+  // them can no longer be rolled back.  Only pools with a mutex -- i.e. those
+  // with a fallback database -- create them, since lookups in other pools
+  // don't lock anyway.
+  scoped_ptr<PublishedSymbolsMap> published_symbols_;
+  scoped_ptr<PublishedFilesMap> published_files_;
+
   // -----------------------------------------------------------------
   // Finding items.
 
@@ -617,6 +644,20 @@ void DescriptorPool::Tables::ClearLastCheckpoint() {
   if (checkpoints_.empty()) {
     // All checkpoints have been cleared: we can now commit all of the pending
     // data.
+    if (published_symbols_ != NULL) {
+      for (int i = 0; i < symbols_after_checkpoint_.size(); i++) {
+        published_symbols_->Insert(
+            symbols_after_checkpoint_[i],
+            FindOrDie(symbols_by_name_, symbols_after_checkpoint_[i]));
+      }
+    }
+    if (published_files_ != NULL) {
+      for (int i = 0; i < files_after_checkpoint_.size(); i++) {
+        published_files_->Insert(
+            files_after_checkpoint_[i],
+            FindOrDie(files_by_name_, files_after_checkpoint_[i]));
+      }
+    }
     symbols_after_checkpoint_.clear();
     files_after_checkpoint_.clear();
     extensions_after_checkpoint_.clear();
@@ -701,6 +742,11 @@ inline Symbol FileDescriptorTables::FindNestedSymbolOfType(
 
 Symbol DescriptorPool::Tables::FindByNameHelper(
     const DescriptorPool* pool, const string& name) {
+  if (published_symbols_ != NULL) {
+    const Symbol* published = published_symbols_->Find(name.c_str());
+    if (published != NULL) return *published;
+  }
+
   MutexLockMaybe lock(pool->mutex_);
   known_bad_symbols_.clear();
   known_bad_files_.clear();
@@ -915,6 +961,10 @@ DescriptorPool::DescriptorPool(DescriptorDatabase* fallback_database,
     enforce_dependencies_(true),
     allow_unknown_(false),
     enforce_weak_(false) {
+  // Everything found in the fallback database is published, so that finding
+  // it again does not lock.
+  tables_->published_symbols_.reset(new PublishedSymbolsMap);
+  tables_->published_files_.reset(new PublishedFilesMap);
 }
 
 DescriptorPool::DescriptorPool(const DescriptorPool* underlay)
@@ -1026,6 +1076,12 @@ void DescriptorPool::InternalAddGeneratedFile(
 //   there's nothing more important to do (read: never).
 
 const FileDescriptor* DescriptorPool::FindFileByName(const string& name) const {
+  if (tables_->published_files_ != NULL) {
+    const FileDescriptor* const* published =
+        tables_->published_files_->Find(name.c_str());
+    if (published != NULL) return *published;
+  }
+
   MutexLockMaybe lock(mutex_);
   tables_->known_bad_symbols_.clear();
   tables_->known_bad_files_.clear();
@@ -1044,6 +1100,12 @@ const FileDescriptor* DescriptorPool::FindFileByName(const string& name) const {
 
 const FileDescriptor* DescriptorPool::FindFileContainingSymbol(
     const string& symbol_name) const {
+  if (tables_->published_symbols_ != NULL) {
+    const Symbol* published =
+        tables_->published_symbols_->Find(symbol_name.c_str());
+    if (published != NULL) return published->GetFile();
+  }
+
   MutexLockMaybe lock(mutex_);
   tables_->known_bad_symbols_.clear();
   tables_->known_bad_files_.clear();
@@ -4512,6 +4574,16 @@ void DescriptorBuilder::ValidateFieldOptions(FieldDescriptor* field,
     }
   }
 
+  // Only repeated fields have an inline capacity.
+  if (field->options().has_inline_capacity() &&
+      (!field->is_repeated() || field->options().inline_capacity() < 0)) {
+    AddError(
+      field->full_name(), proto,
+      DescriptorPool::ErrorCollector::TYPE,
+      "[inline_capacity] can only be specified for repeated fields, and "
+      "cannot be negative.");
+  }
+
   // Only repeated primitive fields may be packed.
   if (field->options().packed() && !field->is_packable()) {
     AddError(
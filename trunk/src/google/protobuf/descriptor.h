@@ -1179,10 +1179,13 @@ class LIBPROTOBUF_EXPORT DescriptorPool {
   // - The Find*By*() methods may block the calling thread if the
   //   DescriptorDatabase blocks.  This in turn means that parsing messages
   //   may block if they need to look up extensions.
-  // - The Find*By*() methods will use mutexes for thread-safety, thus making
-  //   them slower even when they don't have to fall back to the database.
-  //   In fact, even the Find*By*() methods of descriptor objects owned by
-  //   this pool will be slower, since they will have to obtain locks too.
+  // - The Find*By*() methods use a mutex for thread-safety whenever they
+  //   might have to fall back to the database.  FindFileByName(),
+  //   FindFileContainingSymbol() and the Find*ByName() methods don't lock
+  //   when what they are looking for has already been loaded; the other
+  //   methods, and lookups of names which aren't loaded yet, always lock.
+  //   The Find*By*() methods of descriptor objects owned by this pool may
+  //   have to obtain the lock too.
   // - An ErrorCollector may optionally be given to collect validation errors
   //   in files loaded from the database.  If not given, errors will be printed
   //   to GOOGLE_LOG(ERROR).  Remember that files are built on-demand, so this
@@ -1416,7 +1419,8 @@ class LIBPROTOBUF_EXPORT DescriptorPool {
     const FileDescriptorProto& proto) const;
 
   // If fallback_database_ is NULL, this is NULL.  Otherwise, this is a mutex
-  // which must be locked while accessing tables_.
+  // which must be locked while accessing tables_, except for the copies of
+  // its lookup maps which are published to be read without locking.
   Mutex* mutex_;
 
   // See constructor.
@@ -286,7 +286,7 @@ void protobuf_AssignDesc_google_2fprotobuf_2fdescriptor_2eproto() {
       ::google::protobuf::MessageFactory::generated_factory(),
       sizeof(MethodDescriptorProto));
   FileOptions_descriptor_ = file->message_type(9);
-  static const int FileOptions_offsets_[12] = {
+  static const int FileOptions_offsets_[13] = {
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(FileOptions, java_package_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(FileOptions, java_outer_classname_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(FileOptions, java_multiple_files_),
@@ -298,6 +298,7 @@ void protobuf_AssignDesc_google_2fprotobuf_2fdescriptor_2eproto() {
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(FileOptions, java_generic_services_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(FileOptions, py_generic_services_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(FileOptions, deprecated_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(FileOptions, cc_enable_arenas_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(FileOptions, uninterpreted_option_),
   };
   FileOptions_reflection_ =
@@ -331,13 +332,14 @@ void protobuf_AssignDesc_google_2fprotobuf_2fdescriptor_2eproto() {
       ::google::protobuf::MessageFactory::generated_factory(),
       sizeof(MessageOptions));
   FieldOptions_descriptor_ = file->message_type(11);
-  static const int FieldOptions_offsets_[7] = {
+  static const int FieldOptions_offsets_[8] = {
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(FieldOptions, ctype_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(FieldOptions, packed_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(FieldOptions, lazy_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(FieldOptions, deprecated_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(FieldOptions, experimental_map_key_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(FieldOptions, weak_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(FieldOptions, inline_capacity_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(FieldOptions, uninterpreted_option_),
   };
   FieldOptions_reflection_ =
@@ -655,7 +657,7 @@ void protobuf_AddDesc_google_2fprotobuf_2fdescriptor_2eproto() {
     "ethodDescriptorProto\022\014\n\004name\030\001 \001(\t\022\022\n\nin"
     "put_type\030\002 \001(\t\022\023\n\013output_type\030\003 \001(\t\022/\n\007o"
     "ptions\030\004 \001(\0132\036.google.protobuf.MethodOpt"
-    "ions\"\253\004\n\013FileOptions\022\024\n\014java_package\030\001 \001"
+    "ions\"\314\004\n\013FileOptions\022\024\n\014java_package\030\001 \001"
     "(\t\022\034\n\024java_outer_classname\030\010 \001(\t\022\"\n\023java"
     "_multiple_files\030\n \001(\010:\005false\022,\n\035java_gen"
     "erate_equals_and_hash\030\024 \001(\010:\005false\022%\n\026ja"
@@ -665,50 +667,51 @@ void protobuf_AddDesc_google_2fprotobuf_2fdescriptor_2eproto() {
     "\013 \001(\t\022\"\n\023cc_generic_services\030\020 \001(\010:\005fals"
     "e\022$\n\025java_generic_services\030\021 \001(\010:\005false\022"
     "\"\n\023py_generic_services\030\022 \001(\010:\005false\022\031\n\nd"
-    "eprecated\030\027 \001(\010:\005false\022C\n\024uninterpreted_"
-    "option\030\347\007 \003(\0132$.google.protobuf.Uninterp"
-    "retedOption\":\n\014OptimizeMode\022\t\n\005SPEED\020\001\022\r"
-    "\n\tCODE_SIZE\020\002\022\020\n\014LITE_RUNTIME\020\003*\t\010\350\007\020\200\200\200"
-    "\200\002\"\323\001\n\016MessageOptions\022&\n\027message_set_wir"
-    "e_format\030\001 \001(\010:\005false\022.\n\037no_standard_des"
-    "criptor_accessor\030\002 \001(\010:\005false\022\031\n\ndepreca"
-    "ted\030\003 \001(\010:\005false\022C\n\024uninterpreted_option"
-    "\030\347\007 \003(\0132$.google.protobuf.UninterpretedO"
-    "ption*\t\010\350\007\020\200\200\200\200\002\"\276\002\n\014FieldOptions\022:\n\005cty"
-    "pe\030\001 \001(\0162#.google.protobuf.FieldOptions."
-    "CType:\006STRING\022\016\n\006packed\030\002 \001(\010\022\023\n\004lazy\030\005 "
-    "\001(\010:\005false\022\031\n\ndeprecated\030\003 \001(\010:\005false\022\034\n"
-    "\024experimental_map_key\030\t \001(\t\022\023\n\004weak\030\n \001("
-    "\010:\005false\022C\n\024uninterpreted_option\030\347\007 \003(\0132"
-    "$.google.protobuf.UninterpretedOption\"/\n"
-    "\005CType\022\n\n\006STRING\020\000\022\010\n\004CORD\020\001\022\020\n\014STRING_P"
-    "IECE\020\002*\t\010\350\007\020\200\200\200\200\002\"\215\001\n\013EnumOptions\022\023\n\013all"
-    "ow_alias\030\002 \001(\010\022\031\n\ndeprecated\030\003 \001(\010:\005fals"
-    "e\022C\n\024uninterpreted_option\030\347\007 \003(\0132$.googl"
-    "e.protobuf.UninterpretedOption*\t\010\350\007\020\200\200\200\200"
-    "\002\"}\n\020EnumValueOptions\022\031\n\ndeprecated\030\001 \001("
-    "\010:\005false\022C\n\024uninterpreted_option\030\347\007 \003(\0132"
-    "$.google.protobuf.UninterpretedOption*\t\010"
-    "\350\007\020\200\200\200\200\002\"{\n\016ServiceOptions\022\031\n\ndeprecated"
-    "\030! \001(\010:\005false\022C\n\024uninterpreted_option\030\347\007"
-    " \003(\0132$.google.protobuf.UninterpretedOpti"
-    "on*\t\010\350\007\020\200\200\200\200\002\"z\n\rMethodOptions\022\031\n\ndeprec"
-    "ated\030! \001(\010:\005false\022C\n\024uninterpreted_optio"
-    "n\030\347\007 \003(\0132$.google.protobuf.Uninterpreted"
-    "Option*\t\010\350\007\020\200\200\200\200\002\"\236\002\n\023UninterpretedOptio"
-    "n\022;\n\004name\030\002 \003(\0132-.google.protobuf.Uninte"
-    "rpretedOption.NamePart\022\030\n\020identifier_val"
-    "ue\030\003 \001(\t\022\032\n\022positive_int_value\030\004 \001(\004\022\032\n\022"
-    "negative_int_value\030\005 \001(\003\022\024\n\014double_value"
-    "\030\006 \001(\001\022\024\n\014string_value\030\007 \001(\014\022\027\n\017aggregat"
-    "e_value\030\010 \001(\t\0323\n\010NamePart\022\021\n\tname_part\030\001"
-    " \002(\t\022\024\n\014is_extension\030\002 \002(\010\"\261\001\n\016SourceCod"
-    "eInfo\022:\n\010location\030\001 \003(\0132(.google.protobu"
-    "f.SourceCodeInfo.Location\032c\n\010Location\022\020\n"
-    "\004path\030\001 \003(\005B\002\020\001\022\020\n\004span\030\002 \003(\005B\002\020\001\022\030\n\020lea"
-    "ding_comments\030\003 \001(\t\022\031\n\021trailing_comments"
-    "\030\004 \001(\tB)\n\023com.google.protobufB\020Descripto"
-    "rProtosH\001", 4449);
+    "eprecated\030\027 \001(\010:\005false\022\037\n\020cc_enable_aren"
+    "as\030\037 \001(\010:\005false\022C\n\024uninterpreted_option\030"
+    "\347\007 \003(\0132$.google.protobuf.UninterpretedOp"
+    "tion\":\n\014OptimizeMode\022\t\n\005SPEED\020\001\022\r\n\tCODE_"
+    "SIZE\020\002\022\020\n\014LITE_RUNTIME\020\003*\t\010\350\007\020\200\200\200\200\002\"\323\001\n\016"
+    "MessageOptions\022&\n\027message_set_wire_forma"
+    "t\030\001 \001(\010:\005false\022.\n\037no_standard_descriptor"
+    "_accessor\030\002 \001(\010:\005false\022\031\n\ndeprecated\030\003 \001"
+    "(\010:\005false\022C\n\024uninterpreted_option\030\347\007 \003(\013"
+    "2$.google.protobuf.UninterpretedOption*\t"
+    "\010\350\007\020\200\200\200\200\002\"\327\002\n\014FieldOptions\022:\n\005ctype\030\001 \001("
+    "\0162#.google.protobuf.FieldOptions.CType:\006"
+    "STRING\022\016\n\006packed\030\002 \001(\010\022\023\n\004lazy\030\005 \001(\010:\005fa"
+    "lse\022\031\n\ndeprecated\030\003 \001(\010:\005false\022\034\n\024experi"
+    "mental_map_key\030\t \001(\t\022\023\n\004weak\030\n \001(\010:\005fals"
+    "e\022\027\n\017inline_capacity\030\013 \001(\005\022C\n\024uninterpre"
+    "ted_option\030\347\007 \003(\0132$.google.protobuf.Unin"
+    "terpretedOption\"/\n\005CType\022\n\n\006STRING\020\000\022\010\n\004"
+    "CORD\020\001\022\020\n\014STRING_PIECE\020\002*\t\010\350\007\020\200\200\200\200\002\"\215\001\n\013"
+    "EnumOptions\022\023\n\013allow_alias\030\002 \001(\010\022\031\n\ndepr"
+    "ecated\030\003 \001(\010:\005false\022C\n\024uninterpreted_opt"
+    "ion\030\347\007 \003(\0132$.google.protobuf.Uninterpret"
+    "edOption*\t\010\350\007\020\200\200\200\200\002\"}\n\020EnumValueOptions\022"
+    "\031\n\ndeprecated\030\001 \001(\010:\005false\022C\n\024uninterpre"
+    "ted_option\030\347\007 \003(\0132$.google.protobuf.Unin"
+    "terpretedOption*\t\010\350\007\020\200\200\200\200\002\"{\n\016ServiceOpt"
+    "ions\022\031\n\ndeprecated\030! \001(\010:\005false\022C\n\024unint"
+    "erpreted_option\030\347\007 \003(\0132$.google.protobuf"
+    ".UninterpretedOption*\t\010\350\007\020\200\200\200\200\002\"z\n\rMetho"
+    "dOptions\022\031\n\ndeprecated\030! \001(\010:\005false\022C\n\024u"
+    "ninterpreted_option\030\347\007 \003(\0132$.google.prot"
+    "obuf.UninterpretedOption*\t\010\350\007\020\200\200\200\200\002\"\236\002\n\023"
+    "UninterpretedOption\022;\n\004name\030\002 \003(\0132-.goog"
+    "le.protobuf.UninterpretedOption.NamePart"
+    "\022\030\n\020identifier_value\030\003 \001(\t\022\032\n\022positive_i"
+    "nt_value\030\004 \001(\004\022\032\n\022negative_int_value\030\005 \001"
+    "(\003\022\024\n\014double_value\030\006 \001(\001\022\024\n\014string_value"
+    "\030\007 \001(\014\022\027\n\017aggregate_value\030\010 \001(\t\0323\n\010NameP"
+    "art\022\021\n\tname_part\030\001 \002(\t\022\024\n\014is_extension\030\002"
+    " \002(\010\"\261\001\n\016SourceCodeInfo\022:\n\010location\030\001 \003("
+    "\0132(.google.protobuf.SourceCodeInfo.Locat"
+    "ion\032c\n\010Location\022\020\n\004path\030\001 \003(\005B\002\020\001\022\020\n\004spa"
+    "n\030\002 \003(\005B\002\020\001\022\030\n\020leading_comments\030\003 \001(\t\022\031\n"
+    "\021trailing_comments\030\004 \001(\tB)\n\023com.google.p"
+    "rotobufB\020DescriptorProtosH\001", 4507);
   ::google::protobuf::MessageFactory::InternalRegisterGeneratedFile(
     "google/protobuf/descriptor.proto", &protobuf_RegisterTypes);
   FileDescriptorSet::default_instance_ = new FileDescriptorSet();
@@ -821,6 +824,14 @@ FileDescriptorSet* FileDescriptorSet::New() const {
   return new FileDescriptorSet;
 }
 
+FileDescriptorSet* FileDescriptorSet::New(::google::protobuf::Arena* arena) const {
+  FileDescriptorSet* n = new FileDescriptorSet;
+  if (arena != NULL) {
+    arena->Own(n);
+  }
+  return n;
+}
+
 void FileDescriptorSet::Clear() {
   file_.Clear();
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
@@ -907,6 +918,21 @@ void FileDescriptorSet::SerializeWithCachedSizes(
   return target;
 }
 
+void FileDescriptorSet::SerializeBackward(
+    ::google::protobuf::io::BackwardOutputBuffer* buffer) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::PrependUnknownFields(
+        unknown_fields(), buffer);
+  }
+
+  // repeated .google.protobuf.FileDescriptorProto file = 1;
+  for (int i = this->file_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      PrependMessageNoVirtual(1, this->file(i), buffer);
+  }
+
+}
+
 int FileDescriptorSet::ByteSize() const {
   int total_size = 0;
 
@@ -1066,6 +1092,14 @@ FileDescriptorProto* FileDescriptorProto::New() const {
   return new FileDescriptorProto;
 }
 
+FileDescriptorProto* FileDescriptorProto::New(::google::protobuf::Arena* arena) const {
+  FileDescriptorProto* n = new FileDescriptorProto;
+  if (arena != NULL) {
+    arena->Own(n);
+  }
+  return n;
+}
+
 void FileDescriptorProto::Clear() {
   if (_has_bits_[0 / 32] & 3) {
     if (has_name()) {
@@ -1487,6 +1521,142 @@ void FileDescriptorProto::SerializeWithCachedSizes(
   return target;
 }
 
+void FileDescriptorProto::SerializeBackward(
+    ::google::protobuf::io::BackwardOutputBuffer* buffer) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::PrependUnknownFields(
+        unknown_fields(), buffer);
+  }
+
+  // repeated int32 weak_dependency = 11;
+  {
+    int total_size = 0;
+    {
+      int data_size = 0;
+      for (int i = 0; i < this->weak_dependency_size(); i++) {
+        data_size += ::google::protobuf::internal::WireFormatLite::
+          Int32Size(this->weak_dependency(i));
+      }
+      total_size += 1 * this->weak_dependency_size() + data_size;
+    }
+    ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+    for (int i = 0; i < this->weak_dependency_size(); i++) {
+      target = ::google::protobuf::internal::WireFormatLite::
+        WriteInt32ToArray(11, this->weak_dependency(i), target);
+    }
+  }
+
+  // repeated int32 public_dependency = 10;
+  {
+    int total_size = 0;
+    {
+      int data_size = 0;
+      for (int i = 0; i < this->public_dependency_size(); i++) {
+        data_size += ::google::protobuf::internal::WireFormatLite::
+          Int32Size(this->public_dependency(i));
+      }
+      total_size += 1 * this->public_dependency_size() + data_size;
+    }
+    ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+    for (int i = 0; i < this->public_dependency_size(); i++) {
+      target = ::google::protobuf::internal::WireFormatLite::
+        WriteInt32ToArray(10, this->public_dependency(i), target);
+    }
+  }
+
+  // optional .google.protobuf.SourceCodeInfo source_code_info = 9;
+  if (has_source_code_info()) {
+    ::google::protobuf::internal::WireFormatLite::
+      PrependMessageNoVirtual(9, this->source_code_info(), buffer);
+  }
+
+  // optional .google.protobuf.FileOptions options = 8;
+  if (has_options()) {
+    ::google::protobuf::internal::WireFormatLite::
+      PrependMessageNoVirtual(8, this->options(), buffer);
+  }
+
+  // repeated .google.protobuf.FieldDescriptorProto extension = 7;
+  for (int i = this->extension_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      PrependMessageNoVirtual(7, this->extension(i), buffer);
+  }
+
+  // repeated .google.protobuf.ServiceDescriptorProto service = 6;
+  for (int i = this->service_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      PrependMessageNoVirtual(6, this->service(i), buffer);
+  }
+
+  // repeated .google.protobuf.EnumDescriptorProto enum_type = 5;
+  for (int i = this->enum_type_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      PrependMessageNoVirtual(5, this->enum_type(i), buffer);
+  }
+
+  // repeated .google.protobuf.DescriptorProto message_type = 4;
+  for (int i = this->message_type_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      PrependMessageNoVirtual(4, this->message_type(i), buffer);
+  }
+
+  // repeated string dependency = 3;
+  {
+    int total_size = 0;
+    total_size += 1 * this->dependency_size();
+    for (int i = 0; i < this->dependency_size(); i++) {
+      total_size += ::google::protobuf::internal::WireFormatLite::StringSize(
+        this->dependency(i));
+    }
+    ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+    for (int i = 0; i < this->dependency_size(); i++) {
+      ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
+        this->dependency(i).data(), this->dependency(i).length(),
+        ::google::protobuf::internal::WireFormat::SERIALIZE,
+        "dependency");
+      target = ::google::protobuf::internal::WireFormatLite::
+        WriteStringToArray(3, this->dependency(i), target);
+    }
+  }
+
+  // optional string package = 2;
+  if (has_package()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::StringSize(
+          this->package());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
+        this->package().data(), this->package().length(),
+        ::google::protobuf::internal::WireFormat::SERIALIZE,
+        "package");
+      target =
+        ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
+          2, this->package(), target);
+    }
+  }
+
+  // optional string name = 1;
+  if (has_name()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::StringSize(
+          this->name());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
+        this->name().data(), this->name().length(),
+        ::google::protobuf::internal::WireFormat::SERIALIZE,
+        "name");
+      target =
+        ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
+          1, this->name(), target);
+    }
+  }
+
+}
+
 int FileDescriptorProto::ByteSize() const {
   int total_size = 0;
 
@@ -1745,6 +1915,14 @@ DescriptorProto_ExtensionRange* DescriptorProto_ExtensionRange::New() const {
   return new DescriptorProto_ExtensionRange;
 }
 
+DescriptorProto_ExtensionRange* DescriptorProto_ExtensionRange::New(::google::protobuf::Arena* arena) const {
+  DescriptorProto_ExtensionRange* n = new DescriptorProto_ExtensionRange;
+  if (arena != NULL) {
+    arena->Own(n);
+  }
+  return n;
+}
+
 void DescriptorProto_ExtensionRange::Clear() {
 #define OFFSET_OF_FIELD_(f) (reinterpret_cast<char*>(      \
   &reinterpret_cast<DescriptorProto_ExtensionRange*>(16)->f) - \
@@ -1867,6 +2045,39 @@ void DescriptorProto_ExtensionRange::SerializeWithCachedSizes(
   return target;
 }
 
+void DescriptorProto_ExtensionRange::SerializeBackward(
+    ::google::protobuf::io::BackwardOutputBuffer* buffer) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::PrependUnknownFields(
+        unknown_fields(), buffer);
+  }
+
+  // optional int32 end = 2;
+  if (has_end()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::Int32Size(
+          this->end());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      target = ::google::protobuf::internal::WireFormatLite::WriteInt32ToArray(2, this->end(), target);
+    }
+  }
+
+  // optional int32 start = 1;
+  if (has_start()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::Int32Size(
+          this->start());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      target = ::google::protobuf::internal::WireFormatLite::WriteInt32ToArray(1, this->start(), target);
+    }
+  }
+
+}
+
 int DescriptorProto_ExtensionRange::ByteSize() const {
   int total_size = 0;
 
@@ -2031,6 +2242,14 @@ DescriptorProto* DescriptorProto::New() const {
   return new DescriptorProto;
 }
 
+DescriptorProto* DescriptorProto::New(::google::protobuf::Arena* arena) const {
+  DescriptorProto* n = new DescriptorProto;
+  if (arena != NULL) {
+    arena->Own(n);
+  }
+  return n;
+}
+
 void DescriptorProto::Clear() {
   if (_has_bits_[0 / 32] & 129) {
     if (has_name()) {
@@ -2330,6 +2549,75 @@ void DescriptorProto::SerializeWithCachedSizes(
   return target;
 }
 
+void DescriptorProto::SerializeBackward(
+    ::google::protobuf::io::BackwardOutputBuffer* buffer) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::PrependUnknownFields(
+        unknown_fields(), buffer);
+  }
+
+  // repeated .google.protobuf.OneofDescriptorProto oneof_decl = 8;
+  for (int i = this->oneof_decl_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      PrependMessageNoVirtual(8, this->oneof_decl(i), buffer);
+  }
+
+  // optional .google.protobuf.MessageOptions options = 7;
+  if (has_options()) {
+    ::google::protobuf::internal::WireFormatLite::
+      PrependMessageNoVirtual(7, this->options(), buffer);
+  }
+
+  // repeated .google.protobuf.FieldDescriptorProto extension = 6;
+  for (int i = this->extension_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      PrependMessageNoVirtual(6, this->extension(i), buffer);
+  }
+
+  // repeated .google.protobuf.DescriptorProto.ExtensionRange extension_range = 5;
+  for (int i = this->extension_range_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      PrependMessageNoVirtual(5, this->extension_range(i), buffer);
+  }
+
+  // repeated .google.protobuf.EnumDescriptorProto enum_type = 4;
+  for (int i = this->enum_type_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      PrependMessageNoVirtual(4, this->enum_type(i), buffer);
+  }
+
+  // repeated .google.protobuf.DescriptorProto nested_type = 3;
+  for (int i = this->nested_type_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      PrependMessageNoVirtual(3, this->nested_type(i), buffer);
+  }
+
+  // repeated .google.protobuf.FieldDescriptorProto field = 2;
+  for (int i = this->field_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      PrependMessageNoVirtual(2, this->field(i), buffer);
+  }
+
+  // optional string name = 1;
+  if (has_name()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::StringSize(
+          this->name());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
+        this->name().data(), this->name().length(),
+        ::google::protobuf::internal::WireFormat::SERIALIZE,
+        "name");
+      target =
+        ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
+          1, this->name(), target);
+    }
+  }
+
+}
+
 int DescriptorProto::ByteSize() const {
   int total_size = 0;
 
@@ -2654,6 +2942,14 @@ FieldDescriptorProto* FieldDescriptorProto::New() const {
   return new FieldDescriptorProto;
 }
 
+FieldDescriptorProto* FieldDescriptorProto::New(::google::protobuf::Arena* arena) const {
+  FieldDescriptorProto* n = new FieldDescriptorProto;
+  if (arena != NULL) {
+    arena->Own(n);
+  }
+  return n;
+}
+
 void FieldDescriptorProto::Clear() {
   if (_has_bits_[0 / 32] & 255) {
     if (has_name()) {
@@ -3032,6 +3328,141 @@ void FieldDescriptorProto::SerializeWithCachedSizes(
   return target;
 }
 
+void FieldDescriptorProto::SerializeBackward(
+    ::google::protobuf::io::BackwardOutputBuffer* buffer) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::PrependUnknownFields(
+        unknown_fields(), buffer);
+  }
+
+  // optional int32 oneof_index = 9;
+  if (has_oneof_index()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::Int32Size(
+          this->oneof_index());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      target = ::google::protobuf::internal::WireFormatLite::WriteInt32ToArray(9, this->oneof_index(), target);
+    }
+  }
+
+  // optional .google.protobuf.FieldOptions options = 8;
+  if (has_options()) {
+    ::google::protobuf::internal::WireFormatLite::
+      PrependMessageNoVirtual(8, this->options(), buffer);
+  }
+
+  // optional string default_value = 7;
+  if (has_default_value()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::StringSize(
+          this->default_value());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
+        this->default_value().data(), this->default_value().length(),
+        ::google::protobuf::internal::WireFormat::SERIALIZE,
+        "default_value");
+      target =
+        ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
+          7, this->default_value(), target);
+    }
+  }
+
+  // optional string type_name = 6;
+  if (has_type_name()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::StringSize(
+          this->type_name());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
+        this->type_name().data(), this->type_name().length(),
+        ::google::protobuf::internal::WireFormat::SERIALIZE,
+        "type_name");
+      target =
+        ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
+          6, this->type_name(), target);
+    }
+  }
+
+  // optional .google.protobuf.FieldDescriptorProto.Type type = 5;
+  if (has_type()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::EnumSize(this->type());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      target = ::google::protobuf::internal::WireFormatLite::WriteEnumToArray(
+        5, this->type(), target);
+    }
+  }
+
+  // optional .google.protobuf.FieldDescriptorProto.Label label = 4;
+  if (has_label()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::EnumSize(this->label());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      target = ::google::protobuf::internal::WireFormatLite::WriteEnumToArray(
+        4, this->label(), target);
+    }
+  }
+
+  // optional int32 number = 3;
+  if (has_number()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::Int32Size(
+          this->number());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      target = ::google::protobuf::internal::WireFormatLite::WriteInt32ToArray(3, this->number(), target);
+    }
+  }
+
+  // optional string extendee = 2;
+  if (has_extendee()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::StringSize(
+          this->extendee());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
+        this->extendee().data(), this->extendee().length(),
+        ::google::protobuf::internal::WireFormat::SERIALIZE,
+        "extendee");
+      target =
+        ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
+          2, this->extendee(), target);
+    }
+  }
+
+  // optional string name = 1;
+  if (has_name()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::StringSize(
+          this->name());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
+        this->name().data(), this->name().length(),
+        ::google::protobuf::internal::WireFormat::SERIALIZE,
+        "name");
+      target =
+        ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
+          1, this->name(), target);
+    }
+  }
+
+}
+
 int FieldDescriptorProto::ByteSize() const {
   int total_size = 0;
 
@@ -3268,6 +3699,14 @@ OneofDescriptorProto* OneofDescriptorProto::New() const {
   return new OneofDescriptorProto;
 }
 
+OneofDescriptorProto* OneofDescriptorProto::New(::google::protobuf::Arena* arena) const {
+  OneofDescriptorProto* n = new OneofDescriptorProto;
+  if (arena != NULL) {
+    arena->Own(n);
+  }
+  return n;
+}
+
 void OneofDescriptorProto::Clear() {
   if (has_name()) {
     if (name_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
@@ -3368,6 +3807,33 @@ void OneofDescriptorProto::SerializeWithCachedSizes(
   return target;
 }
 
+void OneofDescriptorProto::SerializeBackward(
+    ::google::protobuf::io::BackwardOutputBuffer* buffer) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::PrependUnknownFields(
+        unknown_fields(), buffer);
+  }
+
+  // optional string name = 1;
+  if (has_name()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::StringSize(
+          this->name());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
+        this->name().data(), this->name().length(),
+        ::google::protobuf::internal::WireFormat::SERIALIZE,
+        "name");
+      target =
+        ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
+          1, this->name(), target);
+    }
+  }
+
+}
+
 int OneofDescriptorProto::ByteSize() const {
   int total_size = 0;
 
@@ -3516,6 +3982,14 @@ EnumDescriptorProto* EnumDescriptorProto::New() const {
   return new EnumDescriptorProto;
 }
 
+EnumDescriptorProto* EnumDescriptorProto::New(::google::protobuf::Arena* arena) const {
+  EnumDescriptorProto* n = new EnumDescriptorProto;
+  if (arena != NULL) {
+    arena->Own(n);
+  }
+  return n;
+}
+
 void EnumDescriptorProto::Clear() {
   if (_has_bits_[0 / 32] & 5) {
     if (has_name()) {
@@ -3675,6 +4149,45 @@ void EnumDescriptorProto::SerializeWithCachedSizes(
   return target;
 }
 
+void EnumDescriptorProto::SerializeBackward(
+    ::google::protobuf::io::BackwardOutputBuffer* buffer) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::PrependUnknownFields(
+        unknown_fields(), buffer);
+  }
+
+  // optional .google.protobuf.EnumOptions options = 3;
+  if (has_options()) {
+    ::google::protobuf::internal::WireFormatLite::
+      PrependMessageNoVirtual(3, this->options(), buffer);
+  }
+
+  // repeated .google.protobuf.EnumValueDescriptorProto value = 2;
+  for (int i = this->value_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      PrependMessageNoVirtual(2, this->value(i), buffer);
+  }
+
+  // optional string name = 1;
+  if (has_name()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::StringSize(
+          this->name());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
+        this->name().data(), this->name().length(),
+        ::google::protobuf::internal::WireFormat::SERIALIZE,
+        "name");
+      target =
+        ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
+          1, this->name(), target);
+    }
+  }
+
+}
+
 int EnumDescriptorProto::ByteSize() const {
   int total_size = 0;
 
@@ -3849,6 +4362,14 @@ EnumValueDescriptorProto* EnumValueDescriptorProto::New() const {
   return new EnumValueDescriptorProto;
 }
 
+EnumValueDescriptorProto* EnumValueDescriptorProto::New(::google::protobuf::Arena* arena) const {
+  EnumValueDescriptorProto* n = new EnumValueDescriptorProto;
+  if (arena != NULL) {
+    arena->Own(n);
+  }
+  return n;
+}
+
 void EnumValueDescriptorProto::Clear() {
   if (_has_bits_[0 / 32] & 7) {
     if (has_name()) {
@@ -4006,7 +4527,52 @@ void EnumValueDescriptorProto::SerializeWithCachedSizes(
   return target;
 }
 
-int EnumValueDescriptorProto::ByteSize() const {
+void EnumValueDescriptorProto::SerializeBackward(
+    ::google::protobuf::io::BackwardOutputBuffer* buffer) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::PrependUnknownFields(
+        unknown_fields(), buffer);
+  }
+
+  // optional .google.protobuf.EnumValueOptions options = 3;
+  if (has_options()) {
+    ::google::protobuf::internal::WireFormatLite::
+      PrependMessageNoVirtual(3, this->options(), buffer);
+  }
+
+  // optional int32 number = 2;
+  if (has_number()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::Int32Size(
+          this->number());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      target = ::google::protobuf::internal::WireFormatLite::WriteInt32ToArray(2, this->number(), target);
+    }
+  }
+
+  // optional string name = 1;
+  if (has_name()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::StringSize(
+          this->name());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
+        this->name().data(), this->name().length(),
+        ::google::protobuf::internal::WireFormat::SERIALIZE,
+        "name");
+      target =
+        ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
+          1, this->name(), target);
+    }
+  }
+
+}
+
+int EnumValueDescriptorProto::ByteSize() const {
   int total_size = 0;
 
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
@@ -4179,6 +4745,14 @@ ServiceDescriptorProto* ServiceDescriptorProto::New() const {
   return new ServiceDescriptorProto;
 }
 
+ServiceDescriptorProto* ServiceDescriptorProto::New(::google::protobuf::Arena* arena) const {
+  ServiceDescriptorProto* n = new ServiceDescriptorProto;
+  if (arena != NULL) {
+    arena->Own(n);
+  }
+  return n;
+}
+
 void ServiceDescriptorProto::Clear() {
   if (_has_bits_[0 / 32] & 5) {
     if (has_name()) {
@@ -4338,6 +4912,45 @@ void ServiceDescriptorProto::SerializeWithCachedSizes(
   return target;
 }
 
+void ServiceDescriptorProto::SerializeBackward(
+    ::google::protobuf::io::BackwardOutputBuffer* buffer) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::PrependUnknownFields(
+        unknown_fields(), buffer);
+  }
+
+  // optional .google.protobuf.ServiceOptions options = 3;
+  if (has_options()) {
+    ::google::protobuf::internal::WireFormatLite::
+      PrependMessageNoVirtual(3, this->options(), buffer);
+  }
+
+  // repeated .google.protobuf.MethodDescriptorProto method = 2;
+  for (int i = this->method_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      PrependMessageNoVirtual(2, this->method(i), buffer);
+  }
+
+  // optional string name = 1;
+  if (has_name()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::StringSize(
+          this->name());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
+        this->name().data(), this->name().length(),
+        ::google::protobuf::internal::WireFormat::SERIALIZE,
+        "name");
+      target =
+        ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
+          1, this->name(), target);
+    }
+  }
+
+}
+
 int ServiceDescriptorProto::ByteSize() const {
   int total_size = 0;
 
@@ -4520,6 +5133,14 @@ MethodDescriptorProto* MethodDescriptorProto::New() const {
   return new MethodDescriptorProto;
 }
 
+MethodDescriptorProto* MethodDescriptorProto::New(::google::protobuf::Arena* arena) const {
+  MethodDescriptorProto* n = new MethodDescriptorProto;
+  if (arena != NULL) {
+    arena->Own(n);
+  }
+  return n;
+}
+
 void MethodDescriptorProto::Clear() {
   if (_has_bits_[0 / 32] & 15) {
     if (has_name()) {
@@ -4737,6 +5358,75 @@ void MethodDescriptorProto::SerializeWithCachedSizes(
   return target;
 }
 
+void MethodDescriptorProto::SerializeBackward(
+    ::google::protobuf::io::BackwardOutputBuffer* buffer) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::PrependUnknownFields(
+        unknown_fields(), buffer);
+  }
+
+  // optional .google.protobuf.MethodOptions options = 4;
+  if (has_options()) {
+    ::google::protobuf::internal::WireFormatLite::
+      PrependMessageNoVirtual(4, this->options(), buffer);
+  }
+
+  // optional string output_type = 3;
+  if (has_output_type()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::StringSize(
+          this->output_type());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
+        this->output_type().data(), this->output_type().length(),
+        ::google::protobuf::internal::WireFormat::SERIALIZE,
+        "output_type");
+      target =
+        ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
+          3, this->output_type(), target);
+    }
+  }
+
+  // optional string input_type = 2;
+  if (has_input_type()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::StringSize(
+          this->input_type());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
+        this->input_type().data(), this->input_type().length(),
+        ::google::protobuf::internal::WireFormat::SERIALIZE,
+        "input_type");
+      target =
+        ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
+          2, this->input_type(), target);
+    }
+  }
+
+  // optional string name = 1;
+  if (has_name()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::StringSize(
+          this->name());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
+        this->name().data(), this->name().length(),
+        ::google::protobuf::internal::WireFormat::SERIALIZE,
+        "name");
+      target =
+        ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
+          1, this->name(), target);
+    }
+  }
+
+}
+
 int MethodDescriptorProto::ByteSize() const {
   int total_size = 0;
 
@@ -4890,6 +5580,7 @@ const int FileOptions::kCcGenericServicesFieldNumber;
 const int FileOptions::kJavaGenericServicesFieldNumber;
 const int FileOptions::kPyGenericServicesFieldNumber;
 const int FileOptions::kDeprecatedFieldNumber;
+const int FileOptions::kCcEnableArenasFieldNumber;
 const int FileOptions::kUninterpretedOptionFieldNumber;
 #endif  // !_MSC_VER
 
@@ -4923,6 +5614,7 @@ void FileOptions::SharedCtor() {
   java_generic_services_ = false;
   py_generic_services_ = false;
   deprecated_ = false;
+  cc_enable_arenas_ = false;
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
 }
 
@@ -4966,6 +5658,14 @@ FileOptions* FileOptions::New() const {
   return new FileOptions;
 }
 
+FileOptions* FileOptions::New(::google::protobuf::Arena* arena) const {
+  FileOptions* n = new FileOptions;
+  if (arena != NULL) {
+    arena->Own(n);
+  }
+  return n;
+}
+
 void FileOptions::Clear() {
   _extensions_.Clear();
 #define OFFSET_OF_FIELD_(f) (reinterpret_cast<char*>(      \
@@ -4997,7 +5697,7 @@ void FileOptions::Clear() {
       }
     }
   }
-  ZR_(java_generic_services_, deprecated_);
+  ZR_(java_generic_services_, cc_enable_arenas_);
 
 #undef OFFSET_OF_FIELD_
 #undef ZR_
@@ -5188,6 +5888,21 @@ bool FileOptions::MergePartialFromCodedStream(
         } else {
           goto handle_unusual;
         }
+        if (input->ExpectTag(248)) goto parse_cc_enable_arenas;
+        break;
+      }
+
+      // optional bool cc_enable_arenas = 31 [default = false];
+      case 31: {
+        if (tag == 248) {
+         parse_cc_enable_arenas:
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   bool, ::google::protobuf::internal::WireFormatLite::TYPE_BOOL>(
+                 input, &cc_enable_arenas_)));
+          set_has_cc_enable_arenas();
+        } else {
+          goto handle_unusual;
+        }
         if (input->ExpectTag(7994)) goto parse_uninterpreted_option;
         break;
       }
@@ -5307,6 +6022,11 @@ void FileOptions::SerializeWithCachedSizes(
     ::google::protobuf::internal::WireFormatLite::WriteBool(27, this->java_string_check_utf8(), output);
   }
 
+  // optional bool cc_enable_arenas = 31 [default = false];
+  if (has_cc_enable_arenas()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBool(31, this->cc_enable_arenas(), output);
+  }
+
   // repeated .google.protobuf.UninterpretedOption uninterpreted_option = 999;
   for (int i = 0; i < this->uninterpreted_option_size(); i++) {
     ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
@@ -5401,6 +6121,11 @@ void FileOptions::SerializeWithCachedSizes(
     target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(27, this->java_string_check_utf8(), target);
   }
 
+  // optional bool cc_enable_arenas = 31 [default = false];
+  if (has_cc_enable_arenas()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(31, this->cc_enable_arenas(), target);
+  }
+
   // repeated .google.protobuf.UninterpretedOption uninterpreted_option = 999;
   for (int i = 0; i < this->uninterpreted_option_size(); i++) {
     target = ::google::protobuf::internal::WireFormatLite::
@@ -5420,6 +6145,170 @@ void FileOptions::SerializeWithCachedSizes(
   return target;
 }
 
+void FileOptions::SerializeBackward(
+    ::google::protobuf::io::BackwardOutputBuffer* buffer) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::PrependUnknownFields(
+        unknown_fields(), buffer);
+  }
+
+  // Extension range [1000, 536870912)
+  _extensions_.SerializeBackward(1000, 536870912, buffer);
+
+  // repeated .google.protobuf.UninterpretedOption uninterpreted_option = 999;
+  for (int i = this->uninterpreted_option_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      PrependMessageNoVirtual(999, this->uninterpreted_option(i), buffer);
+  }
+
+  // optional bool cc_enable_arenas = 31 [default = false];
+  if (has_cc_enable_arenas()) {
+    {
+      int total_size = 0;
+      total_size += 2 + 1;
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(31, this->cc_enable_arenas(), target);
+    }
+  }
+
+  // optional bool java_string_check_utf8 = 27 [default = false];
+  if (has_java_string_check_utf8()) {
+    {
+      int total_size = 0;
+      total_size += 2 + 1;
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(27, this->java_string_check_utf8(), target);
+    }
+  }
+
+  // optional bool deprecated = 23 [default = false];
+  if (has_deprecated()) {
+    {
+      int total_size = 0;
+      total_size += 2 + 1;
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(23, this->deprecated(), target);
+    }
+  }
+
+  // optional bool java_generate_equals_and_hash = 20 [default = false];
+  if (has_java_generate_equals_and_hash()) {
+    {
+      int total_size = 0;
+      total_size += 2 + 1;
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(20, this->java_generate_equals_and_hash(), target);
+    }
+  }
+
+  // optional bool py_generic_services = 18 [default = false];
+  if (has_py_generic_services()) {
+    {
+      int total_size = 0;
+      total_size += 2 + 1;
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(18, this->py_generic_services(), target);
+    }
+  }
+
+  // optional bool java_generic_services = 17 [default = false];
+  if (has_java_generic_services()) {
+    {
+      int total_size = 0;
+      total_size += 2 + 1;
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(17, this->java_generic_services(), target);
+    }
+  }
+
+  // optional bool cc_generic_services = 16 [default = false];
+  if (has_cc_generic_services()) {
+    {
+      int total_size = 0;
+      total_size += 2 + 1;
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(16, this->cc_generic_services(), target);
+    }
+  }
+
+  // optional string go_package = 11;
+  if (has_go_package()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::StringSize(
+          this->go_package());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
+        this->go_package().data(), this->go_package().length(),
+        ::google::protobuf::internal::WireFormat::SERIALIZE,
+        "go_package");
+      target =
+        ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
+          11, this->go_package(), target);
+    }
+  }
+
+  // optional bool java_multiple_files = 10 [default = false];
+  if (has_java_multiple_files()) {
+    {
+      int total_size = 0;
+      total_size += 1 + 1;
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(10, this->java_multiple_files(), target);
+    }
+  }
+
+  // optional .google.protobuf.FileOptions.OptimizeMode optimize_for = 9 [default = SPEED];
+  if (has_optimize_for()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::EnumSize(this->optimize_for());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      target = ::google::protobuf::internal::WireFormatLite::WriteEnumToArray(
+        9, this->optimize_for(), target);
+    }
+  }
+
+  // optional string java_outer_classname = 8;
+  if (has_java_outer_classname()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::StringSize(
+          this->java_outer_classname());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
+        this->java_outer_classname().data(), this->java_outer_classname().length(),
+        ::google::protobuf::internal::WireFormat::SERIALIZE,
+        "java_outer_classname");
+      target =
+        ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
+          8, this->java_outer_classname(), target);
+    }
+  }
+
+  // optional string java_package = 1;
+  if (has_java_package()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::StringSize(
+          this->java_package());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
+        this->java_package().data(), this->java_package().length(),
+        ::google::protobuf::internal::WireFormat::SERIALIZE,
+        "java_package");
+      target =
+        ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
+          1, this->java_package(), target);
+    }
+  }
+
+}
+
 int FileOptions::ByteSize() const {
   int total_size = 0;
 
@@ -5488,6 +6377,11 @@ int FileOptions::ByteSize() const {
       total_size += 2 + 1;
     }
 
+    // optional bool cc_enable_arenas = 31 [default = false];
+    if (has_cc_enable_arenas()) {
+      total_size += 2 + 1;
+    }
+
   }
   // repeated .google.protobuf.UninterpretedOption uninterpreted_option = 999;
   total_size += 2 * this->uninterpreted_option_size();
@@ -5561,6 +6455,9 @@ void FileOptions::MergeFrom(const FileOptions& from) {
     if (from.has_deprecated()) {
       set_deprecated(from.deprecated());
     }
+    if (from.has_cc_enable_arenas()) {
+      set_cc_enable_arenas(from.cc_enable_arenas());
+    }
   }
   _extensions_.MergeFrom(from._extensions_);
   mutable_unknown_fields()->MergeFrom(from.unknown_fields());
@@ -5598,6 +6495,7 @@ void FileOptions::Swap(FileOptions* other) {
     std::swap(java_generic_services_, other->java_generic_services_);
     std::swap(py_generic_services_, other->py_generic_services_);
     std::swap(deprecated_, other->deprecated_);
+    std::swap(cc_enable_arenas_, other->cc_enable_arenas_);
     uninterpreted_option_.Swap(&other->uninterpreted_option_);
     std::swap(_has_bits_[0], other->_has_bits_[0]);
     _unknown_fields_.Swap(&other->_unknown_fields_);
@@ -5679,6 +6577,14 @@ MessageOptions* MessageOptions::New() const {
   return new MessageOptions;
 }
 
+MessageOptions* MessageOptions::New(::google::protobuf::Arena* arena) const {
+  MessageOptions* n = new MessageOptions;
+  if (arena != NULL) {
+    arena->Own(n);
+  }
+  return n;
+}
+
 void MessageOptions::Clear() {
   _extensions_.Clear();
 #define OFFSET_OF_FIELD_(f) (reinterpret_cast<char*>(      \
@@ -5868,6 +6774,54 @@ void MessageOptions::SerializeWithCachedSizes(
   return target;
 }
 
+void MessageOptions::SerializeBackward(
+    ::google::protobuf::io::BackwardOutputBuffer* buffer) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::PrependUnknownFields(
+        unknown_fields(), buffer);
+  }
+
+  // Extension range [1000, 536870912)
+  _extensions_.SerializeBackward(1000, 536870912, buffer);
+
+  // repeated .google.protobuf.UninterpretedOption uninterpreted_option = 999;
+  for (int i = this->uninterpreted_option_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      PrependMessageNoVirtual(999, this->uninterpreted_option(i), buffer);
+  }
+
+  // optional bool deprecated = 3 [default = false];
+  if (has_deprecated()) {
+    {
+      int total_size = 0;
+      total_size += 1 + 1;
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(3, this->deprecated(), target);
+    }
+  }
+
+  // optional bool no_standard_descriptor_accessor = 2 [default = false];
+  if (has_no_standard_descriptor_accessor()) {
+    {
+      int total_size = 0;
+      total_size += 1 + 1;
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(2, this->no_standard_descriptor_accessor(), target);
+    }
+  }
+
+  // optional bool message_set_wire_format = 1 [default = false];
+  if (has_message_set_wire_format()) {
+    {
+      int total_size = 0;
+      total_size += 1 + 1;
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(1, this->message_set_wire_format(), target);
+    }
+  }
+
+}
+
 int MessageOptions::ByteSize() const {
   int total_size = 0;
 
@@ -6012,6 +6966,7 @@ const int FieldOptions::kLazyFieldNumber;
 const int FieldOptions::kDeprecatedFieldNumber;
 const int FieldOptions::kExperimentalMapKeyFieldNumber;
 const int FieldOptions::kWeakFieldNumber;
+const int FieldOptions::kInlineCapacityFieldNumber;
 const int FieldOptions::kUninterpretedOptionFieldNumber;
 #endif  // !_MSC_VER
 
@@ -6040,6 +6995,7 @@ void FieldOptions::SharedCtor() {
   deprecated_ = false;
   experimental_map_key_ = const_cast< ::std::string*>(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
   weak_ = false;
+  inline_capacity_ = 0;
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
 }
 
@@ -6077,6 +7033,14 @@ FieldOptions* FieldOptions::New() const {
   return new FieldOptions;
 }
 
+FieldOptions* FieldOptions::New(::google::protobuf::Arena* arena) const {
+  FieldOptions* n = new FieldOptions;
+  if (arena != NULL) {
+    arena->Own(n);
+  }
+  return n;
+}
+
 void FieldOptions::Clear() {
   _extensions_.Clear();
 #define OFFSET_OF_FIELD_(f) (reinterpret_cast<char*>(      \
@@ -6089,13 +7053,14 @@ void FieldOptions::Clear() {
     ::memset(&first, 0, n);                                \
   } while (0)
 
-  if (_has_bits_[0 / 32] & 63) {
+  if (_has_bits_[0 / 32] & 127) {
     ZR_(ctype_, weak_);
     if (has_experimental_map_key()) {
       if (experimental_map_key_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
         experimental_map_key_->clear();
       }
     }
+    inline_capacity_ = 0;
   }
 
 #undef OFFSET_OF_FIELD_
@@ -6208,6 +7173,21 @@ bool FieldOptions::MergePartialFromCodedStream(
         } else {
           goto handle_unusual;
         }
+        if (input->ExpectTag(88)) goto parse_inline_capacity;
+        break;
+      }
+
+      // optional int32 inline_capacity = 11;
+      case 11: {
+        if (tag == 88) {
+         parse_inline_capacity:
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::int32, ::google::protobuf::internal::WireFormatLite::TYPE_INT32>(
+                 input, &inline_capacity_)));
+          set_has_inline_capacity();
+        } else {
+          goto handle_unusual;
+        }
         if (input->ExpectTag(7994)) goto parse_uninterpreted_option;
         break;
       }
@@ -6292,6 +7272,11 @@ void FieldOptions::SerializeWithCachedSizes(
     ::google::protobuf::internal::WireFormatLite::WriteBool(10, this->weak(), output);
   }
 
+  // optional int32 inline_capacity = 11;
+  if (has_inline_capacity()) {
+    ::google::protobuf::internal::WireFormatLite::WriteInt32(11, this->inline_capacity(), output);
+  }
+
   // repeated .google.protobuf.UninterpretedOption uninterpreted_option = 999;
   for (int i = 0; i < this->uninterpreted_option_size(); i++) {
     ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
@@ -6349,6 +7334,11 @@ void FieldOptions::SerializeWithCachedSizes(
     target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(10, this->weak(), target);
   }
 
+  // optional int32 inline_capacity = 11;
+  if (has_inline_capacity()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteInt32ToArray(11, this->inline_capacity(), target);
+  }
+
   // repeated .google.protobuf.UninterpretedOption uninterpreted_option = 999;
   for (int i = 0; i < this->uninterpreted_option_size(); i++) {
     target = ::google::protobuf::internal::WireFormatLite::
@@ -6368,6 +7358,106 @@ void FieldOptions::SerializeWithCachedSizes(
   return target;
 }
 
+void FieldOptions::SerializeBackward(
+    ::google::protobuf::io::BackwardOutputBuffer* buffer) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::PrependUnknownFields(
+        unknown_fields(), buffer);
+  }
+
+  // Extension range [1000, 536870912)
+  _extensions_.SerializeBackward(1000, 536870912, buffer);
+
+  // repeated .google.protobuf.UninterpretedOption uninterpreted_option = 999;
+  for (int i = this->uninterpreted_option_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      PrependMessageNoVirtual(999, this->uninterpreted_option(i), buffer);
+  }
+
+  // optional int32 inline_capacity = 11;
+  if (has_inline_capacity()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::Int32Size(
+          this->inline_capacity());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      target = ::google::protobuf::internal::WireFormatLite::WriteInt32ToArray(11, this->inline_capacity(), target);
+    }
+  }
+
+  // optional bool weak = 10 [default = false];
+  if (has_weak()) {
+    {
+      int total_size = 0;
+      total_size += 1 + 1;
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(10, this->weak(), target);
+    }
+  }
+
+  // optional string experimental_map_key = 9;
+  if (has_experimental_map_key()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::StringSize(
+          this->experimental_map_key());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
+        this->experimental_map_key().data(), this->experimental_map_key().length(),
+        ::google::protobuf::internal::WireFormat::SERIALIZE,
+        "experimental_map_key");
+      target =
+        ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
+          9, this->experimental_map_key(), target);
+    }
+  }
+
+  // optional bool lazy = 5 [default = false];
+  if (has_lazy()) {
+    {
+      int total_size = 0;
+      total_size += 1 + 1;
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(5, this->lazy(), target);
+    }
+  }
+
+  // optional bool deprecated = 3 [default = false];
+  if (has_deprecated()) {
+    {
+      int total_size = 0;
+      total_size += 1 + 1;
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(3, this->deprecated(), target);
+    }
+  }
+
+  // optional bool packed = 2;
+  if (has_packed()) {
+    {
+      int total_size = 0;
+      total_size += 1 + 1;
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(2, this->packed(), target);
+    }
+  }
+
+  // optional .google.protobuf.FieldOptions.CType ctype = 1 [default = STRING];
+  if (has_ctype()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::EnumSize(this->ctype());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      target = ::google::protobuf::internal::WireFormatLite::WriteEnumToArray(
+        1, this->ctype(), target);
+    }
+  }
+
+}
+
 int FieldOptions::ByteSize() const {
   int total_size = 0;
 
@@ -6405,6 +7495,13 @@ int FieldOptions::ByteSize() const {
       total_size += 1 + 1;
     }
 
+    // optional int32 inline_capacity = 11;
+    if (has_inline_capacity()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::Int32Size(
+          this->inline_capacity());
+    }
+
   }
   // repeated .google.protobuf.UninterpretedOption uninterpreted_option = 999;
   total_size += 2 * this->uninterpreted_option_size();
@@ -6461,6 +7558,9 @@ void FieldOptions::MergeFrom(const FieldOptions& from) {
     if (from.has_weak()) {
       set_weak(from.weak());
     }
+    if (from.has_inline_capacity()) {
+      set_inline_capacity(from.inline_capacity());
+    }
   }
   _extensions_.MergeFrom(from._extensions_);
   mutable_unknown_fields()->MergeFrom(from.unknown_fields());
@@ -6493,6 +7593,7 @@ void FieldOptions::Swap(FieldOptions* other) {
     std::swap(deprecated_, other->deprecated_);
     std::swap(experimental_map_key_, other->experimental_map_key_);
     std::swap(weak_, other->weak_);
+    std::swap(inline_capacity_, other->inline_capacity_);
     uninterpreted_option_.Swap(&other->uninterpreted_option_);
     std::swap(_has_bits_[0], other->_has_bits_[0]);
     _unknown_fields_.Swap(&other->_unknown_fields_);
@@ -6572,6 +7673,14 @@ EnumOptions* EnumOptions::New() const {
   return new EnumOptions;
 }
 
+EnumOptions* EnumOptions::New(::google::protobuf::Arena* arena) const {
+  EnumOptions* n = new EnumOptions;
+  if (arena != NULL) {
+    arena->Own(n);
+  }
+  return n;
+}
+
 void EnumOptions::Clear() {
   _extensions_.Clear();
 #define OFFSET_OF_FIELD_(f) (reinterpret_cast<char*>(      \
@@ -6736,6 +7845,44 @@ void EnumOptions::SerializeWithCachedSizes(
   return target;
 }
 
+void EnumOptions::SerializeBackward(
+    ::google::protobuf::io::BackwardOutputBuffer* buffer) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::PrependUnknownFields(
+        unknown_fields(), buffer);
+  }
+
+  // Extension range [1000, 536870912)
+  _extensions_.SerializeBackward(1000, 536870912, buffer);
+
+  // repeated .google.protobuf.UninterpretedOption uninterpreted_option = 999;
+  for (int i = this->uninterpreted_option_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      PrependMessageNoVirtual(999, this->uninterpreted_option(i), buffer);
+  }
+
+  // optional bool deprecated = 3 [default = false];
+  if (has_deprecated()) {
+    {
+      int total_size = 0;
+      total_size += 1 + 1;
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(3, this->deprecated(), target);
+    }
+  }
+
+  // optional bool allow_alias = 2;
+  if (has_allow_alias()) {
+    {
+      int total_size = 0;
+      total_size += 1 + 1;
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(2, this->allow_alias(), target);
+    }
+  }
+
+}
+
 int EnumOptions::ByteSize() const {
   int total_size = 0;
 
@@ -6899,6 +8046,14 @@ EnumValueOptions* EnumValueOptions::New() const {
   return new EnumValueOptions;
 }
 
+EnumValueOptions* EnumValueOptions::New(::google::protobuf::Arena* arena) const {
+  EnumValueOptions* n = new EnumValueOptions;
+  if (arena != NULL) {
+    arena->Own(n);
+  }
+  return n;
+}
+
 void EnumValueOptions::Clear() {
   _extensions_.Clear();
   deprecated_ = false;
@@ -7024,6 +8179,34 @@ void EnumValueOptions::SerializeWithCachedSizes(
   return target;
 }
 
+void EnumValueOptions::SerializeBackward(
+    ::google::protobuf::io::BackwardOutputBuffer* buffer) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::PrependUnknownFields(
+        unknown_fields(), buffer);
+  }
+
+  // Extension range [1000, 536870912)
+  _extensions_.SerializeBackward(1000, 536870912, buffer);
+
+  // repeated .google.protobuf.UninterpretedOption uninterpreted_option = 999;
+  for (int i = this->uninterpreted_option_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      PrependMessageNoVirtual(999, this->uninterpreted_option(i), buffer);
+  }
+
+  // optional bool deprecated = 1 [default = false];
+  if (has_deprecated()) {
+    {
+      int total_size = 0;
+      total_size += 1 + 1;
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(1, this->deprecated(), target);
+    }
+  }
+
+}
+
 int EnumValueOptions::ByteSize() const {
   int total_size = 0;
 
@@ -7178,6 +8361,14 @@ ServiceOptions* ServiceOptions::New() const {
   return new ServiceOptions;
 }
 
+ServiceOptions* ServiceOptions::New(::google::protobuf::Arena* arena) const {
+  ServiceOptions* n = new ServiceOptions;
+  if (arena != NULL) {
+    arena->Own(n);
+  }
+  return n;
+}
+
 void ServiceOptions::Clear() {
   _extensions_.Clear();
   deprecated_ = false;
@@ -7303,6 +8494,34 @@ void ServiceOptions::SerializeWithCachedSizes(
   return target;
 }
 
+void ServiceOptions::SerializeBackward(
+    ::google::protobuf::io::BackwardOutputBuffer* buffer) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::PrependUnknownFields(
+        unknown_fields(), buffer);
+  }
+
+  // Extension range [1000, 536870912)
+  _extensions_.SerializeBackward(1000, 536870912, buffer);
+
+  // repeated .google.protobuf.UninterpretedOption uninterpreted_option = 999;
+  for (int i = this->uninterpreted_option_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      PrependMessageNoVirtual(999, this->uninterpreted_option(i), buffer);
+  }
+
+  // optional bool deprecated = 33 [default = false];
+  if (has_deprecated()) {
+    {
+      int total_size = 0;
+      total_size += 2 + 1;
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(33, this->deprecated(), target);
+    }
+  }
+
+}
+
 int ServiceOptions::ByteSize() const {
   int total_size = 0;
 
@@ -7457,6 +8676,14 @@ MethodOptions* MethodOptions::New() const {
   return new MethodOptions;
 }
 
+MethodOptions* MethodOptions::New(::google::protobuf::Arena* arena) const {
+  MethodOptions* n = new MethodOptions;
+  if (arena != NULL) {
+    arena->Own(n);
+  }
+  return n;
+}
+
 void MethodOptions::Clear() {
   _extensions_.Clear();
   deprecated_ = false;
@@ -7582,6 +8809,34 @@ void MethodOptions::SerializeWithCachedSizes(
   return target;
 }
 
+void MethodOptions::SerializeBackward(
+    ::google::protobuf::io::BackwardOutputBuffer* buffer) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::PrependUnknownFields(
+        unknown_fields(), buffer);
+  }
+
+  // Extension range [1000, 536870912)
+  _extensions_.SerializeBackward(1000, 536870912, buffer);
+
+  // repeated .google.protobuf.UninterpretedOption uninterpreted_option = 999;
+  for (int i = this->uninterpreted_option_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      PrependMessageNoVirtual(999, this->uninterpreted_option(i), buffer);
+  }
+
+  // optional bool deprecated = 33 [default = false];
+  if (has_deprecated()) {
+    {
+      int total_size = 0;
+      total_size += 2 + 1;
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(33, this->deprecated(), target);
+    }
+  }
+
+}
+
 int MethodOptions::ByteSize() const {
   int total_size = 0;
 
@@ -7741,6 +8996,14 @@ UninterpretedOption_NamePart* UninterpretedOption_NamePart::New() const {
   return new UninterpretedOption_NamePart;
 }
 
+UninterpretedOption_NamePart* UninterpretedOption_NamePart::New(::google::protobuf::Arena* arena) const {
+  UninterpretedOption_NamePart* n = new UninterpretedOption_NamePart;
+  if (arena != NULL) {
+    arena->Own(n);
+  }
+  return n;
+}
+
 void UninterpretedOption_NamePart::Clear() {
   if (_has_bits_[0 / 32] & 3) {
     if (has_name_part()) {
@@ -7869,6 +9132,43 @@ void UninterpretedOption_NamePart::SerializeWithCachedSizes(
   return target;
 }
 
+void UninterpretedOption_NamePart::SerializeBackward(
+    ::google::protobuf::io::BackwardOutputBuffer* buffer) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::PrependUnknownFields(
+        unknown_fields(), buffer);
+  }
+
+  // required bool is_extension = 2;
+  if (has_is_extension()) {
+    {
+      int total_size = 0;
+      total_size += 1 + 1;
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(2, this->is_extension(), target);
+    }
+  }
+
+  // required string name_part = 1;
+  if (has_name_part()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::StringSize(
+          this->name_part());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
+        this->name_part().data(), this->name_part().length(),
+        ::google::protobuf::internal::WireFormat::SERIALIZE,
+        "name_part");
+      target =
+        ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
+          1, this->name_part(), target);
+    }
+  }
+
+}
+
 int UninterpretedOption_NamePart::ByteSize() const {
   int total_size = 0;
 
@@ -8039,6 +9339,14 @@ UninterpretedOption* UninterpretedOption::New() const {
   return new UninterpretedOption;
 }
 
+UninterpretedOption* UninterpretedOption::New(::google::protobuf::Arena* arena) const {
+  UninterpretedOption* n = new UninterpretedOption;
+  if (arena != NULL) {
+    arena->Own(n);
+  }
+  return n;
+}
+
 void UninterpretedOption::Clear() {
 #define OFFSET_OF_FIELD_(f) (reinterpret_cast<char*>(      \
   &reinterpret_cast<UninterpretedOption*>(16)->f) - \
@@ -8334,6 +9642,105 @@ void UninterpretedOption::SerializeWithCachedSizes(
   return target;
 }
 
+void UninterpretedOption::SerializeBackward(
+    ::google::protobuf::io::BackwardOutputBuffer* buffer) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::PrependUnknownFields(
+        unknown_fields(), buffer);
+  }
+
+  // optional string aggregate_value = 8;
+  if (has_aggregate_value()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::StringSize(
+          this->aggregate_value());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
+        this->aggregate_value().data(), this->aggregate_value().length(),
+        ::google::protobuf::internal::WireFormat::SERIALIZE,
+        "aggregate_value");
+      target =
+        ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
+          8, this->aggregate_value(), target);
+    }
+  }
+
+  // optional bytes string_value = 7;
+  if (has_string_value()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::BytesSize(
+          this->string_value());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      target =
+        ::google::protobuf::internal::WireFormatLite::WriteBytesToArray(
+          7, this->string_value(), target);
+    }
+  }
+
+  // optional double double_value = 6;
+  if (has_double_value()) {
+    {
+      int total_size = 0;
+      total_size += 1 + 8;
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      target = ::google::protobuf::internal::WireFormatLite::WriteDoubleToArray(6, this->double_value(), target);
+    }
+  }
+
+  // optional int64 negative_int_value = 5;
+  if (has_negative_int_value()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::Int64Size(
+          this->negative_int_value());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      target = ::google::protobuf::internal::WireFormatLite::WriteInt64ToArray(5, this->negative_int_value(), target);
+    }
+  }
+
+  // optional uint64 positive_int_value = 4;
+  if (has_positive_int_value()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::UInt64Size(
+          this->positive_int_value());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      target = ::google::protobuf::internal::WireFormatLite::WriteUInt64ToArray(4, this->positive_int_value(), target);
+    }
+  }
+
+  // optional string identifier_value = 3;
+  if (has_identifier_value()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::StringSize(
+          this->identifier_value());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
+        this->identifier_value().data(), this->identifier_value().length(),
+        ::google::protobuf::internal::WireFormat::SERIALIZE,
+        "identifier_value");
+      target =
+        ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
+          3, this->identifier_value(), target);
+    }
+  }
+
+  // repeated .google.protobuf.UninterpretedOption.NamePart name = 2;
+  for (int i = this->name_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      PrependMessageNoVirtual(2, this->name(i), buffer);
+  }
+
+}
+
 int UninterpretedOption::ByteSize() const {
   int total_size = 0;
 
@@ -8548,6 +9955,14 @@ SourceCodeInfo_Location* SourceCodeInfo_Location::New() const {
   return new SourceCodeInfo_Location;
 }
 
+SourceCodeInfo_Location* SourceCodeInfo_Location::New(::google::protobuf::Arena* arena) const {
+  SourceCodeInfo_Location* n = new SourceCodeInfo_Location;
+  if (arena != NULL) {
+    arena->Own(n);
+  }
+  return n;
+}
+
 void SourceCodeInfo_Location::Clear() {
   if (_has_bits_[0 / 32] & 12) {
     if (has_leading_comments()) {
@@ -8779,6 +10194,117 @@ void SourceCodeInfo_Location::SerializeWithCachedSizes(
   return target;
 }
 
+void SourceCodeInfo_Location::SerializeBackward(
+    ::google::protobuf::io::BackwardOutputBuffer* buffer) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::PrependUnknownFields(
+        unknown_fields(), buffer);
+  }
+
+  // optional string trailing_comments = 4;
+  if (has_trailing_comments()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::StringSize(
+          this->trailing_comments());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
+        this->trailing_comments().data(), this->trailing_comments().length(),
+        ::google::protobuf::internal::WireFormat::SERIALIZE,
+        "trailing_comments");
+      target =
+        ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
+          4, this->trailing_comments(), target);
+    }
+  }
+
+  // optional string leading_comments = 3;
+  if (has_leading_comments()) {
+    {
+      int total_size = 0;
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::StringSize(
+          this->leading_comments());
+      ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+      ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
+        this->leading_comments().data(), this->leading_comments().length(),
+        ::google::protobuf::internal::WireFormat::SERIALIZE,
+        "leading_comments");
+      target =
+        ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
+          3, this->leading_comments(), target);
+    }
+  }
+
+  // repeated int32 span = 2 [packed = true];
+  {
+    int total_size = 0;
+    {
+      int data_size = 0;
+      for (int i = 0; i < this->span_size(); i++) {
+        data_size += ::google::protobuf::internal::WireFormatLite::
+          Int32Size(this->span(i));
+      }
+      if (data_size > 0) {
+        total_size += 1 +
+          ::google::protobuf::internal::WireFormatLite::Int32Size(data_size);
+      }
+      GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
+      _span_cached_byte_size_ = data_size;
+      GOOGLE_SAFE_CONCURRENT_WRITES_END();
+      total_size += data_size;
+    }
+    ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+    if (this->span_size() > 0) {
+      target = ::google::protobuf::internal::WireFormatLite::WriteTagToArray(
+        2,
+        ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED,
+        target);
+      target = ::google::protobuf::io::CodedOutputStream::WriteVarint32ToArray(
+        _span_cached_byte_size_, target);
+    }
+    for (int i = 0; i < this->span_size(); i++) {
+      target = ::google::protobuf::internal::WireFormatLite::
+        WriteInt32NoTagToArray(this->span(i), target);
+    }
+  }
+
+  // repeated int32 path = 1 [packed = true];
+  {
+    int total_size = 0;
+    {
+      int data_size = 0;
+      for (int i = 0; i < this->path_size(); i++) {
+        data_size += ::google::protobuf::internal::WireFormatLite::
+          Int32Size(this->path(i));
+      }
+      if (data_size > 0) {
+        total_size += 1 +
+          ::google::protobuf::internal::WireFormatLite::Int32Size(data_size);
+      }
+      GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
+      _path_cached_byte_size_ = data_size;
+      GOOGLE_SAFE_CONCURRENT_WRITES_END();
+      total_size += data_size;
+    }
+    ::google::protobuf::uint8* target = buffer->Prepend(total_size);
+    if (this->path_size() > 0) {
+      target = ::google::protobuf::internal::WireFormatLite::WriteTagToArray(
+        1,
+        ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED,
+        target);
+      target = ::google::protobuf::io::CodedOutputStream::WriteVarint32ToArray(
+        _path_cached_byte_size_, target);
+    }
+    for (int i = 0; i < this->path_size(); i++) {
+      target = ::google::protobuf::internal::WireFormatLite::
+        WriteInt32NoTagToArray(this->path(i), target);
+    }
+  }
+
+}
+
 int SourceCodeInfo_Location::ByteSize() const {
   int total_size = 0;
 
@@ -8966,6 +10492,14 @@ SourceCodeInfo* SourceCodeInfo::New() const {
   return new SourceCodeInfo;
 }
 
+SourceCodeInfo* SourceCodeInfo::New(::google::protobuf::Arena* arena) const {
+  SourceCodeInfo* n = new SourceCodeInfo;
+  if (arena != NULL) {
+    arena->Own(n);
+  }
+  return n;
+}
+
 void SourceCodeInfo::Clear() {
   location_.Clear();
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
@@ -9052,6 +10586,21 @@ void SourceCodeInfo::SerializeWithCachedSizes(
   return target;
 }
 
+void SourceCodeInfo::SerializeBackward(
+    ::google::protobuf::io::BackwardOutputBuffer* buffer) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::PrependUnknownFields(
+        unknown_fields(), buffer);
+  }
+
+  // repeated .google.protobuf.SourceCodeInfo.Location location = 1;
+  for (int i = this->location_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      PrependMessageNoVirtual(1, this->location(i), buffer);
+  }
+
+}
+
 int SourceCodeInfo::ByteSize() const {
   int total_size = 0;
 
@@ -4042,6 +4042,35 @@ TEST_F(ValidationErrorTest, IllegalPackedField) {
         );
 }
 
+TEST_F(ValidationErrorTest, IllegalInlineCapacity) {
+  BuildFileWithErrors(
+    "name: \"foo.proto\" "
+    "message_type {\n"
+    "  name: \"Foo\""
+    "  field { name:\"optional_int32\" number:1 label:LABEL_OPTIONAL "
+    "          type:TYPE_INT32 "
+    "          options { uninterpreted_option {"
+    "            name { name_part: \"inline_capacity\" is_extension: false }"
+    "            positive_int_value: 4 }}}\n"
+    "  field { name:\"repeated_int32\" number:2 label:LABEL_REPEATED "
+    "          type:TYPE_INT32 "
+    "          options { uninterpreted_option {"
+    "            name { name_part: \"inline_capacity\" is_extension: false }"
+    "            negative_int_value: -1 }}}\n"
+    "  field { name:\"repeated_string\" number:3 label:LABEL_REPEATED "
+    "          type:TYPE_STRING "
+    "          options { uninterpreted_option {"
+    "            name { name_part: \"inline_capacity\" is_extension: false }"
+    "            positive_int_value: 4 }}}\n"
+    "}",
+
+    "foo.proto: Foo.optional_int32: TYPE: [inline_capacity] can only be "
+        "specified for repeated fields, and cannot be negative.\n"
+    "foo.proto: Foo.repeated_int32: TYPE: [inline_capacity] can only be "
+        "specified for repeated fields, and cannot be negative.\n"
+        );
+}
+
 TEST_F(ValidationErrorTest, OptionWrongType) {
   BuildFileWithErrors(
     "name: \"foo.proto\" "
@@ -5037,6 +5066,28 @@ TEST_F(DatabaseBackedPoolTest, RollbackAfterError) {
   EXPECT_TRUE(pool.FindMessageTypeByName("Baz") == NULL);
 }
 
+TEST_F(DatabaseBackedPoolTest, LookupsAfterRollback) {
+  // Loading baz.proto loads foo.proto to resolve Foo, then fails and rolls
+  // both back.  Lookups which don't lock must not see anything from the
+  // rolled-back files, and must see foo.proto once it is loaded for real.
+  CallCountingDatabase call_counter(&database_);
+  DescriptorPool pool(&call_counter);
+  EXPECT_TRUE(pool.FindMessageTypeByName("Baz") == NULL);
+
+  const Descriptor* foo = pool.FindMessageTypeByName("Foo");
+  ASSERT_TRUE(foo != NULL);
+  EXPECT_EQ(foo->file(), pool.FindFileByName("foo.proto"));
+  EXPECT_EQ(foo->file(), pool.FindFileContainingSymbol("Foo"));
+  EXPECT_EQ(foo, foo->file()->message_type(0));
+
+  call_counter.Clear();
+  EXPECT_EQ(foo, pool.FindMessageTypeByName("Foo"));
+  EXPECT_TRUE(pool.FindEnumTypeByName("TestEnum") != NULL);
+  EXPECT_TRUE(pool.FindEnumValueByName("DUMMY") != NULL);
+  EXPECT_TRUE(pool.FindServiceByName("TestService") != NULL);
+  EXPECT_EQ(0, call_counter.call_count_);
+}
+
 TEST_F(DatabaseBackedPoolTest, UnittestProto) {
   // Try to load all of unittest.proto from a DescriptorDatabase.  This should
   // thoroughly test all paths through DescriptorBuilder to insure that there
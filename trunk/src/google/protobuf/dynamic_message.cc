@@ -63,9 +63,11 @@
 // I don't have the book on me right now so I'm not sure.
 
 #include <algorithm>
+#include <vector>
 #include <google/protobuf/stubs/hash.h>
 
 #include <google/protobuf/stubs/common.h>
+#include <google/protobuf/stubs/published_map.h>
 
 #include <google/protobuf/dynamic_message.h>
 #include <google/protobuf/descriptor.h>
@@ -75,6 +77,8 @@
 #include <google/protobuf/reflection_ops.h>
 #include <google/protobuf/repeated_field.h>
 #include <google/protobuf/extension_set.h>
+#include <google/protobuf/lazy_field.h>
+#include <google/protobuf/string_piece_field.h>
 #include <google/protobuf/wire_format.h>
 
 namespace google {
@@ -83,6 +87,10 @@ namespace protobuf {
 using internal::WireFormat;
 using internal::ExtensionSet;
 using internal::GeneratedMessageReflection;
+using internal::IsLazyField;
+using internal::LazyField;
+using internal::IsStringPieceField;
+using internal::StringPieceField;
 
 
 // ===================================================================
@@ -125,10 +133,14 @@ int FieldSpaceUsed(const FieldDescriptor* field) {
       case FD::CPPTYPE_ENUM   : return sizeof(int     );
 
       case FD::CPPTYPE_MESSAGE:
+        if (IsLazyField(field)) return sizeof(LazyField);
         return sizeof(Message*);
 
       case FD::CPPTYPE_STRING:
         switch (field->options().ctype()) {
+          case FieldOptions::STRING_PIECE:
+            if (IsStringPieceField(field)) return sizeof(StringPieceField);
+            // Fall through.
           default:  // TODO(kenton):  Support other string reps.
           case FieldOptions::STRING:
             return sizeof(string*);
@@ -236,6 +248,7 @@ class DynamicMessage : public Message {
   // implements Message ----------------------------------------------
 
   Message* New() const;
+  Message* New(Arena* arena) const;
 
   int GetCachedSize() const;
   void SetCachedSize(int size) const;
@@ -327,6 +340,13 @@ DynamicMessage::DynamicMessage(const TypeInfo* type_info)
 
       case FieldDescriptor::CPPTYPE_STRING:
         switch (field->options().ctype()) {
+          case FieldOptions::STRING_PIECE:
+            if (IsStringPieceField(field)) {
+              reinterpret_cast<StringPieceField*>(field_ptr)->Init(
+                  field->default_value_string());
+              break;
+            }
+            // Fall through.
           default:  // TODO(kenton):  Support other string reps.
           case FieldOptions::STRING:
             if (!field->is_repeated()) {
@@ -347,7 +367,11 @@ DynamicMessage::DynamicMessage(const TypeInfo* type_info)
         break;
 
       case FieldDescriptor::CPPTYPE_MESSAGE: {
-        if (!field->is_repeated()) {
+        if (IsLazyField(field)) {
+          // The prototype's field is pointed at the prototype of its type
+          // by CrossLinkPrototypes().
+          reinterpret_cast<LazyField*>(field_ptr)->Init();
+        } else if (!field->is_repeated()) {
           new(field_ptr) Message*(NULL);
         } else {
           new(field_ptr) RepeatedPtrField<Message>();
@@ -438,6 +462,12 @@ DynamicMessage::~DynamicMessage() {
 
     } else if (field->cpp_type() == FieldDescriptor::CPPTYPE_STRING) {
       switch (field->options().ctype()) {
+        case FieldOptions::STRING_PIECE:
+          if (IsStringPieceField(field)) {
+            reinterpret_cast<StringPieceField*>(field_ptr)->Destroy();
+            break;
+          }
+          // Fall through.
         default:  // TODO(kenton):  Support other string reps.
         case FieldOptions::STRING: {
           string* ptr = *reinterpret_cast<string**>(field_ptr);
@@ -449,6 +479,10 @@ DynamicMessage::~DynamicMessage() {
       }
     } else if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
       if (!is_prototype()) {
+        if (IsLazyField(field)) {
+          reinterpret_cast<LazyField*>(field_ptr)->Destroy();
+          continue;
+        }
         Message* message = *reinterpret_cast<Message**>(field_ptr);
         if (message != NULL) {
           delete message;
@@ -480,8 +514,13 @@ void DynamicMessage::CrossLinkPrototypes() {
       // prototype for the field's type.
       // For singular fields, the field is just a pointer which should
       // point to the prototype.
-      *reinterpret_cast<const Message**>(field_ptr) =
-        factory->GetPrototypeNoLock(field->message_type());
+      if (IsLazyField(field)) {
+        reinterpret_cast<LazyField*>(field_ptr)->InitAsDefault(
+            factory->GetPrototypeNoLock(field->message_type()));
+      } else {
+        *reinterpret_cast<const Message**>(field_ptr) =
+          factory->GetPrototypeNoLock(field->message_type());
+      }
     }
   }
 }
@@ -492,6 +531,12 @@ Message* DynamicMessage::New() const {
   return new(new_base) DynamicMessage(type_info_);
 }
 
+Message* DynamicMessage::New(Arena* arena) const {
+  // Dynamic messages are always allocated on the heap; the arena just takes
+  // ownership.
+  return Message::New(arena);
+}
+
 int DynamicMessage::GetCachedSize() const {
   return cached_byte_size_;
 }
@@ -514,9 +559,38 @@ Metadata DynamicMessage::GetMetadata() const {
 
 // ===================================================================
 
+namespace {
+
+struct DescriptorPointerHash {
+  size_t operator()(const Descriptor* type) const {
+    return reinterpret_cast<uintptr_t>(type);
+  }
+};
+
+}  // namespace
+
+// map_ holds every type the factory has built and is guarded by the
+// factory's mutex.  Once a prototype, and every prototype it links to, is
+// completely built, GetPrototype() also publishes it to published_, which
+// is read without locking, so looking up an existing prototype never blocks.
 struct DynamicMessageFactory::PrototypeMap {
   typedef hash_map<const Descriptor*, const DynamicMessage::TypeInfo*> Map;
   Map map_;
+
+  internal::PublishedMap<const Descriptor*, const Message*,
+                         DescriptorPointerHash> published_;
+
+  // Types whose prototypes were built since the last PublishPending().
+  vector<const Descriptor*> pending_;
+
+  // Publishes the prototypes of the types in pending_.  Must be called with
+  // the factory's mutex held.
+  void PublishPending() {
+    for (int i = 0; i < pending_.size(); i++) {
+      published_.Insert(pending_[i], map_[pending_[i]]->prototype);
+    }
+    pending_.clear();
+  }
 };
 
 DynamicMessageFactory::DynamicMessageFactory()
@@ -540,8 +614,18 @@ DynamicMessageFactory::~DynamicMessageFactory() {
 }
 
 const Message* DynamicMessageFactory::GetPrototype(const Descriptor* type) {
+  if (!delegate_to_generated_factory_ ||
+      type->file()->pool() != DescriptorPool::generated_pool()) {
+    const Message* const* result = prototypes_->published_.Find(type);
+    if (result != NULL) return *result;
+  }
+
   MutexLock lock(&prototypes_mutex_);
-  return GetPrototypeNoLock(type);
+  const Message* result = GetPrototypeNoLock(type);
+  // Building type may have built the types it refers to, too.  Now they are
+  // all complete, so publish them together.
+  prototypes_->PublishPending();
+  return result;
 }
 
 const Message* DynamicMessageFactory::GetPrototypeNoLock(
@@ -559,6 +643,7 @@ const Message* DynamicMessageFactory::GetPrototypeNoLock(
 
   DynamicMessage::TypeInfo* type_info = new DynamicMessage::TypeInfo;
   *target = type_info;
+  prototypes_->pending_.push_back(type);
 
   type_info->type = type;
   type_info->pool = (pool_ == NULL) ? type->file()->pool() : pool_;
@@ -110,7 +110,8 @@ class LIBPROTOBUF_EXPORT DynamicMessageFactory : public MessageFactory {
   // The given descriptor must outlive the returned message, and hence must
   // outlive the DynamicMessageFactory.
   //
-  // The method is thread-safe.
+  // The method is thread-safe.  Once the prototype for a type has been
+  // built, later calls for that type do not lock.
   const Message* GetPrototype(const Descriptor* type);
 
  private:
@@ -119,6 +119,32 @@ TEST_F(DynamicMessageTest, OnePrototype) {
   EXPECT_EQ(prototype_, factory_.GetPrototype(descriptor_));
 }
 
+TEST_F(DynamicMessageTest, ManyPrototypes) {
+  // Build prototypes for every message type in unittest.proto, which makes
+  // the factory grow its table of published prototypes several times, and
+  // check that each is found again.
+  DynamicMessageFactory factory(&pool_);
+  const FileDescriptor* file = descriptor_->file();
+  vector<const Descriptor*> types;
+  for (int i = 0; i < file->message_type_count(); i++) {
+    types.push_back(file->message_type(i));
+  }
+  for (int i = 0; i < types.size(); i++) {
+    for (int j = 0; j < types[i]->nested_type_count(); j++) {
+      types.push_back(types[i]->nested_type(j));
+    }
+  }
+
+  vector<const Message*> prototypes;
+  for (int i = 0; i < types.size(); i++) {
+    prototypes.push_back(factory.GetPrototype(types[i]));
+    EXPECT_EQ(types[i], prototypes.back()->GetDescriptor());
+  }
+  for (int i = 0; i < types.size(); i++) {
+    EXPECT_EQ(prototypes[i], factory.GetPrototype(types[i]));
+  }
+}
+
 TEST_F(DynamicMessageTest, Defaults) {
   // Check that all default values are set correctly in the initial message.
   TestUtil::ReflectionTester reflection_tester(descriptor_);
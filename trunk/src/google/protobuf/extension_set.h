@@ -59,6 +59,7 @@ namespace protobuf {
   class MessageFactory;                                // message.h
   class UnknownFieldSet;                               // unknown_field_set.h
   namespace io {
+    class BackwardOutputBuffer;                    // backward_output_buffer.h
     class CodedInputStream;                              // coded_stream.h
     class CodedOutputStream;                             // coded_stream.h
   }
@@ -394,6 +395,11 @@ class LIBPROTOBUF_EXPORT ExtensionSet {
                                          int end_field_number,
                                          uint8* target) const;
 
+  // Writes the extensions in the same range in front of the contents of
+  // *buffer.  Used by the generated SerializeBackward() methods.
+  void SerializeBackward(int start_field_number, int end_field_number,
+                         io::BackwardOutputBuffer* buffer) const;
+
   // Like above but serializes in MessageSet format.
   void SerializeMessageSetWithCachedSizes(io::CodedOutputStream* output) const;
   uint8* SerializeMessageSetWithCachedSizesToArray(uint8* target) const;
@@ -523,6 +529,155 @@ class LIBPROTOBUF_EXPORT ExtensionSet {
     int SpaceUsedExcludingSelf() const;
   };
 
+  // Maps field numbers to Extensions, in order of field number, with the
+  // part of std::map's interface which ExtensionSet uses.  Most messages
+  // carry only a handful of extensions, so they are kept in a sorted array,
+  // which takes a single allocation and is quick to search.  Once there
+  // are more than kMaximumFlatCapacity of them, they move to a std::map so
+  // that inserting stays cheap.  Unlike std::map's, iterators and pointers
+  // to elements are invalidated by insert() and erase().
+  class LIBPROTOBUF_EXPORT ExtensionMap {
+   public:
+    struct KeyValue {
+      int first;
+      Extension second;
+    };
+
+   private:
+    typedef std::map<int, KeyValue> LargeMap;
+
+    template <typename Value, typename LargeIterator>
+    class IteratorImpl {
+     public:
+      IteratorImpl() : is_large_(false), flat_(NULL) {}
+      explicit IteratorImpl(Value* flat) : is_large_(false), flat_(flat) {}
+      explicit IteratorImpl(LargeIterator large)
+        : is_large_(true), flat_(NULL), large_(large) {}
+      // Allows an iterator to be converted to a const_iterator.
+      template <typename OtherValue, typename OtherLargeIterator>
+      IteratorImpl(const IteratorImpl<OtherValue, OtherLargeIterator>& other)
+        : is_large_(other.is_large_), flat_(other.flat_),
+          large_(other.large_) {}
+
+      Value& operator*() const { return is_large_ ? large_->second : *flat_; }
+      Value* operator->() const { return &**this; }
+
+      IteratorImpl& operator++() {
+        if (is_large_) {
+          ++large_;
+        } else {
+          ++flat_;
+        }
+        return *this;
+      }
+
+      bool operator==(const IteratorImpl& other) const {
+        return is_large_ ? large_ == other.large_ : flat_ == other.flat_;
+      }
+      bool operator!=(const IteratorImpl& other) const {
+        return !(*this == other);
+      }
+
+     private:
+      template <typename OtherValue, typename OtherLargeIterator>
+      friend class IteratorImpl;
+
+      bool is_large_;
+      Value* flat_;
+      LargeIterator large_;
+    };
+
+   public:
+    typedef IteratorImpl<KeyValue, LargeMap::iterator> iterator;
+    typedef IteratorImpl<const KeyValue, LargeMap::const_iterator>
+        const_iterator;
+
+    ExtensionMap() : flat_capacity_(0), flat_size_(0) { map_.flat = NULL; }
+    ~ExtensionMap();
+
+    iterator begin() {
+      return is_large() ? iterator(map_.large->begin()) : iterator(map_.flat);
+    }
+    const_iterator begin() const {
+      return is_large() ? const_iterator(map_.large->begin())
+                        : const_iterator(map_.flat);
+    }
+    iterator end() {
+      return is_large() ? iterator(map_.large->end())
+                        : iterator(map_.flat + flat_size_);
+    }
+    const_iterator end() const {
+      return is_large() ? const_iterator(map_.large->end())
+                        : const_iterator(map_.flat + flat_size_);
+    }
+
+    iterator find(int key) {
+      if (is_large()) return iterator(map_.large->find(key));
+      return iterator(FlatFind(key));
+    }
+    const_iterator find(int key) const {
+      if (is_large()) return const_iterator(map_.large->find(key));
+      return const_iterator(FlatFind(key));
+    }
+    iterator lower_bound(int key) {
+      if (is_large()) return iterator(map_.large->lower_bound(key));
+      return iterator(FlatLowerBound(key));
+    }
+    const_iterator lower_bound(int key) const {
+      if (is_large()) return const_iterator(map_.large->lower_bound(key));
+      return const_iterator(FlatLowerBound(key));
+    }
+
+    // Like std::map::insert(), does nothing if the key is already present.
+    std::pair<iterator, bool> insert(const std::pair<int, Extension>& value);
+    void erase(int key);
+
+    int size() const {
+      return is_large() ? static_cast<int>(map_.large->size()) : flat_size_;
+    }
+    void swap(ExtensionMap& other);
+
+    // Returns the bytes allocated for elements, including unused capacity.
+    int SpaceUsedExcludingSelf() const;
+
+   private:
+    static const int kMaximumFlatCapacity = 256;
+
+    bool is_large() const { return flat_capacity_ > kMaximumFlatCapacity; }
+
+    // A binary search written so that the compiler can use conditional
+    // moves rather than branches, which would mispredict half the time.
+    KeyValue* FlatLowerBound(int key) const {
+      KeyValue* base = map_.flat;
+      int length = flat_size_;
+      if (length == 0) return base;
+      while (length > 1) {
+        int half = length / 2;
+        base = base[half].first < key ? base + half : base;
+        length -= half;
+      }
+      return base->first < key ? base + 1 : base;
+    }
+    // Returns the element with the given key, or the end of the array.
+    KeyValue* FlatFind(int key) const {
+      KeyValue* result = FlatLowerBound(key);
+      KeyValue* end = map_.flat + flat_size_;
+      return result != end && result->first != key ? end : result;
+    }
+    void ConvertToLarge();
+
+    // kMaximumFlatCapacity + 1 once the extensions have moved to map_.large.
+    int flat_capacity_;
+    int flat_size_;
+    union Storage {
+      KeyValue* flat;  // Sorted by key.  NULL until something is inserted.
+      LargeMap* large;
+    };
+    Storage map_;
+
+    GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(ExtensionMap);
+  };
+
 
   // Returns true and fills field_number and extension if extension is found.
   // Note to support packed repeated field compatibility, it also fills whether
@@ -582,11 +737,11 @@ class LIBPROTOBUF_EXPORT ExtensionSet {
 
   // The Extension struct is small enough to be passed by value, so we use it
   // directly as the value type in the map rather than use pointers.  We use
-  // a map rather than hash_map here because we expect most ExtensionSets will
-  // only contain a small number of extensions whereas hash_map is optimized
-  // for 100 elements or more.  Also, we want AppendToList() to order fields
-  // by field number.
-  std::map<int, Extension> extensions_;
+  // a sorted map rather than hash_map here because we expect most
+  // ExtensionSets will only contain a small number of extensions whereas
+  // hash_map is optimized for 100 elements or more.  Also, we want
+  // AppendToList() to order fields by field number.
+  ExtensionMap extensions_;
 
   GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(ExtensionSet);
 };
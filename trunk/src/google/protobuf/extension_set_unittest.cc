@@ -919,6 +919,57 @@ TEST(ExtensionSetTest, AbsentExtension) {
           unittest::repeated_nested_message_extension, 0).bb());
 }
 
+TEST(ExtensionSetTest, ManyExtensions) {
+  // ExtensionSet keeps a few extensions in a sorted array and moves them to
+  // a map when there are many.  Either way, iteration -- and therefore
+  // serialization -- must be in order of field number, whatever order the
+  // extensions were added in.
+  const int kCounts[] = { 10, 300 };
+  for (int i = 0; i < GOOGLE_ARRAYSIZE(kCounts); i++) {
+    const int count = kCounts[i];
+    SCOPED_TRACE(count);
+    ExtensionSet extensions;
+    for (int j = 0; j < count; j++) {
+      int number = (j * 7) % count + 1;
+      extensions.SetInt32(number, WireFormatLite::TYPE_INT32, number * 2,
+                          NULL);
+    }
+    EXPECT_EQ(count, extensions.NumExtensions());
+    for (int number = 1; number <= count; number++) {
+      EXPECT_EQ(number * 2, extensions.GetInt32(number, 0));
+    }
+    EXPECT_FALSE(extensions.Has(count + 1));
+
+    // Moving an extension to another set removes it from this one.
+    ExtensionSet other;
+    extensions.SwapExtension(&other, 5);
+    EXPECT_FALSE(extensions.Has(5));
+    EXPECT_EQ(10, other.GetInt32(5, 0));
+    EXPECT_EQ(count - 1, extensions.NumExtensions());
+    extensions.SwapExtension(&other, 5);
+    EXPECT_EQ(10, extensions.GetInt32(5, 0));
+
+    string data;
+    {
+      extensions.ByteSize();
+      io::StringOutputStream output_stream(&data);
+      io::CodedOutputStream output(&output_stream);
+      extensions.SerializeWithCachedSizes(1, count + 1, &output);
+    }
+    io::CodedInputStream input(reinterpret_cast<const uint8*>(data.data()),
+                               data.size());
+    for (int number = 1; number <= count; number++) {
+      EXPECT_EQ(WireFormatLite::MakeTag(number,
+                                        WireFormatLite::WIRETYPE_VARINT),
+                input.ReadTag());
+      uint32 value;
+      ASSERT_TRUE(input.ReadVarint32(&value));
+      EXPECT_EQ(static_cast<uint32>(number * 2), value);
+    }
+    EXPECT_EQ(0u, input.ReadTag());
+  }
+}
+
 #ifdef PROTOBUF_HAS_DEATH_TEST
 
 TEST(ExtensionSetTest, InvalidEnumDeath) {
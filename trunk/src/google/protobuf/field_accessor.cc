@@ -0,0 +1,61 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <google/protobuf/field_accessor.h>
+
+namespace google {
+namespace protobuf {
+namespace internal {
+
+bool FieldAccessorBase::Init(const Message& prototype,
+                             const FieldDescriptor* field,
+                             FieldDescriptor::CppType cpp_type,
+                             bool repeated) {
+  field_ = NULL;
+  reflection_ = NULL;
+
+  if (field == NULL || field->is_repeated() != repeated) return false;
+  if (field->cpp_type() != cpp_type &&
+      !(cpp_type == FieldDescriptor::CPPTYPE_INT32 &&
+        field->cpp_type() == FieldDescriptor::CPPTYPE_ENUM)) {
+    return false;
+  }
+
+  const Reflection* reflection = prototype.GetReflection();
+  if (!reflection->GetFieldLayout(field, &layout_)) return false;
+
+  field_ = field;
+  reflection_ = reflection;
+  return true;
+}
+
+}  // namespace internal
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,325 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// FieldAccessor resolves a FieldDescriptor once into a small typed handle
+// which then reads and writes that field of any message sharing the same
+// Reflection without re-validating the descriptor, looking up offsets or
+// making a virtual call.  It is meant for generic code which touches the
+// same few fields of many messages, e.g.:
+//
+//   const Descriptor* descriptor = prototype.GetDescriptor();
+//   FieldAccessor<int64> timestamp;
+//   FieldAccessor<string> name;
+//   if (!timestamp.Init(prototype, descriptor->FindFieldByName("timestamp")) ||
+//       !name.Init(prototype, descriptor->FindFieldByName("name"))) {
+//     // Fall back to Reflection.
+//   }
+//   for (int i = 0; i < messages.size(); i++) {
+//     if (timestamp.Get(*messages[i]) < cutoff) {
+//       name.Set(messages[i], "expired");
+//     }
+//   }
+//
+// Accessors work on generated messages and on DynamicMessage.  Init()
+// returns false for fields whose storage they do not understand:
+// extensions, lazy fields and fields with [ctype=STRING_PIECE].  Those must
+// go through Reflection.
+//
+// An accessor may only be used with messages whose GetReflection() is the
+// Reflection it was initialized from, i.e. messages of the same type created
+// by the same factory; this is checked only in debug builds.
+
+#ifndef GOOGLE_PROTOBUF_FIELD_ACCESSOR_H__
+#define GOOGLE_PROTOBUF_FIELD_ACCESSOR_H__
+
+#include <string>
+
+#include <google/protobuf/stubs/common.h>
+#include <google/protobuf/arena.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/message.h>
+#include <google/protobuf/repeated_field.h>
+
+namespace google {
+namespace protobuf {
+namespace internal {
+
+// Where a field lives inside a message object.  Filled in by
+// Reflection::GetFieldLayout().  All offsets are in bytes from the start of
+// the message.
+struct FieldLayout {
+  // The field's storage, or for a oneof member the storage shared by all
+  // members of the oneof.
+  int offset;
+  // The 32-bit word holding the field's has bit and the bit within it.  -1
+  // and 0 for repeated fields and oneof members.
+  int has_bits_word_offset;
+  uint32 has_bit_mask;
+  // The uint32 holding the number of the oneof member which is set, or -1 if
+  // the field is not in a oneof.
+  int oneof_case_offset;
+  // Storage of the field's value in the default instance, read when the
+  // field is not set.
+  const void* default_storage;
+};
+
+// Untyped part of FieldAccessor.
+class LIBPROTOBUF_EXPORT FieldAccessorBase {
+ public:
+  FieldAccessorBase() : field_(NULL), reflection_(NULL) {}
+
+  // The field this accessor was initialized for, or NULL.
+  const FieldDescriptor* field() const { return field_; }
+
+ protected:
+  // Resolves field for messages of prototype's type.  The field's C++ type
+  // and cardinality must match; CPPTYPE_INT32 also matches enum fields.
+  bool Init(const Message& prototype, const FieldDescriptor* field,
+            FieldDescriptor::CppType cpp_type, bool repeated);
+
+  template <typename Type>
+  inline const Type& Raw(const Message& message) const {
+    GOOGLE_DCHECK(message.GetReflection() == reflection_);
+    return *reinterpret_cast<const Type*>(
+        reinterpret_cast<const uint8*>(&message) + layout_.offset);
+  }
+  template <typename Type>
+  inline Type* MutableRaw(Message* message) const {
+    GOOGLE_DCHECK(message->GetReflection() == reflection_);
+    return reinterpret_cast<Type*>(
+        reinterpret_cast<uint8*>(message) + layout_.offset);
+  }
+  template <typename Type>
+  inline const Type& Default() const {
+    return *reinterpret_cast<const Type*>(layout_.default_storage);
+  }
+
+  inline bool InOneof() const { return layout_.oneof_case_offset >= 0; }
+  inline uint32 OneofCase(const Message& message) const {
+    return *reinterpret_cast<const uint32*>(
+        reinterpret_cast<const uint8*>(&message) + layout_.oneof_case_offset);
+  }
+
+  inline bool IsSet(const Message& message) const {
+    if (InOneof()) {
+      return OneofCase(message) == static_cast<uint32>(field_->number());
+    }
+    return (*reinterpret_cast<const uint32*>(
+                reinterpret_cast<const uint8*>(&message) +
+                layout_.has_bits_word_offset) & layout_.has_bit_mask) != 0;
+  }
+
+  // Clears whichever other member of the field's oneof is set.  Returns true
+  // if it did so, in which case the caller must initialize the shared
+  // storage before calling MarkSet().
+  inline bool ClaimOneof(Message* message) const {
+    if (!InOneof() || IsSet(*message)) return false;
+    reflection_->ClearOneof(message, field_->containing_oneof());
+    return true;
+  }
+
+  // Sets the has bit or the oneof case.
+  inline void MarkSet(Message* message) const {
+    if (InOneof()) {
+      *reinterpret_cast<uint32*>(
+          reinterpret_cast<uint8*>(message) + layout_.oneof_case_offset) =
+          field_->number();
+    } else {
+      *reinterpret_cast<uint32*>(
+          reinterpret_cast<uint8*>(message) + layout_.has_bits_word_offset) |=
+          layout_.has_bit_mask;
+    }
+  }
+
+  const FieldDescriptor* field_;
+  const Reflection* reflection_;
+  FieldLayout layout_;
+};
+
+// Maps a FieldAccessor's type parameter to the field C++ type it accesses.
+template <typename T> struct FieldAccessorCppType;
+
+#define GOOGLE_PROTOBUF_FIELD_ACCESSOR_CPPTYPE(TYPE, CPPTYPE)               \
+  template <> struct FieldAccessorCppType<TYPE> {                          \
+    static const FieldDescriptor::CppType value =                          \
+        FieldDescriptor::CPPTYPE_##CPPTYPE;                                \
+  }
+
+GOOGLE_PROTOBUF_FIELD_ACCESSOR_CPPTYPE(int32 , INT32 );
+GOOGLE_PROTOBUF_FIELD_ACCESSOR_CPPTYPE(int64 , INT64 );
+GOOGLE_PROTOBUF_FIELD_ACCESSOR_CPPTYPE(uint32, UINT32);
+GOOGLE_PROTOBUF_FIELD_ACCESSOR_CPPTYPE(uint64, UINT64);
+GOOGLE_PROTOBUF_FIELD_ACCESSOR_CPPTYPE(float , FLOAT );
+GOOGLE_PROTOBUF_FIELD_ACCESSOR_CPPTYPE(double, DOUBLE);
+GOOGLE_PROTOBUF_FIELD_ACCESSOR_CPPTYPE(bool  , BOOL  );
+GOOGLE_PROTOBUF_FIELD_ACCESSOR_CPPTYPE(string, STRING);
+GOOGLE_PROTOBUF_FIELD_ACCESSOR_CPPTYPE(Message, MESSAGE);
+
+#undef GOOGLE_PROTOBUF_FIELD_ACCESSOR_CPPTYPE
+
+}  // namespace internal
+
+// Accessor for a singular field.  T is one of int32, int64, uint32, uint64,
+// float, double, bool, string or Message.  Enum fields are accessed with
+// FieldAccessor<int32>; Set() stores the number it is given, which must be
+// a value defined by the enum type.
+template <typename T>
+class FieldAccessor : public internal::FieldAccessorBase {
+ public:
+  // Resolves field for messages of prototype's type.  Returns false if the
+  // field is repeated, has a different type, or is not supported (see top of
+  // file).
+  bool Init(const Message& prototype, const FieldDescriptor* field) {
+    return FieldAccessorBase::Init(
+        prototype, field, internal::FieldAccessorCppType<T>::value, false);
+  }
+
+  inline bool Has(const Message& message) const { return IsSet(message); }
+
+  inline T Get(const Message& message) const {
+    if (InOneof() && !IsSet(message)) return Default<T>();
+    return Raw<T>(message);
+  }
+
+  inline void Set(Message* message, T value) const {
+    ClaimOneof(message);
+    *MutableRaw<T>(message) = value;
+    MarkSet(message);
+  }
+};
+
+template <>
+class FieldAccessor<string> : public internal::FieldAccessorBase {
+ public:
+  bool Init(const Message& prototype, const FieldDescriptor* field) {
+    return FieldAccessorBase::Init(
+        prototype, field, FieldDescriptor::CPPTYPE_STRING, false);
+  }
+
+  inline bool Has(const Message& message) const { return IsSet(message); }
+
+  inline const string& Get(const Message& message) const {
+    if (InOneof() && !IsSet(message)) return *Default<const string*>();
+    return *Raw<const string*>(message);
+  }
+
+  inline void Set(Message* message, const string& value) const {
+    string** ptr = MutableRaw<string*>(message);
+    if (ClaimOneof(message) || *ptr == Default<const string*>()) {
+      *ptr = Arena::Create<string>(message->GetArena(), value);
+    } else {
+      (*ptr)->assign(value);
+    }
+    MarkSet(message);
+  }
+};
+
+template <>
+class FieldAccessor<Message> : public internal::FieldAccessorBase {
+ public:
+  bool Init(const Message& prototype, const FieldDescriptor* field) {
+    return FieldAccessorBase::Init(
+        prototype, field, FieldDescriptor::CPPTYPE_MESSAGE, false);
+  }
+
+  inline bool Has(const Message& message) const { return IsSet(message); }
+
+  inline const Message& Get(const Message& message) const {
+    const Message* result = (InOneof() && !IsSet(message)) ?
+        NULL : Raw<const Message*>(message);
+    return result != NULL ? *result : *Default<const Message*>();
+  }
+
+  inline Message* Mutable(Message* message) const {
+    Message** ptr = MutableRaw<Message*>(message);
+    if (ClaimOneof(message) || *ptr == NULL) {
+      *ptr = Default<const Message*>()->New(message->GetArena());
+    }
+    MarkSet(message);
+    return *ptr;
+  }
+};
+
+// Accessor for a repeated field, giving direct access to its RepeatedField
+// (or for string and Message fields, RepeatedPtrField).  Elements of a
+// repeated message field must be added through Reflection::AddMessage(),
+// since RepeatedPtrField<Message> does not know what type to create.
+template <typename T>
+class RepeatedFieldAccessor : public internal::FieldAccessorBase {
+ public:
+  bool Init(const Message& prototype, const FieldDescriptor* field) {
+    return FieldAccessorBase::Init(
+        prototype, field, internal::FieldAccessorCppType<T>::value, true);
+  }
+
+  inline const RepeatedField<T>& Get(const Message& message) const {
+    return Raw<RepeatedField<T> >(message);
+  }
+  inline RepeatedField<T>* Mutable(Message* message) const {
+    return MutableRaw<RepeatedField<T> >(message);
+  }
+};
+
+template <>
+class RepeatedFieldAccessor<string> : public internal::FieldAccessorBase {
+ public:
+  bool Init(const Message& prototype, const FieldDescriptor* field) {
+    return FieldAccessorBase::Init(
+        prototype, field, FieldDescriptor::CPPTYPE_STRING, true);
+  }
+
+  inline const RepeatedPtrField<string>& Get(const Message& message) const {
+    return Raw<RepeatedPtrField<string> >(message);
+  }
+  inline RepeatedPtrField<string>* Mutable(Message* message) const {
+    return MutableRaw<RepeatedPtrField<string> >(message);
+  }
+};
+
+template <>
+class RepeatedFieldAccessor<Message> : public internal::FieldAccessorBase {
+ public:
+  bool Init(const Message& prototype, const FieldDescriptor* field) {
+    return FieldAccessorBase::Init(
+        prototype, field, FieldDescriptor::CPPTYPE_MESSAGE, true);
+  }
+
+  inline const RepeatedPtrField<Message>& Get(const Message& message) const {
+    return Raw<RepeatedPtrField<Message> >(message);
+  }
+  inline RepeatedPtrField<Message>* Mutable(Message* message) const {
+    return MutableRaw<RepeatedPtrField<Message> >(message);
+  }
+};
+
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_FIELD_ACCESSOR_H__
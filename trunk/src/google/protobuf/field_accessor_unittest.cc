@@ -0,0 +1,320 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <google/protobuf/field_accessor.h>
+
+#include <google/protobuf/stubs/common.h>
+#include <google/protobuf/arena.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/dynamic_message.h>
+#include <google/protobuf/unittest.pb.h>
+#include <gtest/gtest.h>
+
+namespace google {
+namespace protobuf {
+namespace {
+
+using protobuf_unittest::TestAllExtensions;
+using protobuf_unittest::TestAllTypes;
+
+const FieldDescriptor* F(const string& name) {
+  const FieldDescriptor* result =
+      TestAllTypes::descriptor()->FindFieldByName(name);
+  GOOGLE_CHECK(result != NULL) << name;
+  return result;
+}
+
+TEST(FieldAccessorTest, Scalars) {
+  TestAllTypes message;
+  FieldAccessor<int32> int32_accessor;
+  FieldAccessor<uint64> uint64_accessor;
+  FieldAccessor<double> double_accessor;
+  FieldAccessor<bool> bool_accessor;
+  ASSERT_TRUE(int32_accessor.Init(message, F("optional_int32")));
+  ASSERT_TRUE(uint64_accessor.Init(message, F("optional_uint64")));
+  ASSERT_TRUE(double_accessor.Init(message, F("optional_double")));
+  ASSERT_TRUE(bool_accessor.Init(message, F("optional_bool")));
+  EXPECT_EQ(F("optional_int32"), int32_accessor.field());
+
+  EXPECT_FALSE(int32_accessor.Has(message));
+  EXPECT_EQ(0, int32_accessor.Get(message));
+
+  int32_accessor.Set(&message, 101);
+  uint64_accessor.Set(&message, GOOGLE_ULONGLONG(1) << 40);
+  double_accessor.Set(&message, 1.5);
+  bool_accessor.Set(&message, true);
+
+  EXPECT_TRUE(message.has_optional_int32());
+  EXPECT_EQ(101, message.optional_int32());
+  EXPECT_EQ(GOOGLE_ULONGLONG(1) << 40, message.optional_uint64());
+  EXPECT_EQ(1.5, message.optional_double());
+  EXPECT_TRUE(message.optional_bool());
+  EXPECT_FALSE(message.has_optional_int64());
+
+  message.set_optional_int32(102);
+  EXPECT_TRUE(int32_accessor.Has(message));
+  EXPECT_EQ(102, int32_accessor.Get(message));
+  message.clear_optional_int32();
+  EXPECT_FALSE(int32_accessor.Has(message));
+}
+
+TEST(FieldAccessorTest, Defaults) {
+  TestAllTypes message;
+  FieldAccessor<int32> int32_accessor;
+  FieldAccessor<string> string_accessor;
+  FieldAccessor<int32> enum_accessor;
+  ASSERT_TRUE(int32_accessor.Init(message, F("default_int32")));
+  ASSERT_TRUE(string_accessor.Init(message, F("default_string")));
+  ASSERT_TRUE(enum_accessor.Init(message, F("default_nested_enum")));
+
+  EXPECT_EQ(41, int32_accessor.Get(message));
+  EXPECT_EQ("hello", string_accessor.Get(message));
+  EXPECT_EQ(TestAllTypes::BAR, enum_accessor.Get(message));
+
+  // Setting a string with a default allocates a new one rather than
+  // modifying the default.
+  string_accessor.Set(&message, "world");
+  EXPECT_EQ("world", message.default_string());
+  EXPECT_EQ("hello", TestAllTypes::default_instance().default_string());
+}
+
+TEST(FieldAccessorTest, Strings) {
+  TestAllTypes message;
+  FieldAccessor<string> string_accessor;
+  FieldAccessor<string> bytes_accessor;
+  ASSERT_TRUE(string_accessor.Init(message, F("optional_string")));
+  ASSERT_TRUE(bytes_accessor.Init(message, F("optional_bytes")));
+
+  EXPECT_EQ("", string_accessor.Get(message));
+  string_accessor.Set(&message, "foo");
+  bytes_accessor.Set(&message, string("\0\1", 2));
+  EXPECT_TRUE(message.has_optional_string());
+  EXPECT_EQ("foo", message.optional_string());
+  EXPECT_EQ(string("\0\1", 2), message.optional_bytes());
+
+  // Setting again reuses the existing string.
+  const string* previous = &message.optional_string();
+  string_accessor.Set(&message, "bar");
+  EXPECT_EQ(previous, &string_accessor.Get(message));
+  EXPECT_EQ("bar", message.optional_string());
+}
+
+TEST(FieldAccessorTest, Enums) {
+  TestAllTypes message;
+  FieldAccessor<int32> accessor;
+  ASSERT_TRUE(accessor.Init(message, F("optional_nested_enum")));
+  EXPECT_EQ(TestAllTypes::FOO, accessor.Get(message));
+  accessor.Set(&message, TestAllTypes::BAZ);
+  EXPECT_TRUE(message.has_optional_nested_enum());
+  EXPECT_EQ(TestAllTypes::BAZ, message.optional_nested_enum());
+}
+
+TEST(FieldAccessorTest, Messages) {
+  TestAllTypes message;
+  FieldAccessor<Message> accessor;
+  ASSERT_TRUE(accessor.Init(message, F("optional_nested_message")));
+
+  EXPECT_FALSE(accessor.Has(message));
+  EXPECT_EQ(&TestAllTypes::NestedMessage::default_instance(),
+            &accessor.Get(message));
+
+  Message* nested = accessor.Mutable(&message);
+  EXPECT_EQ(message.mutable_optional_nested_message(), nested);
+  message.mutable_optional_nested_message()->set_bb(12);
+  EXPECT_TRUE(accessor.Has(message));
+  EXPECT_EQ(nested, &accessor.Get(message));
+  EXPECT_EQ(nested, accessor.Mutable(&message));
+}
+
+TEST(FieldAccessorTest, Oneofs) {
+  TestAllTypes message;
+  FieldAccessor<uint32> uint32_accessor;
+  FieldAccessor<string> string_accessor;
+  FieldAccessor<Message> message_accessor;
+  ASSERT_TRUE(uint32_accessor.Init(message, F("oneof_uint32")));
+  ASSERT_TRUE(string_accessor.Init(message, F("oneof_string")));
+  ASSERT_TRUE(message_accessor.Init(message, F("oneof_nested_message")));
+
+  EXPECT_FALSE(string_accessor.Has(message));
+  EXPECT_EQ("", string_accessor.Get(message));
+  EXPECT_EQ(&TestAllTypes::NestedMessage::default_instance(),
+            &message_accessor.Get(message));
+
+  string_accessor.Set(&message, "foo");
+  EXPECT_EQ(TestAllTypes::kOneofString, message.oneof_field_case());
+  EXPECT_EQ("foo", message.oneof_string());
+  EXPECT_EQ(0, uint32_accessor.Get(message));
+
+  // Setting another member clears the string.
+  uint32_accessor.Set(&message, 5);
+  EXPECT_EQ(TestAllTypes::kOneofUint32, message.oneof_field_case());
+  EXPECT_EQ(5, message.oneof_uint32());
+  EXPECT_FALSE(string_accessor.Has(message));
+  EXPECT_EQ("", string_accessor.Get(message));
+
+  message_accessor.Mutable(&message);
+  EXPECT_EQ(TestAllTypes::kOneofNestedMessage, message.oneof_field_case());
+  message.mutable_oneof_nested_message()->set_bb(3);
+  EXPECT_EQ(&message.oneof_nested_message(), &message_accessor.Get(message));
+  EXPECT_EQ(0, uint32_accessor.Get(message));
+
+  string_accessor.Set(&message, "bar");
+  EXPECT_EQ(TestAllTypes::kOneofString, message.oneof_field_case());
+  EXPECT_EQ("bar", message.oneof_string());
+}
+
+TEST(FieldAccessorTest, RepeatedFields) {
+  TestAllTypes message;
+  RepeatedFieldAccessor<int64> int64_accessor;
+  RepeatedFieldAccessor<string> string_accessor;
+  RepeatedFieldAccessor<Message> message_accessor;
+  ASSERT_TRUE(int64_accessor.Init(message, F("repeated_int64")));
+  ASSERT_TRUE(string_accessor.Init(message, F("repeated_string")));
+  ASSERT_TRUE(message_accessor.Init(message, F("repeated_nested_message")));
+
+  int64_accessor.Mutable(&message)->Add(7);
+  int64_accessor.Mutable(&message)->Add(8);
+  *string_accessor.Mutable(&message)->Add() = "foo";
+  message.add_repeated_nested_message()->set_bb(1);
+  message.add_repeated_nested_message()->set_bb(2);
+
+  ASSERT_EQ(2, message.repeated_int64_size());
+  EXPECT_EQ(8, message.repeated_int64(1));
+  ASSERT_EQ(1, message.repeated_string_size());
+  EXPECT_EQ("foo", message.repeated_string(0));
+
+  EXPECT_EQ(&message.repeated_int64(), &int64_accessor.Get(message));
+  ASSERT_EQ(2, message_accessor.Get(message).size());
+  EXPECT_EQ(&message.repeated_nested_message(1),
+            &message_accessor.Get(message).Get(1));
+  message_accessor.Mutable(&message)->SwapElements(0, 1);
+  EXPECT_EQ(2, message.repeated_nested_message(0).bb());
+}
+
+TEST(FieldAccessorTest, Arena) {
+  Arena arena;
+  TestAllTypes* message = Arena::CreateMessage<TestAllTypes>(&arena);
+  FieldAccessor<string> string_accessor;
+  FieldAccessor<Message> message_accessor;
+  ASSERT_TRUE(string_accessor.Init(*message, F("optional_string")));
+  ASSERT_TRUE(message_accessor.Init(*message, F("optional_nested_message")));
+
+  string_accessor.Set(message, "foo");
+  EXPECT_EQ("foo", message->optional_string());
+  Message* nested = message_accessor.Mutable(message);
+  EXPECT_EQ(&arena, nested->GetArena());
+}
+
+TEST(FieldAccessorTest, DynamicMessage) {
+  DynamicMessageFactory factory;
+  const Message* prototype = factory.GetPrototype(TestAllTypes::descriptor());
+  scoped_ptr<Message> message(prototype->New());
+  const Reflection* reflection = message->GetReflection();
+
+  FieldAccessor<int32> int32_accessor;
+  FieldAccessor<string> string_accessor;
+  FieldAccessor<string> default_string_accessor;
+  FieldAccessor<Message> message_accessor;
+  FieldAccessor<uint32> oneof_uint32_accessor;
+  FieldAccessor<string> oneof_string_accessor;
+  RepeatedFieldAccessor<int32> repeated_accessor;
+  ASSERT_TRUE(int32_accessor.Init(*prototype, F("optional_int32")));
+  ASSERT_TRUE(string_accessor.Init(*prototype, F("optional_string")));
+  ASSERT_TRUE(default_string_accessor.Init(*prototype, F("default_string")));
+  ASSERT_TRUE(message_accessor.Init(*prototype, F("optional_nested_message")));
+  ASSERT_TRUE(oneof_uint32_accessor.Init(*prototype, F("oneof_uint32")));
+  ASSERT_TRUE(oneof_string_accessor.Init(*prototype, F("oneof_string")));
+  ASSERT_TRUE(repeated_accessor.Init(*prototype, F("repeated_int32")));
+
+  EXPECT_EQ("hello", default_string_accessor.Get(*message));
+
+  int32_accessor.Set(message.get(), 7);
+  string_accessor.Set(message.get(), "foo");
+  Message* nested = message_accessor.Mutable(message.get());
+  nested->GetReflection()->SetInt32(
+      nested, nested->GetDescriptor()->FindFieldByName("bb"), 3);
+  oneof_string_accessor.Set(message.get(), "bar");
+  oneof_uint32_accessor.Set(message.get(), 9);
+  repeated_accessor.Mutable(message.get())->Add(11);
+
+  // Check the results through reflection, and through the generated class
+  // by way of the wire format.
+  EXPECT_TRUE(reflection->HasField(*message, F("optional_int32")));
+  EXPECT_EQ(7, reflection->GetInt32(*message, F("optional_int32")));
+  EXPECT_EQ("foo", reflection->GetString(*message, F("optional_string")));
+  EXPECT_EQ(nested, &reflection->GetMessage(*message,
+                                            F("optional_nested_message")));
+  EXPECT_FALSE(reflection->HasField(*message, F("oneof_string")));
+
+  TestAllTypes parsed;
+  ASSERT_TRUE(parsed.ParseFromString(message->SerializeAsString()));
+  EXPECT_EQ(7, parsed.optional_int32());
+  EXPECT_EQ("foo", parsed.optional_string());
+  EXPECT_EQ(3, parsed.optional_nested_message().bb());
+  EXPECT_EQ(9, parsed.oneof_uint32());
+  ASSERT_EQ(1, parsed.repeated_int32_size());
+  EXPECT_EQ(11, parsed.repeated_int32(0));
+
+  EXPECT_EQ(9, oneof_uint32_accessor.Get(*message));
+  EXPECT_EQ("", oneof_string_accessor.Get(*message));
+}
+
+TEST(FieldAccessorTest, UnsupportedFields) {
+  TestAllTypes message;
+  FieldAccessor<int32> int32_accessor;
+  FieldAccessor<int64> int64_accessor;
+  FieldAccessor<string> string_accessor;
+  FieldAccessor<Message> message_accessor;
+  RepeatedFieldAccessor<int32> repeated_accessor;
+
+  // Wrong type or cardinality.
+  EXPECT_FALSE(int64_accessor.Init(message, F("optional_int32")));
+  EXPECT_FALSE(int32_accessor.Init(message, F("repeated_int32")));
+  EXPECT_FALSE(repeated_accessor.Init(message, F("optional_int32")));
+  EXPECT_FALSE(int32_accessor.Init(message, NULL));
+  EXPECT_TRUE(int32_accessor.field() == NULL);
+
+  // A field of another message type.
+  EXPECT_FALSE(int32_accessor.Init(
+      message, TestAllTypes::NestedMessage::descriptor()->FindFieldByName(
+                   "bb")));
+
+  // Storage which accessors do not handle.
+  EXPECT_FALSE(string_accessor.Init(message, F("optional_string_piece")));
+  EXPECT_FALSE(message_accessor.Init(message, F("optional_lazy_message")));
+  EXPECT_FALSE(int32_accessor.Init(
+      TestAllExtensions::default_instance(),
+      TestAllExtensions::descriptor()->file()->FindExtensionByName(
+          "optional_int32_extension")));
+}
+
+}  // namespace
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,263 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <google/protobuf/field_projection.h>
+
+#include <algorithm>
+
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/message.h>
+#include <google/protobuf/wire_format.h>
+#include <google/protobuf/wire_format_lite_inl.h>
+#include <google/protobuf/io/coded_stream.h>
+
+namespace google {
+namespace protobuf {
+
+using internal::WireFormat;
+using internal::WireFormatLite;
+
+// One selected field of a message.
+struct FieldProjection::Entry {
+  const FieldDescriptor* field;
+  // The selection within the field's message type (owned), or NULL if the
+  // whole field is selected.
+  Node* children;
+};
+
+// The selected fields of one message type.
+struct FieldProjection::Node {
+  explicit Node(const Descriptor* descriptor_in)
+      : descriptor(descriptor_in), max_number(0) {}
+  ~Node() {
+    for (int i = 0; i < entries.size(); i++) {
+      delete entries[i].children;
+    }
+  }
+
+  // Returns the entry for the given field number, or NULL.
+  const Entry* Find(int number) const {
+    if (number > max_number) return NULL;
+    vector<Entry>::const_iterator it =
+        lower_bound(entries.begin(), entries.end(), number, EntryLess());
+    return it != entries.end() && it->field->number() == number ? &*it : NULL;
+  }
+
+  // Returns the entry for the given field, adding one with no children if
+  // it is not there.  *added tells which happened.
+  Entry* FindOrAdd(const FieldDescriptor* field, bool* added) {
+    vector<Entry>::iterator it = lower_bound(
+        entries.begin(), entries.end(), field->number(), EntryLess());
+    *added = it == entries.end() || it->field->number() != field->number();
+    if (*added) {
+      Entry entry = { field, NULL };
+      it = entries.insert(it, entry);
+      max_number = max(max_number, field->number());
+    }
+    return &*it;
+  }
+
+  struct EntryLess {
+    bool operator()(const Entry& entry, int number) const {
+      return entry.field->number() < number;
+    }
+  };
+
+  const Descriptor* descriptor;
+  // Sorted by field number.
+  vector<Entry> entries;
+  // The largest number in entries, so that the many fields after it are
+  // skipped without searching.
+  int max_number;
+
+ private:
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(Node);
+};
+
+FieldProjection::FieldProjection(const Descriptor* descriptor)
+    : root_(new Node(descriptor)) {}
+
+FieldProjection::~FieldProjection() {}
+
+const Descriptor* FieldProjection::descriptor() const {
+  return root_->descriptor;
+}
+
+bool FieldProjection::AddPath(const vector<const FieldDescriptor*>& path) {
+  if (path.empty()) return false;
+  const Descriptor* type = root_->descriptor;
+  for (int i = 0; i < path.size(); i++) {
+    if (type == NULL || path[i]->containing_type() != type) return false;
+    type = path[i]->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE ?
+        path[i]->message_type() : NULL;
+  }
+
+  Node* node = root_.get();
+  for (int i = 0; i < path.size(); i++) {
+    bool last = i == path.size() - 1;
+    bool added;
+    Entry* entry = node->FindOrAdd(path[i], &added);
+    if (last) {
+      // Select all of the field, replacing any narrower selection.
+      delete entry->children;
+      entry->children = NULL;
+      return true;
+    }
+    if (added) {
+      entry->children = new Node(path[i]->message_type());
+    } else if (entry->children == NULL) {
+      // The whole field is already selected.
+      return true;
+    }
+    node = entry->children;
+  }
+  return true;
+}
+
+bool FieldProjection::AddPath(const string& path) {
+  vector<const FieldDescriptor*> fields;
+  const Descriptor* type = root_->descriptor;
+  string::size_type start = 0;
+  while (true) {
+    string::size_type end = path.find('.', start);
+    if (end == string::npos) end = path.size();
+    if (type == NULL) return false;
+    const FieldDescriptor* field =
+        type->FindFieldByName(path.substr(start, end - start));
+    if (field == NULL) return false;
+    fields.push_back(field);
+    if (end == path.size()) break;
+    type = field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE ?
+        field->message_type() : NULL;
+    start = end + 1;
+  }
+  return AddPath(fields);
+}
+
+bool FieldProjection::MergePartialFromCodedStream(
+    io::CodedInputStream* input, Message* message) const {
+  GOOGLE_DCHECK(message->GetDescriptor() == root_->descriptor);
+  return MergeNode(*root_, input, message);
+}
+
+bool FieldProjection::ParsePartialFromArray(const void* data, int size,
+                                            Message* message) const {
+  message->Clear();
+  io::CodedInputStream input(reinterpret_cast<const uint8*>(data), size);
+  return MergePartialFromCodedStream(&input, message) &&
+         input.ConsumedEntireMessage();
+}
+
+bool FieldProjection::ParsePartialFromString(const string& data,
+                                             Message* message) const {
+  return ParsePartialFromArray(data.data(), data.size(), message);
+}
+
+namespace {
+
+// Returns true if a field encoded with the given wire type can be parsed
+// as the given field.  Fields on the wire which do not match their
+// declaration are skipped rather than being kept as unknown fields, as
+// WireFormat::ParseAndMergeField() would.
+inline bool WireTypeMatches(WireFormatLite::WireType wire_type,
+                            const FieldDescriptor* field) {
+  return wire_type == WireFormat::WireTypeForFieldType(field->type()) ||
+         (field->is_packable() &&
+          wire_type == WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+}
+
+}  // namespace
+
+bool FieldProjection::MergeNode(const Node& node,
+                                io::CodedInputStream* input,
+                                Message* message) {
+  const Reflection* reflection = message->GetReflection();
+
+  while (true) {
+    uint32 tag = input->ReadTag();
+    if (tag == 0) {
+      // End of input.  This is a valid place to end, so return true.
+      return true;
+    }
+
+    WireFormatLite::WireType wire_type = WireFormatLite::GetTagWireType(tag);
+    if (wire_type == WireFormatLite::WIRETYPE_END_GROUP) {
+      // Must be the end of the message.
+      return true;
+    }
+
+    const Entry* entry = node.Find(WireFormatLite::GetTagFieldNumber(tag));
+    if (entry == NULL || !WireTypeMatches(wire_type, entry->field)) {
+      if (!WireFormatLite::SkipField(input, tag)) return false;
+      continue;
+    }
+
+    const FieldDescriptor* field = entry->field;
+    if (entry->children == NULL) {
+      if (!WireFormat::ParseAndMergeField(tag, field, message, input)) {
+        return false;
+      }
+      continue;
+    }
+
+    Message* sub_message;
+    if (field->is_repeated()) {
+      sub_message = reflection->AddMessage(
+          message, field, input->GetExtensionFactory());
+    } else {
+      sub_message = reflection->MutableMessage(
+          message, field, input->GetExtensionFactory());
+    }
+
+    if (field->type() == FieldDescriptor::TYPE_GROUP) {
+      if (!input->IncrementRecursionDepth()) return false;
+      if (!MergeNode(*entry->children, input, sub_message)) return false;
+      input->DecrementRecursionDepth();
+      if (!input->LastTagWas(WireFormatLite::MakeTag(
+              field->number(), WireFormatLite::WIRETYPE_END_GROUP))) {
+        return false;
+      }
+    } else {
+      uint32 length;
+      if (!input->ReadVarint32(&length)) return false;
+      if (!input->IncrementRecursionDepth()) return false;
+      io::CodedInputStream::Limit limit = input->PushLimit(length);
+      if (!MergeNode(*entry->children, input, sub_message)) return false;
+      // Make sure that parsing stopped when the limit was hit, not at an
+      // endgroup tag.
+      if (!input->ConsumedEntireMessage()) return false;
+      input->PopLimit(limit);
+      input->DecrementRecursionDepth();
+    }
+  }
+}
+
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,121 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// FieldProjection parses only a chosen subset of a message's fields.
+// Fields which were not asked for are skipped on the wire without being
+// decoded or stored, not even as unknown fields, so reading three fields of
+// a record with hundreds costs little more than scanning its tags:
+//
+//   FieldProjection projection(LogRecord::descriptor());
+//   GOOGLE_CHECK(projection.AddPath("timestamp"));
+//   GOOGLE_CHECK(projection.AddPath("request.url"));
+//   LogRecord record;
+//   while (...) {
+//     if (!projection.ParsePartialFromString(data, &record)) ...
+//   }
+//
+// Here record.request() ends up holding only its url field.  Selecting a
+// message field without naming any of its subfields keeps the whole
+// submessage.  Works with generated messages and with DynamicMessage.
+
+#ifndef GOOGLE_PROTOBUF_FIELD_PROJECTION_H__
+#define GOOGLE_PROTOBUF_FIELD_PROJECTION_H__
+
+#include <string>
+#include <vector>
+
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+  class Descriptor;              // descriptor.h
+  class FieldDescriptor;         // descriptor.h
+  class Message;                 // message.h
+  namespace io {
+    class CodedInputStream;      // coded_stream.h
+  }
+}
+
+namespace protobuf {
+
+// The selection is compiled into a tree of per-message tables when paths
+// are added; parsing only consults it.  Once all paths have been added, a
+// FieldProjection may be used by many threads at once.
+class LIBPROTOBUF_EXPORT FieldProjection {
+ public:
+  // Creates a projection of messages of the given type which selects no
+  // fields yet.
+  explicit FieldProjection(const Descriptor* descriptor);
+  ~FieldProjection();
+
+  const Descriptor* descriptor() const;
+
+  // Selects a field.  path[0] must be a field (or an extension) of
+  // descriptor(), and each following element a field of the message type
+  // of the one before it.  Selecting a field selects everything within it,
+  // so after AddPath({a}), AddPath({a, b}) changes nothing, while after
+  // AddPath({a, b}), AddPath({a}) widens the selection to all of a.
+  // Returns false, selecting nothing, if the path is empty or invalid.
+  bool AddPath(const vector<const FieldDescriptor*>& path);
+
+  // Like above, but names the fields, separated by dots, e.g.
+  // "request.url".  Extensions cannot be named this way.
+  bool AddPath(const string& path);
+
+  // Reads a message from the input, merging the selected fields into
+  // *message and skipping all others.  Like
+  // Message::MergePartialFromCodedStream(), this does not check that
+  // required fields are set.  message must be of type descriptor().
+  bool MergePartialFromCodedStream(io::CodedInputStream* input,
+                                   Message* message) const;
+
+  // Clears *message and parses the selected fields of the given data into
+  // it.
+  bool ParsePartialFromArray(const void* data, int size,
+                             Message* message) const;
+  bool ParsePartialFromString(const string& data, Message* message) const;
+
+ private:
+  struct Node;
+  struct Entry;
+
+  // Merges the selected fields of one message (or group) from the input.
+  static bool MergeNode(const Node& node, io::CodedInputStream* input,
+                        Message* message);
+
+  scoped_ptr<Node> root_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(FieldProjection);
+};
+
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_FIELD_PROJECTION_H__
@@ -0,0 +1,310 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <google/protobuf/field_projection.h>
+
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/dynamic_message.h>
+#include <google/protobuf/unittest.pb.h>
+#include <google/protobuf/test_util.h>
+#include <google/protobuf/wire_format_lite.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
+#include <google/protobuf/stubs/common.h>
+#include <gtest/gtest.h>
+
+namespace google {
+namespace protobuf {
+namespace {
+
+using protobuf_unittest::NestedTestAllTypes;
+using protobuf_unittest::TestAllExtensions;
+using protobuf_unittest::TestAllTypes;
+using protobuf_unittest::TestPackedTypes;
+using protobuf_unittest::TestUnpackedTypes;
+
+// Returns all fields set in a serialized TestAllTypes.
+string AllFields() {
+  TestAllTypes message;
+  TestUtil::SetAllFields(&message);
+  return message.SerializeAsString();
+}
+
+TEST(FieldProjectionTest, TopLevelFields) {
+  FieldProjection projection(TestAllTypes::descriptor());
+  EXPECT_EQ(TestAllTypes::descriptor(), projection.descriptor());
+  ASSERT_TRUE(projection.AddPath("optional_int64"));
+  ASSERT_TRUE(projection.AddPath("optional_string"));
+  ASSERT_TRUE(projection.AddPath("repeated_fixed32"));
+
+  TestAllTypes message;
+  message.set_optional_int32(1);  // Cleared by parsing.
+  ASSERT_TRUE(projection.ParsePartialFromString(AllFields(), &message));
+
+  TestAllTypes expected;
+  expected.set_optional_int64(102);
+  expected.set_optional_string("115");
+  expected.add_repeated_fixed32(207);
+  expected.add_repeated_fixed32(307);
+  EXPECT_EQ(expected.DebugString(), message.DebugString());
+  EXPECT_EQ(0, message.unknown_fields().field_count());
+}
+
+TEST(FieldProjectionTest, NothingSelected) {
+  FieldProjection projection(TestAllTypes::descriptor());
+  TestAllTypes message;
+  ASSERT_TRUE(projection.ParsePartialFromString(AllFields(), &message));
+  EXPECT_EQ(0, message.ByteSize());
+}
+
+TEST(FieldProjectionTest, WholeSubmessages) {
+  FieldProjection projection(TestAllTypes::descriptor());
+  ASSERT_TRUE(projection.AddPath("optional_nested_message"));
+  ASSERT_TRUE(projection.AddPath("repeated_foreign_message"));
+  ASSERT_TRUE(projection.AddPath("optionalgroup"));
+
+  TestAllTypes message;
+  ASSERT_TRUE(projection.ParsePartialFromString(AllFields(), &message));
+
+  TestAllTypes all;
+  TestUtil::SetAllFields(&all);
+  TestAllTypes expected;
+  *expected.mutable_optional_nested_message() = all.optional_nested_message();
+  *expected.mutable_repeated_foreign_message() =
+      all.repeated_foreign_message();
+  *expected.mutable_optionalgroup() = all.optionalgroup();
+  EXPECT_EQ(expected.DebugString(), message.DebugString());
+}
+
+TEST(FieldProjectionTest, NestedPaths) {
+  NestedTestAllTypes source;
+  TestUtil::SetAllFields(source.mutable_payload());
+  TestUtil::SetAllFields(source.mutable_child()->mutable_payload());
+  source.mutable_child()->mutable_child()->mutable_payload()
+      ->set_optional_int32(5);
+
+  FieldProjection projection(NestedTestAllTypes::descriptor());
+  ASSERT_TRUE(projection.AddPath("child.payload.optional_int32"));
+  ASSERT_TRUE(projection.AddPath("child.payload.repeated_nested_message.bb"));
+  ASSERT_TRUE(projection.AddPath("payload.optionalgroup.a"));
+
+  NestedTestAllTypes message;
+  ASSERT_TRUE(projection.ParsePartialFromString(source.SerializeAsString(),
+                                                &message));
+
+  NestedTestAllTypes expected;
+  TestAllTypes* child_payload = expected.mutable_child()->mutable_payload();
+  child_payload->set_optional_int32(101);
+  child_payload->add_repeated_nested_message()->set_bb(218);
+  child_payload->add_repeated_nested_message()->set_bb(318);
+  expected.mutable_payload()->mutable_optionalgroup()->set_a(117);
+  EXPECT_EQ(expected.DebugString(), message.DebugString());
+}
+
+TEST(FieldProjectionTest, WiderPathWins) {
+  NestedTestAllTypes source;
+  TestUtil::SetAllFields(source.mutable_payload());
+  string data = source.SerializeAsString();
+
+  // A path below a whole field changes nothing...
+  FieldProjection projection(NestedTestAllTypes::descriptor());
+  ASSERT_TRUE(projection.AddPath("payload"));
+  ASSERT_TRUE(projection.AddPath("payload.optional_int32"));
+  NestedTestAllTypes message;
+  ASSERT_TRUE(projection.ParsePartialFromString(data, &message));
+  TestUtil::ExpectAllFieldsSet(message.payload());
+
+  // ...and a whole field replaces paths below it.
+  FieldProjection projection2(NestedTestAllTypes::descriptor());
+  ASSERT_TRUE(projection2.AddPath("payload.optional_int32"));
+  ASSERT_TRUE(projection2.AddPath("payload"));
+  message.Clear();
+  ASSERT_TRUE(projection2.ParsePartialFromString(data, &message));
+  TestUtil::ExpectAllFieldsSet(message.payload());
+}
+
+TEST(FieldProjectionTest, PackedAndUnpacked) {
+  TestPackedTypes packed;
+  TestUtil::SetPackedFields(&packed);
+  TestUnpackedTypes unpacked;
+  TestUtil::SetUnpackedFields(&unpacked);
+
+  FieldProjection projection(TestPackedTypes::descriptor());
+  ASSERT_TRUE(projection.AddPath("packed_sint64"));
+
+  // Packed fields may be sent unpacked, and vice versa.
+  TestPackedTypes message;
+  ASSERT_TRUE(projection.ParsePartialFromString(packed.SerializeAsString(),
+                                                &message));
+  ASSERT_EQ(2, message.packed_sint64_size());
+  EXPECT_EQ(606, message.packed_sint64(0));
+  EXPECT_EQ(706, message.packed_sint64(1));
+  EXPECT_EQ(0, message.packed_int32_size());
+
+  ASSERT_TRUE(projection.ParsePartialFromString(unpacked.SerializeAsString(),
+                                                &message));
+  ASSERT_EQ(2, message.packed_sint64_size());
+  EXPECT_EQ(606, message.packed_sint64(0));
+  EXPECT_EQ(0, message.unknown_fields().field_count());
+}
+
+TEST(FieldProjectionTest, Extensions) {
+  TestAllExtensions source;
+  TestUtil::SetAllExtensions(&source);
+
+  const FileDescriptor* file = TestAllExtensions::descriptor()->file();
+  vector<const FieldDescriptor*> path;
+  path.push_back(
+      file->FindExtensionByName("optional_nested_message_extension"));
+  path.push_back(TestAllTypes::NestedMessage::descriptor()->field(0));
+  vector<const FieldDescriptor*> path2;
+  path2.push_back(file->FindExtensionByName("optional_int32_extension"));
+
+  FieldProjection projection(TestAllExtensions::descriptor());
+  ASSERT_TRUE(projection.AddPath(path));
+  ASSERT_TRUE(projection.AddPath(path2));
+
+  TestAllExtensions message;
+  ASSERT_TRUE(projection.ParsePartialFromString(source.SerializeAsString(),
+                                                &message));
+  EXPECT_EQ(101, message.GetExtension(
+      protobuf_unittest::optional_int32_extension));
+  EXPECT_EQ(118, message.GetExtension(
+      protobuf_unittest::optional_nested_message_extension).bb());
+  EXPECT_FALSE(message.HasExtension(
+      protobuf_unittest::optional_int64_extension));
+  EXPECT_EQ(0, message.unknown_fields().field_count());
+}
+
+TEST(FieldProjectionTest, DynamicMessage) {
+  DynamicMessageFactory factory;
+  const Descriptor* descriptor = NestedTestAllTypes::descriptor();
+  scoped_ptr<Message> message(factory.GetPrototype(descriptor)->New());
+
+  NestedTestAllTypes source;
+  TestUtil::SetAllFields(source.mutable_child()->mutable_payload());
+  FieldProjection projection(descriptor);
+  ASSERT_TRUE(projection.AddPath("child.payload.optional_string"));
+  ASSERT_TRUE(projection.AddPath("child.payload.repeated_int32"));
+  ASSERT_TRUE(projection.ParsePartialFromString(source.SerializeAsString(),
+                                                message.get()));
+
+  NestedTestAllTypes result;
+  ASSERT_TRUE(result.ParseFromString(message->SerializeAsString()));
+  NestedTestAllTypes expected;
+  TestAllTypes* payload = expected.mutable_child()->mutable_payload();
+  payload->set_optional_string("115");
+  payload->add_repeated_int32(201);
+  payload->add_repeated_int32(301);
+  EXPECT_EQ(expected.DebugString(), result.DebugString());
+}
+
+TEST(FieldProjectionTest, MismatchedWireTypeIsSkipped) {
+  // optional_int32 sent as a string.
+  string data;
+  {
+    io::StringOutputStream output(&data);
+    io::CodedOutputStream coded_output(&output);
+    internal::WireFormatLite::WriteString(1, "foo", &coded_output);
+    internal::WireFormatLite::WriteInt64(2, 5, &coded_output);
+  }
+
+  FieldProjection projection(TestAllTypes::descriptor());
+  ASSERT_TRUE(projection.AddPath("optional_int32"));
+  ASSERT_TRUE(projection.AddPath("optional_int64"));
+  TestAllTypes message;
+  ASSERT_TRUE(projection.ParsePartialFromString(data, &message));
+  EXPECT_FALSE(message.has_optional_int32());
+  EXPECT_EQ(5, message.optional_int64());
+  EXPECT_EQ(0, message.unknown_fields().field_count());
+}
+
+TEST(FieldProjectionTest, InvalidPaths) {
+  FieldProjection projection(NestedTestAllTypes::descriptor());
+  EXPECT_FALSE(projection.AddPath(""));
+  EXPECT_FALSE(projection.AddPath("nonexistent"));
+  EXPECT_FALSE(projection.AddPath("payload."));
+  EXPECT_FALSE(projection.AddPath(".payload"));
+  EXPECT_FALSE(projection.AddPath("payload..optional_int32"));
+  EXPECT_FALSE(projection.AddPath("payload.optional_int32.foo"));
+  EXPECT_FALSE(projection.AddPath(vector<const FieldDescriptor*>()));
+
+  vector<const FieldDescriptor*> path;
+  path.push_back(TestAllTypes::descriptor()->FindFieldByName("optional_int32"));
+  EXPECT_FALSE(projection.AddPath(path));
+
+  // Nothing was selected.
+  NestedTestAllTypes source;
+  TestUtil::SetAllFields(source.mutable_payload());
+  NestedTestAllTypes message;
+  ASSERT_TRUE(projection.ParsePartialFromString(source.SerializeAsString(),
+                                                &message));
+  EXPECT_EQ(0, message.ByteSize());
+}
+
+TEST(FieldProjectionTest, MalformedInput) {
+  FieldProjection projection(NestedTestAllTypes::descriptor());
+  ASSERT_TRUE(projection.AddPath("child.payload.optional_int32"));
+
+  NestedTestAllTypes source;
+  TestUtil::SetAllFields(source.mutable_child()->mutable_payload());
+  TestUtil::SetAllFields(source.mutable_payload());
+  string data = source.SerializeAsString();
+
+  int child_size = source.child().ByteSize();
+  int child_end =
+      1 + io::CodedOutputStream::VarintSize32(child_size) + child_size;
+  NestedTestAllTypes message;
+  NestedTestAllTypes full;
+
+  // Truncated inside the selected child, the projection fails whenever
+  // the regular parser does.  (The regular parser accepts a submessage
+  // which ends early on a field boundary, and so does the projection for
+  // the submessages it parses; those it skips must be complete.)
+  for (int size = 1; size <= child_end; size++) {
+    if (!full.ParsePartialFromArray(data.data(), size)) {
+      EXPECT_FALSE(projection.ParsePartialFromArray(data.data(), size,
+                                                    &message)) << size;
+    }
+  }
+  // Truncated inside the skipped payload, it always fails.
+  for (int size = child_end + 1; size < data.size(); size++) {
+    EXPECT_FALSE(projection.ParsePartialFromArray(data.data(), size,
+                                                  &message)) << size;
+  }
+
+  // A stray end-group tag.
+  EXPECT_FALSE(projection.ParsePartialFromString("\014", &message));
+}
+
+}  // namespace
+}  // namespace protobuf
+}  // namespace google
@@ -36,10 +36,14 @@
 #include <set>
 #include <google/protobuf/descriptor.pb.h>
 #include <google/protobuf/generated_message_reflection.h>
+#include <google/protobuf/arena.h>
 #include <google/protobuf/descriptor.h>
 #include <google/protobuf/repeated_field.h>
 #include <google/protobuf/extension_set.h>
+#include <google/protobuf/field_accessor.h>
 #include <google/protobuf/generated_message_util.h>
+#include <google/protobuf/lazy_field.h>
+#include <google/protobuf/string_piece_field.h>
 #include <google/protobuf/stubs/common.h>
 
 #define GOOGLE_PROTOBUF_HAS_ONEOF
@@ -60,6 +64,19 @@ int StringSpaceUsedExcludingSelf(const string& str) {
   }
 }
 
+bool IsStringPieceField(const FieldDescriptor* field) {
+  return field->cpp_type() == FieldDescriptor::CPPTYPE_STRING &&
+         field->options().ctype() == FieldOptions::STRING_PIECE &&
+         !field->is_repeated() && field->containing_oneof() == NULL;
+}
+
+bool IsLazyField(const FieldDescriptor* field) {
+  return field->type() == FieldDescriptor::TYPE_MESSAGE &&
+         field->options().lazy() && !field->options().weak() &&
+         !field->is_repeated() && !field->is_extension() &&
+         field->containing_oneof() == NULL;
+}
+
 bool ParseNamedEnum(const EnumDescriptor* descriptor,
                     const string& name,
                     int* value) {
@@ -301,6 +318,20 @@ int GeneratedMessageReflection::SpaceUsed(const Message& message) const {
 
         case FieldDescriptor::CPPTYPE_STRING: {
           switch (field->options().ctype()) {
+            case FieldOptions::STRING_PIECE:
+              if (IsStringPieceField(field)) {
+                // Aliased bytes belong to someone else; only count the
+                // field's own storage.
+                const string* ptr =
+                    GetField<StringPieceField>(message, field).GetOwned();
+                if (ptr != NULL) {
+                  total_size +=
+                      sizeof(*ptr) + StringSpaceUsedExcludingSelf(*ptr);
+                }
+                break;
+              }
+              // Oneof members are stored as string*.
+              // Fall through.
             default:  // TODO(kenton):  Support other string reps.
             case FieldOptions::STRING: {
               const string* ptr = GetField<const string*>(message, field);
@@ -325,6 +356,16 @@ int GeneratedMessageReflection::SpaceUsed(const Message& message) const {
           if (&message == default_instance_) {
             // For singular fields, the prototype just stores a pointer to the
             // external type's prototype, so there is no extra memory usage.
+          } else if (IsLazyField(field)) {
+            const LazyField& lazy = GetRaw<LazyField>(message, field);
+            if (lazy.message() != NULL) {
+              total_size +=
+                  down_cast<const Message*>(lazy.message())->SpaceUsed();
+            }
+            if (lazy.bytes() != NULL) {
+              total_size += sizeof(*lazy.bytes()) +
+                            StringSpaceUsedExcludingSelf(*lazy.bytes());
+            }
           } else {
             const Message* sub_message = GetRaw<const Message*>(message, field);
             if (sub_message != NULL) {
@@ -388,12 +429,24 @@ void GeneratedMessageReflection::SwapField(
       SWAP_VALUES(ENUM  , int   );
 #undef SWAP_VALUES
       case FieldDescriptor::CPPTYPE_MESSAGE:
+        if (IsLazyField(field)) {
+          MutableRaw<LazyField>(message1, field)->Swap(
+              MutableRaw<LazyField>(message2, field));
+          break;
+        }
         std::swap(*MutableRaw<Message*>(message1, field),
                   *MutableRaw<Message*>(message2, field));
         break;
 
       case FieldDescriptor::CPPTYPE_STRING:
         switch (field->options().ctype()) {
+          case FieldOptions::STRING_PIECE:
+            if (IsStringPieceField(field)) {
+              MutableRaw<StringPieceField>(message1, field)->Swap(
+                  MutableRaw<StringPieceField>(message2, field));
+              break;
+            }
+            // Fall through.
           default:  // TODO(kenton):  Support other string reps.
           case FieldOptions::STRING:
             std::swap(*MutableRaw<string*>(message1, field),
@@ -549,6 +602,17 @@ void GeneratedMessageReflection::Swap(
     << "\").  Note that the exact same class is required; not just the same "
        "descriptor.";
 
+  if (message1->GetArena() != message2->GetArena()) {
+    // The two messages' sub-objects are owned by different arenas, so their
+    // pointers can't be exchanged.  Swap by copying instead.
+    Message* temp = message1->New();
+    temp->MergeFrom(*message1);
+    message1->CopyFrom(*message2);
+    message2->CopyFrom(*temp);
+    delete temp;
+    return;
+  }
+
   uint32* has_bits1 = MutableHasBits(message1);
   uint32* has_bits2 = MutableHasBits(message2);
   int has_bits_size = (descriptor_->field_count() + 31) / 32;
@@ -597,6 +661,21 @@ void GeneratedMessageReflection::SwapFields(
     << "\").  Note that the exact same class is required; not just the same "
        "descriptor.";
 
+  if (message1->GetArena() != message2->GetArena()) {
+    // Move each side's fields into an empty message on its own arena, then
+    // copy them across.  MergeFrom() only touches the fields which are set,
+    // i.e. exactly the ones being swapped.
+    Message* temp1 = message1->New(message1->GetArena());
+    Message* temp2 = message2->New(message2->GetArena());
+    SwapFields(temp1, message1, fields);
+    SwapFields(temp2, message2, fields);
+    message1->MergeFrom(*temp2);
+    message2->MergeFrom(*temp1);
+    if (message1->GetArena() == NULL) delete temp1;
+    if (message2->GetArena() == NULL) delete temp2;
+    return;
+  }
+
   std::set<int> swapped_oneof;
 
   for (int i = 0; i < fields.size(); i++) {
@@ -714,6 +793,13 @@ void GeneratedMessageReflection::ClearField(
 
         case FieldDescriptor::CPPTYPE_STRING: {
           switch (field->options().ctype()) {
+            case FieldOptions::STRING_PIECE:
+              if (IsStringPieceField(field)) {
+                MutableRaw<StringPieceField>(message, field)->ClearToDefault(
+                    field->default_value_string());
+                break;
+              }
+              // Fall through.
             default:  // TODO(kenton):  Support other string reps.
             case FieldOptions::STRING:
               const string* default_ptr = DefaultRaw<const string*>(field);
@@ -731,6 +817,10 @@ void GeneratedMessageReflection::ClearField(
         }
 
         case FieldDescriptor::CPPTYPE_MESSAGE:
+          if (IsLazyField(field)) {
+            MutableRaw<LazyField>(message, field)->Clear();
+            break;
+          }
           (*MutableRaw<Message*>(message, field))->Clear();
           break;
       }
@@ -993,6 +1083,11 @@ string GeneratedMessageReflection::GetString(
                                               field->default_value_string());
   } else {
     switch (field->options().ctype()) {
+      case FieldOptions::STRING_PIECE:
+        if (IsStringPieceField(field)) {
+          return GetField<StringPieceField>(message, field).Get().ToString();
+        }
+        // Fall through.
       default:  // TODO(kenton):  Support other string reps.
       case FieldOptions::STRING:
         return *GetField<const string*>(message, field);
@@ -1012,6 +1107,15 @@ const string& GeneratedMessageReflection::GetStringReference(
                                               field->default_value_string());
   } else {
     switch (field->options().ctype()) {
+      case FieldOptions::STRING_PIECE:
+        if (IsStringPieceField(field)) {
+          const StringPieceField& value =
+              GetField<StringPieceField>(message, field);
+          if (value.GetOwned() != NULL) return *value.GetOwned();
+          value.Get().CopyToString(scratch);
+          return *scratch;
+        }
+        // Fall through.
       default:  // TODO(kenton):  Support other string reps.
       case FieldOptions::STRING:
         return *GetField<const string*>(message, field);
@@ -1032,15 +1136,23 @@ void GeneratedMessageReflection::SetString(
                                                    field->type(), value, field);
   } else {
     switch (field->options().ctype()) {
+      case FieldOptions::STRING_PIECE:
+        if (IsStringPieceField(field)) {
+          MutableField<StringPieceField>(message, field)->Set(
+              value.data(), value.size(), message->GetArena());
+          break;
+        }
+        // Fall through.
       default:  // TODO(kenton):  Support other string reps.
       case FieldOptions::STRING: {
         if (field->containing_oneof() && !HasOneofField(*message, field)) {
           ClearOneof(message, field->containing_oneof());
-          *MutableField<string*>(message, field) = new string;
+          *MutableField<string*>(message, field) =
+              Arena::Create<string>(message->GetArena());
         }
         string** ptr = MutableField<string*>(message, field);
         if (*ptr == DefaultRaw<const string*>(field)) {
-          *ptr = new string(value);
+          *ptr = Arena::Create<string>(message->GetArena(), value);
         } else {
           (*ptr)->assign(value);
         }
@@ -1219,6 +1331,11 @@ const Message& GeneratedMessageReflection::GetMessage(
     return static_cast<const Message&>(
         GetExtensionSet(message).GetMessage(
           field->number(), field->message_type(), factory));
+  } else if (IsLazyField(field)) {
+    // The default instance's field refers to the prototype of its type.
+    const MessageLite& prototype = *DefaultRaw<LazyField>(field).message();
+    return *down_cast<const Message*>(
+        &GetRaw<LazyField>(message, field).Get(prototype));
   } else {
     const Message* result;
     result = GetRaw<const Message*>(message, field);
@@ -1237,6 +1354,10 @@ Message* GeneratedMessageReflection::MutableMessage(
   if (field->is_extension()) {
     return static_cast<Message*>(
         MutableExtensionSet(message)->MutableMessage(field, factory));
+  } else if (IsLazyField(field)) {
+    SetBit(message, field);
+    return down_cast<Message*>(MutableRaw<LazyField>(message, field)->Mutable(
+        *DefaultRaw<LazyField>(field).message(), message->GetArena()));
   } else {
     Message* result;
     Message** result_holder = MutableRaw<Message*>(message, field);
@@ -1246,7 +1367,7 @@ Message* GeneratedMessageReflection::MutableMessage(
         ClearOneof(message, field->containing_oneof());
         result_holder = MutableField<Message*>(message, field);
         const Message* default_message = DefaultRaw<const Message*>(field);
-        *result_holder = default_message->New();
+        *result_holder = default_message->New(message->GetArena());
       }
     } else {
       SetBit(message, field);
@@ -1254,7 +1375,7 @@ Message* GeneratedMessageReflection::MutableMessage(
 
     if (*result_holder == NULL) {
       const Message* default_message = DefaultRaw<const Message*>(field);
-      *result_holder = default_message->New();
+      *result_holder = default_message->New(message->GetArena());
     }
     result = *result_holder;
     return result;
@@ -1270,7 +1391,19 @@ void GeneratedMessageReflection::SetAllocatedMessage(
   if (field->is_extension()) {
     MutableExtensionSet(message)->SetAllocatedMessage(
         field->number(), field->type(), field, sub_message);
+  } else if (IsLazyField(field)) {
+    if (sub_message == NULL) {
+      ClearBit(message, field);
+    } else {
+      SetBit(message, field);
+    }
+    MutableRaw<LazyField>(message, field)->SetAllocated(sub_message,
+                                                        message->GetArena());
   } else {
+    Arena* arena = message->GetArena();
+    if (arena != NULL) {
+      arena->Own(sub_message);
+    }
     if (field->containing_oneof()) {
       if (sub_message == NULL) {
         ClearOneof(message, field->containing_oneof());
@@ -1288,7 +1421,9 @@ void GeneratedMessageReflection::SetAllocatedMessage(
       SetBit(message, field);
     }
     Message** sub_message_holder = MutableRaw<Message*>(message, field);
-    delete *sub_message_holder;
+    if (arena == NULL) {
+      delete *sub_message_holder;
+    }
     *sub_message_holder = sub_message;
   }
 }
@@ -1304,6 +1439,10 @@ Message* GeneratedMessageReflection::ReleaseMessage(
   if (field->is_extension()) {
     return static_cast<Message*>(
         MutableExtensionSet(message)->ReleaseMessage(field, factory));
+  } else if (IsLazyField(field)) {
+    ClearBit(message, field);
+    return down_cast<Message*>(MutableRaw<LazyField>(message, field)->Release(
+        *DefaultRaw<LazyField>(field).message(), message->GetArena()));
   } else {
     ClearBit(message, field);
     if (field->containing_oneof()) {
@@ -1316,6 +1455,12 @@ Message* GeneratedMessageReflection::ReleaseMessage(
     Message** result = MutableRaw<Message*>(message, field);
     Message* ret = *result;
     *result = NULL;
+    if (ret != NULL && message->GetArena() != NULL) {
+      // The arena still owns ret; give the caller a heap copy.
+      Message* copy = ret->New();
+      copy->MergeFrom(*ret);
+      ret = copy;
+    }
     return ret;
   }
 }
@@ -1371,8 +1516,9 @@ Message* GeneratedMessageReflection::AddMessage(
       } else {
         prototype = &repeated->Get<GenericTypeHandler<Message> >(0);
       }
-      result = prototype->New();
-      repeated->AddAllocated<GenericTypeHandler<Message> >(result);
+      result = prototype->New(message->GetArena());
+      // result is already owned by the message's arena, if it has one.
+      repeated->UnsafeArenaAddAllocated<GenericTypeHandler<Message> >(result);
     }
     return result;
   }
@@ -1397,6 +1543,43 @@ void* GeneratedMessageReflection::MutableRawRepeatedField(
     return reinterpret_cast<uint8*>(message) + offsets_[field->index()];
 }
 
+bool GeneratedMessageReflection::GetFieldLayout(
+    const FieldDescriptor* field, FieldLayout* layout) const {
+  if (field->containing_type() != descriptor_ || field->is_extension() ||
+      IsStringPieceField(field) || IsLazyField(field)) {
+    return false;
+  }
+
+  const OneofDescriptor* oneof = field->containing_oneof();
+  if (oneof != NULL) {
+    // All members of a oneof share one slot, found after the fields, and
+    // the default values live in default_oneof_instance_.
+    layout->offset = offsets_[descriptor_->field_count() + oneof->index()];
+    layout->has_bits_word_offset = -1;
+    layout->has_bit_mask = 0;
+    layout->oneof_case_offset =
+        oneof_case_offset_ + oneof->index() * sizeof(uint32);
+    layout->default_storage =
+        reinterpret_cast<const uint8*>(default_oneof_instance_) +
+        offsets_[field->index()];
+  } else {
+    layout->offset = offsets_[field->index()];
+    if (field->is_repeated()) {
+      layout->has_bits_word_offset = -1;
+      layout->has_bit_mask = 0;
+    } else {
+      layout->has_bits_word_offset =
+          has_bits_offset_ + (field->index() / 32) * sizeof(uint32);
+      layout->has_bit_mask = 1u << (field->index() % 32);
+    }
+    layout->oneof_case_offset = -1;
+    layout->default_storage =
+        reinterpret_cast<const uint8*>(default_instance_) +
+        offsets_[field->index()];
+  }
+  return true;
+}
+
 const FieldDescriptor* GeneratedMessageReflection::GetOneofFieldDescriptor(
     const Message& message,
     const OneofDescriptor* oneof_descriptor) const {
@@ -1587,6 +1770,11 @@ inline void GeneratedMessageReflection::ClearOneof(
   uint32 oneof_case = GetOneofCase(*message, oneof_descriptor);
   if (oneof_case > 0) {
     const FieldDescriptor* field = descriptor_->FindFieldByNumber(oneof_case);
+    // Objects on an arena are freed along with it.
+    if (message->GetArena() != NULL) {
+      *MutableOneofCase(message, oneof_descriptor) = 0;
+      return;
+    }
     switch (field->cpp_type()) {
       case FieldDescriptor::CPPTYPE_STRING: {
         switch (field->options().ctype()) {
@@ -44,6 +44,7 @@
 // TODO(jasonh): Remove this once the compiler change to directly include this
 // is released to components.
 #include <google/protobuf/generated_enum_reflection.h>
+#include <google/protobuf/generated_message_util.h>
 #include <google/protobuf/message.h>
 #include <google/protobuf/unknown_field_set.h>
 
@@ -334,6 +335,9 @@ class LIBPROTOBUF_EXPORT GeneratedMessageReflection : public Reflection {
       Message* message, const FieldDescriptor* field, FieldDescriptor::CppType,
       int ctype, const Descriptor* desc) const;
 
+  virtual bool GetFieldLayout(const FieldDescriptor* field,
+                              FieldLayout* layout) const;
+
  private:
   friend class GeneratedMessage;
 
@@ -441,25 +445,19 @@ class LIBPROTOBUF_EXPORT GeneratedMessageReflection : public Reflection {
   GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(GeneratedMessageReflection);
 };
 
-// Returns the offset of the given field within the given aggregate type.
-// This is equivalent to the ANSI C offsetof() macro.  However, according
-// to the C++ standard, offsetof() only works on POD types, and GCC
-// enforces this requirement with a warning.  In practice, this rule is
-// unnecessarily strict; there is probably no compiler or platform on
-// which the offsets of the direct fields of a class are non-constant.
-// Fields inherited from superclasses *can* have non-constant offsets,
-// but that's not what this macro will be used for.
-//
-// Note that we calculate relative to the pointer value 16 here since if we
-// just use zero, GCC complains about dereferencing a NULL pointer.  We
-// choose 16 rather than some other number just in case the compiler would
-// be confused by an unaligned pointer.
-#define GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(TYPE, FIELD)    \
-  static_cast<int>(                                           \
-      reinterpret_cast<const char*>(                          \
-          &reinterpret_cast<const TYPE*>(16)->FIELD) -        \
-      reinterpret_cast<const char*>(16))
+// Returns true if the field is stored as a StringPieceField (see
+// string_piece_field.h): a singular string or bytes field declared with
+// [ctype=STRING_PIECE] which is not part of a oneof.  All other string fields
+// are stored as string* or RepeatedPtrField<string>, whatever their ctype.
+LIBPROTOBUF_EXPORT bool IsStringPieceField(const FieldDescriptor* field);
 
+// Returns true if the field is stored as a LazyField (see lazy_field.h): a
+// singular, non-weak message field declared with [lazy=true] which is not
+// part of a oneof.  Groups, extensions and all other message fields are
+// stored as Message* or RepeatedPtrField<Message>.
+LIBPROTOBUF_EXPORT bool IsLazyField(const FieldDescriptor* field);
+
+// Returns the offset of the given field within the given aggregate type.
 #define PROTO2_GENERATED_DEFAULT_ONEOF_FIELD_OFFSET(ONEOF, FIELD)     \
   static_cast<int>(                                                   \
       reinterpret_cast<const char*>(&(ONEOF->FIELD))                  \
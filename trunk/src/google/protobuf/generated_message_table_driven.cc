@@ -0,0 +1,89 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <google/protobuf/generated_message_table_driven.h>
+#include <google/protobuf/generated_message_table_driven_lite.h>
+#include <google/protobuf/message.h>
+#include <google/protobuf/unknown_field_set.h>
+#include <google/protobuf/wire_format.h>
+
+namespace google {
+namespace protobuf {
+namespace internal {
+
+namespace {
+
+// Stores unknown fields, and unknown extensions, in the UnknownFieldSet used
+// by messages with descriptors.
+class UnknownFieldHandler {
+ public:
+  static bool Skip(MessageLite* msg, const ParseTable& table,
+                   io::CodedInputStream* input, uint32 tag) {
+    UnknownFieldSet* unknown_fields =
+        MutableField<UnknownFieldSet>(msg, table.unknown_fields_offset);
+    const Message* prototype =
+        down_cast<const Message*>(table.default_instance);
+    if (table.extensions_offset != -1 &&
+        (!table.unknown_fields_as_bytes ||
+         prototype->GetDescriptor()->IsExtensionNumber(
+             WireFormatLite::GetTagFieldNumber(tag)))) {
+      // ExtensionSet::ParseField() skips fields with no known extension.
+      return MutableField<ExtensionSet>(msg, table.extensions_offset)->
+          ParseField(tag, input, prototype, unknown_fields);
+    }
+    if (table.unknown_fields_as_bytes) {
+      return WireFormat::SkipFieldAsBytes(input, tag, unknown_fields);
+    }
+    return WireFormat::SkipField(input, tag, unknown_fields);
+  }
+
+  static void AddVarint(MessageLite* msg, const ParseTable& table,
+                        uint32 tag, int value) {
+    MutableField<UnknownFieldSet>(msg, table.unknown_fields_offset)->
+        AddVarint(WireFormatLite::GetTagFieldNumber(tag), value);
+  }
+
+  static void VerifyUtf8(const ParseTableField& field, StringPiece value) {
+    WireFormat::VerifyUTF8StringNamedField(
+        value.data(), value.length(), WireFormat::PARSE, field.name);
+  }
+};
+
+}  // namespace
+
+bool MergePartialFromCodedStream(MessageLite* msg, const ParseTable& table,
+                                 io::CodedInputStream* input) {
+  return MergePartialFromCodedStreamImpl<UnknownFieldHandler>(
+      msg, table, input);
+}
+
+}  // namespace internal
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,120 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// This file contains the data structures used by generated code compiled
+// with the table_driven_parsing option.  Rather than emitting a dedicated
+// MergePartialFromCodedStream() for every message, the generator emits a
+// compact table describing the message's fields and a one-line method that
+// hands the table to a shared interpreter.  This file should not be used
+// directly by users.
+
+#ifndef GOOGLE_PROTOBUF_GENERATED_MESSAGE_TABLE_DRIVEN_H__
+#define GOOGLE_PROTOBUF_GENERATED_MESSAGE_TABLE_DRIVEN_H__
+
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+  class MessageLite;
+  namespace io {
+    class CodedInputStream;
+  }
+}
+
+namespace protobuf {
+namespace internal {
+
+// Describes how to parse one field of a message.
+struct ParseTableField {
+  // Values for |flags|.
+  enum {
+    kRepeated = 1,     // The field is repeated.
+    kOneof = 2,        // The field is a member of a oneof.
+    kVerifyUtf8 = 4,   // Log an error when parsing invalid UTF-8.
+    kStringPiece = 8,  // The field is stored as a StringPieceField.
+    kLazy = 16         // The field is stored as a LazyField.
+  };
+
+  // The field's number.  Entries of a ParseTable are sorted by number.
+  int number;
+  // The WireFormatLite::FieldType of the field.
+  uint8 type;
+  // A combination of the flags above.
+  uint8 flags;
+  // For singular fields, the index of the field's has-bit; for members of a
+  // oneof, the index of the oneof.  Unused for repeated fields.
+  int16 presence_index;
+  // The offset of the field within the message.  For members of a oneof,
+  // the offset of the oneof's union.  Filled in at initialization time.
+  int offset;
+  // For enums, the generated function which checks whether a value is
+  // valid.  NULL otherwise.
+  bool (*enum_is_valid)(int);
+  // For messages and groups, the default instance of the field's type.
+  // Filled in at initialization time.
+  const MessageLite* prototype;
+  // The field's name, used in error messages.
+  const char* name;
+};
+
+// Describes how to parse a message.  Every offset is relative to the start
+// of the message object, and is -1 if the message has no such member.
+struct ParseTable {
+  const ParseTableField* fields;
+  int field_count;
+  int has_bits_offset;
+  int oneof_case_offset;
+  int extensions_offset;
+  int unknown_fields_offset;
+  // The message's default instance, used to look up extensions.
+  const MessageLite* default_instance;
+  // Whether unknown fields are kept as serialized bytes; see the
+  // "unknown_fields_as_bytes" generator option.  Only used by the full
+  // library.
+  bool unknown_fields_as_bytes;
+};
+
+// Parses the fields of |msg| described by |table|, merging them into the
+// message.  Implements MergePartialFromCodedStream() for generated lite
+// messages, which keep their unknown fields in a string.
+LIBPROTOBUF_EXPORT bool MergePartialFromCodedStreamLite(
+    MessageLite* msg, const ParseTable& table, io::CodedInputStream* input);
+
+// Like MergePartialFromCodedStreamLite(), but for messages with descriptors,
+// which keep their unknown fields in an UnknownFieldSet.  Only available in
+// the full library.
+LIBPROTOBUF_EXPORT bool MergePartialFromCodedStream(
+    MessageLite* msg, const ParseTable& table, io::CodedInputStream* input);
+
+}  // namespace internal
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_GENERATED_MESSAGE_TABLE_DRIVEN_H__
@@ -0,0 +1,418 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// The interpreter behind MergePartialFromCodedStreamLite() and
+// MergePartialFromCodedStream() in generated_message_table_driven.h.  It is
+// shared between the lite and the full library, which differ only in how
+// they store unknown fields; see UnknownFieldHandlerLite below.
+
+#ifndef GOOGLE_PROTOBUF_GENERATED_MESSAGE_TABLE_DRIVEN_LITE_H__
+#define GOOGLE_PROTOBUF_GENERATED_MESSAGE_TABLE_DRIVEN_LITE_H__
+
+#include <string>
+
+#include <google/protobuf/generated_message_table_driven.h>
+#include <google/protobuf/arena.h>
+#include <google/protobuf/extension_set.h>
+#include <google/protobuf/message_lite.h>
+#include <google/protobuf/repeated_field.h>
+#include <google/protobuf/lazy_field.h>
+#include <google/protobuf/string_piece_field.h>
+#include <google/protobuf/wire_format_lite.h>
+#include <google/protobuf/wire_format_lite_inl.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
+namespace google {
+namespace protobuf {
+namespace internal {
+
+// Returns a pointer to the member of |msg| at the given offset.
+template <typename Type>
+inline Type* MutableField(MessageLite* msg, int offset) {
+  return reinterpret_cast<Type*>(reinterpret_cast<uint8*>(msg) + offset);
+}
+template <typename Type>
+inline const Type& GetField(const MessageLite* msg, int offset) {
+  return *reinterpret_cast<const Type*>(
+      reinterpret_cast<const uint8*>(msg) + offset);
+}
+
+// Adds elements to repeated message fields without knowing their type.  A
+// friend of RepeatedPtrFieldBase, like GeneratedMessageReflection.
+class MergePartialFromCodedStreamHelper {
+ public:
+  static MessageLite* Add(RepeatedPtrFieldBase* field,
+                          const MessageLite* prototype) {
+    typedef GenericTypeHandler<MessageLite> TypeHandler;
+    MessageLite* result = field->AddFromCleared<TypeHandler>();
+    if (result == NULL) {
+      // New() already hands the object to the arena, if there is one.
+      result = prototype->New(field->arena_);
+      field->UnsafeArenaAddAllocated<TypeHandler>(result);
+    }
+    return result;
+  }
+};
+
+// Stores unknown fields, and unknown extensions, in the string used by lite
+// messages.
+class UnknownFieldHandlerLite {
+ public:
+  static bool Skip(MessageLite* msg, const ParseTable& table,
+                   io::CodedInputStream* input, uint32 tag) {
+    io::StringOutputStream unknown_fields_string(
+        MutableField<string>(msg, table.unknown_fields_offset));
+    io::CodedOutputStream unknown_fields_stream(&unknown_fields_string);
+    if (table.extensions_offset != -1) {
+      // ExtensionSet::ParseField() skips fields with no known extension.
+      return MutableField<ExtensionSet>(msg, table.extensions_offset)->
+          ParseField(tag, input, table.default_instance,
+                     &unknown_fields_stream);
+    }
+    return WireFormatLite::SkipField(input, tag, &unknown_fields_stream);
+  }
+
+  static void AddVarint(MessageLite* msg, const ParseTable& table,
+                        uint32 tag, int value) {
+    io::StringOutputStream unknown_fields_string(
+        MutableField<string>(msg, table.unknown_fields_offset));
+    io::CodedOutputStream unknown_fields_stream(&unknown_fields_string);
+    unknown_fields_stream.WriteVarint32(tag);
+    unknown_fields_stream.WriteVarint32(value);
+  }
+
+  static void VerifyUtf8(const ParseTableField& field, StringPiece value) {
+    // Lite messages never verify UTF-8.
+  }
+};
+
+// Finds the entry for the given field number, or returns NULL.  |expected|
+// is tried first: fields are usually serialized in order of number, so it is
+// set to the entry after the one parsed last.
+inline const ParseTableField* FindParseTableField(
+    const ParseTable& table, const ParseTableField* expected, int number) {
+  const ParseTableField* end = table.fields + table.field_count;
+  if (expected < end && expected->number == number) return expected;
+
+  const ParseTableField* begin = table.fields;
+  while (begin < end) {
+    const ParseTableField* middle = begin + (end - begin) / 2;
+    if (middle->number < number) {
+      begin = middle + 1;
+    } else {
+      end = middle;
+    }
+  }
+  if (begin < table.fields + table.field_count && begin->number == number) {
+    return begin;
+  }
+  return NULL;
+}
+
+// Clears whichever member of the given oneof is set, freeing its storage.
+inline void ClearOneof(MessageLite* msg, const ParseTable& table,
+                       int oneof_index, Arena* arena) {
+  uint32* oneof_case =
+      MutableField<uint32>(msg, table.oneof_case_offset) + oneof_index;
+  if (*oneof_case == 0) return;
+  const ParseTableField* field =
+      FindParseTableField(table, table.fields, *oneof_case);
+  *oneof_case = 0;
+  if (field == NULL || arena != NULL) return;
+
+  switch (field->type) {
+    case WireFormatLite::TYPE_STRING:
+    case WireFormatLite::TYPE_BYTES:
+      delete *MutableField<string*>(msg, field->offset);
+      break;
+    case WireFormatLite::TYPE_GROUP:
+    case WireFormatLite::TYPE_MESSAGE:
+      delete *MutableField<MessageLite*>(msg, field->offset);
+      break;
+    default:
+      // Nothing to free.
+      break;
+  }
+}
+
+// Marks a singular field as present: sets its has-bit, or, for members of a
+// oneof, makes it the oneof's current field.  Returns false if the field was
+// a oneof member which was not already set, in which case its storage must
+// be initialized by the caller.
+inline bool SetFieldPresent(MessageLite* msg, const ParseTable& table,
+                            const ParseTableField& field, Arena* arena) {
+  if (field.flags & ParseTableField::kOneof) {
+    uint32* oneof_case = MutableField<uint32>(msg, table.oneof_case_offset) +
+                         field.presence_index;
+    if (*oneof_case == field.number) return true;
+    ClearOneof(msg, table, field.presence_index, arena);
+    *oneof_case = field.number;
+    return false;
+  } else {
+    MutableField<uint32>(msg, table.has_bits_offset)
+        [field.presence_index / 32] |= 1u << (field.presence_index % 32);
+    return true;
+  }
+}
+
+template <typename UnknownFieldHandler>
+bool MergePartialFromCodedStreamImpl(MessageLite* msg, const ParseTable& table,
+                                     io::CodedInputStream* input) {
+  Arena* const arena = msg->GetArena();
+  const ParseTableField* expected = table.fields;
+
+  for (;;) {
+    const uint32 tag = input->ReadTag();
+    const ParseTableField* field = FindParseTableField(
+        table, expected, WireFormatLite::GetTagFieldNumber(tag));
+
+    const WireFormatLite::FieldType type =
+        field == NULL ? WireFormatLite::MAX_FIELD_TYPE :
+        static_cast<WireFormatLite::FieldType>(field->type);
+    const WireFormatLite::WireType wire_type =
+        WireFormatLite::GetTagWireType(tag);
+    const bool is_repeated =
+        field != NULL && (field->flags & ParseTableField::kRepeated);
+
+    if (field == NULL ||
+        wire_type != WireFormatLite::WireTypeForFieldType(type)) {
+      // Repeated primitive fields are accepted both packed and unpacked.
+      if (field != NULL && is_repeated &&
+          wire_type == WireFormatLite::WIRETYPE_LENGTH_DELIMITED &&
+          type != WireFormatLite::TYPE_STRING &&
+          type != WireFormatLite::TYPE_BYTES &&
+          type != WireFormatLite::TYPE_MESSAGE &&
+          type != WireFormatLite::TYPE_GROUP) {
+        switch (type) {
+#define HANDLE_PACKED_TYPE(TYPE, CPPTYPE)                                    \
+          case WireFormatLite::TYPE_##TYPE:                                  \
+            if (!WireFormatLite::ReadPackedPrimitiveNoInline<                \
+                    CPPTYPE, WireFormatLite::TYPE_##TYPE>(                   \
+                    input, MutableField<RepeatedField<CPPTYPE> >(            \
+                        msg, field->offset))) {                              \
+              return false;                                                  \
+            }                                                                \
+            break;
+
+          HANDLE_PACKED_TYPE( INT32,  int32)
+          HANDLE_PACKED_TYPE( INT64,  int64)
+          HANDLE_PACKED_TYPE(SINT32,  int32)
+          HANDLE_PACKED_TYPE(SINT64,  int64)
+          HANDLE_PACKED_TYPE(UINT32, uint32)
+          HANDLE_PACKED_TYPE(UINT64, uint64)
+
+          HANDLE_PACKED_TYPE( FIXED32, uint32)
+          HANDLE_PACKED_TYPE( FIXED64, uint64)
+          HANDLE_PACKED_TYPE(SFIXED32,  int32)
+          HANDLE_PACKED_TYPE(SFIXED64,  int64)
+
+          HANDLE_PACKED_TYPE(FLOAT , float )
+          HANDLE_PACKED_TYPE(DOUBLE, double)
+
+          HANDLE_PACKED_TYPE(BOOL, bool)
+#undef HANDLE_PACKED_TYPE
+
+          case WireFormatLite::TYPE_ENUM:
+            if (!WireFormatLite::ReadPackedEnumNoInline(
+                    input, field->enum_is_valid,
+                    MutableField<RepeatedField<int> >(msg, field->offset))) {
+              return false;
+            }
+            break;
+
+          default:
+            GOOGLE_LOG(FATAL) << "Can't get here.";
+            break;
+        }
+        expected = field + 1;
+        continue;
+      }
+
+      // Unknown field, or the end of the message.
+      if (tag == 0 || wire_type == WireFormatLite::WIRETYPE_END_GROUP) {
+        return true;
+      }
+      if (!UnknownFieldHandler::Skip(msg, table, input, tag)) return false;
+      continue;
+    }
+
+    switch (type) {
+#define HANDLE_TYPE(TYPE, CPPTYPE)                                           \
+      case WireFormatLite::TYPE_##TYPE:                                      \
+        if (is_repeated) {                                                   \
+          if (!WireFormatLite::ReadRepeatedPrimitiveNoInline<                \
+                  CPPTYPE, WireFormatLite::TYPE_##TYPE>(                     \
+                  io::CodedOutputStream::VarintSize32(tag), tag, input,      \
+                  MutableField<RepeatedField<CPPTYPE> >(                     \
+                      msg, field->offset))) {                                \
+            return false;                                                    \
+          }                                                                  \
+        } else {                                                             \
+          CPPTYPE value;                                                     \
+          if (!WireFormatLite::ReadPrimitive<                                \
+                  CPPTYPE, WireFormatLite::TYPE_##TYPE>(input, &value)) {    \
+            /* Generated code clears a oneof before reading into it. */      \
+            if (field->flags & ParseTableField::kOneof) {                    \
+              ClearOneof(msg, table, field->presence_index, arena);          \
+            }                                                                \
+            return false;                                                    \
+          }                                                                  \
+          SetFieldPresent(msg, table, *field, arena);                        \
+          *MutableField<CPPTYPE>(msg, field->offset) = value;                \
+        }                                                                    \
+        break;
+
+      HANDLE_TYPE( INT32,  int32)
+      HANDLE_TYPE( INT64,  int64)
+      HANDLE_TYPE(SINT32,  int32)
+      HANDLE_TYPE(SINT64,  int64)
+      HANDLE_TYPE(UINT32, uint32)
+      HANDLE_TYPE(UINT64, uint64)
+
+      HANDLE_TYPE( FIXED32, uint32)
+      HANDLE_TYPE( FIXED64, uint64)
+      HANDLE_TYPE(SFIXED32,  int32)
+      HANDLE_TYPE(SFIXED64,  int64)
+
+      HANDLE_TYPE(FLOAT , float )
+      HANDLE_TYPE(DOUBLE, double)
+
+      HANDLE_TYPE(BOOL, bool)
+#undef HANDLE_TYPE
+
+      case WireFormatLite::TYPE_ENUM: {
+        int value;
+        if (!WireFormatLite::ReadPrimitive<int, WireFormatLite::TYPE_ENUM>(
+                input, &value)) {
+          return false;
+        }
+        if (!field->enum_is_valid(value)) {
+          UnknownFieldHandler::AddVarint(msg, table, tag, value);
+        } else if (is_repeated) {
+          MutableField<RepeatedField<int> >(msg, field->offset)->Add(value);
+        } else {
+          SetFieldPresent(msg, table, *field, arena);
+          *MutableField<int>(msg, field->offset) = value;
+        }
+        break;
+      }
+
+      case WireFormatLite::TYPE_STRING:
+      case WireFormatLite::TYPE_BYTES: {
+        if (field->flags & ParseTableField::kStringPiece) {
+          StringPieceField* value =
+              MutableField<StringPieceField>(msg, field->offset);
+          SetFieldPresent(msg, table, *field, arena);
+          if (!WireFormatLite::ReadStringPiece(input, value, arena)) {
+            return false;
+          }
+          if (field->flags & ParseTableField::kVerifyUtf8) {
+            UnknownFieldHandler::VerifyUtf8(*field, value->Get());
+          }
+          break;
+        }
+
+        string* value;
+        if (is_repeated) {
+          value = MutableField<RepeatedPtrField<string> >(
+              msg, field->offset)->Add();
+        } else {
+          string** slot = MutableField<string*>(msg, field->offset);
+          if (field->flags & ParseTableField::kOneof) {
+            if (!SetFieldPresent(msg, table, *field, arena)) {
+              *slot = Arena::Create<string>(arena);
+            }
+          } else {
+            // Until first mutated, the field shares the default instance's
+            // string.  Like the generated mutable_*() accessor, start from a
+            // copy of the default value.
+            const string* default_value =
+                GetField<string*>(table.default_instance, field->offset);
+            SetFieldPresent(msg, table, *field, arena);
+            if (*slot == default_value) {
+              *slot = Arena::Create<string>(arena, *default_value);
+            }
+          }
+          value = *slot;
+        }
+        if (!WireFormatLite::ReadBytes(input, value)) return false;
+        if (field->flags & ParseTableField::kVerifyUtf8) {
+          UnknownFieldHandler::VerifyUtf8(*field, *value);
+        }
+        break;
+      }
+
+      case WireFormatLite::TYPE_GROUP:
+      case WireFormatLite::TYPE_MESSAGE: {
+        if (field->flags & ParseTableField::kLazy) {
+          SetFieldPresent(msg, table, *field, arena);
+          if (!MutableField<LazyField>(msg, field->offset)
+                   ->MergeFromCodedStream(input, *field->prototype, arena)) {
+            return false;
+          }
+          break;
+        }
+
+        MessageLite* value;
+        if (is_repeated) {
+          value = MergePartialFromCodedStreamHelper::Add(
+              MutableField<RepeatedPtrFieldBase>(msg, field->offset),
+              field->prototype);
+        } else {
+          MessageLite** slot = MutableField<MessageLite*>(msg, field->offset);
+          if (!SetFieldPresent(msg, table, *field, arena) || *slot == NULL) {
+            *slot = field->prototype->New(arena);
+          }
+          value = *slot;
+        }
+        if (type == WireFormatLite::TYPE_GROUP) {
+          if (!WireFormatLite::ReadGroup(field->number, input, value)) {
+            return false;
+          }
+        } else {
+          if (!WireFormatLite::ReadMessage(input, value)) return false;
+        }
+        break;
+      }
+
+      default:
+        GOOGLE_LOG(FATAL) << "Can't get here.";
+        break;
+    }
+    expected = field + 1;
+  }
+}
+
+}  // namespace internal
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_GENERATED_MESSAGE_TABLE_DRIVEN_LITE_H__
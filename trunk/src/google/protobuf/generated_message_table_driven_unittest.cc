@@ -0,0 +1,324 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <google/protobuf/generated_message_table_driven.h>
+
+#include <string>
+
+#include <google/protobuf/arena.h>
+#include <google/protobuf/test_util.h>
+#include <google/protobuf/test_util_lite.h>
+#include <google/protobuf/unittest.pb.h>
+#include <google/protobuf/unittest_lite.pb.h>
+#include <google/protobuf/unittest_table_driven.pb.h>
+#include <google/protobuf/unittest_table_driven_lite.pb.h>
+#include <google/protobuf/wire_format_lite.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
+#include <google/protobuf/stubs/common.h>
+#include <gtest/gtest.h>
+
+namespace google {
+namespace protobuf {
+namespace {
+
+namespace table_driven = protobuf_unittest_table_driven;
+
+// The table-driven messages mirror types of unittest.proto and
+// unittest_lite.proto, so after parsing the same bytes, both must serialize
+// identically.
+template <typename Generated, typename TableDriven>
+void ExpectParsesLikeGeneratedCode(const string& data) {
+  Generated generated;
+  TableDriven table_driven;
+  EXPECT_EQ(generated.ParsePartialFromString(data),
+            table_driven.ParsePartialFromString(data));
+  EXPECT_EQ(generated.SerializePartialAsString(),
+            table_driven.SerializePartialAsString());
+}
+
+// Writes a varint field with the given number and value.
+string VarintField(int number, uint64 value) {
+  string result;
+  {
+    io::StringOutputStream raw_output(&result);
+    io::CodedOutputStream output(&raw_output);
+    internal::WireFormatLite::WriteUInt64(number, value, &output);
+  }
+  return result;
+}
+
+// Writes a length-delimited field with the given number and contents.
+string StringField(int number, const string& value) {
+  string result;
+  {
+    io::StringOutputStream raw_output(&result);
+    io::CodedOutputStream output(&raw_output);
+    internal::WireFormatLite::WriteBytes(number, value, &output);
+  }
+  return result;
+}
+
+bool MergeFromString(const string& data, MessageLite* message) {
+  io::CodedInputStream input(reinterpret_cast<const uint8*>(data.data()),
+                             data.size());
+  return message->MergeFromCodedStream(&input);
+}
+
+TEST(TableDrivenParsingTest, AllFields) {
+  unittest::TestAllTypes message;
+  TestUtil::SetAllFields(&message);
+  string data = message.SerializeAsString();
+
+  table_driven::TestAllTypes table_driven;
+  ASSERT_TRUE(table_driven.ParseFromString(data));
+  EXPECT_EQ(data, table_driven.SerializeAsString());
+
+  unittest::TestAllTypes round_trip;
+  ASSERT_TRUE(round_trip.ParseFromString(table_driven.SerializeAsString()));
+  TestUtil::ExpectAllFieldsSet(round_trip);
+}
+
+TEST(TableDrivenParsingTest, MergesRepeatedParses) {
+  unittest::TestAllTypes message;
+  TestUtil::SetAllFields(&message);
+  string data = message.SerializeAsString();
+  ExpectParsesLikeGeneratedCode<unittest::TestAllTypes,
+                                table_driven::TestAllTypes>(data + data);
+
+  // Parsing again into the same object reuses its strings and messages.
+  table_driven::TestAllTypes table_driven;
+  ASSERT_TRUE(table_driven.ParseFromString(data));
+  ASSERT_TRUE(MergeFromString(data, &table_driven));
+  // Lazy fields keep both occurrences' bytes, so compare with generated code
+  // which parsed the same way.
+  unittest::TestAllTypes generated;
+  ASSERT_TRUE(generated.ParseFromString(data));
+  ASSERT_TRUE(MergeFromString(data, &generated));
+  EXPECT_EQ(generated.SerializeAsString(), table_driven.SerializeAsString());
+  message.MergeFrom(unittest::TestAllTypes(message));
+  EXPECT_EQ(message.DebugString(), generated.DebugString());
+}
+
+TEST(TableDrivenParsingTest, DefaultFields) {
+  unittest::TestAllTypes message;
+  TestUtil::SetDefaultFields(&message);
+  ExpectParsesLikeGeneratedCode<unittest::TestAllTypes,
+                                table_driven::TestAllTypes>(
+      message.SerializeAsString());
+
+  // Parsing a field with a default value must not modify the default
+  // instance's string, which the field shared until then.
+  table_driven::TestAllTypes table_driven;
+  ASSERT_TRUE(table_driven.ParseFromString(message.SerializeAsString()));
+  EXPECT_EQ("415", table_driven.default_string());
+  EXPECT_EQ("hello",
+            table_driven::TestAllTypes::default_instance().default_string());
+}
+
+TEST(TableDrivenParsingTest, PackedAndUnpacked) {
+  unittest::TestPackedTypes packed;
+  TestUtil::SetPackedFields(&packed);
+  ExpectParsesLikeGeneratedCode<unittest::TestPackedTypes,
+                                table_driven::TestPackedTypes>(
+      packed.SerializeAsString());
+
+  // Repeated primitive fields accept both encodings.
+  unittest::TestUnpackedTypes unpacked;
+  TestUtil::SetUnpackedFields(&unpacked);
+  ExpectParsesLikeGeneratedCode<unittest::TestPackedTypes,
+                                table_driven::TestPackedTypes>(
+      unpacked.SerializeAsString());
+
+  ExpectParsesLikeGeneratedCode<unittest::TestAllTypes,
+                                table_driven::TestAllTypes>(
+      StringField(unittest::TestAllTypes::kRepeatedInt32FieldNumber,
+                  string("\x01\x02\x03\x96\x01", 5)));
+}
+
+TEST(TableDrivenParsingTest, Oneof) {
+  unittest::TestAllTypes message;
+  message.set_oneof_string("string");
+  string data = message.SerializeAsString();
+  message.mutable_oneof_nested_message()->set_bb(7);
+  data += message.SerializeAsString();
+  message.set_oneof_uint32(3);
+  data += message.SerializeAsString();
+  message.set_oneof_bytes("bytes");
+  data += message.SerializeAsString();
+
+  // Each prefix ends with a different member set.
+  for (int i = 1; i <= data.size(); i++) {
+    SCOPED_TRACE(i);
+    ExpectParsesLikeGeneratedCode<unittest::TestAllTypes,
+                                  table_driven::TestAllTypes>(
+        data.substr(0, i));
+  }
+
+  table_driven::TestAllTypes table_driven;
+  ASSERT_TRUE(table_driven.ParseFromString(data));
+  EXPECT_TRUE(table_driven.has_oneof_bytes());
+  EXPECT_EQ("bytes", table_driven.oneof_bytes());
+}
+
+TEST(TableDrivenParsingTest, UnknownFields) {
+  // Unknown field numbers, enum values and wire types all end up in the
+  // UnknownFieldSet.
+  string data =
+      VarintField(unittest::TestAllTypes::kOptionalNestedEnumFieldNumber, 10) +
+      VarintField(unittest::TestAllTypes::kRepeatedNestedEnumFieldNumber, 11) +
+      StringField(unittest::TestAllTypes::kOptionalInt32FieldNumber, "x") +
+      VarintField(unittest::TestAllTypes::kRepeatedNestedEnumFieldNumber, 2) +
+      StringField(12345, "unknown") +
+      VarintField(1, 150);
+  ExpectParsesLikeGeneratedCode<unittest::TestAllTypes,
+                                table_driven::TestAllTypes>(data);
+
+  table_driven::TestAllTypes table_driven;
+  ASSERT_TRUE(table_driven.ParseFromString(data));
+  EXPECT_FALSE(table_driven.has_optional_nested_enum());
+  ASSERT_EQ(1, table_driven.repeated_nested_enum_size());
+  EXPECT_EQ(table_driven::TestAllTypes::BAR,
+            table_driven.repeated_nested_enum(0));
+  EXPECT_EQ(150, table_driven.optional_int32());
+  EXPECT_EQ(4, table_driven.unknown_fields().field_count());
+}
+
+TEST(TableDrivenParsingTest, Extensions) {
+  table_driven::TestExtensions message;
+  message.set_a(1);
+  message.SetExtension(table_driven::optional_int32_extension, 2);
+  message.SetExtension(table_driven::optional_string_extension, "three");
+  message.AddExtension(table_driven::repeated_nested_message_extension)
+      ->set_bb(4);
+  string data = message.SerializeAsString() + StringField(2000, "unknown");
+
+  table_driven::TestExtensions parsed;
+  ASSERT_TRUE(parsed.ParseFromString(data));
+  EXPECT_EQ(1, parsed.a());
+  EXPECT_EQ(2, parsed.GetExtension(table_driven::optional_int32_extension));
+  EXPECT_EQ("three",
+            parsed.GetExtension(table_driven::optional_string_extension));
+  ASSERT_EQ(1, parsed.ExtensionSize(
+      table_driven::repeated_nested_message_extension));
+  EXPECT_EQ(4, parsed.GetExtension(
+      table_driven::repeated_nested_message_extension, 0).bb());
+  EXPECT_EQ(1, parsed.unknown_fields().field_count());
+  EXPECT_EQ(data, parsed.SerializeAsString());
+}
+
+TEST(TableDrivenParsingTest, Arena) {
+  unittest::TestAllTypes message;
+  TestUtil::SetAllFields(&message);
+  string data = message.SerializeAsString();
+
+  Arena arena;
+  table_driven::TestAllTypes* table_driven =
+      Arena::CreateMessage<table_driven::TestAllTypes>(&arena);
+  ASSERT_TRUE(table_driven->ParseFromString(data));
+  ASSERT_TRUE(MergeFromString(data, table_driven));
+  EXPECT_EQ(&arena, table_driven->mutable_optional_nested_message()
+                        ->GetArena());
+  EXPECT_EQ(&arena, table_driven->repeated_nested_message(1).GetArena());
+
+  message.MergeFrom(unittest::TestAllTypes(message));
+  EXPECT_EQ(message.SerializeAsString(), table_driven->SerializeAsString());
+}
+
+TEST(TableDrivenParsingTest, MalformedInput) {
+  unittest::TestAllTypes message;
+  TestUtil::SetAllFields(&message);
+  string data = message.SerializeAsString();
+
+  // Every truncation either fails or parses like the generated code.
+  for (int i = 0; i < data.size(); i++) {
+    ExpectParsesLikeGeneratedCode<unittest::TestAllTypes,
+                                  table_driven::TestAllTypes>(
+        data.substr(0, i));
+  }
+
+  // A group which is never closed.
+  table_driven::TestAllTypes table_driven;
+  EXPECT_FALSE(table_driven.ParseFromString(string("\x83\x01", 2)));
+}
+
+TEST(TableDrivenParsingTest, Lite) {
+  unittest::TestAllTypesLite message;
+  TestUtilLite::SetAllFields(&message);
+  string data = message.SerializeAsString();
+
+  table_driven::TestAllTypesLite table_driven;
+  ASSERT_TRUE(table_driven.ParseFromString(data));
+  EXPECT_EQ(data, table_driven.SerializeAsString());
+
+  unittest::TestPackedTypesLite packed;
+  TestUtilLite::SetPackedFields(&packed);
+  ExpectParsesLikeGeneratedCode<unittest::TestPackedTypesLite,
+                                table_driven::TestPackedTypesLite>(
+      packed.SerializeAsString());
+
+  // Unknown fields are kept as raw bytes, in order.
+  string unknown =
+      VarintField(unittest::TestAllTypesLite::kOptionalNestedEnumFieldNumber,
+                  10) +
+      StringField(12345, "unknown");
+  ExpectParsesLikeGeneratedCode<unittest::TestAllTypesLite,
+                                table_driven::TestAllTypesLite>(
+      data + unknown + data);
+  ASSERT_TRUE(table_driven.ParseFromString(unknown));
+  EXPECT_EQ(unknown, table_driven.unknown_fields());
+}
+
+TEST(TableDrivenParsingTest, LiteExtensions) {
+  table_driven::TestExtensionsLite message;
+  message.set_a(1);
+  message.SetExtension(table_driven::optional_int32_extension_lite, 2);
+  message.SetExtension(table_driven::optional_string_extension_lite, "three");
+  message.AddExtension(table_driven::repeated_nested_message_extension_lite)
+      ->set_bb(4);
+  string unknown = StringField(2000, "unknown");
+  string data = message.SerializeAsString() + unknown;
+
+  table_driven::TestExtensionsLite parsed;
+  ASSERT_TRUE(parsed.ParseFromString(data));
+  EXPECT_EQ(1, parsed.a());
+  EXPECT_EQ(2,
+            parsed.GetExtension(table_driven::optional_int32_extension_lite));
+  EXPECT_EQ("three",
+            parsed.GetExtension(table_driven::optional_string_extension_lite));
+  EXPECT_EQ(4, parsed.GetExtension(
+      table_driven::repeated_nested_message_extension_lite, 0).bb());
+  EXPECT_EQ(unknown, parsed.unknown_fields());
+}
+
+}  // namespace
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,62 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <google/protobuf/io/backward_output_buffer.h>
+
+#include <algorithm>
+
+namespace google {
+namespace protobuf {
+namespace io {
+
+BackwardOutputBuffer::BackwardOutputBuffer()
+    : buffer_(initial_buffer_),
+      front_(initial_buffer_ + kInitialBufferSize),
+      end_(initial_buffer_ + kInitialBufferSize) {}
+
+BackwardOutputBuffer::~BackwardOutputBuffer() {
+  if (buffer_ != initial_buffer_) delete [] buffer_;
+}
+
+void BackwardOutputBuffer::Grow(int size) {
+  int used = ByteCount();
+  int new_size = std::max<int>(2 * (end_ - buffer_), used + size);
+  uint8* new_buffer = new uint8[new_size];
+  uint8* new_end = new_buffer + new_size;
+  memcpy(new_end - used, front_, used);
+  if (buffer_ != initial_buffer_) delete [] buffer_;
+  buffer_ = new_buffer;
+  front_ = new_end - used;
+  end_ = new_end;
+}
+
+}  // namespace io
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,132 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Defines BackwardOutputBuffer, a buffer which is filled from back to front.
+//
+// Serializing a message normally takes two passes over it:  ByteSize()
+// computes and caches the size of every sub-message, because a sub-message
+// is preceded by its length, and then SerializeWithCachedSizes() encodes it.
+// If instead the fields are written last to first, each into the space
+// immediately before everything written so far, the length of a sub-message
+// is known as soon as its contents have been written, and a single pass
+// suffices.  See MessageLite::SerializeToStringSinglePass().
+
+#ifndef GOOGLE_PROTOBUF_IO_BACKWARD_OUTPUT_BUFFER_H__
+#define GOOGLE_PROTOBUF_IO_BACKWARD_OUTPUT_BUFFER_H__
+
+#include <string.h>
+#include <google/protobuf/stubs/common.h>
+#include <google/protobuf/io/coded_stream.h>
+
+namespace google {
+namespace protobuf {
+namespace io {
+
+// A growable byte buffer to which data is prepended rather than appended.
+// After writing, data() points at ByteCount() contiguous bytes, the last
+// ones written first.
+class LIBPROTOBUF_EXPORT BackwardOutputBuffer {
+ public:
+  BackwardOutputBuffer();
+  ~BackwardOutputBuffer();
+
+  // Returns a pointer to |size| bytes located immediately before the data
+  // written so far, which become the new front of the data.  The caller must
+  // fill all of them in.  The pointer is invalidated by the next call.
+  inline uint8* Prepend(int size);
+
+  // Prepends the given bytes.
+  inline void PrependRaw(const void* data, int size);
+  // Prepends a varint, as CodedOutputStream::WriteVarint32() would write it.
+  inline void PrependVarint32(uint32 value);
+  // Prepends a varint, as CodedOutputStream::WriteVarint64() would write it.
+  inline void PrependVarint64(uint64 value);
+
+  // Returns the number of bytes written so far.  Since data is only ever
+  // prepended, the difference between two calls is the size of whatever was
+  // written in between.
+  inline int ByteCount() const;
+
+  // Returns a pointer to the bytes written so far.
+  inline const uint8* data() const;
+
+ private:
+  static const int kInitialBufferSize = 512;
+
+  // Makes room for at least |size| more bytes before front_.
+  void Grow(int size);
+
+  uint8* buffer_;  // The start of the current block.
+  uint8* front_;   // The first byte written, or end_ if there is none.
+  uint8* end_;     // The end of the current block.
+  uint8 initial_buffer_[kInitialBufferSize];
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(BackwardOutputBuffer);
+};
+
+// inline methods ====================================================
+
+inline uint8* BackwardOutputBuffer::Prepend(int size) {
+  if (!GOOGLE_PREDICT_TRUE(front_ - buffer_ >= size)) Grow(size);
+  front_ -= size;
+  return front_;
+}
+
+inline void BackwardOutputBuffer::PrependRaw(const void* data, int size) {
+  memcpy(Prepend(size), data, size);
+}
+
+inline void BackwardOutputBuffer::PrependVarint32(uint32 value) {
+  if (value < 0x80) {
+    *Prepend(1) = static_cast<uint8>(value);
+  } else {
+    CodedOutputStream::WriteVarint32ToArray(
+        value, Prepend(CodedOutputStream::VarintSize32(value)));
+  }
+}
+
+inline void BackwardOutputBuffer::PrependVarint64(uint64 value) {
+  CodedOutputStream::WriteVarint64ToArray(
+      value, Prepend(CodedOutputStream::VarintSize64(value)));
+}
+
+inline int BackwardOutputBuffer::ByteCount() const {
+  return end_ - front_;
+}
+
+inline const uint8* BackwardOutputBuffer::data() const {
+  return front_;
+}
+
+}  // namespace io
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_IO_BACKWARD_OUTPUT_BUFFER_H__
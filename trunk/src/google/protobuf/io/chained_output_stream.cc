@@ -0,0 +1,216 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifdef _MSC_VER
+#include <io.h>
+#else
+#include <unistd.h>
+#include <limits.h>
+#include <sys/uio.h>
+#endif
+#include <errno.h>
+#include <string.h>
+
+#include <google/protobuf/io/chained_output_stream.h>
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+namespace io {
+
+namespace {
+
+// Default block size for ChainedOutputStream.
+const int kDefaultBlockSize = 8192;
+
+#ifndef _WIN32
+// The most iovecs passed to one writev() call.
+#ifdef IOV_MAX
+const int kMaxIovecs = IOV_MAX < 1024 ? IOV_MAX : 1024;
+#else
+const int kMaxIovecs = 16;  // The minimum POSIX allows.
+#endif
+#endif
+
+}  // namespace
+
+ChainedOutputStream::ChainedOutputStream(int block_size)
+  : block_size_(block_size > 0 ? block_size : kDefaultBlockSize),
+    last_piece_is_open_(false),
+    next_block_(0),
+    block_position_(NULL),
+    block_end_(NULL),
+    byte_count_(0),
+    errno_(0) {
+}
+
+ChainedOutputStream::~ChainedOutputStream() {
+  for (int i = 0; i < blocks_.size(); i++) {
+    delete [] blocks_[i];
+  }
+}
+
+bool ChainedOutputStream::Next(void** data, int* size) {
+  if (block_position_ == block_end_) {
+    if (next_block_ == blocks_.size()) {
+      blocks_.push_back(new char[block_size_]);
+    }
+    block_position_ = blocks_[next_block_++];
+    block_end_ = block_position_ + block_size_;
+    last_piece_is_open_ = false;
+  }
+
+  if (!last_piece_is_open_) {
+    Piece piece = { block_position_, 0 };
+    pieces_.push_back(piece);
+    last_piece_is_open_ = true;
+  }
+
+  *data = block_position_;
+  *size = block_end_ - block_position_;
+  pieces_.back().size += *size;
+  block_position_ = block_end_;
+  byte_count_ += *size;
+  return true;
+}
+
+void ChainedOutputStream::BackUp(int count) {
+  GOOGLE_CHECK(last_piece_is_open_)
+      << "BackUp() can only be called after Next().";
+  GOOGLE_CHECK_GE(count, 0);
+  GOOGLE_CHECK_LE(count, pieces_.back().size);
+  pieces_.back().size -= count;
+  block_position_ -= count;
+  byte_count_ -= count;
+  if (pieces_.back().size == 0) {
+    pieces_.pop_back();
+    last_piece_is_open_ = false;
+  }
+}
+
+int64 ChainedOutputStream::ByteCount() const {
+  return byte_count_;
+}
+
+bool ChainedOutputStream::WriteAliasedRaw(const void* data, int size) {
+  if (size < kMinAliasedSize) {
+    const char* in = reinterpret_cast<const char*>(data);
+    while (size > 0) {
+      void* out;
+      int out_size;
+      Next(&out, &out_size);
+      int n = min(size, out_size);
+      memcpy(out, in, n);
+      BackUp(out_size - n);
+      in += n;
+      size -= n;
+    }
+    return true;
+  }
+
+  Piece piece = { reinterpret_cast<const char*>(data), size };
+  pieces_.push_back(piece);
+  last_piece_is_open_ = false;
+  byte_count_ += size;
+  return true;
+}
+
+bool ChainedOutputStream::WriteToFileDescriptor(int file_descriptor) {
+  errno_ = 0;
+  int i = 0;       // The first piece not completely written.
+  int offset = 0;  // How much of pieces_[i] has been written.
+  while (i < pieces_.size()) {
+#ifdef _WIN32
+    // There is no writev(); write one piece at a time.
+    int result;
+    do {
+      result = write(file_descriptor, pieces_[i].data + offset,
+                     pieces_[i].size - offset);
+    } while (result < 0 && errno == EINTR);
+#else
+    struct iovec iov[kMaxIovecs];
+    int count = 0;
+    for (int j = i; j < pieces_.size() && count < kMaxIovecs; j++) {
+      int skip = (j == i) ? offset : 0;
+      iov[count].iov_base = const_cast<char*>(pieces_[j].data) + skip;
+      iov[count].iov_len = pieces_[j].size - skip;
+      ++count;
+    }
+    ssize_t result;
+    do {
+      result = writev(file_descriptor, iov, count);
+    } while (result < 0 && errno == EINTR);
+#endif
+
+    if (result <= 0) {
+      // Write error.  As with FileOutputStream, a zero return is treated as
+      // an error too.
+      errno_ = (result < 0) ? errno : EIO;
+      Clear();
+      return false;
+    }
+
+    // Skip over whatever was written, which may end in the middle of a piece.
+    while (result > 0) {
+      int remaining = pieces_[i].size - offset;
+      if (result >= remaining) {
+        result -= remaining;
+        ++i;
+        offset = 0;
+      } else {
+        offset += result;
+        result = 0;
+      }
+    }
+  }
+
+  Clear();
+  return true;
+}
+
+void ChainedOutputStream::AppendToString(string* output) const {
+  output->reserve(output->size() + byte_count_);
+  for (int i = 0; i < pieces_.size(); i++) {
+    output->append(pieces_[i].data, pieces_[i].size);
+  }
+}
+
+void ChainedOutputStream::Clear() {
+  pieces_.clear();
+  last_piece_is_open_ = false;
+  next_block_ = 0;
+  block_position_ = NULL;
+  block_end_ = NULL;
+  byte_count_ = 0;
+}
+
+}  // namespace io
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,139 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Defines ChainedOutputStream, a ZeroCopyOutputStream which collects its
+// output in a chain of buffers and hands it to a file descriptor in one
+// writev() call.
+//
+// FileOutputStream copies everything written into a single block and makes
+// one write() per block.  ChainedOutputStream also accepts aliased data
+// (see CodedOutputStream::EnableAliasing()):  a large string or bytes field
+// is recorded as a reference to the caller's memory rather than copied, and
+// goes from there straight to the kernel.
+
+#ifndef GOOGLE_PROTOBUF_IO_CHAINED_OUTPUT_STREAM_H__
+#define GOOGLE_PROTOBUF_IO_CHAINED_OUTPUT_STREAM_H__
+
+#include <string>
+#include <vector>
+#include <google/protobuf/io/zero_copy_stream.h>
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+namespace io {
+
+// A ZeroCopyOutputStream which keeps everything written to it in memory,
+// as a list of pieces, until WriteToFileDescriptor() or AppendToString()
+// is called.  A piece is either part of a buffer owned by the stream or,
+// for aliased writes, data owned by the caller.
+//
+// Aliased data is not copied, so it must not be modified or freed until
+// the stream has been written out or cleared.  Typically a message is
+// serialized through a CodedOutputStream with aliasing enabled and then
+// written out before the message is touched again:
+//
+//   ChainedOutputStream output;
+//   {
+//     CodedOutputStream coded_output(&output);
+//     coded_output.EnableAliasing(true);
+//     message.SerializeToCodedStream(&coded_output);
+//   }
+//   if (!output.WriteToFileDescriptor(fd)) ...
+class LIBPROTOBUF_EXPORT ChainedOutputStream : public ZeroCopyOutputStream {
+ public:
+  // If a block_size is given, it specifies the size of the buffers returned
+  // by Next().  Otherwise, a reasonable default is used.
+  explicit ChainedOutputStream(int block_size = -1);
+  ~ChainedOutputStream();
+
+  // Writes everything written so far to the given file descriptor, using as
+  // few writev() calls as possible, and then clears the stream.  Returns
+  // false if an error occurs; use GetErrno() to examine the error.  The
+  // stream is cleared either way.
+  bool WriteToFileDescriptor(int file_descriptor);
+
+  // Appends everything written so far to *output, without clearing the
+  // stream.
+  void AppendToString(string* output) const;
+
+  // Discards everything written so far, and forgets all aliased data.  The
+  // stream's own buffers are kept for reuse.
+  void Clear();
+
+  // If an I/O error occurred in the last call to WriteToFileDescriptor(),
+  // this is the errno from that error.  Otherwise, this is zero.
+  int GetErrno() const { return errno_; }
+
+  // Aliased writes smaller than this are copied instead, since an iovec for
+  // each costs more than the copy would.
+  static const int kMinAliasedSize = 512;
+
+  // implements ZeroCopyOutputStream ---------------------------------
+  bool Next(void** data, int* size);
+  void BackUp(int count);
+  int64 ByteCount() const;
+  bool WriteAliasedRaw(const void* data, int size);
+  bool AllowsAliasing() const { return true; }
+
+ private:
+  // A contiguous run of output.
+  struct Piece {
+    const char* data;
+    int size;
+  };
+
+  const int block_size_;
+
+  // The output, in order.
+  vector<Piece> pieces_;
+  // True if the last piece ends at block_position_, so that Next() may
+  // extend it instead of starting another.
+  bool last_piece_is_open_;
+
+  // All buffers ever allocated, of block_size_ bytes each.  Those before
+  // next_block_ are in use.
+  vector<char*> blocks_;
+  int next_block_;
+  // The unused part of the current block.
+  char* block_position_;
+  char* block_end_;
+
+  int64 byte_count_;
+  int errno_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(ChainedOutputStream);
+};
+
+}  // namespace io
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_IO_CHAINED_OUTPUT_STREAM_H__
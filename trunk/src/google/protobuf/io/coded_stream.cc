@@ -41,6 +41,7 @@
 #include <google/protobuf/io/coded_stream_inl.h>
 #include <algorithm>
 #include <limits.h>
+#include <google/protobuf/io/varint_decoder.h>
 #include <google/protobuf/io/zero_copy_stream.h>
 #include <google/protobuf/stubs/common.h>
 #include <google/protobuf/stubs/stl_util.h>
@@ -83,6 +84,10 @@ CodedInputStream::~CodedInputStream() {
 int CodedInputStream::default_recursion_limit_ = 100;
 
 
+void CodedInputStream::EnableAliasing(bool enabled) {
+  aliasing_enabled_ = enabled && IsFlat();
+}
+
 void CodedOutputStream::EnableAliasing(bool enabled) {
   aliasing_enabled_ = enabled && output_->AllowsAliasing();
 }
@@ -465,7 +470,14 @@ bool CodedInputStream::ReadVarint64Slow(uint64* value) {
 }
 
 bool CodedInputStream::ReadVarint64Fallback(uint64* value) {
-  if (BufferSize() >= kMaxVarintBytes ||
+  if (BufferSize() >= internal::kVarintBlockBytes) {
+    // Fastest path:  Decode the varint from a single block load, see
+    // varint_decoder.h.
+    const uint8* end = internal::DecodeVarint64(buffer_, value);
+    if (end == NULL) return false;
+    buffer_ = end;
+    return true;
+  } else if (BufferSize() >= kMaxVarintBytes ||
       // Optimization:  We're also safe if the buffer is non-empty and it ends
       // with a byte that would terminate a varint.
       (buffer_end_ > buffer_ && !(buffer_end_[-1] & 0x80))) {
@@ -515,6 +527,14 @@ bool CodedInputStream::ReadVarint64Fallback(uint64* value) {
   }
 }
 
+int CodedInputStream::ReadVarint64Batch(uint64* values, int max_values) {
+  int bytes_consumed;
+  int count = internal::DecodeVarint64s(buffer_, buffer_end_, values,
+                                        max_values, &bytes_consumed);
+  Advance(bytes_consumed);
+  return count;
+}
+
 bool CodedInputStream::Refresh() {
   GOOGLE_DCHECK_EQ(0, BufferSize());
 
@@ -208,6 +208,24 @@ class LIBPROTOBUF_EXPORT CodedInputStream {
   inline bool InternalReadStringInline(string* buffer,
                                        int size) GOOGLE_ATTRIBUTE_ALWAYS_INLINE;
 
+  // Allows string fields declared with [ctype=STRING_PIECE] to point into
+  // the buffer being parsed instead of copying their values out of it; see
+  // string_piece_field.h.  Aliasing only takes effect if this
+  // CodedInputStream reads from a flat array (IsFlat()).  Buffers returned by
+  // a ZeroCopyInputStream are only valid until its next call, so for other
+  // streams enabling aliasing has no effect.
+  //
+  // NOTE: It is the caller's responsibility to keep the array alive and
+  // unmodified for as long as any message parsed from it refers to it.
+  void EnableAliasing(bool enabled);
+
+  // If aliasing is enabled and at least size bytes remain before the current
+  // limit, points *data at them and skips over them.  *data then remains
+  // valid as long as the underlying array.  Otherwise, returns false without
+  // consuming anything; the caller should fall back to ReadString() or
+  // ReadRaw().
+  inline bool ReadAliasedRaw(const void** data, int size);
+
 
   // Read a 32-bit little-endian integer.
   bool ReadLittleEndian32(uint32* value);
@@ -230,6 +248,16 @@ class LIBPROTOBUF_EXPORT CodedInputStream {
   // Read an unsigned integer with Varint encoding.
   bool ReadVarint64(uint64* value);
 
+  // Reads up to |max_values| varints into |values|, decoding them straight
+  // out of the current buffer (with SSE2 or AVX2 where the CPU supports
+  // them).  Stops early at the end of the buffer or of the current limit.
+  // Returns the number of values read, which is zero if the next varint is
+  // not entirely in the buffer or is malformed; in that case, fall back to
+  // ReadVarint64(), which refreshes the buffer and reports errors.  This is
+  // much faster than ReadVarint64() for long runs of varints, such as packed
+  // repeated fields.
+  int ReadVarint64Batch(uint64* values, int max_values);
+
   // Read a tag.  This calls ReadVarint32() and returns the result, or returns
   // zero (which is not a valid tag) if ReadVarint32() fails.  Also, it updates
   // the last tag value, which can be checked with LastTagWas().
@@ -977,6 +1005,13 @@ inline void CodedInputStream::GetDirectBufferPointerInline(const void** data,
   *size = buffer_end_ - buffer_;
 }
 
+inline bool CodedInputStream::ReadAliasedRaw(const void** data, int size) {
+  if (!aliasing_enabled_ || size < 0 || size > BufferSize()) return false;
+  *data = buffer_;
+  Advance(size);
+  return true;
+}
+
 inline bool CodedInputStream::ExpectAtEnd() {
   // If we are at a limit we know no more bytes can be read.  Otherwise, it's
   // hard to say without calling Refresh(), and we'd rather not do that.
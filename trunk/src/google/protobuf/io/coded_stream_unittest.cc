@@ -43,6 +43,8 @@
 #include <google/protobuf/stubs/common.h>
 #include <google/protobuf/testing/googletest.h>
 #include <gtest/gtest.h>
+#include <google/protobuf/io/backward_output_buffer.h>
+#include <google/protobuf/io/varint_decoder.h>
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 
 
@@ -347,6 +349,42 @@ TEST_2D(CodedStreamTest, WriteVarint64, kVarintCases, kBlockSizes) {
     memcmp(buffer_, kVarintCases_case.bytes, kVarintCases_case.size));
 }
 
+TEST_1D(CodedStreamTest, PrependVarint, kVarintCases) {
+  BackwardOutputBuffer buffer;
+  buffer.PrependRaw("end", 3);
+  if (kVarintCases_case.value <= ULL(0x00000000FFFFFFFF)) {
+    buffer.PrependVarint32(static_cast<uint32>(kVarintCases_case.value));
+  } else {
+    buffer.PrependVarint64(kVarintCases_case.value);
+  }
+  buffer.PrependVarint64(kVarintCases_case.value);
+
+  ASSERT_EQ(kVarintCases_case.size * 2 + 3, buffer.ByteCount());
+  EXPECT_EQ(0, memcmp(buffer.data(), kVarintCases_case.bytes,
+                      kVarintCases_case.size));
+  EXPECT_EQ(0, memcmp(buffer.data() + kVarintCases_case.size,
+                      kVarintCases_case.bytes, kVarintCases_case.size));
+  EXPECT_EQ(0, memcmp(buffer.data() + kVarintCases_case.size * 2, "end", 3));
+}
+
+TEST_F(CodedStreamTest, BackwardOutputBufferGrows) {
+  // Write well past the inline block so that the data is moved several
+  // times, and check that nothing is lost on the way.
+  BackwardOutputBuffer buffer;
+  for (int i = 0; i < 10000; i++) {
+    buffer.PrependVarint32(i);
+  }
+
+  ArrayInputStream input(buffer.data(), buffer.ByteCount());
+  CodedInputStream coded_input(&input);
+  for (int i = 9999; i >= 0; i--) {
+    uint32 value;
+    ASSERT_TRUE(coded_input.ReadVarint32(&value));
+    EXPECT_EQ(i, value);
+  }
+  EXPECT_EQ(buffer.ByteCount(), coded_input.CurrentPosition());
+}
+
 // This test causes gcc 3.3.5 (and earlier?) to give the cryptic error:
 //   "sorry, unimplemented: `method_call_expr' not supported by dump_expr"
 #if !defined(__GNUC__) || __GNUC__ > 3 || (__GNUC__ == 3 && __GNUC_MINOR__ > 3)
@@ -448,6 +486,149 @@ TEST_2D(CodedStreamTest, ReadVarint64Error, kVarintErrorCases, kBlockSizes) {
   EXPECT_EQ(kVarintErrorCases_case.can_parse, coded_input.ReadVarint64(&value));
 }
 
+// -------------------------------------------------------------------
+// Batch varint tests.
+
+TEST_2D(CodedStreamTest, ReadVarint64Batch, kVarintCases, kBlockSizes) {
+  // Long enough that the SIMD decoders see many full blocks.
+  const int kCount = 100;
+  for (int i = 0; i < kCount; i++) {
+    memcpy(buffer_ + i * kVarintCases_case.size, kVarintCases_case.bytes,
+           kVarintCases_case.size);
+  }
+  ArrayInputStream input(buffer_, kCount * kVarintCases_case.size,
+                         kBlockSizes_case);
+
+  {
+    CodedInputStream coded_input(&input);
+
+    uint64 values[32];
+    int read = 0;
+    while (read < kCount) {
+      int count = coded_input.ReadVarint64Batch(values, 32);
+      if (count == 0) {
+        ASSERT_TRUE(coded_input.ReadVarint64(&values[0]));
+        count = 1;
+      }
+      for (int i = 0; i < count; i++) {
+        EXPECT_EQ(kVarintCases_case.value, values[i]);
+      }
+      read += count;
+    }
+    EXPECT_EQ(kCount, read);
+    EXPECT_EQ(0, coded_input.ReadVarint64Batch(values, 32));
+  }
+
+  EXPECT_EQ(kCount * kVarintCases_case.size, input.ByteCount());
+}
+
+TEST_F(CodedStreamTest, ReadVarint64BatchRespectsLimit) {
+  // 100 one-byte varints, of which only the first 40 are inside the limit.
+  memset(buffer_, 0x01, 100);
+  ArrayInputStream input(buffer_, 100);
+  CodedInputStream coded_input(&input);
+
+  CodedInputStream::Limit limit = coded_input.PushLimit(40);
+  uint64 values[64];
+  EXPECT_EQ(40, coded_input.ReadVarint64Batch(values, 64));
+  EXPECT_EQ(0, coded_input.BytesUntilLimit());
+  EXPECT_EQ(0, coded_input.ReadVarint64Batch(values, 64));
+  coded_input.PopLimit(limit);
+  EXPECT_EQ(60, coded_input.ReadVarint64Batch(values, 64));
+}
+
+TEST_F(CodedStreamTest, ReadVarint64BatchStopsAtMalformedVarint) {
+  // 50 valid two-byte varints followed by an 11-byte one.
+  for (int i = 0; i < 50; i++) {
+    buffer_[2 * i] = 0x81;
+    buffer_[2 * i + 1] = 0x01;
+  }
+  memset(buffer_ + 100, 0xff, 10);
+  buffer_[110] = 0x01;
+  memset(buffer_ + 111, 0, 64);
+  ArrayInputStream input(buffer_, 175);
+  CodedInputStream coded_input(&input);
+
+  uint64 values[64];
+  EXPECT_EQ(50, coded_input.ReadVarint64Batch(values, 64));
+  EXPECT_EQ(129, values[49]);
+  EXPECT_EQ(0, coded_input.ReadVarint64Batch(values, 64));
+  uint64 value;
+  EXPECT_FALSE(coded_input.ReadVarint64(&value));
+}
+
+TEST_F(CodedStreamTest, VarintDecodersAgree) {
+  // Random varints of all lengths, with runs of one-byte values mixed in so
+  // that the SIMD decoders take both their fast and their general paths.
+  uint32 seed = 12345;
+  vector<uint64> expected;
+  int size = 0;
+  {
+    ArrayOutputStream output(buffer_, kBufferSize);
+    CodedOutputStream coded_output(&output);
+    for (int i = 0; i < 2000; i++) {
+      seed = seed * 1103515245 + 12345;
+      uint64 value;
+      if ((seed >> 16) % 3 == 0) {
+        value = (seed >> 8) & 0x7f;
+      } else {
+        value = (static_cast<uint64>(seed) << 32 | (seed * 69069)) >>
+                ((seed >> 10) % 64);
+      }
+      expected.push_back(value);
+      coded_output.WriteVarint64(value);
+    }
+    size = coded_output.ByteCount();
+  }
+
+  vector<internal::VarintBatchDecoder*> decoders;
+  decoders.push_back(&internal::DecodeVarint64sScalar);
+  decoders.push_back(&internal::DecodeVarint64s);
+  if (internal::SupportsSSE2VarintDecoder()) {
+    decoders.push_back(&internal::DecodeVarint64sSSE2);
+  }
+  if (internal::SupportsAVX2VarintDecoder()) {
+    decoders.push_back(&internal::DecodeVarint64sAVX2);
+  }
+
+  for (int d = 0; d < decoders.size(); d++) {
+    SCOPED_TRACE(d);
+    vector<uint64> values(expected.size());
+    const uint8* ptr = buffer_;
+    const uint8* end = buffer_ + size;
+    int total = 0;
+    // Odd batch sizes make decoders stop in the middle of a block.
+    int batch = 1;
+    while (ptr < end) {
+      int bytes_consumed;
+      int count = decoders[d](ptr, end, &values[total], batch, &bytes_consumed);
+      ASSERT_GT(count, 0);
+      total += count;
+      ptr += bytes_consumed;
+      batch = batch % 61 + 7;
+    }
+    ASSERT_EQ(expected.size(), total);
+    for (int i = 0; i < total; i++) {
+      EXPECT_EQ(expected[i], values[i]) << "index " << i;
+    }
+
+    // A buffer cut in the middle of a varint must stop before that varint.
+    int bytes_consumed;
+    EXPECT_EQ(expected.size() - 1,
+              decoders[d](buffer_, end - 1, &values[0], expected.size(),
+                          &bytes_consumed));
+  }
+
+  // The single-value decoder agrees as well.
+  const uint8* ptr = buffer_;
+  for (int i = 0; i + 1 < expected.size(); i++) {
+    uint64 value;
+    ptr = internal::DecodeVarint64(ptr, &value);
+    ASSERT_TRUE(ptr != NULL);
+    EXPECT_EQ(expected[i], value) << "index " << i;
+  }
+}
+
 // -------------------------------------------------------------------
 // VarintSize
 
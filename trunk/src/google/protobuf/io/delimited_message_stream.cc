@@ -0,0 +1,210 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <google/protobuf/io/delimited_message_stream.h>
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/message_lite.h>
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+namespace io {
+
+namespace {
+
+const int kMaxVarint32Bytes = 5;
+
+// CodedOutputStream counts the bytes written in an int, so the writer
+// starts a new one before the count can overflow.
+const int kMaxBytesPerCodedOutputStream = 1 << 30;
+
+}  // namespace
+
+// ===================================================================
+
+DelimitedMessageWriter::DelimitedMessageWriter(ZeroCopyOutputStream* output)
+  : output_(output),
+    flushed_byte_count_(0),
+    had_error_(false) {
+}
+
+DelimitedMessageWriter::~DelimitedMessageWriter() {
+  Flush();
+}
+
+bool DelimitedMessageWriter::WriteMessage(const MessageLite& message) {
+  GOOGLE_DCHECK(message.IsInitialized())
+      << "Can't serialize message of type \"" << message.GetTypeName()
+      << "\" because it is missing required fields: "
+      << message.InitializationErrorString();
+  return WritePartialMessage(message);
+}
+
+bool DelimitedMessageWriter::WritePartialMessage(const MessageLite& message) {
+  if (had_error_) return false;
+  if (coded_output_ != NULL &&
+      coded_output_->ByteCount() >= kMaxBytesPerCodedOutputStream) {
+    Flush();
+  }
+  if (coded_output_ == NULL) {
+    coded_output_.reset(new CodedOutputStream(output_));
+  }
+
+  const int size = message.ByteSize();
+  uint8* target = coded_output_->GetDirectBufferForNBytesAndAdvance(
+      CodedOutputStream::VarintSize32(size) + size);
+  if (target != NULL) {
+    // The whole record fits in the current buffer.
+    target = CodedOutputStream::WriteVarint32ToArray(size, target);
+    message.SerializeWithCachedSizesToArray(target);
+  } else {
+    coded_output_->WriteVarint32(size);
+    message.SerializeWithCachedSizes(coded_output_.get());
+    if (coded_output_->HadError()) had_error_ = true;
+  }
+  return !had_error_;
+}
+
+void DelimitedMessageWriter::Flush() {
+  if (coded_output_ != NULL) {
+    flushed_byte_count_ += coded_output_->ByteCount();
+    coded_output_.reset();  // Backs up over the unused part of the buffer.
+  }
+}
+
+int64 DelimitedMessageWriter::ByteCount() const {
+  return flushed_byte_count_ +
+         (coded_output_ == NULL ? 0 : coded_output_->ByteCount());
+}
+
+// ===================================================================
+
+DelimitedMessageReader::DelimitedMessageReader(ZeroCopyInputStream* input)
+  : input_(input),
+    finished_byte_count_(0),
+    max_record_size_(64 << 20),
+    had_error_(false) {
+}
+
+DelimitedMessageReader::~DelimitedMessageReader() {}
+
+void DelimitedMessageReader::SetMaxRecordSize(int max_record_size) {
+  GOOGLE_CHECK_GE(max_record_size, 0);
+  GOOGLE_CHECK_LE(max_record_size, kint32max - kMaxVarint32Bytes);
+  max_record_size_ = max_record_size;
+}
+
+bool DelimitedMessageReader::BeginRecord(int* old_limit) {
+  if (had_error_) return false;
+
+  // CodedInputStream counts the bytes read in an int, so start a new one
+  // before a record could take it past kint32max.  Destroying the old one
+  // returns whatever it read ahead to input_.
+  if (coded_input_ != NULL &&
+      coded_input_->CurrentPosition() >
+          kint32max - kMaxVarint32Bytes - max_record_size_) {
+    finished_byte_count_ += coded_input_->CurrentPosition();
+    coded_input_.reset();
+  }
+  if (coded_input_ == NULL) {
+    coded_input_.reset(new CodedInputStream(input_));
+    // Records are limited by max_record_size_ instead.
+    coded_input_->SetTotalBytesLimit(kint32max, -1);
+  }
+
+  // Running out of data between records is the normal end of the stream.
+  const void* data;
+  int buffer_size;
+  if (!coded_input_->GetDirectBufferPointer(&data, &buffer_size)) {
+    return false;
+  }
+
+  uint32 size;
+  if (!coded_input_->ReadVarint32(&size)) {
+    had_error_ = true;
+    return false;
+  }
+  if (size > static_cast<uint32>(max_record_size_)) {
+    GOOGLE_LOG(ERROR) << "A delimited record of " << size << " bytes is "
+                         "larger than the limit of " << max_record_size_
+                      << " bytes.  To accept it, call SetMaxRecordSize().";
+    had_error_ = true;
+    return false;
+  }
+  *old_limit = coded_input_->PushLimit(size);
+  return true;
+}
+
+bool DelimitedMessageReader::ReadMessage(MessageLite* message) {
+  if (!ReadPartialMessage(message)) return false;
+  if (!message->IsInitialized()) {
+    GOOGLE_LOG(ERROR) << "Can't parse message of type \""
+                      << message->GetTypeName()
+                      << "\" because it is missing required fields: "
+                      << message->InitializationErrorString();
+    had_error_ = true;
+    return false;
+  }
+  return true;
+}
+
+bool DelimitedMessageReader::ReadPartialMessage(MessageLite* message) {
+  int old_limit;
+  if (!BeginRecord(&old_limit)) return false;
+  message->Clear();
+  if (!message->MergePartialFromCodedStream(coded_input_.get()) ||
+      !coded_input_->ConsumedEntireMessage()) {
+    had_error_ = true;
+    return false;
+  }
+  coded_input_->PopLimit(old_limit);
+  return true;
+}
+
+bool DelimitedMessageReader::SkipMessage() {
+  int old_limit;
+  if (!BeginRecord(&old_limit)) return false;
+  if (!coded_input_->Skip(coded_input_->BytesUntilLimit())) {
+    had_error_ = true;
+    return false;
+  }
+  coded_input_->PopLimit(old_limit);
+  return true;
+}
+
+int64 DelimitedMessageReader::ByteCount() const {
+  return finished_byte_count_ +
+         (coded_input_ == NULL ? 0 : coded_input_->CurrentPosition());
+}
+
+}  // namespace io
+}  // namespace protobuf
+}  // namespace google
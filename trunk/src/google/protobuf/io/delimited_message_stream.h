@@ -0,0 +1,171 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Defines DelimitedMessageWriter and DelimitedMessageReader, which write and
+// read a stream of messages, each preceded by its size as a varint.
+//
+// Protocol buffers are not self-delimiting, so a stream holding more than
+// one message must frame them somehow.  Writing the size of each message
+// before it is the usual way, and it is what these classes do, in the same
+// format as the Java library's writeDelimitedTo() and parseDelimitedFrom().
+// A stream written this way is a sequence of "records":
+//
+//   record = varint(size) message-bytes(size)
+//
+// Example:
+//
+//   DelimitedMessageWriter writer(&file_output);
+//   for (int i = 0; i < count; i++) {
+//     writer.WriteMessage(messages[i]);
+//   }
+//   writer.Flush();
+//
+//   DelimitedMessageReader reader(&file_input);
+//   MyMessage message;
+//   while (reader.ReadMessage(&message)) {
+//     Process(message);
+//   }
+//   if (reader.HadError()) ...
+
+#ifndef GOOGLE_PROTOBUF_IO_DELIMITED_MESSAGE_STREAM_H__
+#define GOOGLE_PROTOBUF_IO_DELIMITED_MESSAGE_STREAM_H__
+
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+  class MessageLite;           // message_lite.h
+}
+
+namespace protobuf {
+namespace io {
+
+class CodedInputStream;        // coded_stream.h
+class CodedOutputStream;       // coded_stream.h
+class ZeroCopyInputStream;     // zero_copy_stream.h
+class ZeroCopyOutputStream;    // zero_copy_stream.h
+
+// Writes size-delimited messages to a ZeroCopyOutputStream.
+//
+// All records share one CodedOutputStream, so small messages are packed
+// into the underlying stream's buffers one after another, and each is
+// serialized straight into the buffer when it fits there.  Nothing reaches
+// the underlying stream until it asks for another buffer; call Flush() (or
+// destroy the writer) before flushing or closing it.
+class LIBPROTOBUF_EXPORT DelimitedMessageWriter {
+ public:
+  explicit DelimitedMessageWriter(ZeroCopyOutputStream* output);
+  // Calls Flush().
+  ~DelimitedMessageWriter();
+
+  // Writes one record.  The message must be initialized; use
+  // WritePartialMessage() otherwise.  Returns false if the underlying stream
+  // failed, in which case the writer stays failed.
+  bool WriteMessage(const MessageLite& message);
+  // Like WriteMessage(), but does not check that required fields are set.
+  bool WritePartialMessage(const MessageLite& message);
+
+  // Returns the unused part of the current buffer to the underlying stream,
+  // so that everything written so far is in it.
+  void Flush();
+
+  // True if writing to the underlying stream failed.
+  bool HadError() const { return had_error_; }
+
+  // The number of bytes written, across all records.
+  int64 ByteCount() const;
+
+ private:
+  ZeroCopyOutputStream* output_;
+  scoped_ptr<CodedOutputStream> coded_output_;  // Created on demand.
+  int64 flushed_byte_count_;  // Bytes written by earlier coded_output_s.
+  bool had_error_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(DelimitedMessageWriter);
+};
+
+// Reads size-delimited messages from a ZeroCopyInputStream.
+//
+// A single CodedInputStream reads all of the records, but the limits that
+// normally apply to a whole stream apply to each record instead:  a record
+// may be at most max_record_size() bytes, and there is no limit on the size
+// of the stream.  Pass the same message object to every ReadMessage() call
+// to reuse the memory it allocated for earlier records.
+class LIBPROTOBUF_EXPORT DelimitedMessageReader {
+ public:
+  explicit DelimitedMessageReader(ZeroCopyInputStream* input);
+  // Returns any data read ahead but not consumed to the underlying stream
+  // with BackUp().
+  ~DelimitedMessageReader();
+
+  // Sets the largest record that will be accepted.  A record bigger than
+  // this is treated as an error, as exceeding
+  // CodedInputStream::SetTotalBytesLimit() would be.  Defaults to 64MB.
+  void SetMaxRecordSize(int max_record_size);
+  int max_record_size() const { return max_record_size_; }
+
+  // Clears the message and parses the next record into it.  Returns false at
+  // the end of the stream or if there is an error; HadError() tells which.
+  // A record that parses but is missing required fields is an error.
+  bool ReadMessage(MessageLite* message);
+  // Like ReadMessage(), but does not check that required fields are set.
+  bool ReadPartialMessage(MessageLite* message);
+
+  // Skips over the next record without parsing it.  Returns false at the end
+  // of the stream or if there is an error; HadError() tells which.
+  bool SkipMessage();
+
+  // True if the stream ended in the middle of a record, a record was larger
+  // than max_record_size(), or a record failed to parse.
+  bool HadError() const { return had_error_; }
+
+  // The number of bytes read, across all records.
+  int64 ByteCount() const;
+
+ private:
+  // Reads the size of the next record and pushes a limit for it.  Returns
+  // false at the end of the stream or on error, after setting had_error_ in
+  // the latter case.
+  bool BeginRecord(int* old_limit);
+
+  ZeroCopyInputStream* input_;
+  scoped_ptr<CodedInputStream> coded_input_;  // Created on demand.
+  int64 finished_byte_count_;  // Bytes read by earlier coded_input_s.
+  int max_record_size_;
+  bool had_error_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(DelimitedMessageReader);
+};
+
+}  // namespace io
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_IO_DELIMITED_MESSAGE_STREAM_H__
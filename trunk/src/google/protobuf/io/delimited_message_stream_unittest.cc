@@ -0,0 +1,257 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <string>
+
+#include <google/protobuf/io/delimited_message_stream.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl.h>
+#include <google/protobuf/unittest.pb.h>
+#include <google/protobuf/test_util.h>
+
+#include <google/protobuf/stubs/common.h>
+#include <google/protobuf/stubs/stl_util.h>
+#include <google/protobuf/testing/googletest.h>
+#include <gtest/gtest.h>
+
+namespace google {
+namespace protobuf {
+namespace io {
+namespace {
+
+// Block sizes for the underlying streams, small enough that records cross
+// buffer boundaries, and big enough that many fit in one buffer.
+const int kBlockSizes[] = {1, 7, 64, 8192};
+
+// Writes |count| records, the i-th of which is a TestAllTypes whose
+// optional_int32 is i.  Every tenth one has all fields set, to make it larger
+// than the smaller block sizes.
+void WriteRecords(int count, DelimitedMessageWriter* writer) {
+  for (int i = 0; i < count; i++) {
+    protobuf_unittest::TestAllTypes message;
+    if (i % 10 == 0) TestUtil::SetAllFields(&message);
+    message.set_optional_int32(i);
+    EXPECT_TRUE(writer->WriteMessage(message));
+  }
+}
+
+TEST(DelimitedMessageStreamTest, RoundTrip) {
+  for (int i = 0; i < GOOGLE_ARRAYSIZE(kBlockSizes); i++) {
+    string data;
+    {
+      StringOutputStream output(&data);
+      DelimitedMessageWriter writer(&output);
+      WriteRecords(100, &writer);
+      writer.Flush();
+      EXPECT_EQ(data.size(), writer.ByteCount());
+      EXPECT_FALSE(writer.HadError());
+    }
+
+    ArrayInputStream input(data.data(), data.size(), kBlockSizes[i]);
+    DelimitedMessageReader reader(&input);
+    protobuf_unittest::TestAllTypes message;
+    for (int j = 0; j < 100; j++) {
+      ASSERT_TRUE(reader.ReadMessage(&message));
+      EXPECT_EQ(j, message.optional_int32());
+      if (j % 10 == 0) {
+        message.set_optional_int32(101);
+        TestUtil::ExpectAllFieldsSet(message);
+      } else {
+        // The message was cleared before parsing.
+        EXPECT_FALSE(message.has_optional_string());
+      }
+    }
+    EXPECT_FALSE(reader.ReadMessage(&message));
+    EXPECT_FALSE(reader.HadError());
+    EXPECT_EQ(data.size(), reader.ByteCount());
+  }
+}
+
+TEST(DelimitedMessageStreamTest, MatchesCodedStreamFraming) {
+  protobuf_unittest::TestAllTypes message;
+  TestUtil::SetAllFields(&message);
+
+  string expected;
+  {
+    StringOutputStream output(&expected);
+    CodedOutputStream coded_output(&output);
+    for (int i = 0; i < 3; i++) {
+      coded_output.WriteVarint32(message.ByteSize());
+      message.SerializeWithCachedSizes(&coded_output);
+    }
+  }
+
+  for (int i = 0; i < GOOGLE_ARRAYSIZE(kBlockSizes); i++) {
+    string data(expected.size(), '\0');
+    ArrayOutputStream output(string_as_array(&data), data.size(),
+                             kBlockSizes[i]);
+    {
+      DelimitedMessageWriter writer(&output);
+      for (int j = 0; j < 3; j++) {
+        EXPECT_TRUE(writer.WriteMessage(message));
+      }
+    }
+    EXPECT_EQ(expected.size(), output.ByteCount());
+    EXPECT_EQ(expected, data);
+  }
+}
+
+TEST(DelimitedMessageStreamTest, SkipMessage) {
+  string data;
+  {
+    StringOutputStream output(&data);
+    DelimitedMessageWriter writer(&output);
+    WriteRecords(30, &writer);
+  }
+
+  for (int i = 0; i < GOOGLE_ARRAYSIZE(kBlockSizes); i++) {
+    ArrayInputStream input(data.data(), data.size(), kBlockSizes[i]);
+    DelimitedMessageReader reader(&input);
+    protobuf_unittest::TestAllTypes message;
+    for (int j = 0; j < 30; j += 2) {
+      EXPECT_TRUE(reader.SkipMessage());
+      ASSERT_TRUE(reader.ReadMessage(&message));
+      EXPECT_EQ(j + 1, message.optional_int32());
+    }
+    EXPECT_FALSE(reader.SkipMessage());
+    EXPECT_FALSE(reader.HadError());
+  }
+}
+
+TEST(DelimitedMessageStreamTest, WriterFailure) {
+  protobuf_unittest::TestAllTypes message;
+  TestUtil::SetAllFields(&message);
+  char buffer[100];
+  ArrayOutputStream output(buffer, sizeof(buffer), 10);
+  DelimitedMessageWriter writer(&output);
+  EXPECT_FALSE(writer.WriteMessage(message));
+  EXPECT_TRUE(writer.HadError());
+
+  // Even a message that would fit is refused once the writer has failed.
+  message.Clear();
+  EXPECT_FALSE(writer.WriteMessage(message));
+}
+
+TEST(DelimitedMessageStreamTest, TruncatedRecord) {
+  protobuf_unittest::TestAllTypes message;
+  TestUtil::SetAllFields(&message);
+  string data;
+  {
+    StringOutputStream output(&data);
+    DelimitedMessageWriter writer(&output);
+    writer.WriteMessage(message);
+    writer.WriteMessage(message);
+  }
+  data.resize(data.size() - 1);
+
+  ArrayInputStream input(data.data(), data.size());
+  DelimitedMessageReader reader(&input);
+  EXPECT_TRUE(reader.ReadMessage(&message));
+  EXPECT_FALSE(reader.ReadMessage(&message));
+  EXPECT_TRUE(reader.HadError());
+  // The reader stays failed.
+  EXPECT_FALSE(reader.SkipMessage());
+}
+
+TEST(DelimitedMessageStreamTest, MaxRecordSize) {
+  protobuf_unittest::TestAllTypes message;
+  message.set_optional_string(string(1000, 'x'));
+  string data;
+  {
+    StringOutputStream output(&data);
+    DelimitedMessageWriter writer(&output);
+    writer.WriteMessage(message);
+  }
+
+  {
+    ArrayInputStream input(data.data(), data.size());
+    DelimitedMessageReader reader(&input);
+    reader.SetMaxRecordSize(1003);
+    EXPECT_TRUE(reader.ReadMessage(&message));
+  }
+  {
+    ArrayInputStream input(data.data(), data.size());
+    DelimitedMessageReader reader(&input);
+    reader.SetMaxRecordSize(1002);
+    EXPECT_FALSE(reader.SkipMessage());
+    EXPECT_TRUE(reader.HadError());
+  }
+}
+
+TEST(DelimitedMessageStreamTest, MissingRequiredFields) {
+  protobuf_unittest::TestRequired message;
+  message.set_a(1);
+  string data;
+  {
+    StringOutputStream output(&data);
+    DelimitedMessageWriter writer(&output);
+    EXPECT_TRUE(writer.WritePartialMessage(message));
+  }
+
+  {
+    ArrayInputStream input(data.data(), data.size());
+    DelimitedMessageReader reader(&input);
+    EXPECT_TRUE(reader.ReadPartialMessage(&message));
+    EXPECT_EQ(1, message.a());
+  }
+  {
+    ArrayInputStream input(data.data(), data.size());
+    DelimitedMessageReader reader(&input);
+    EXPECT_FALSE(reader.ReadMessage(&message));
+    EXPECT_TRUE(reader.HadError());
+  }
+}
+
+TEST(DelimitedMessageStreamTest, LeavesUnreadDataInStream) {
+  string data;
+  {
+    StringOutputStream output(&data);
+    DelimitedMessageWriter writer(&output);
+    WriteRecords(2, &writer);
+  }
+  data += "trailer";
+
+  ArrayInputStream input(data.data(), data.size());
+  {
+    DelimitedMessageReader reader(&input);
+    protobuf_unittest::TestAllTypes message;
+    EXPECT_TRUE(reader.ReadMessage(&message));
+    EXPECT_TRUE(reader.ReadMessage(&message));
+  }
+  const void* rest;
+  int size;
+  ASSERT_TRUE(input.Next(&rest, &size));
+  EXPECT_EQ("trailer", string(reinterpret_cast<const char*>(rest), size));
+}
+
+}  // namespace
+}  // namespace io
+}  // namespace protobuf
+}  // namespace google
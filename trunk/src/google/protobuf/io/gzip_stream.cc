@@ -38,13 +38,22 @@
 #if HAVE_ZLIB
 #include <google/protobuf/io/gzip_stream.h>
 
+#include <algorithm>
+
 #include <google/protobuf/stubs/common.h>
+#include <google/protobuf/stubs/parallel.h>
+#include <google/protobuf/stubs/stl_util.h>
 
 namespace google {
 namespace protobuf {
 namespace io {
 
 static const int kDefaultBufferSize = 65536;
+static const int kDefaultBlockSize = 131072;
+
+// Deflate can refer back this far, so this much of the data before a block
+// is given to it as a dictionary.
+static const int kWindowSize = 32768;
 
 GzipInputStream::GzipInputStream(
     ZeroCopyInputStream* sub_stream, Format format, int buffer_size)
@@ -184,11 +193,91 @@ int64 GzipInputStream::ByteCount() const {
 
 // =========================================================================
 
+// A block of data to be compressed on its own, for GzipOutputStream's
+// parallel mode.
+class GzipOutputStream::Block {
+ public:
+  explicit Block(int size) : size_(0), error_(Z_OK) {
+    data_.resize(size);
+  }
+
+  // The data.  The first size() bytes have been written.
+  char* data() { return string_as_array(&data_); }
+  int size() const { return size_; }
+  int capacity() const { return data_.size(); }
+  void set_size(int size) { size_ = size; }
+
+  const string& output() const { return output_; }
+  int error() const { return error_; }
+
+  // Sets up Compress().  dictionary must outlive it.
+  void Prepare(const Options& options, const string* dictionary, int flush) {
+    options_ = &options;
+    dictionary_ = dictionary;
+    flush_ = flush;
+  }
+
+  // Compresses the data into a raw deflate stream, ending it with the given
+  // flush mode:  Z_SYNC_FLUSH leaves the stream open for the next block to
+  // continue it, Z_FINISH ends it.  Runs on a worker thread.
+  void Compress() {
+    z_stream zcontext;
+    zcontext.zalloc = Z_NULL;
+    zcontext.zfree = Z_NULL;
+    zcontext.opaque = Z_NULL;
+    error_ = deflateInit2(&zcontext, options_->compression_level, Z_DEFLATED,
+                          /* windowBits (raw) */-15,
+                          /* memLevel (default) */8,
+                          options_->compression_strategy);
+    if (error_ != Z_OK) return;
+    if (!dictionary_->empty()) {
+      error_ = deflateSetDictionary(
+          &zcontext, reinterpret_cast<const Bytef*>(dictionary_->data()),
+          dictionary_->size());
+    }
+
+    // deflateBound() doesn't count the empty block which Z_SYNC_FLUSH adds,
+    // so leave room for that too.
+    output_.resize(deflateBound(&zcontext, size_) + 16);
+    zcontext.next_in = reinterpret_cast<Bytef*>(data());
+    zcontext.avail_in = size_;
+    zcontext.next_out = reinterpret_cast<Bytef*>(string_as_array(&output_));
+    zcontext.avail_out = output_.size();
+    while (error_ == Z_OK) {
+      error_ = deflate(&zcontext, flush_);
+      if (error_ == Z_STREAM_END || zcontext.avail_out > 0) break;
+      // Out of room.  This should not happen, but just in case...
+      output_.resize(output_.size() * 2);
+      zcontext.next_out = reinterpret_cast<Bytef*>(
+          string_as_array(&output_) + zcontext.total_out);
+      zcontext.avail_out = output_.size() - zcontext.total_out;
+    }
+    if (error_ == Z_STREAM_END) error_ = Z_OK;
+    output_.resize(zcontext.total_out);
+
+    // deflateEnd() returns Z_DATA_ERROR for a stream which wasn't finished,
+    // as those ending in Z_SYNC_FLUSH aren't.
+    int end_error = deflateEnd(&zcontext);
+    if (error_ == Z_OK && flush_ == Z_FINISH) error_ = end_error;
+  }
+
+ private:
+  string data_;
+  int size_;
+  const Options* options_;
+  const string* dictionary_;
+  int flush_;
+  string output_;
+  int error_;
+};
+
 GzipOutputStream::Options::Options()
     : format(GZIP),
       buffer_size(kDefaultBufferSize),
       compression_level(Z_DEFAULT_COMPRESSION),
-      compression_strategy(Z_DEFAULT_STRATEGY) {}
+      compression_strategy(Z_DEFAULT_STRATEGY),
+      num_threads(1),
+      block_size(kDefaultBlockSize) {}
 
 GzipOutputStream::GzipOutputStream(ZeroCopyOutputStream* sub_stream) {
   Init(sub_stream, Options());
@@ -205,6 +294,21 @@ void GzipOutputStream::Init(ZeroCopyOutputStream* sub_stream,
   sub_data_ = NULL;
   sub_data_size_ = 0;
 
+  options_ = options;
+  if (parallel()) {
+    // zcontext_ is not used; the blocks have their own.
+    GOOGLE_CHECK_GT(options.block_size, 0);
+    input_buffer_ = NULL;
+    input_buffer_length_ = 0;
+    zcontext_.msg = NULL;
+    zerror_ = Z_OK;
+    check_ = options.format == ZLIB ? adler32(0, Z_NULL, 0)
+                                    : crc32(0, Z_NULL, 0);
+    compressed_bytes_ = 0;
+    header_written_ = false;
+    return;
+  }
+
   input_buffer_length_ = options.buffer_size;
   input_buffer_ = operator new(input_buffer_length_);
   GOOGLE_CHECK(input_buffer_ != NULL);
@@ -238,6 +342,7 @@ GzipOutputStream::~GzipOutputStream() {
   if (input_buffer_ != NULL) {
     operator delete(input_buffer_);
   }
+  STLDeleteElements(&blocks_);
 }
 
 // private
@@ -267,11 +372,148 @@ int GzipOutputStream::Deflate(int flush) {
   return error;
 }
 
+// private
+int GzipOutputStream::CompressBlocks(bool finish) {
+  if (finish && blocks_.empty()) {
+    // The stream still needs a final (empty) deflate block.
+    blocks_.push_back(new Block(0));
+  }
+
+  // Checksums and dictionaries depend on the data before each block, so are
+  // done here, in order.  The window of each block is the 32kB before it.
+  vector<string> windows(blocks_.size());
+  for (int i = 0; i < blocks_.size(); i++) {
+    Block* block = blocks_[i];
+    windows[i] = window_;
+    const Bytef* data = reinterpret_cast<const Bytef*>(block->data());
+    check_ = options_.format == ZLIB ? adler32(check_, data, block->size())
+                                     : crc32(check_, data, block->size());
+    if (block->size() >= kWindowSize) {
+      window_.assign(block->data() + block->size() - kWindowSize,
+                     kWindowSize);
+    } else {
+      window_.append(block->data(), block->size());
+      if (window_.size() > kWindowSize) {
+        window_.erase(0, window_.size() - kWindowSize);
+      }
+    }
+    bool last = finish && i == blocks_.size() - 1;
+    block->Prepare(options_, &windows[i], last ? Z_FINISH : Z_SYNC_FLUSH);
+  }
+
+  vector<Closure*> closures;
+  for (int i = 0; i < blocks_.size(); i++) {
+    closures.push_back(NewCallback(blocks_[i], &Block::Compress));
+  }
+  internal::RunInParallel(closures, options_.num_threads);
+
+  int error = Z_OK;
+  if (!header_written_) {
+    uint8 header[10];
+    int header_size;
+    if (options_.format == ZLIB) {
+      // Deflate with a 32kB window, and zlib's hint of how hard it tried.
+      int level = options_.compression_level == Z_DEFAULT_COMPRESSION ?
+          6 : options_.compression_level;
+      int level_flags;
+      if (options_.compression_strategy >= Z_HUFFMAN_ONLY || level < 2) {
+        level_flags = 0;
+      } else if (level < 6) {
+        level_flags = 1;
+      } else if (level == 6) {
+        level_flags = 2;
+      } else {
+        level_flags = 3;
+      }
+      int value = (0x78 << 8) | (level_flags << 6);
+      value += 31 - value % 31;
+      header[0] = value >> 8;
+      header[1] = value & 0xff;
+      header_size = 2;
+    } else {
+      // Magic, deflate, no flags, no modification time, no extra flags,
+      // unknown OS.
+      static const uint8 kGzipHeader[10] =
+          { 0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 0xff };
+      memcpy(header, kGzipHeader, sizeof(kGzipHeader));
+      header_size = sizeof(kGzipHeader);
+    }
+    if (!WriteToSubStream(header, header_size)) error = Z_BUF_ERROR;
+    header_written_ = true;
+  }
+
+  for (int i = 0; i < blocks_.size() && error == Z_OK; i++) {
+    const Block& block = *blocks_[i];
+    if (block.error() != Z_OK) {
+      error = block.error();
+    } else if (!WriteToSubStream(block.output().data(),
+                                 block.output().size())) {
+      error = Z_BUF_ERROR;
+    }
+    compressed_bytes_ += block.size();
+  }
+  STLDeleteElements(&blocks_);
+
+  if (finish && error == Z_OK) {
+    uint8 trailer[8];
+    int trailer_size;
+    if (options_.format == ZLIB) {
+      // Adler-32, big-endian.
+      for (int i = 0; i < 4; i++) {
+        trailer[i] = (check_ >> (24 - 8 * i)) & 0xff;
+      }
+      trailer_size = 4;
+    } else {
+      // CRC-32, then the length modulo 2^32, little-endian.
+      for (int i = 0; i < 4; i++) {
+        trailer[i] = (check_ >> (8 * i)) & 0xff;
+        trailer[4 + i] = (compressed_bytes_ >> (8 * i)) & 0xff;
+      }
+      trailer_size = 8;
+    }
+    if (!WriteToSubStream(trailer, trailer_size)) error = Z_BUF_ERROR;
+  }
+  return error;
+}
+
+// private
+bool GzipOutputStream::WriteToSubStream(const void* data, int size) {
+  const char* input = static_cast<const char*>(data);
+  while (size > 0) {
+    void* output;
+    int output_size;
+    if (!sub_stream_->Next(&output, &output_size)) return false;
+    int n = min(size, output_size);
+    memcpy(output, input, n);
+    input += n;
+    size -= n;
+    if (n < output_size) sub_stream_->BackUp(output_size - n);
+  }
+  return true;
+}
+
 // implements ZeroCopyOutputStream ---------------------------------
 bool GzipOutputStream::Next(void** data, int* size) {
   if ((zerror_ != Z_OK) && (zerror_ != Z_BUF_ERROR)) {
     return false;
   }
+  if (parallel()) {
+    if (blocks_.empty() || blocks_.back()->size() == options_.block_size) {
+      if (blocks_.size() == options_.num_threads) {
+        // Enough for every thread to have a block.
+        zerror_ = CompressBlocks(false);
+        if (zerror_ != Z_OK) {
+          return false;
+        }
+      }
+      blocks_.push_back(new Block(options_.block_size));
+    }
+    Block* block = blocks_.back();
+    *data = block->data() + block->size();
+    *size = block->capacity() - block->size();
+    block->set_size(block->capacity());
+    return true;
+  }
   if (zcontext_.avail_in != 0) {
     zerror_ = Deflate(Z_NO_FLUSH);
     if (zerror_ != Z_OK) {
@@ -291,14 +533,34 @@ bool GzipOutputStream::Next(void** data, int* size) {
   return true;
 }
 void GzipOutputStream::BackUp(int count) {
+  if (parallel()) {
+    GOOGLE_CHECK(!blocks_.empty());
+    GOOGLE_CHECK_GE(blocks_.back()->size(), count);
+    blocks_.back()->set_size(blocks_.back()->size() - count);
+    return;
+  }
   GOOGLE_CHECK_GE(zcontext_.avail_in, count);
   zcontext_.avail_in -= count;
 }
 int64 GzipOutputStream::ByteCount() const {
+  if (parallel()) {
+    int64 count = compressed_bytes_;
+    for (int i = 0; i < blocks_.size(); i++) {
+      count += blocks_[i]->size();
+    }
+    return count;
+  }
   return zcontext_.total_in + zcontext_.avail_in;
 }
 
 bool GzipOutputStream::Flush() {
+  if (parallel()) {
+    if ((zerror_ != Z_OK) && (zerror_ != Z_BUF_ERROR)) {
+      return false;
+    }
+    zerror_ = CompressBlocks(false);
+    return zerror_ == Z_OK;
+  }
   zerror_ = Deflate(Z_FULL_FLUSH);
   // Return true if the flush succeeded or if it was a no-op.
   return  (zerror_ == Z_OK) ||
@@ -310,6 +572,11 @@ bool GzipOutputStream::Close() {
   if ((zerror_ != Z_OK) && (zerror_ != Z_BUF_ERROR)) {
     return false;
   }
+  if (parallel()) {
+    bool ok = CompressBlocks(true) == Z_OK;
+    zerror_ = Z_STREAM_END;
+    return ok;
+  }
   do {
     zerror_ = Deflate(Z_FINISH);
   } while (zerror_ == Z_OK);
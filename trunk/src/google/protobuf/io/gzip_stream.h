@@ -43,6 +43,8 @@
 #ifndef GOOGLE_PROTOBUF_IO_GZIP_STREAM_H__
 #define GOOGLE_PROTOBUF_IO_GZIP_STREAM_H__
 
+#include <string>
+#include <vector>
 #include <zlib.h>
 
 #include <google/protobuf/stubs/common.h>
@@ -134,6 +136,19 @@ class LIBPROTOBUF_EXPORT GzipOutputStream : public ZeroCopyOutputStream {
     // zlib.h for definitions of these constants.
     int compression_strategy;
 
+    // How many threads to compress on.  Defaults to 1, which compresses on
+    // the calling thread as data is written.  With more, the data is cut
+    // into blocks of block_size bytes, which are compressed up to
+    // num_threads at a time, each with the 32kB of data before it as its
+    // dictionary, like pigz does.  The output is still a single gzip or
+    // zlib stream, which any decompressor can read, and is only slightly
+    // larger.  buffer_size is not used in this mode.
+    int num_threads;
+
+    // The size of the blocks compressed in parallel when num_threads is more
+    // than 1.  Defaults to 128kB.
+    int block_size;
+
     Options();  // Initializes with default values.
   };
 
@@ -191,6 +206,15 @@ class LIBPROTOBUF_EXPORT GzipOutputStream : public ZeroCopyOutputStream {
   void* input_buffer_;
   size_t input_buffer_length_;
 
+  // Used instead of the above when compressing on several threads.
+  class Block;
+  Options options_;
+  vector<Block*> blocks_;  // Written but not compressed yet.
+  string window_;          // The last 32kB of data before blocks_.
+  uLong check_;            // CRC-32 (GZIP) or Adler-32 (ZLIB) so far.
+  int64 compressed_bytes_; // Bytes of data which are no longer in blocks_.
+  bool header_written_;
+
   // Shared constructor code.
   void Init(ZeroCopyOutputStream* sub_stream, const Options& options);
 
@@ -199,6 +223,16 @@ class LIBPROTOBUF_EXPORT GzipOutputStream : public ZeroCopyOutputStream {
   // Returns zlib error code.
   int Deflate(int flush);
 
+  bool parallel() const { return options_.num_threads > 1; }
+
+  // Compresses blocks_ in parallel and writes them to sub_stream_, preceded
+  // by the header if nothing has been written yet.  If finish is true, ends
+  // the stream, adding the trailer.  Returns zlib error code.
+  int CompressBlocks(bool finish);
+
+  // Copies the given bytes to sub_stream_.
+  bool WriteToSubStream(const void* data, int size);
+
   GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(GzipOutputStream);
 };
 
@@ -0,0 +1,187 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#endif
+#include <errno.h>
+#include <algorithm>
+
+#include <google/protobuf/io/mmap_input_stream.h>
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+namespace io {
+
+namespace {
+
+// How far ahead of the current position to ask the kernel to read after a
+// Skip(), since a jump defeats its own sequential read-ahead.
+const int64 kReadAheadSize = 1 << 20;
+
+}  // namespace
+
+MmapInputStream::MmapInputStream(int file_descriptor, int block_size)
+  : data_(NULL),
+    size_(0),
+    position_(0),
+    block_size_(block_size > 0 ? block_size : kint32max),
+    last_returned_size_(0),
+    errno_(0) {
+#ifdef _WIN32
+  mapping_handle_ = NULL;
+  HANDLE file = reinterpret_cast<HANDLE>(_get_osfhandle(file_descriptor));
+  LARGE_INTEGER file_size;
+  if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &file_size)) {
+    errno_ = EBADF;
+    return;
+  }
+  size_ = file_size.QuadPart;
+  if (size_ == 0) return;  // An empty file cannot be mapped.
+
+  mapping_handle_ = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+  if (mapping_handle_ == NULL) {
+    errno_ = EACCES;
+    size_ = 0;
+    return;
+  }
+  data_ = reinterpret_cast<const uint8*>(
+      MapViewOfFile(mapping_handle_, FILE_MAP_READ, 0, 0, 0));
+  if (data_ == NULL) {
+    errno_ = ENOMEM;
+    Unmap();
+  }
+#else
+  struct stat file_stat;
+  if (fstat(file_descriptor, &file_stat) != 0) {
+    errno_ = errno;
+    return;
+  }
+  if (!S_ISREG(file_stat.st_mode)) {
+    errno_ = ENODEV;
+    return;
+  }
+  size_ = file_stat.st_size;
+  if (size_ == 0) return;  // An empty file cannot be mapped.
+
+  void* mapping = mmap(NULL, size_, PROT_READ, MAP_SHARED, file_descriptor, 0);
+  if (mapping == MAP_FAILED) {
+    errno_ = errno;
+    size_ = 0;
+    return;
+  }
+  data_ = reinterpret_cast<const uint8*>(mapping);
+
+  // The pages are usually read once, front to back.  This makes the kernel
+  // read ahead aggressively and drop pages soon after they are passed.
+  // madvise() is only a hint, so failure is ignored.
+  madvise(mapping, size_, MADV_SEQUENTIAL);
+#endif
+}
+
+MmapInputStream::~MmapInputStream() {
+  Unmap();
+}
+
+void MmapInputStream::Unmap() {
+#ifdef _WIN32
+  if (data_ != NULL) UnmapViewOfFile(data_);
+  if (mapping_handle_ != NULL) CloseHandle(mapping_handle_);
+  mapping_handle_ = NULL;
+#else
+  if (data_ != NULL) munmap(const_cast<uint8*>(data_), size_);
+#endif
+  data_ = NULL;
+  size_ = 0;
+}
+
+void MmapInputStream::WillNeed(int64 offset, int64 size) {
+#ifndef _WIN32
+  // madvise() wants a page-aligned address.
+  static const int64 kPageSize = sysconf(_SC_PAGESIZE);
+  int64 start = offset - offset % kPageSize;
+  int64 end = std::min(offset + size, size_);
+  if (start < end) {
+    madvise(const_cast<uint8*>(data_) + start, end - start, MADV_WILLNEED);
+  }
+#endif
+}
+
+bool MmapInputStream::Next(const void** data, int* size) {
+  if (errno_ != 0 || position_ >= size_) {
+    last_returned_size_ = 0;  // Don't let caller back up.
+    return false;
+  }
+
+  *data = data_ + position_;
+  *size = static_cast<int>(std::min<int64>(block_size_, size_ - position_));
+  position_ += *size;
+  last_returned_size_ = *size;
+  return true;
+}
+
+void MmapInputStream::BackUp(int count) {
+  GOOGLE_CHECK_GT(last_returned_size_, 0)
+      << "BackUp() can only be called after a successful Next().";
+  GOOGLE_CHECK_LE(count, last_returned_size_);
+  GOOGLE_CHECK_GE(count, 0);
+  position_ -= count;
+  last_returned_size_ = 0;  // Don't let caller back up further.
+}
+
+bool MmapInputStream::Skip(int count) {
+  GOOGLE_CHECK_GE(count, 0);
+  last_returned_size_ = 0;   // Don't let caller back up.
+  if (count > size_ - position_) {
+    position_ = size_;
+    return false;
+  }
+  position_ += count;
+  if (count >= kReadAheadSize) WillNeed(position_, kReadAheadSize);
+  return true;
+}
+
+int64 MmapInputStream::ByteCount() const {
+  return position_;
+}
+
+}  // namespace io
+}  // namespace protobuf
+}  // namespace google
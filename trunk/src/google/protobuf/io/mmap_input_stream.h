@@ -0,0 +1,111 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Defines MmapInputStream, a ZeroCopyInputStream which reads a file by
+// mapping it into memory.
+//
+// Unlike FileInputStream, which copies the file through a buffer in user
+// space, MmapInputStream returns pointers directly into the mapped pages, so
+// CodedInputStream parses straight out of the page cache.  BackUp() and
+// Skip() merely move the current position.  This header only depends on
+// zero_copy_stream.h, so it may be used with the lite library.
+
+#ifndef GOOGLE_PROTOBUF_IO_MMAP_INPUT_STREAM_H__
+#define GOOGLE_PROTOBUF_IO_MMAP_INPUT_STREAM_H__
+
+#include <google/protobuf/io/zero_copy_stream.h>
+#include <google/protobuf/stubs/common.h>
+
+
+namespace google {
+namespace protobuf {
+namespace io {
+
+// A ZeroCopyInputStream which reads a file through a read-only memory
+// mapping of the whole file.
+//
+// The mapping is created by the constructor.  If that fails (for example
+// because the descriptor refers to a pipe rather than a regular file), the
+// first call to Next() returns false and GetErrno() tells why; callers that
+// must handle such descriptors can fall back to FileInputStream.  The file
+// must not be truncated while the stream exists:  accessing pages past the
+// new end of the file raises SIGBUS.
+class LIBPROTOBUF_EXPORT MmapInputStream : public ZeroCopyInputStream {
+ public:
+  // Maps the given file descriptor, which need not stay open afterwards.
+  // The stream starts at the beginning of the file regardless of the
+  // descriptor's current offset.  If a block_size is given, Next() returns
+  // at most that many bytes at a time; otherwise it returns all of the
+  // remaining data at once, which lets CodedInputStream read it as one flat
+  // buffer.
+  explicit MmapInputStream(int file_descriptor, int block_size = -1);
+  ~MmapInputStream();
+
+  // If an I/O error has occurred on this stream, this is the errno from that
+  // error.  Otherwise, this is zero.
+  int GetErrno() { return errno_; }
+
+  // The size of the mapped file.
+  int64 FileSize() const { return size_; }
+
+  // implements ZeroCopyInputStream ----------------------------------
+  bool Next(const void** data, int* size);
+  void BackUp(int count);
+  bool Skip(int count);
+  int64 ByteCount() const;
+
+ private:
+  // Unmaps the file, if it is mapped.
+  void Unmap();
+
+  // Tells the kernel that the |size| bytes at |offset| will be read soon.
+  void WillNeed(int64 offset, int64 size);
+
+  const uint8* data_;    // The mapping, or NULL.
+  int64 size_;           // The size of the mapping.
+  int64 position_;       // The offset of the next byte Next() returns.
+  const int block_size_;
+  int last_returned_size_;  // How many bytes the last call to Next() returned,
+                            // for BackUp().  Zero if BackUp() may not be
+                            // called.
+  int errno_;
+
+#ifdef _WIN32
+  void* mapping_handle_;  // The HANDLE of the file mapping object.
+#endif
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(MmapInputStream);
+};
+
+}  // namespace io
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_IO_MMAP_INPUT_STREAM_H__
@@ -0,0 +1,403 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <google/protobuf/io/varint_decoder.h>
+
+#include <string.h>
+
+#include <google/protobuf/stubs/once.h>
+#include <google/protobuf/stubs/platform_macros.h>
+
+// SSE2 is part of the x86-64 baseline, so it needs no runtime check.  AVX2
+// code is compiled with a per-function target attribute (or, on MSVC, is
+// always available to the compiler) and is only called after checking the
+// CPU.
+#if defined(GOOGLE_PROTOBUF_ARCH_X64) && \
+    (defined(__GNUC__) || defined(_MSC_VER))
+#define GOOGLE_PROTOBUF_VARINT_SSE2 1
+#include <emmintrin.h>
+#if defined(__clang__) ||                                              \
+    (defined(__GNUC__) &&                                              \
+     ((__GNUC__ == 4 && __GNUC_MINOR__ >= 9) || __GNUC__ > 4)) ||      \
+    (defined(_MSC_VER) && _MSC_VER >= 1800)
+#define GOOGLE_PROTOBUF_VARINT_AVX2 1
+#include <immintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#if defined(__GNUC__)
+#define GOOGLE_PROTOBUF_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define GOOGLE_PROTOBUF_TARGET_AVX2
+#endif
+
+namespace google {
+namespace protobuf {
+namespace internal {
+
+namespace {
+
+static const int kMaxVarintBytes = 10;
+
+#ifdef GOOGLE_PROTOBUF_VARINT_SSE2
+
+inline int CountTrailingZeros(uint32 bits) {
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward(&index, bits);
+  return static_cast<int>(index);
+#else
+  return __builtin_ctz(bits);
+#endif
+}
+
+// Decodes the varint of |length| bytes (1 to 10) starting at |ptr|.  Always
+// reads ten bytes, so the caller must make sure they exist.  The 7-bit
+// groups of the first eight bytes are packed together with three
+// shift-and-merge steps, and the length only selects masks, so varints of
+// mixed lengths do not cause branch mispredictions.
+inline uint64 DecodeVarintOfLength(const uint8* ptr, int length) {
+  // Masks for the ninth and tenth bytes, indexed by how many of them belong
+  // to the varint.  Only the lowest bit of the tenth byte fits in 64 bits.
+  static const uint64 kHighMasks[3] = {
+    0, GOOGLE_ULONGLONG(0x7f) << 56, ~GOOGLE_ULONGLONG(0)
+  };
+  uint64 word;
+  memcpy(&word, ptr, sizeof(word));  // x86 is little-endian.
+  int low_bytes = length < 8 ? length : 8;
+  word &= ~GOOGLE_ULONGLONG(0) >> (64 - 8 * low_bytes);
+  word &= GOOGLE_ULONGLONG(0x7f7f7f7f7f7f7f7f);
+  word = (word & GOOGLE_ULONGLONG(0x007f007f007f007f)) |
+         ((word & GOOGLE_ULONGLONG(0x7f007f007f007f00)) >> 1);
+  word = (word & GOOGLE_ULONGLONG(0x00003fff00003fff)) |
+         ((word & GOOGLE_ULONGLONG(0x3fff00003fff0000)) >> 2);
+  word = (word & GOOGLE_ULONGLONG(0x000000000fffffff)) |
+         ((word & GOOGLE_ULONGLONG(0x0fffffff00000000)) >> 4);
+  uint64 high = (static_cast<uint64>(ptr[8]) << 56) |
+                (static_cast<uint64>(ptr[9]) << 63);
+  return word | (high & kHighMasks[length - low_bytes]);
+}
+
+// Cheaper versions of DecodeVarintOfLength() for blocks in which no varint
+// is longer than two or four bytes, which is the common case for packed
+// fields of small numbers.
+inline uint64 DecodeShortVarintOfLength(const uint8* ptr, int length) {
+  uint32 word = ptr[0] | (static_cast<uint32>(ptr[1]) << 8);
+  word &= 0xffff >> (16 - 8 * length);
+  return (word & 0x7f) | ((word >> 1) & 0x3f80);
+}
+
+inline uint64 DecodeMediumVarintOfLength(const uint8* ptr, int length) {
+  uint32 word;
+  memcpy(&word, ptr, sizeof(word));
+  word &= 0xffffffffu >> (32 - 8 * length);
+  word = (word & 0x007f007f) | ((word & 0x7f007f00) >> 1);
+  return (word & 0x00003fff) | ((word & 0x3fff0000) >> 2);
+}
+
+// Decodes the varints that end inside a block whose terminating bytes are
+// marked by the set bits of |stops|.  Returns the number of bytes consumed,
+// which stops short of the block end if the last varint continues past it,
+// if |max_values| is reached, or at a malformed varint (in which case
+// *malformed is set).
+template <uint64 Decode(const uint8* ptr, int length)>
+inline int DecodeBlockWith(const uint8* block, uint32 stops, uint64* values,
+                           int max_values, int* count, bool* malformed) {
+  int start = 0;
+  while (stops != 0 && *count < max_values) {
+    int last = CountTrailingZeros(stops);
+    int length = last + 1 - start;
+    if (length > kMaxVarintBytes) {
+      *malformed = true;
+      break;
+    }
+    values[(*count)++] = Decode(block + start, length);
+    start = last + 1;
+    stops &= stops - 1;
+  }
+  return start;
+}
+
+// Picks the cheapest decoder that can handle every varint ending in the
+// block, based on the longest run of continuation bits.  Since a block
+// always starts at the beginning of a varint, the runs of all varints that
+// end in it are fully visible.
+inline int DecodeBlock(const uint8* block, uint32 continuation, uint32 stops,
+                       uint64* values, int max_values, int* count,
+                       bool* malformed) {
+  // Bit i is set if bytes i and i - 1 both continue a varint, and so on.
+  uint32 runs_of_two = continuation & (continuation << 1);
+  if (runs_of_two == 0) {
+    return DecodeBlockWith<DecodeShortVarintOfLength>(
+        block, stops, values, max_values, count, malformed);
+  } else if ((runs_of_two & (runs_of_two << 2)) == 0) {
+    return DecodeBlockWith<DecodeMediumVarintOfLength>(
+        block, stops, values, max_values, count, malformed);
+  } else {
+    return DecodeBlockWith<DecodeVarintOfLength>(
+        block, stops, values, max_values, count, malformed);
+  }
+}
+
+#endif  // GOOGLE_PROTOBUF_VARINT_SSE2
+
+bool sse2_supported = false;
+bool avx2_supported = false;
+VarintBatchDecoder* best_decoder = NULL;
+
+GOOGLE_PROTOBUF_DECLARE_ONCE(decoder_init_once);
+
+void InitDecoder() {
+#ifdef GOOGLE_PROTOBUF_VARINT_SSE2
+  sse2_supported = true;
+#ifdef GOOGLE_PROTOBUF_VARINT_AVX2
+  // AVX2 needs both the instructions (CPUID leaf 7) and an OS that saves the
+  // YMM registers on context switches (OSXSAVE + XCR0 bits 1 and 2).
+  uint32 ecx1, ebx7, xcr0 = 0;
+#ifdef _MSC_VER
+  int info[4];
+  __cpuid(info, 1);
+  ecx1 = info[2];
+  __cpuidex(info, 7, 0);
+  ebx7 = info[1];
+  if ((ecx1 & (1 << 27)) != 0) {
+    xcr0 = static_cast<uint32>(_xgetbv(0));
+  }
+#else
+  uint32 eax, ebx, edx;
+  __cpuid(1, eax, ebx, ecx1, edx);
+  uint32 ecx7;
+  __cpuid_count(7, 0, eax, ebx7, ecx7, edx);
+  if ((ecx1 & (1 << 27)) != 0) {
+    __asm__("xgetbv" : "=a" (xcr0), "=d" (edx) : "c" (0));
+  }
+#endif
+  avx2_supported = (ecx1 & (1 << 28)) != 0 &&  // AVX
+                   (xcr0 & 6) == 6 &&
+                   (ebx7 & (1 << 5)) != 0;     // AVX2
+#endif  // GOOGLE_PROTOBUF_VARINT_AVX2
+#endif  // GOOGLE_PROTOBUF_VARINT_SSE2
+
+  if (avx2_supported) {
+    best_decoder = &DecodeVarint64sAVX2;
+  } else if (sse2_supported) {
+    best_decoder = &DecodeVarint64sSSE2;
+  } else {
+    best_decoder = &DecodeVarint64sScalar;
+  }
+}
+
+}  // namespace
+
+int DecodeVarint64sScalar(const uint8* begin, const uint8* end,
+                          uint64* values, int max_values,
+                          int* bytes_consumed) {
+  const uint8* ptr = begin;
+  int count = 0;
+  while (count < max_values) {
+    const uint8* p = ptr;
+    uint64 result = 0;
+    int shift = 0;
+    uint32 b;
+    do {
+      if (p == end || shift == 7 * kMaxVarintBytes) {
+        *bytes_consumed = ptr - begin;
+        return count;
+      }
+      b = *(p++);
+      result |= static_cast<uint64>(b & 0x7F) << shift;
+      shift += 7;
+    } while (b & 0x80);
+    values[count++] = result;
+    ptr = p;
+  }
+  *bytes_consumed = ptr - begin;
+  return count;
+}
+
+#ifdef GOOGLE_PROTOBUF_VARINT_SSE2
+
+int DecodeVarint64sSSE2(const uint8* begin, const uint8* end,
+                        uint64* values, int max_values,
+                        int* bytes_consumed) {
+  const uint8* ptr = begin;
+  int count = 0;
+  bool malformed = false;
+  // A varint ending inside a 16-byte block is read with an eight-byte load
+  // plus up to two more bytes, so keep 32 bytes of slack; the scalar loop
+  // finishes the rest.
+  while (end - ptr >= 32 && count < max_values && !malformed) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+    uint32 continuation = _mm_movemask_epi8(block);
+    if (continuation == 0 && max_values - count >= 16) {
+      // Sixteen one-byte varints: zero-extend each byte to 64 bits.
+      const __m128i zero = _mm_setzero_si128();
+      __m128i words[2] = { _mm_unpacklo_epi8(block, zero),
+                           _mm_unpackhi_epi8(block, zero) };
+      __m128i* out = reinterpret_cast<__m128i*>(values + count);
+      for (int i = 0; i < 2; i++) {
+        __m128i lo = _mm_unpacklo_epi16(words[i], zero);
+        __m128i hi = _mm_unpackhi_epi16(words[i], zero);
+        _mm_storeu_si128(out++, _mm_unpacklo_epi32(lo, zero));
+        _mm_storeu_si128(out++, _mm_unpackhi_epi32(lo, zero));
+        _mm_storeu_si128(out++, _mm_unpacklo_epi32(hi, zero));
+        _mm_storeu_si128(out++, _mm_unpackhi_epi32(hi, zero));
+      }
+      ptr += 16;
+      count += 16;
+      continue;
+    }
+    uint32 stops = ~continuation & 0xffff;
+    if (stops == 0) break;  // A varint longer than 16 bytes is malformed.
+    ptr += DecodeBlock(ptr, continuation, stops, values, max_values, &count,
+                       &malformed);
+  }
+
+  int tail_bytes;
+  count += DecodeVarint64sScalar(ptr, end, values + count, max_values - count,
+                                 &tail_bytes);
+  *bytes_consumed = ptr + tail_bytes - begin;
+  return count;
+}
+
+#else  // GOOGLE_PROTOBUF_VARINT_SSE2
+
+int DecodeVarint64sSSE2(const uint8* begin, const uint8* end,
+                        uint64* values, int max_values,
+                        int* bytes_consumed) {
+  return DecodeVarint64sScalar(begin, end, values, max_values, bytes_consumed);
+}
+
+#endif  // !GOOGLE_PROTOBUF_VARINT_SSE2
+
+#ifdef GOOGLE_PROTOBUF_VARINT_AVX2
+
+GOOGLE_PROTOBUF_TARGET_AVX2
+int DecodeVarint64sAVX2(const uint8* begin, const uint8* end,
+                        uint64* values, int max_values,
+                        int* bytes_consumed) {
+  const uint8* ptr = begin;
+  int count = 0;
+  bool malformed = false;
+  // Same as the SSE2 loop, with 32-byte blocks and 48 bytes of slack.
+  while (end - ptr >= 48 && count < max_values && !malformed) {
+    __m256i block =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+    uint32 continuation = static_cast<uint32>(_mm256_movemask_epi8(block));
+    if (continuation == 0 && max_values - count >= 32) {
+      // Thirty-two one-byte varints: zero-extend four bytes at a time.
+      __m256i* out = reinterpret_cast<__m256i*>(values + count);
+      for (int i = 0; i < 32; i += 4) {
+        int32 four;
+        memcpy(&four, ptr + i, sizeof(four));
+        _mm256_storeu_si256(out++,
+                            _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(four)));
+      }
+      ptr += 32;
+      count += 32;
+      continue;
+    }
+    uint32 stops = ~continuation;
+    if (stops == 0) break;  // A varint longer than 32 bytes is malformed.
+    ptr += DecodeBlock(ptr, continuation, stops, values, max_values, &count,
+                       &malformed);
+  }
+
+  int tail_bytes;
+  count += DecodeVarint64sScalar(ptr, end, values + count, max_values - count,
+                                 &tail_bytes);
+  *bytes_consumed = ptr + tail_bytes - begin;
+  return count;
+}
+
+#else  // GOOGLE_PROTOBUF_VARINT_AVX2
+
+int DecodeVarint64sAVX2(const uint8* begin, const uint8* end,
+                        uint64* values, int max_values,
+                        int* bytes_consumed) {
+  return DecodeVarint64sSSE2(begin, end, values, max_values, bytes_consumed);
+}
+
+#endif  // !GOOGLE_PROTOBUF_VARINT_AVX2
+
+const uint8* DecodeVarint64(const uint8* ptr, uint64* value) {
+  // One- and two-byte varints are the most common, and are cheaper to decode
+  // directly than with a block load.
+  if (!(ptr[0] & 0x80)) {
+    *value = ptr[0];
+    return ptr + 1;
+  }
+  if (!(ptr[1] & 0x80)) {
+    *value = (ptr[0] & 0x7f) | (static_cast<uint32>(ptr[1]) << 7);
+    return ptr + 2;
+  }
+#ifdef GOOGLE_PROTOBUF_VARINT_SSE2
+  __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+  uint32 stops = ~_mm_movemask_epi8(block) & 0xffff;
+  if (stops == 0) return NULL;
+  int length = CountTrailingZeros(stops) + 1;
+  if (length > kMaxVarintBytes) return NULL;
+  *value = DecodeVarintOfLength(ptr, length);
+  return ptr + length;
+#else
+  int bytes_consumed;
+  if (DecodeVarint64sScalar(ptr, ptr + kMaxVarintBytes, value, 1,
+                            &bytes_consumed) == 0) {
+    return NULL;
+  }
+  return ptr + bytes_consumed;
+#endif
+}
+
+int DecodeVarint64s(const uint8* begin, const uint8* end,
+                    uint64* values, int max_values,
+                    int* bytes_consumed) {
+  ::google::protobuf::GoogleOnceInit(&decoder_init_once, &InitDecoder);
+  return best_decoder(begin, end, values, max_values, bytes_consumed);
+}
+
+bool SupportsSSE2VarintDecoder() {
+  ::google::protobuf::GoogleOnceInit(&decoder_init_once, &InitDecoder);
+  return sse2_supported;
+}
+
+bool SupportsAVX2VarintDecoder() {
+  ::google::protobuf::GoogleOnceInit(&decoder_init_once, &InitDecoder);
+  return avx2_supported;
+}
+
+}  // namespace internal
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,105 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Bulk varint decoding.
+//
+// Packed repeated varint fields are a long run of back-to-back varints.
+// Decoding them one byte at a time leaves most of the CPU idle, so on x86-64
+// this module classifies 16 (SSE2) or 32 (AVX2) bytes at a time: the high
+// bits of a whole block are extracted with a single movemask, which gives the
+// length of every varint in the block without a data-dependent branch per
+// byte.  Blocks made up entirely of one-byte varints are widened directly.
+//
+// The best implementation for the running CPU is picked once at runtime.
+// On other architectures the portable decoder is always used.
+//
+// This header is internal to the protobuf implementation; use
+// CodedInputStream::ReadVarint64Batch() instead of calling it directly.
+
+#ifndef GOOGLE_PROTOBUF_IO_VARINT_DECODER_H__
+#define GOOGLE_PROTOBUF_IO_VARINT_DECODER_H__
+
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+namespace internal {
+
+// Decodes consecutive varints from [begin, end) into |values|.  Decoding
+// stops after |max_values| values, before the first varint that is not
+// terminated inside the buffer, or before a varint that is longer than ten
+// bytes (and therefore malformed).  Values wider than 64 bits are truncated,
+// matching CodedInputStream::ReadVarint64().  Returns the number of values
+// decoded and sets *bytes_consumed to the number of bytes they occupied.
+typedef int VarintBatchDecoder(const uint8* begin, const uint8* end,
+                               uint64* values, int max_values,
+                               int* bytes_consumed);
+
+// The decoder CodedInputStream uses: the fastest of the implementations
+// below that the running CPU supports.
+LIBPROTOBUF_EXPORT int DecodeVarint64s(const uint8* begin, const uint8* end,
+                                       uint64* values, int max_values,
+                                       int* bytes_consumed);
+
+// Individual implementations, exposed for tests and benchmarks.  The SIMD
+// versions must only be called if the matching Supports*VarintDecoder()
+// returns true.  In builds without SIMD support they forward to the
+// portable decoder.
+LIBPROTOBUF_EXPORT int DecodeVarint64sScalar(const uint8* begin,
+                                             const uint8* end,
+                                             uint64* values, int max_values,
+                                             int* bytes_consumed);
+LIBPROTOBUF_EXPORT int DecodeVarint64sSSE2(const uint8* begin,
+                                           const uint8* end,
+                                           uint64* values, int max_values,
+                                           int* bytes_consumed);
+LIBPROTOBUF_EXPORT int DecodeVarint64sAVX2(const uint8* begin,
+                                           const uint8* end,
+                                           uint64* values, int max_values,
+                                           int* bytes_consumed);
+
+// Number of bytes DecodeVarint64() may read past its argument.
+static const int kVarintBlockBytes = 16;
+
+// Decodes a single varint starting at |ptr|, for which kVarintBlockBytes
+// bytes must be readable.  Returns a pointer just past the varint, or NULL
+// if it is longer than ten bytes.  Varints of three or more bytes are
+// decoded without a branch per byte.
+LIBPROTOBUF_EXPORT const uint8* DecodeVarint64(const uint8* ptr,
+                                               uint64* value);
+
+LIBPROTOBUF_EXPORT bool SupportsSSE2VarintDecoder();
+LIBPROTOBUF_EXPORT bool SupportsAVX2VarintDecoder();
+
+}  // namespace internal
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_IO_VARINT_DECODER_H__
@@ -61,7 +61,9 @@
 #include <sstream>
 
 #include <google/protobuf/io/zero_copy_stream_impl.h>
+#include <google/protobuf/io/chained_output_stream.h>
 #include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/mmap_input_stream.h>
 
 #if HAVE_ZLIB
 #include <google/protobuf/io/gzip_stream.h>
@@ -592,6 +594,94 @@ TEST_F(IoTest, CompressionOptions) {
   EXPECT_TRUE(Uncompress(zlib_compressed) == golden);
 }
 
+TEST_F(IoTest, GzipIoParallel) {
+  // Small blocks, so that many are compressed at once and the stream is
+  // split in odd places.
+  const GzipOutputStream::Format kFormats[] =
+      { GzipOutputStream::GZIP, GzipOutputStream::ZLIB };
+  const GzipInputStream::Format kInputFormats[] =
+      { GzipInputStream::GZIP, GzipInputStream::ZLIB };
+  const int kParallelBlockSizes[] = { 1, 7, 64 };
+
+  for (int f = 0; f < GOOGLE_ARRAYSIZE(kFormats); f++) {
+    for (int b = 0; b < GOOGLE_ARRAYSIZE(kParallelBlockSizes); b++) {
+      for (int i = 0; i < kBlockSizeCount; i++) {
+        for (int flush = 0; flush < 2; flush++) {
+          string compressed;
+          {
+            StringOutputStream string_output(&compressed);
+            GzipOutputStream::Options options;
+            options.format = kFormats[f];
+            options.num_threads = 4;
+            options.block_size = kParallelBlockSizes[b];
+            GzipOutputStream gzout(&string_output, options);
+            WriteStuff(&gzout);
+            if (flush) {
+              EXPECT_TRUE(gzout.Flush());
+            }
+            EXPECT_TRUE(gzout.Close());
+          }
+          ArrayInputStream input(compressed.data(), compressed.size(),
+                                 kBlockSizes[i]);
+          GzipInputStream gzin(&input, kInputFormats[f]);
+          ReadStuff(&gzin);
+        }
+      }
+    }
+  }
+}
+
+TEST_F(IoTest, GzipIoParallelLarge) {
+  // Blocks both smaller and larger than the 32kB window.
+  const int kParallelBlockSizes[] = { 1000, 40000, 128 * 1024 };
+
+  for (int b = 0; b < GOOGLE_ARRAYSIZE(kParallelBlockSizes); b++) {
+    string compressed;
+    {
+      StringOutputStream output(&compressed);
+      GzipOutputStream::Options options;
+      options.num_threads = 3;
+      options.block_size = kParallelBlockSizes[b];
+      GzipOutputStream gzout(&output, options);
+      WriteStuffLarge(&gzout);
+      EXPECT_TRUE(gzout.Close());
+    }
+    // Each block can refer back to the data before it, so the long runs still
+    // compress well.
+    EXPECT_LT(compressed.size(), 2000);
+    ArrayInputStream input(compressed.data(), compressed.size());
+    GzipInputStream gzin(&input, GzipInputStream::AUTO);
+    ReadStuffLarge(&gzin);
+  }
+}
+
+TEST_F(IoTest, CompressionOptionsParallel) {
+  string golden;
+  GOOGLE_CHECK_OK(File::GetContents(
+      TestSourceDir() +
+          "/google/protobuf/testdata/golden_message",
+      &golden, true));
+
+  GzipOutputStream::Options options;
+  string serial = Compress(golden, options);
+  options.num_threads = 4;
+  options.block_size = 100;
+  string parallel = Compress(golden, options);
+
+  options.format = GzipOutputStream::ZLIB;
+  options.compression_level = 9;
+  string zlib_parallel = Compress(golden, options);
+
+  EXPECT_TRUE(Uncompress(parallel) == golden);
+  EXPECT_TRUE(Uncompress(zlib_parallel) == golden);
+  EXPECT_LT(parallel.size(), golden.size());
+
+  // Nothing written at all is still a valid stream.
+  options = GzipOutputStream::Options();
+  options.num_threads = 2;
+  EXPECT_EQ("", Uncompress(Compress("", options)));
+}
+
 TEST_F(IoTest, TwoSessionWriteGzip) {
   // Test that two concatenated gzip streams can be read correctly
 
@@ -705,6 +795,147 @@ TEST_F(IoTest, FileIo) {
   }
 }
 
+TEST_F(IoTest, ChainedIo) {
+  string filename = TestTempDir() + "/zero_copy_stream_test_file";
+
+  for (int i = 0; i < kBlockSizeCount; i++) {
+    for (int j = 0; j < kBlockSizeCount; j++) {
+      int file =
+        open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_BINARY, 0777);
+      ASSERT_GE(file, 0);
+
+      ChainedOutputStream output(kBlockSizes[i]);
+      WriteStuffLarge(&output);
+      string contents;
+      output.AppendToString(&contents);
+      EXPECT_EQ(200055, contents.size());
+      EXPECT_TRUE(output.WriteToFileDescriptor(file));
+      EXPECT_EQ(0, output.GetErrno());
+      EXPECT_EQ(0, output.ByteCount());
+
+      // Rewind.
+      ASSERT_NE(lseek(file, 0, SEEK_SET), (off_t)-1);
+
+      {
+        FileInputStream input(file, kBlockSizes[j]);
+        ReadStuffLarge(&input);
+        EXPECT_EQ(0, input.GetErrno());
+      }
+
+      close(file);
+    }
+  }
+}
+
+// Aliased data must reach the file descriptor without being copied into the
+// stream's buffers.
+TEST_F(IoTest, ChainedIoAliasing) {
+  string filename = TestTempDir() + "/zero_copy_stream_test_file";
+  int file =
+    open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_BINARY, 0777);
+  ASSERT_GE(file, 0);
+
+  string blob(100000, 'x');
+  ChainedOutputStream output;
+  {
+    CodedOutputStream coded_output(&output);
+    coded_output.EnableAliasing(true);
+    coded_output.WriteRaw("Hello ", 6);
+    coded_output.WriteRawMaybeAliased(blob.data(), blob.size());
+    // Too small to be worth aliasing.
+    coded_output.WriteRawMaybeAliased("world", 5);
+  }
+  EXPECT_EQ(100011, output.ByteCount());
+
+  // Changing the blob now changes the output, proving it was not copied.
+  blob[0] = 'y';
+  string expected = "Hello " + blob + "world";
+
+  string contents;
+  output.AppendToString(&contents);
+  EXPECT_EQ(expected, contents);
+  EXPECT_TRUE(output.WriteToFileDescriptor(file));
+
+  // Rewind.
+  ASSERT_NE(lseek(file, 0, SEEK_SET), (off_t)-1);
+  {
+    FileInputStream input(file);
+    ReadString(&input, expected);
+    uint8 byte;
+    EXPECT_EQ(ReadFromInput(&input, &byte, 1), 0);
+  }
+  close(file);
+}
+
+TEST_F(IoTest, MmapIo) {
+  string filename = TestTempDir() + "/zero_copy_stream_test_file";
+
+  for (int i = 0; i < kBlockSizeCount; i++) {
+    int file =
+      open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_BINARY, 0777);
+    ASSERT_GE(file, 0);
+
+    {
+      FileOutputStream output(file);
+      WriteStuff(&output);
+      EXPECT_EQ(0, output.GetErrno());
+    }
+
+    {
+      // The stream reads from the start of the file even though the
+      // descriptor is positioned at the end.
+      MmapInputStream input(file, kBlockSizes[i]);
+      EXPECT_EQ(68, input.FileSize());
+      ReadStuff(&input);
+      EXPECT_EQ(0, input.GetErrno());
+    }
+
+    // The mapping outlives the descriptor.
+    MmapInputStream input(file, kBlockSizes[i]);
+    close(file);
+    ReadStuff(&input);
+  }
+}
+
+TEST_F(IoTest, MmapIoLarge) {
+  string filename = TestTempDir() + "/zero_copy_stream_test_file";
+  int file =
+    open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_BINARY, 0777);
+  ASSERT_GE(file, 0);
+  {
+    FileOutputStream output(file);
+    WriteStuffLarge(&output);
+  }
+
+  MmapInputStream input(file);
+  close(file);
+
+  // Without a block size, the whole file is returned by one call to Next().
+  const void* data;
+  int size;
+  ASSERT_TRUE(input.Next(&data, &size));
+  EXPECT_EQ(200055, size);
+  EXPECT_EQ(0, memcmp(data, "Hello world!\n", 13));
+  input.BackUp(size);
+  ReadStuffLarge(&input);
+  EXPECT_FALSE(input.Skip(1));
+}
+
+TEST_F(IoTest, MmapIoEmptyFile) {
+  string filename = TestTempDir() + "/zero_copy_stream_test_file";
+  int file =
+    open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_BINARY, 0777);
+  ASSERT_GE(file, 0);
+
+  MmapInputStream input(file);
+  close(file);
+  const void* data;
+  int size;
+  EXPECT_FALSE(input.Next(&data, &size));
+  EXPECT_EQ(0, input.GetErrno());
+  EXPECT_EQ(0, input.ByteCount());
+}
+
 #if HAVE_ZLIB
 TEST_F(IoTest, GzipFileIo) {
   string filename = TestTempDir() + "/zero_copy_stream_test_file";
@@ -786,6 +1017,18 @@ TEST_F(IoTest, FileReadError) {
   EXPECT_EQ(EBADF, input.GetErrno());
 }
 
+TEST_F(IoTest, MmapReadError) {
+  MsvcDebugDisabler debug_disabler;
+
+  // -1 = invalid file descriptor.
+  MmapInputStream input(-1);
+
+  const void* buffer;
+  int size;
+  EXPECT_FALSE(input.Next(&buffer, &size));
+  EXPECT_EQ(EBADF, input.GetErrno());
+}
+
 // Test that FileOutputStreams report errors correctly.
 TEST_F(IoTest, FileWriteError) {
   MsvcDebugDisabler debug_disabler;
@@ -806,6 +1049,18 @@ TEST_F(IoTest, FileWriteError) {
   EXPECT_EQ(EBADF, input.GetErrno());
 }
 
+TEST_F(IoTest, ChainedWriteError) {
+  MsvcDebugDisabler debug_disabler;
+
+  ChainedOutputStream output;
+  WriteStuff(&output);
+
+  // -1 = invalid file descriptor.
+  EXPECT_FALSE(output.WriteToFileDescriptor(-1));
+  EXPECT_EQ(EBADF, output.GetErrno());
+  EXPECT_EQ(0, output.ByteCount());
+}
+
 // Pipes are not seekable, so File{Input,Output}Stream ends up doing some
 // different things to handle them.  We'll test by writing to a pipe and
 // reading back from it.
@@ -0,0 +1,1195 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <google/protobuf/json_format.h>
+
+#include <float.h>
+#include <limits>
+#include <string.h>
+#include <vector>
+
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/io/tokenizer.h>
+#include <google/protobuf/io/zero_copy_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/io/strtod.h>
+#include <google/protobuf/stubs/hash.h>
+#include <google/protobuf/stubs/once.h>
+#include <google/protobuf/stubs/stl_util.h>
+#include <google/protobuf/stubs/strutil.h>
+
+namespace google {
+namespace protobuf {
+
+namespace {
+
+// ===========================================================================
+// Name tables
+
+// The keys of one message type, computed once.
+struct MessageNames {
+  // For each field, by index, the key as printed:  the name in quotes,
+  // followed by a colon.
+  vector<string> camelcase_keys;
+  vector<string> proto_keys;
+  // Fields by both their lowerCamelCase and .proto names.
+  hash_map<string, const FieldDescriptor*> fields_by_name;
+};
+
+class NameTables {
+ public:
+  NameTables() {}
+  ~NameTables() { STLDeleteValues(&tables_); }
+
+  const MessageNames* Get(const Descriptor* descriptor) {
+    MutexLock lock(&mutex_);
+    MessageNames*& names = tables_[descriptor];
+    if (names == NULL) {
+      names = new MessageNames;
+      for (int i = 0; i < descriptor->field_count(); i++) {
+        const FieldDescriptor* field = descriptor->field(i);
+        names->camelcase_keys.push_back(
+            "\"" + field->camelcase_name() + "\":");
+        names->proto_keys.push_back("\"" + field->name() + "\":");
+        names->fields_by_name[field->camelcase_name()] = field;
+        names->fields_by_name[field->name()] = field;
+      }
+    }
+    return names;
+  }
+
+ private:
+  Mutex mutex_;
+  hash_map<const Descriptor*, MessageNames*> tables_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(NameTables);
+};
+
+NameTables* name_tables_ = NULL;
+GOOGLE_PROTOBUF_DECLARE_ONCE(name_tables_once_);
+
+void DeleteNameTables() {
+  delete name_tables_;
+  name_tables_ = NULL;
+}
+
+void InitNameTables() {
+  name_tables_ = new NameTables;
+  internal::OnShutdown(&DeleteNameTables);
+}
+
+// Looks up names through the shared tables, remembering the results so that
+// each type costs one lock per printer or parser run.
+class NameCache {
+ public:
+  NameCache() {}
+
+  const MessageNames* Get(const Descriptor* descriptor) {
+    const MessageNames*& names = cache_[descriptor];
+    if (names == NULL) {
+      ::google::protobuf::GoogleOnceInit(&name_tables_once_, &InitNameTables);
+      names = name_tables_->Get(descriptor);
+    }
+    return names;
+  }
+
+ private:
+  hash_map<const Descriptor*, const MessageNames*> cache_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(NameCache);
+};
+
+const char kBase64Chars[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Returns the value of a base64 digit, or -1.  Accepts both the standard
+// and the URL-safe alphabets.
+inline int Base64Value(char c) {
+  if (c >= 'A' && c <= 'Z') return c - 'A';
+  if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+  if (c >= '0' && c <= '9') return c - '0' + 52;
+  if (c == '+' || c == '-') return 62;
+  if (c == '/' || c == '_') return 63;
+  return -1;
+}
+
+// Decodes base64, with or without padding.  Returns false if the input is
+// not valid base64.
+bool Base64Decode(const string& input, string* output) {
+  output->clear();
+  int size = input.size();
+  while (size > 0 && input[size - 1] == '=') --size;
+  if (input.size() - size > 2 || size % 4 == 1 ||
+      (size != input.size() && input.size() % 4 != 0)) {
+    return false;
+  }
+  output->reserve(size * 3 / 4);
+
+  uint32 bits = 0;
+  int bit_count = 0;
+  for (int i = 0; i < size; i++) {
+    int value = Base64Value(input[i]);
+    if (value < 0) return false;
+    bits = (bits << 6) | value;
+    bit_count += 6;
+    if (bit_count >= 8) {
+      bit_count -= 8;
+      output->push_back(static_cast<char>((bits >> bit_count) & 0xff));
+    }
+  }
+  return true;
+}
+
+// Parses a decimal number with no sign and no leading zeros, up to max.
+bool ParseDigits(const char* p, const char* end, uint64 max, uint64* value) {
+  if (p == end || (*p == '0' && end - p > 1)) return false;
+  uint64 result = 0;
+  for (; p < end; ++p) {
+    if (*p < '0' || *p > '9') return false;
+    int digit = *p - '0';
+    if (digit > max || result > (max - digit) / 10) return false;
+    result = result * 10 + digit;
+  }
+  *value = result;
+  return true;
+}
+
+// Parses text as an integer in [-max_negative, max_positive].  Besides
+// plain decimal integers, accepts numbers with a fraction or an exponent
+// whose value is integral, such as 1.0 or 1e3.
+bool ParseInteger(const string& text, uint64 max_positive, uint64 max_negative,
+                  bool* negative, uint64* magnitude) {
+  const char* p = text.data();
+  const char* end = p + text.size();
+  *negative = p < end && *p == '-';
+  if (ParseDigits(p + *negative, end, *negative ? max_negative : max_positive,
+                  magnitude)) {
+    return true;
+  }
+  if (text.find_first_of(".eE") == string::npos) return false;
+
+  char* double_end;
+  double value = io::NoLocaleStrtod(text.c_str(), &double_end);
+  if (double_end != end) return false;
+  // Doubles hold integers exactly up to 2^53.
+  const double kMaxExact = static_cast<double>(GOOGLE_ULONGLONG(1) << 53);
+  *negative = value < 0;
+  double abs_value = *negative ? -value : value;
+  if (!(abs_value <= kMaxExact) ||
+      abs_value != static_cast<double>(static_cast<uint64>(abs_value)) ||
+      static_cast<uint64>(abs_value) >
+          (*negative ? max_negative : max_positive)) {
+    return false;
+  }
+  *magnitude = static_cast<uint64>(abs_value);
+  return true;
+}
+
+// Appends the UTF-8 encoding of a code point.
+void AppendUTF8(uint32 code_point, string* output) {
+  if (code_point < 0x80) {
+    output->push_back(static_cast<char>(code_point));
+  } else if (code_point < 0x800) {
+    output->push_back(static_cast<char>(0xc0 | (code_point >> 6)));
+    output->push_back(static_cast<char>(0x80 | (code_point & 0x3f)));
+  } else if (code_point < 0x10000) {
+    output->push_back(static_cast<char>(0xe0 | (code_point >> 12)));
+    output->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3f)));
+    output->push_back(static_cast<char>(0x80 | (code_point & 0x3f)));
+  } else {
+    output->push_back(static_cast<char>(0xf0 | (code_point >> 18)));
+    output->push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3f)));
+    output->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3f)));
+    output->push_back(static_cast<char>(0x80 | (code_point & 0x3f)));
+  }
+}
+
+}  // namespace
+
+// ===========================================================================
+// Internal class for printing JSON.
+
+class JsonFormat::Printer::PrinterImpl {
+ public:
+  PrinterImpl(const Printer& options, io::ZeroCopyOutputStream* output)
+      : use_proto_field_names_(options.use_proto_field_names_),
+        print_enums_as_ints_(options.print_enums_as_ints_),
+        output_(output),
+        buffer_(NULL),
+        buffer_end_(NULL),
+        failed_(false),
+        depth_(0) {}
+
+  ~PrinterImpl() {
+    // Give back whatever is left of the last buffer.
+    if (buffer_ < buffer_end_) output_->BackUp(buffer_end_ - buffer_);
+  }
+
+  bool failed() const { return failed_; }
+
+  void PrintMessage(const Message& message) {
+    const Reflection* reflection = message.GetReflection();
+    const MessageNames* names = names_.Get(message.GetDescriptor());
+    const vector<string>& keys =
+        use_proto_field_names_ ? names->proto_keys : names->camelcase_keys;
+
+    // Each nesting level gets its own vector, reused from message to message.
+    // Printing submessages may grow fields_by_depth_, so it is indexed
+    // afresh rather than held by reference.
+    const int depth = depth_++;
+    if (depth == fields_by_depth_.size()) fields_by_depth_.resize(depth + 1);
+    reflection->ListFields(message, &fields_by_depth_[depth]);
+    const int field_count = fields_by_depth_[depth].size();
+
+    Put('{');
+    for (int i = 0; i < field_count; i++) {
+      const FieldDescriptor* field = fields_by_depth_[depth][i];
+      if (i > 0) Put(',');
+      if (field->is_extension()) {
+        Write("\"[", 2);
+        Write(field->full_name());
+        Write("]\":", 3);
+      } else {
+        Write(keys[field->index()]);
+      }
+
+      if (field->is_repeated()) {
+        Put('[');
+        int count = reflection->FieldSize(message, field);
+        for (int j = 0; j < count; j++) {
+          if (j > 0) Put(',');
+          PrintFieldValue(message, reflection, field, j);
+        }
+        Put(']');
+      } else {
+        PrintFieldValue(message, reflection, field, -1);
+      }
+    }
+    Put('}');
+
+    --depth_;
+  }
+
+ private:
+  // Prints a single value of the field; index is -1 for singular fields.
+  void PrintFieldValue(const Message& message, const Reflection* reflection,
+                       const FieldDescriptor* field, int index) {
+    char buffer[kFastToBufferSize];
+    switch (field->cpp_type()) {
+#define OUTPUT_FIELD(CPPTYPE, METHOD)                                        \
+      case FieldDescriptor::CPPTYPE_##CPPTYPE:                               \
+        Print##METHOD(buffer, index < 0 ?                                    \
+            reflection->Get##METHOD(message, field) :                        \
+            reflection->GetRepeated##METHOD(message, field, index));         \
+        break
+
+      OUTPUT_FIELD( INT32,  Int32);
+      OUTPUT_FIELD( INT64,  Int64);
+      OUTPUT_FIELD(UINT32, UInt32);
+      OUTPUT_FIELD(UINT64, UInt64);
+      OUTPUT_FIELD( FLOAT,  Float);
+      OUTPUT_FIELD(DOUBLE, Double);
+      OUTPUT_FIELD(  BOOL,   Bool);
+#undef OUTPUT_FIELD
+
+      case FieldDescriptor::CPPTYPE_STRING: {
+        string scratch;
+        const string& value = index < 0 ?
+            reflection->GetStringReference(message, field, &scratch) :
+            reflection->GetRepeatedStringReference(message, field, index,
+                                                   &scratch);
+        if (field->type() == FieldDescriptor::TYPE_BYTES) {
+          PrintBytes(value);
+        } else {
+          PrintString(value);
+        }
+        break;
+      }
+
+      case FieldDescriptor::CPPTYPE_ENUM: {
+        const EnumValueDescriptor* value = index < 0 ?
+            reflection->GetEnum(message, field) :
+            reflection->GetRepeatedEnum(message, field, index);
+        if (print_enums_as_ints_) {
+          PrintInt32(buffer, value->number());
+        } else {
+          Put('"');
+          Write(value->name());
+          Put('"');
+        }
+        break;
+      }
+
+      case FieldDescriptor::CPPTYPE_MESSAGE:
+        PrintMessage(index < 0 ?
+            reflection->GetMessage(message, field) :
+            reflection->GetRepeatedMessage(message, field, index));
+        break;
+    }
+  }
+
+  void PrintInt32(char* buffer, int32 value) {
+    Write(buffer, FastInt32ToBufferLeft(value, buffer) - buffer);
+  }
+  void PrintUInt32(char* buffer, uint32 value) {
+    Write(buffer, FastUInt32ToBufferLeft(value, buffer) - buffer);
+  }
+  void PrintInt64(char* buffer, int64 value) {
+    Put('"');
+    Write(buffer, FastInt64ToBufferLeft(value, buffer) - buffer);
+    Put('"');
+  }
+  void PrintUInt64(char* buffer, uint64 value) {
+    Put('"');
+    Write(buffer, FastUInt64ToBufferLeft(value, buffer) - buffer);
+    Put('"');
+  }
+  void PrintFloat(char* buffer, float value) {
+    if (!PrintNonFinite(value)) {
+      FloatToBuffer(value, buffer);
+      Write(buffer, strlen(buffer));
+    }
+  }
+  void PrintDouble(char* buffer, double value) {
+    if (!PrintNonFinite(value)) {
+      DoubleToBuffer(value, buffer);
+      Write(buffer, strlen(buffer));
+    }
+  }
+  void PrintBool(char* buffer, bool value) {
+    if (value) {
+      Write("true", 4);
+    } else {
+      Write("false", 5);
+    }
+  }
+
+  // JSON has no numbers for these, so they are printed as strings.
+  bool PrintNonFinite(double value) {
+    if (value != value) {
+      Write("\"NaN\"", 5);
+    } else if (value > DBL_MAX) {
+      Write("\"Infinity\"", 10);
+    } else if (value < -DBL_MAX) {
+      Write("\"-Infinity\"", 11);
+    } else {
+      return false;
+    }
+    return true;
+  }
+
+  void PrintString(const string& value) {
+    Put('"');
+    const char* run = value.data();
+    const char* end = run + value.size();
+    for (const char* p = run; p < end; ++p) {
+      unsigned char c = static_cast<unsigned char>(*p);
+      if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+      Write(run, p - run);
+      run = p + 1;
+      switch (c) {
+        case '"':  Write("\\\"", 2); break;
+        case '\\': Write("\\\\", 2); break;
+        case '\n': Write("\\n", 2); break;
+        case '\r': Write("\\r", 2); break;
+        case '\t': Write("\\t", 2); break;
+        case '\b': Write("\\b", 2); break;
+        case '\f': Write("\\f", 2); break;
+        default: {
+          char escape[6] = { '\\', 'u', '0', '0',
+                             "0123456789abcdef"[c >> 4],
+                             "0123456789abcdef"[c & 0xf] };
+          Write(escape, 6);
+          break;
+        }
+      }
+    }
+    Write(run, end - run);
+    Put('"');
+  }
+
+  void PrintBytes(const string& value) {
+    Put('"');
+    const uint8* p = reinterpret_cast<const uint8*>(value.data());
+    const uint8* end = p + value.size();
+    char chunk[256];
+    int chunk_size = 0;
+    for (; end - p >= 3; p += 3) {
+      uint32 bits = (p[0] << 16) | (p[1] << 8) | p[2];
+      chunk[chunk_size++] = kBase64Chars[bits >> 18];
+      chunk[chunk_size++] = kBase64Chars[(bits >> 12) & 0x3f];
+      chunk[chunk_size++] = kBase64Chars[(bits >> 6) & 0x3f];
+      chunk[chunk_size++] = kBase64Chars[bits & 0x3f];
+      if (chunk_size == sizeof(chunk)) {
+        Write(chunk, chunk_size);
+        chunk_size = 0;
+      }
+    }
+    if (p < end) {
+      uint32 bits = p[0] << 16;
+      if (end - p == 2) bits |= p[1] << 8;
+      chunk[chunk_size++] = kBase64Chars[bits >> 18];
+      chunk[chunk_size++] = kBase64Chars[(bits >> 12) & 0x3f];
+      chunk[chunk_size++] = end - p == 2 ? kBase64Chars[(bits >> 6) & 0x3f]
+                                         : '=';
+      chunk[chunk_size++] = '=';
+    }
+    Write(chunk, chunk_size);
+    Put('"');
+  }
+
+  // Output, straight into the stream's buffers.
+
+  inline void Put(char c) {
+    if (buffer_ == buffer_end_ && !Refresh()) return;
+    *buffer_++ = c;
+  }
+
+  void Write(const char* data, int size) {
+    while (size > buffer_end_ - buffer_) {
+      int available = buffer_end_ - buffer_;
+      memcpy(buffer_, data, available);
+      data += available;
+      size -= available;
+      buffer_ += available;
+      if (!Refresh()) return;
+    }
+    memcpy(buffer_, data, size);
+    buffer_ += size;
+  }
+
+  inline void Write(const string& data) { Write(data.data(), data.size()); }
+
+  bool Refresh() {
+    if (failed_) return false;
+    void* data;
+    int size;
+    do {
+      if (!output_->Next(&data, &size)) {
+        failed_ = true;
+        buffer_ = buffer_end_ = NULL;
+        return false;
+      }
+    } while (size == 0);
+    buffer_ = reinterpret_cast<char*>(data);
+    buffer_end_ = buffer_ + size;
+    return true;
+  }
+
+  const bool use_proto_field_names_;
+  const bool print_enums_as_ints_;
+  io::ZeroCopyOutputStream* const output_;
+  char* buffer_;
+  char* buffer_end_;
+  bool failed_;
+
+  NameCache names_;
+  vector<vector<const FieldDescriptor*> > fields_by_depth_;
+  int depth_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(PrinterImpl);
+};
+
+// ===========================================================================
+// Internal class for parsing JSON.
+
+class JsonFormat::Parser::ParserImpl {
+ public:
+  // Objects nested deeper than this are rejected, so that hostile input
+  // cannot overflow the stack.
+  static const int kMaxDepth = 100;
+
+  ParserImpl(const Descriptor* root_message_type,
+             io::ZeroCopyInputStream* input,
+             io::ErrorCollector* error_collector,
+             bool ignore_unknown_fields)
+      : root_message_type_(root_message_type),
+        input_(input),
+        error_collector_(error_collector),
+        ignore_unknown_fields_(ignore_unknown_fields),
+        buffer_start_(NULL),
+        pos_(NULL),
+        end_(NULL),
+        buffer_offset_(0),
+        line_(0),
+        line_start_(0),
+        token_line_(0),
+        token_column_(0),
+        had_errors_(false) {}
+
+  ~ParserImpl() {
+    // Give back whatever was not read.
+    if (pos_ < end_) input_->BackUp(end_ - pos_);
+  }
+
+  // Parses the whole input as one object, merging it into output.
+  bool Parse(Message* output) {
+    SkipWhitespace();
+    if (!Consume('{') || !ParseObject(output, 0)) return false;
+    SkipWhitespace();
+    if (Peek() != -1) {
+      ReportError("Expected end of input.");
+      return false;
+    }
+    return !had_errors_;
+  }
+
+  void ReportError(int line, int col, const string& message) {
+    had_errors_ = true;
+    if (error_collector_ == NULL) {
+      if (line >= 0) {
+        GOOGLE_LOG(ERROR) << "Error parsing JSON "
+                   << root_message_type_->full_name()
+                   << ": " << (line + 1) << ":"
+                   << (col + 1) << ": " << message;
+      } else {
+        GOOGLE_LOG(ERROR) << "Error parsing JSON "
+                   << root_message_type_->full_name()
+                   << ": " << message;
+      }
+    } else {
+      error_collector_->AddError(line, col, message);
+    }
+  }
+
+ private:
+  // Reports an error at the start of the current token.
+  void ReportError(const string& message) {
+    ReportError(token_line_, token_column_, message);
+  }
+
+  // Parses the members of an object, after its "{", into message.
+  bool ParseObject(Message* message, int depth) {
+    if (depth >= kMaxDepth) {
+      ReportError("Message is nested too deeply.");
+      return false;
+    }
+    if (TryConsume('}')) return true;
+
+    const Descriptor* descriptor = message->GetDescriptor();
+    const MessageNames* names = names_.Get(descriptor);
+    do {
+      SkipWhitespace();
+      if (Peek() != '"') {
+        ReportError("Expected string key.");
+        return false;
+      }
+      if (!ParseString(&key_)) return false;
+
+      const FieldDescriptor* field = NULL;
+      if (key_.size() > 2 && key_[0] == '[' && key_[key_.size() - 1] == ']') {
+        field = FindExtension(*message, key_.substr(1, key_.size() - 2));
+      } else {
+        hash_map<string, const FieldDescriptor*>::const_iterator it =
+            names->fields_by_name.find(key_);
+        if (it != names->fields_by_name.end()) field = it->second;
+      }
+
+      if (field == NULL && !ignore_unknown_fields_) {
+        ReportError("Message type \"" + descriptor->full_name() +
+                    "\" has no field named \"" + key_ + "\".");
+        return false;
+      }
+      if (!Consume(':')) return false;
+      if (field == NULL) {
+        if (!SkipValue(depth)) return false;
+      } else {
+        if (!ParseField(message, field, depth)) return false;
+      }
+    } while (TryConsume(','));
+
+    return Consume('}');
+  }
+
+  const FieldDescriptor* FindExtension(const Message& message,
+                                       const string& name) {
+    const Descriptor* descriptor = message.GetDescriptor();
+    const FieldDescriptor* field =
+        descriptor->file()->pool()->FindExtensionByName(name);
+    if (field == NULL) {
+      field = message.GetReflection()->FindKnownExtensionByName(name);
+    }
+    if (field != NULL && field->containing_type() != descriptor) return NULL;
+    return field;
+  }
+
+  // Parses the value of a field:  null, a value, or for repeated fields an
+  // array of values.
+  bool ParseField(Message* message, const FieldDescriptor* field,
+                  int depth) {
+    SkipWhitespace();
+    if (Peek() == 'n') return ConsumeLiteral("null");
+
+    if (!field->is_repeated()) return ParseValue(message, field, depth);
+
+    if (!Consume('[')) return false;
+    if (TryConsume(']')) return true;
+    do {
+      if (!ParseValue(message, field, depth)) return false;
+    } while (TryConsume(','));
+    return Consume(']');
+  }
+
+  // Parses one value of the field, setting it, or adding it to a repeated
+  // field.
+  bool ParseValue(Message* message, const FieldDescriptor* field, int depth) {
+    const Reflection* reflection = message->GetReflection();
+    SkipWhitespace();
+
+    switch (field->cpp_type()) {
+#define SET_FIELD(CPPTYPE, VALUE)                                  \
+        if (field->is_repeated()) {                                \
+          reflection->Add##CPPTYPE(message, field, VALUE);         \
+        } else {                                                   \
+          reflection->Set##CPPTYPE(message, field, VALUE);         \
+        }
+
+      case FieldDescriptor::CPPTYPE_INT32: {
+        bool negative;
+        uint64 magnitude;
+        if (!ParseIntegerValue(kint32max, static_cast<uint64>(kint32max) + 1,
+                               &negative, &magnitude)) {
+          return false;
+        }
+        SET_FIELD(Int32, static_cast<int32>(
+            negative ? -static_cast<int64>(magnitude) : magnitude));
+        break;
+      }
+
+      case FieldDescriptor::CPPTYPE_INT64: {
+        bool negative;
+        uint64 magnitude;
+        if (!ParseIntegerValue(kint64max, static_cast<uint64>(kint64max) + 1,
+                               &negative, &magnitude)) {
+          return false;
+        }
+        SET_FIELD(Int64, negative ? static_cast<int64>(0 - magnitude)
+                                  : static_cast<int64>(magnitude));
+        break;
+      }
+
+      case FieldDescriptor::CPPTYPE_UINT32: {
+        bool negative;
+        uint64 magnitude;
+        if (!ParseIntegerValue(kuint32max, 0, &negative, &magnitude)) {
+          return false;
+        }
+        SET_FIELD(UInt32, static_cast<uint32>(magnitude));
+        break;
+      }
+
+      case FieldDescriptor::CPPTYPE_UINT64: {
+        bool negative;
+        uint64 magnitude;
+        if (!ParseIntegerValue(kuint64max, 0, &negative, &magnitude)) {
+          return false;
+        }
+        SET_FIELD(UInt64, magnitude);
+        break;
+      }
+
+      case FieldDescriptor::CPPTYPE_FLOAT: {
+        double value;
+        if (!ParseFloatingPointValue(&value)) return false;
+        if ((value > FLT_MAX && value <= DBL_MAX) ||
+            (value < -FLT_MAX && value >= -DBL_MAX)) {
+          ReportError("Value out of range for float: " + token_ + ".");
+          return false;
+        }
+        SET_FIELD(Float, static_cast<float>(value));
+        break;
+      }
+
+      case FieldDescriptor::CPPTYPE_DOUBLE: {
+        double value;
+        if (!ParseFloatingPointValue(&value)) return false;
+        SET_FIELD(Double, value);
+        break;
+      }
+
+      case FieldDescriptor::CPPTYPE_BOOL: {
+        bool value = Peek() == 't';
+        if (!ConsumeLiteral(value ? "true" : "false")) return false;
+        SET_FIELD(Bool, value);
+        break;
+      }
+
+      case FieldDescriptor::CPPTYPE_STRING: {
+        if (Peek() != '"') {
+          ReportError("Expected string.");
+          return false;
+        }
+        if (!ParseString(&token_)) return false;
+        if (field->type() == FieldDescriptor::TYPE_BYTES) {
+          if (!Base64Decode(token_, &bytes_)) {
+            ReportError("Invalid base64 data for field \"" + field->name() +
+                        "\".");
+            return false;
+          }
+          SET_FIELD(String, bytes_);
+        } else {
+          SET_FIELD(String, token_);
+        }
+        break;
+      }
+
+      case FieldDescriptor::CPPTYPE_ENUM: {
+        const EnumDescriptor* enum_type = field->enum_type();
+        const EnumValueDescriptor* value;
+        if (Peek() == '"') {
+          if (!ParseString(&token_)) return false;
+          value = enum_type->FindValueByName(token_);
+        } else {
+          bool negative;
+          uint64 magnitude;
+          if (!ParseIntegerValue(kint32max,
+                                 static_cast<uint64>(kint32max) + 1,
+                                 &negative, &magnitude)) {
+            return false;
+          }
+          value = enum_type->FindValueByNumber(static_cast<int32>(
+              negative ? -static_cast<int64>(magnitude) : magnitude));
+        }
+        if (value == NULL) {
+          ReportError("Unknown enumeration value of \"" + token_ + "\" for "
+                      "field \"" + field->name() + "\".");
+          return false;
+        }
+        SET_FIELD(Enum, value);
+        break;
+      }
+
+      case FieldDescriptor::CPPTYPE_MESSAGE: {
+        if (!Consume('{')) return false;
+        Message* sub_message = field->is_repeated() ?
+            reflection->AddMessage(message, field) :
+            reflection->MutableMessage(message, field);
+        if (!ParseObject(sub_message, depth + 1)) return false;
+        break;
+      }
+#undef SET_FIELD
+    }
+    return true;
+  }
+
+  // Reads a number, or a string holding one, into token_.
+  bool ReadNumberText() {
+    if (Peek() == '"') return ParseString(&token_);
+    token_.clear();
+    while (true) {
+      int c = Peek();
+      if ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' ||
+          c == 'e' || c == 'E') {
+        token_.push_back(static_cast<char>(c));
+        ++pos_;
+      } else {
+        break;
+      }
+    }
+    if (token_.empty()) {
+      ReportError("Expected number.");
+      return false;
+    }
+    return true;
+  }
+
+  bool ParseIntegerValue(uint64 max_positive, uint64 max_negative,
+                         bool* negative, uint64* magnitude) {
+    if (!ReadNumberText()) return false;
+    if (!ParseInteger(token_, max_positive, max_negative, negative,
+                      magnitude)) {
+      ReportError("Expected integer in range, got: " + token_);
+      return false;
+    }
+    return true;
+  }
+
+  bool ParseFloatingPointValue(double* value) {
+    if (!ReadNumberText()) return false;
+    if (token_ == "NaN") {
+      *value = numeric_limits<double>::quiet_NaN();
+    } else if (token_ == "Infinity") {
+      *value = numeric_limits<double>::infinity();
+    } else if (token_ == "-Infinity") {
+      *value = -numeric_limits<double>::infinity();
+    } else {
+      char* end;
+      *value = io::NoLocaleStrtod(token_.c_str(), &end);
+      if (token_.empty() || end != token_.data() + token_.size()) {
+        ReportError("Expected number, got: " + token_);
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Skips a value of any kind, for a key which names no field.
+  bool SkipValue(int depth) {
+    if (depth >= kMaxDepth) {
+      ReportError("Value is nested too deeply.");
+      return false;
+    }
+    SkipWhitespace();
+    switch (Peek()) {
+      case '{':
+        ++pos_;
+        if (TryConsume('}')) return true;
+        do {
+          SkipWhitespace();
+          if (Peek() != '"') {
+            ReportError("Expected string key.");
+            return false;
+          }
+          if (!ParseString(&token_) || !Consume(':') ||
+              !SkipValue(depth + 1)) {
+            return false;
+          }
+        } while (TryConsume(','));
+        return Consume('}');
+      case '[':
+        ++pos_;
+        if (TryConsume(']')) return true;
+        do {
+          if (!SkipValue(depth + 1)) return false;
+        } while (TryConsume(','));
+        return Consume(']');
+      case '"':
+        return ParseString(&token_);
+      case 't':
+        return ConsumeLiteral("true");
+      case 'f':
+        return ConsumeLiteral("false");
+      case 'n':
+        return ConsumeLiteral("null");
+      default:
+        return ReadNumberText();
+    }
+  }
+
+  // Parses a string, starting at its opening quote, into *value.
+  bool ParseString(string* value) {
+    value->clear();
+    ++pos_;  // The opening quote.
+    while (true) {
+      // Copy everything up to the next special character at once.
+      const char* run = pos_;
+      while (pos_ < end_ && *pos_ != '"' && *pos_ != '\\' &&
+             static_cast<unsigned char>(*pos_) >= 0x20) {
+        ++pos_;
+      }
+      value->append(run, pos_ - run);
+
+      int c = Peek();
+      if (c == '"') {
+        ++pos_;
+        return true;
+      } else if (c == '\\') {
+        ++pos_;
+        if (!ParseEscape(value)) return false;
+      } else if (c == -1) {
+        ReportError("Unterminated string.");
+        return false;
+      } else if (c < 0x20) {
+        ReportError("Control characters must be escaped in strings.");
+        return false;
+      }
+      // Otherwise, the run stopped at the end of a buffer.
+    }
+  }
+
+  // Parses an escape sequence, after its backslash.
+  bool ParseEscape(string* value) {
+    int c = Peek();
+    ++pos_;
+    switch (c) {
+      case '"':  value->push_back('"');  return true;
+      case '\\': value->push_back('\\'); return true;
+      case '/':  value->push_back('/');  return true;
+      case 'b':  value->push_back('\b'); return true;
+      case 'f':  value->push_back('\f'); return true;
+      case 'n':  value->push_back('\n'); return true;
+      case 'r':  value->push_back('\r'); return true;
+      case 't':  value->push_back('\t'); return true;
+      case 'u': {
+        uint32 code_point;
+        if (!ParseHex4(&code_point)) return false;
+        if (code_point >= 0xd800 && code_point < 0xdc00) {
+          // A high surrogate, which must be followed by a low one.
+          uint32 low;
+          if (Peek() != '\\' || (++pos_, Peek()) != 'u' ||
+              (++pos_, !ParseHex4(&low)) || low < 0xdc00 || low >= 0xe000) {
+            ReportError("Invalid surrogate pair in string.");
+            return false;
+          }
+          code_point = 0x10000 + ((code_point - 0xd800) << 10) +
+                       (low - 0xdc00);
+        } else if (code_point >= 0xdc00 && code_point < 0xe000) {
+          ReportError("Invalid surrogate pair in string.");
+          return false;
+        }
+        AppendUTF8(code_point, value);
+        return true;
+      }
+      default:
+        ReportError("Invalid escape sequence in string.");
+        return false;
+    }
+  }
+
+  bool ParseHex4(uint32* value) {
+    *value = 0;
+    for (int i = 0; i < 4; i++) {
+      int c = Peek();
+      int digit;
+      if (c >= '0' && c <= '9') {
+        digit = c - '0';
+      } else if (c >= 'a' && c <= 'f') {
+        digit = c - 'a' + 10;
+      } else if (c >= 'A' && c <= 'F') {
+        digit = c - 'A' + 10;
+      } else {
+        ReportError("Expected four hex digits after \\u.");
+        return false;
+      }
+      *value = (*value << 4) | digit;
+      ++pos_;
+    }
+    return true;
+  }
+
+  // Consumes the given word, which must not be followed by more letters.
+  bool ConsumeLiteral(const char* literal) {
+    for (const char* p = literal; *p != '\0'; ++p) {
+      if (Peek() != *p) {
+        ReportError(string("Expected \"") + literal + "\".");
+        return false;
+      }
+      ++pos_;
+    }
+    int c = Peek();
+    if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+        (c >= '0' && c <= '9')) {
+      ReportError(string("Expected \"") + literal + "\".");
+      return false;
+    }
+    return true;
+  }
+
+  // Skips whitespace, then consumes c, reporting an error if it is not
+  // there.
+  bool Consume(char c) {
+    if (TryConsume(c)) return true;
+    ReportError(string("Expected \"") + c + "\".");
+    return false;
+  }
+
+  // Skips whitespace, then consumes c if it is there.
+  bool TryConsume(char c) {
+    SkipWhitespace();
+    if (Peek() != c) return false;
+    ++pos_;
+    return true;
+  }
+
+  // Skips whitespace, and records the position of what follows as the
+  // start of the current token.
+  void SkipWhitespace() {
+    while (true) {
+      if (pos_ == end_ && !Refresh()) break;
+      char c = *pos_;
+      if (c == '\n') {
+        ++line_;
+        line_start_ = Offset() + 1;
+      } else if (c != ' ' && c != '\t' && c != '\r') {
+        break;
+      }
+      ++pos_;
+    }
+    token_line_ = line_;
+    token_column_ = static_cast<int>(Offset() - line_start_);
+  }
+
+  // Returns the next character without consuming it, or -1 at the end of
+  // the input.
+  inline int Peek() {
+    if (pos_ == end_ && !Refresh()) return -1;
+    return static_cast<unsigned char>(*pos_);
+  }
+
+  // The offset of pos_ from the start of the input.
+  inline int64 Offset() const { return buffer_offset_ + (pos_ - buffer_start_); }
+
+  bool Refresh() {
+    const void* data;
+    int size;
+    do {
+      if (!input_->Next(&data, &size)) return false;
+    } while (size == 0);
+    buffer_offset_ += end_ - buffer_start_;
+    buffer_start_ = pos_ = reinterpret_cast<const char*>(data);
+    end_ = pos_ + size;
+    return true;
+  }
+
+  const Descriptor* const root_message_type_;
+  io::ZeroCopyInputStream* const input_;
+  io::ErrorCollector* const error_collector_;
+  const bool ignore_unknown_fields_;
+
+  // The current buffer, and the position in it.
+  const char* buffer_start_;
+  const char* pos_;
+  const char* end_;
+  // Offset of buffer_start_ from the start of the input.
+  int64 buffer_offset_;
+  // The current line, and the offset at which it starts.
+  int line_;
+  int64 line_start_;
+  // Where the current token starts, for error messages.
+  int token_line_;
+  int token_column_;
+
+  bool had_errors_;
+
+  NameCache names_;
+  // Scratch space, reused to avoid allocating for each value.
+  string key_;
+  string token_;
+  string bytes_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(ParserImpl);
+};
+
+// ===========================================================================
+
+JsonFormat::Printer::Printer()
+    : use_proto_field_names_(false),
+      print_enums_as_ints_(false) {}
+
+JsonFormat::Printer::~Printer() {}
+
+bool JsonFormat::Printer::Print(const Message& message,
+                                io::ZeroCopyOutputStream* output) const {
+  PrinterImpl printer(*this, output);
+  printer.PrintMessage(message);
+  return !printer.failed();
+}
+
+bool JsonFormat::Printer::PrintToString(const Message& message,
+                                        string* output) const {
+  GOOGLE_DCHECK(output) << "output specified is NULL";
+
+  output->clear();
+  io::StringOutputStream output_stream(output);
+
+  return Print(message, &output_stream);
+}
+
+JsonFormat::Parser::Parser()
+    : error_collector_(NULL),
+      allow_partial_(false),
+      ignore_unknown_fields_(false) {}
+
+JsonFormat::Parser::~Parser() {}
+
+bool JsonFormat::Parser::Parse(io::ZeroCopyInputStream* input,
+                               Message* output) {
+  output->Clear();
+  ParserImpl parser(output->GetDescriptor(), input, error_collector_,
+                    ignore_unknown_fields_);
+  return MergeUsingImpl(input, output, &parser);
+}
+
+bool JsonFormat::Parser::ParseFromString(const string& input,
+                                         Message* output) {
+  io::ArrayInputStream input_stream(input.data(), input.size());
+  return Parse(&input_stream, output);
+}
+
+bool JsonFormat::Parser::Merge(io::ZeroCopyInputStream* input,
+                               Message* output) {
+  ParserImpl parser(output->GetDescriptor(), input, error_collector_,
+                    ignore_unknown_fields_);
+  return MergeUsingImpl(input, output, &parser);
+}
+
+bool JsonFormat::Parser::MergeFromString(const string& input,
+                                         Message* output) {
+  io::ArrayInputStream input_stream(input.data(), input.size());
+  return Merge(&input_stream, output);
+}
+
+bool JsonFormat::Parser::MergeUsingImpl(io::ZeroCopyInputStream* /* input */,
+                                        Message* output,
+                                        ParserImpl* parser_impl) {
+  if (!parser_impl->Parse(output)) return false;
+  if (!allow_partial_ && !output->IsInitialized()) {
+    vector<string> missing_fields;
+    output->FindInitializationErrors(&missing_fields);
+    parser_impl->ReportError(-1, 0, "Message missing required fields: " +
+                                        Join(missing_fields, ", "));
+    return false;
+  }
+  return true;
+}
+
+/* static */ bool JsonFormat::Print(const Message& message,
+                                    io::ZeroCopyOutputStream* output) {
+  return Printer().Print(message, output);
+}
+
+/* static */ bool JsonFormat::PrintToString(const Message& message,
+                                            string* output) {
+  return Printer().PrintToString(message, output);
+}
+
+/* static */ bool JsonFormat::Parse(io::ZeroCopyInputStream* input,
+                                    Message* output) {
+  return Parser().Parse(input, output);
+}
+
+/* static */ bool JsonFormat::ParseFromString(const string& input,
+                                              Message* output) {
+  return Parser().ParseFromString(input, output);
+}
+
+/* static */ bool JsonFormat::Merge(io::ZeroCopyInputStream* input,
+                                    Message* output) {
+  return Parser().Merge(input, output);
+}
+
+/* static */ bool JsonFormat::MergeFromString(const string& input,
+                                              Message* output) {
+  return Parser().MergeFromString(input, output);
+}
+
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,186 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Utilities for printing and parsing protocol messages as JSON.
+//
+// A message is written as an object whose keys are the lowerCamelCase names
+// of its set fields (FieldDescriptor::camelcase_name()), and whose values
+// are:
+//   int32, uint32 and their variants:  numbers.
+//   int64, uint64 and their variants:  decimal strings, since JSON readers
+//                                      often store numbers as doubles.
+//   float, double:  numbers, or "NaN", "Infinity" and "-Infinity".
+//   bool:  true or false.
+//   string:  strings.
+//   bytes:  base64 strings.
+//   enums:  the value's name as a string.
+//   messages and groups:  objects.
+//   repeated fields:  arrays.
+//   extensions:  keyed by their full name in brackets, e.g.
+//                "[my.package.my_extension]".
+// Unknown fields are not printed.
+//
+// The parser accepts either lowerCamelCase names or the names written in the
+// .proto file, numbers or strings for any integer or floating-point field,
+// enum numbers as well as names, and null for any field (leaving it unset).
+//
+// Both directions work straight from the descriptor and Reflection:
+// printing streams to a ZeroCopyOutputStream, and parsing reads a
+// ZeroCopyInputStream a buffer at a time into the message, with no
+// intermediate representation of the JSON document.  The names used for
+// each message type are computed once and shared by all printers and
+// parsers.
+
+#ifndef GOOGLE_PROTOBUF_JSON_FORMAT_H__
+#define GOOGLE_PROTOBUF_JSON_FORMAT_H__
+
+#include <string>
+
+#include <google/protobuf/stubs/common.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/message.h>
+
+namespace google {
+namespace protobuf {
+
+namespace io {
+  class ErrorCollector;      // tokenizer.h
+}
+
+// This class is really a namespace that contains only static methods.
+class LIBPROTOBUF_EXPORT JsonFormat {
+ public:
+  // Outputs the given message as JSON to the given output stream.
+  static bool Print(const Message& message, io::ZeroCopyOutputStream* output);
+
+  // Like Print(), but outputs directly to a string.
+  static bool PrintToString(const Message& message, string* output);
+
+  // Parses a JSON object from the given input stream to the given message
+  // object.  This function parses the format written by Print().
+  static bool Parse(io::ZeroCopyInputStream* input, Message* output);
+  // Like Parse(), but reads directly from a string.
+  static bool ParseFromString(const string& input, Message* output);
+
+  // Like Parse(), but the data is merged into the given message, as if
+  // using Message::MergeFrom().
+  static bool Merge(io::ZeroCopyInputStream* input, Message* output);
+  // Like Merge(), but reads directly from a string.
+  static bool MergeFromString(const string& input, Message* output);
+
+  // Class for those users which require more fine-grained control over how
+  // a message is printed out.
+  class LIBPROTOBUF_EXPORT Printer {
+   public:
+    Printer();
+    ~Printer();
+
+    // Like JsonFormat::Print
+    bool Print(const Message& message, io::ZeroCopyOutputStream* output) const;
+    // Like JsonFormat::PrintToString
+    bool PrintToString(const Message& message, string* output) const;
+
+    // Use the field names written in the .proto file as keys, rather than
+    // their lowerCamelCase forms.
+    void SetUseProtoFieldNames(bool use_proto_field_names) {
+      use_proto_field_names_ = use_proto_field_names;
+    }
+
+    // Print enum values as numbers rather than names.
+    void SetPrintEnumsAsInts(bool print_enums_as_ints) {
+      print_enums_as_ints_ = print_enums_as_ints;
+    }
+
+   private:
+    // Forward declaration of an internal class used to print JSON (see
+    // json_format.cc for implementation).
+    class PrinterImpl;
+
+    bool use_proto_field_names_;
+    bool print_enums_as_ints_;
+  };
+
+  // For more control over parsing, use this class.
+  class LIBPROTOBUF_EXPORT Parser {
+   public:
+    Parser();
+    ~Parser();
+
+    // Like JsonFormat::Parse().
+    bool Parse(io::ZeroCopyInputStream* input, Message* output);
+    // Like JsonFormat::ParseFromString().
+    bool ParseFromString(const string& input, Message* output);
+    // Like JsonFormat::Merge().
+    bool Merge(io::ZeroCopyInputStream* input, Message* output);
+    // Like JsonFormat::MergeFromString().
+    bool MergeFromString(const string& input, Message* output);
+
+    // Set where to report parse errors.  If NULL (the default), errors will
+    // be printed to stderr.
+    void RecordErrorsTo(io::ErrorCollector* error_collector) {
+      error_collector_ = error_collector;
+    }
+
+    // Normally parsing fails if, after parsing, output->IsInitialized()
+    // returns false.  Call AllowPartialMessage(true) to skip this check.
+    void AllowPartialMessage(bool allow) {
+      allow_partial_ = allow;
+    }
+
+    // Normally parsing fails on a key which names no field of the message.
+    // Call IgnoreUnknownFields(true) to skip such keys and their values.
+    void IgnoreUnknownFields(bool ignore) {
+      ignore_unknown_fields_ = ignore;
+    }
+
+   private:
+    // Forward declaration of an internal class used to parse JSON (see
+    // json_format.cc for implementation).
+    class ParserImpl;
+
+    // Like JsonFormat::Merge().  The provided implementation is used
+    // to do the parsing.
+    bool MergeUsingImpl(io::ZeroCopyInputStream* input,
+                        Message* output,
+                        ParserImpl* parser_impl);
+
+    io::ErrorCollector* error_collector_;
+    bool allow_partial_;
+    bool ignore_unknown_fields_;
+  };
+
+ private:
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(JsonFormat);
+};
+
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_JSON_FORMAT_H__
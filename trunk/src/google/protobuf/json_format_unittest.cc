@@ -0,0 +1,336 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <limits>
+
+#include <google/protobuf/json_format.h>
+#include <google/protobuf/io/tokenizer.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/dynamic_message.h>
+#include <google/protobuf/unittest.pb.h>
+#include <google/protobuf/test_util.h>
+
+#include <google/protobuf/stubs/common.h>
+#include <google/protobuf/stubs/strutil.h>
+#include <google/protobuf/stubs/substitute.h>
+#include <google/protobuf/testing/googletest.h>
+#include <gtest/gtest.h>
+
+namespace google {
+namespace protobuf {
+namespace {
+
+class MockErrorCollector : public io::ErrorCollector {
+ public:
+  MockErrorCollector() {}
+  ~MockErrorCollector() {}
+
+  string text_;
+
+  // implements ErrorCollector -------------------------------------
+  void AddError(int line, int column, const string& message) {
+    strings::SubstituteAndAppend(&text_, "$0:$1: $2\n",
+                                 line + 1, column + 1, message);
+  }
+};
+
+// Parses input, expecting it to fail with the given error.
+void ExpectFailure(const string& input, Message* message,
+                   const string& expected_error) {
+  JsonFormat::Parser parser;
+  MockErrorCollector error_collector;
+  parser.RecordErrorsTo(&error_collector);
+  EXPECT_FALSE(parser.ParseFromString(input, message)) << input;
+  EXPECT_EQ(expected_error + "\n", error_collector.text_) << input;
+}
+
+TEST(JsonFormatTest, RoundTripAllFields) {
+  unittest::TestAllTypes message;
+  TestUtil::SetAllFields(&message);
+
+  string json;
+  ASSERT_TRUE(JsonFormat::PrintToString(message, &json));
+
+  unittest::TestAllTypes parsed;
+  ASSERT_TRUE(JsonFormat::ParseFromString(json, &parsed)) << json;
+  TestUtil::ExpectAllFieldsSet(parsed);
+}
+
+TEST(JsonFormatTest, RoundTripExtensions) {
+  unittest::TestAllExtensions message;
+  TestUtil::SetAllExtensions(&message);
+
+  string json;
+  ASSERT_TRUE(JsonFormat::PrintToString(message, &json));
+  EXPECT_NE(string::npos,
+            json.find("\"[protobuf_unittest.optional_int32_extension]\":101"));
+
+  unittest::TestAllExtensions parsed;
+  ASSERT_TRUE(JsonFormat::ParseFromString(json, &parsed)) << json;
+  TestUtil::ExpectAllExtensionsSet(parsed);
+}
+
+TEST(JsonFormatTest, RoundTripDynamicMessage) {
+  unittest::TestAllTypes message;
+  TestUtil::SetAllFields(&message);
+  string json;
+  ASSERT_TRUE(JsonFormat::PrintToString(message, &json));
+
+  DynamicMessageFactory factory;
+  scoped_ptr<Message> parsed(
+      factory.GetPrototype(unittest::TestAllTypes::descriptor())->New());
+  ASSERT_TRUE(JsonFormat::ParseFromString(json, parsed.get()));
+
+  string dynamic_json;
+  ASSERT_TRUE(JsonFormat::PrintToString(*parsed, &dynamic_json));
+  EXPECT_EQ(json, dynamic_json);
+}
+
+TEST(JsonFormatTest, Print) {
+  unittest::TestAllTypes message;
+  message.set_optional_int32(-12);
+  message.set_optional_int64(GOOGLE_LONGLONG(1) << 40);
+  message.set_optional_bool(true);
+  message.set_optional_string("a\"b\\c\n\001");
+  message.set_optional_bytes("\xff\x00?", 3);
+  message.mutable_optional_nested_message()->set_bb(7);
+  message.set_optional_nested_enum(unittest::TestAllTypes::BAZ);
+  message.add_repeated_uint32(1);
+  message.add_repeated_uint32(2);
+
+  string json;
+  ASSERT_TRUE(JsonFormat::PrintToString(message, &json));
+  EXPECT_EQ(
+      "{\"optionalInt32\":-12,"
+      "\"optionalInt64\":\"1099511627776\","
+      "\"optionalBool\":true,"
+      "\"optionalString\":\"a\\\"b\\\\c\\n\\u0001\","
+      "\"optionalBytes\":\"/wA/\","
+      "\"optionalNestedMessage\":{\"bb\":7},"
+      "\"optionalNestedEnum\":\"BAZ\","
+      "\"repeatedUint32\":[1,2]}",
+      json);
+}
+
+TEST(JsonFormatTest, PrintOptions) {
+  unittest::TestAllTypes message;
+  message.set_optional_int32(1);
+  message.set_optional_nested_enum(unittest::TestAllTypes::BAR);
+
+  JsonFormat::Printer printer;
+  printer.SetUseProtoFieldNames(true);
+  printer.SetPrintEnumsAsInts(true);
+  string json;
+  ASSERT_TRUE(printer.PrintToString(message, &json));
+  EXPECT_EQ("{\"optional_int32\":1,\"optional_nested_enum\":2}", json);
+
+  unittest::TestAllTypes parsed;
+  ASSERT_TRUE(JsonFormat::ParseFromString(json, &parsed));
+  EXPECT_EQ(message.DebugString(), parsed.DebugString());
+}
+
+TEST(JsonFormatTest, NonFiniteValues) {
+  unittest::TestAllTypes message;
+  message.set_optional_double(numeric_limits<double>::infinity());
+  message.set_optional_float(-numeric_limits<float>::infinity());
+  message.add_repeated_double(numeric_limits<double>::quiet_NaN());
+
+  string json;
+  ASSERT_TRUE(JsonFormat::PrintToString(message, &json));
+  EXPECT_EQ("{\"optionalFloat\":\"-Infinity\","
+            "\"optionalDouble\":\"Infinity\","
+            "\"repeatedDouble\":[\"NaN\"]}", json);
+
+  unittest::TestAllTypes parsed;
+  ASSERT_TRUE(JsonFormat::ParseFromString(json, &parsed));
+  EXPECT_EQ(numeric_limits<double>::infinity(), parsed.optional_double());
+  EXPECT_EQ(-numeric_limits<float>::infinity(), parsed.optional_float());
+  EXPECT_NE(parsed.repeated_double(0), parsed.repeated_double(0));
+}
+
+TEST(JsonFormatTest, ParseLenientForms) {
+  unittest::TestAllTypes message;
+  ASSERT_TRUE(JsonFormat::ParseFromString(
+      " {\n"
+      "  \"optional_int32\" : \"-5\",\n"
+      "  \"optionalInt64\": -9223372036854775808,\n"
+      "  \"optionalUint64\": \"18446744073709551615\",\n"
+      "  \"optionalUint32\": 3e2,\n"
+      "  \"optionalDouble\": 1.5E-3,\n"
+      "  \"optionalString\": \"\\u00e9\\ud83d\\ude00\\/\",\n"
+      "  \"optionalBytes\": \"_w\",\n"
+      "  \"optionalNestedEnum\": 3,\n"
+      "  \"optionalForeignEnum\": null,\n"
+      "  \"repeatedInt32\": [],\n"
+      "  \"optionalgroup\": {\"a\": 4}\n"
+      "}\n",
+      &message));
+  EXPECT_EQ(-5, message.optional_int32());
+  EXPECT_EQ(kint64min, message.optional_int64());
+  EXPECT_EQ(kuint64max, message.optional_uint64());
+  EXPECT_EQ(300, message.optional_uint32());
+  EXPECT_EQ(1.5e-3, message.optional_double());
+  EXPECT_EQ("\xc3\xa9\xf0\x9f\x98\x80/", message.optional_string());
+  EXPECT_EQ("\xff", message.optional_bytes());
+  EXPECT_EQ(unittest::TestAllTypes::BAZ, message.optional_nested_enum());
+  EXPECT_FALSE(message.has_optional_foreign_enum());
+  EXPECT_EQ(0, message.repeated_int32_size());
+  EXPECT_EQ(4, message.optionalgroup().a());
+}
+
+TEST(JsonFormatTest, MergeKeepsExistingFields) {
+  unittest::TestAllTypes message;
+  message.set_optional_int32(1);
+  message.add_repeated_int32(2);
+  ASSERT_TRUE(JsonFormat::MergeFromString(
+      "{\"optionalInt64\":\"3\",\"repeatedInt32\":[4]}", &message));
+  EXPECT_EQ(1, message.optional_int32());
+  EXPECT_EQ(3, message.optional_int64());
+  ASSERT_EQ(2, message.repeated_int32_size());
+  EXPECT_EQ(4, message.repeated_int32(1));
+
+  ASSERT_TRUE(JsonFormat::ParseFromString("{}", &message));
+  EXPECT_EQ(0, message.ByteSize());
+}
+
+TEST(JsonFormatTest, StreamsInSmallPieces) {
+  unittest::TestAllTypes message;
+  TestUtil::SetAllFields(&message);
+  string json;
+  ASSERT_TRUE(JsonFormat::PrintToString(message, &json));
+
+  // Reading and writing one byte at a time crosses every buffer boundary.
+  io::ArrayInputStream input(json.data(), json.size(), 1);
+  unittest::TestAllTypes parsed;
+  ASSERT_TRUE(JsonFormat::Parse(&input, &parsed));
+  TestUtil::ExpectAllFieldsSet(parsed);
+
+  char buffer[4096];
+  ASSERT_LT(json.size(), sizeof(buffer));
+  io::ArrayOutputStream output(buffer, sizeof(buffer), 1);
+  ASSERT_TRUE(JsonFormat::Print(message, &output));
+  EXPECT_EQ(json, string(buffer, output.ByteCount()));
+}
+
+TEST(JsonFormatTest, PrintBufferTooSmall) {
+  unittest::TestAllTypes message;
+  message.set_optional_string("a string which does not fit");
+  char buffer[10];
+  io::ArrayOutputStream output(buffer, sizeof(buffer));
+  EXPECT_FALSE(JsonFormat::Print(message, &output));
+  EXPECT_EQ(sizeof(buffer), output.ByteCount());
+}
+
+TEST(JsonFormatTest, IgnoreUnknownFields) {
+  unittest::TestAllTypes message;
+  ExpectFailure("{\"noSuchField\": 1}", &message,
+                "1:2: Message type \"protobuf_unittest.TestAllTypes\" has no "
+                "field named \"noSuchField\".");
+
+  JsonFormat::Parser parser;
+  parser.IgnoreUnknownFields(true);
+  ASSERT_TRUE(parser.ParseFromString(
+      "{\"a\": {\"b\": [1, \"x\", null, true, {}]}, \"optionalInt32\": 5, "
+      "\"[no.such.extension]\": false}",
+      &message));
+  EXPECT_EQ(5, message.optional_int32());
+}
+
+TEST(JsonFormatTest, RequiredFields) {
+  unittest::TestRequired message;
+  ExpectFailure("{\"a\": 1}", &message,
+                "0:1: Message missing required fields: b, c");
+
+  JsonFormat::Parser parser;
+  parser.AllowPartialMessage(true);
+  EXPECT_TRUE(parser.ParseFromString("{\"a\": 1}", &message));
+  EXPECT_EQ(1, message.a());
+}
+
+TEST(JsonFormatTest, ParseErrors) {
+  unittest::TestAllTypes message;
+  ExpectFailure("", &message, "1:1: Expected \"{\".");
+  ExpectFailure("{} x", &message, "1:4: Expected end of input.");
+  ExpectFailure("{\"optionalInt32\" 1}", &message, "1:18: Expected \":\".");
+  ExpectFailure("{\n  \"optionalInt32\": 1,\n}", &message,
+                "3:1: Expected string key.");
+  ExpectFailure("{\"optionalInt32\": 2147483648}", &message,
+                "1:19: Expected integer in range, got: 2147483648");
+  ExpectFailure("{\"optionalUint32\": -1}", &message,
+                "1:20: Expected integer in range, got: -1");
+  ExpectFailure("{\"optionalInt32\": 1.5}", &message,
+                "1:19: Expected integer in range, got: 1.5");
+  ExpectFailure("{\"optionalInt32\": 01}", &message,
+                "1:19: Expected integer in range, got: 01");
+  ExpectFailure("{\"optionalFloat\": 1e39}", &message,
+                "1:19: Value out of range for float: 1e39.");
+  ExpectFailure("{\"optionalDouble\": x}", &message,
+                "1:20: Expected number.");
+  ExpectFailure("{\"optionalBool\": tru}", &message,
+                "1:18: Expected \"true\".");
+  ExpectFailure("{\"optionalString\": 1}", &message,
+                "1:20: Expected string.");
+  ExpectFailure("{\"optionalString\": \"a\\qb\"}", &message,
+                "1:20: Invalid escape sequence in string.");
+  ExpectFailure("{\"optionalString\": \"\\ud800x\"}", &message,
+                "1:20: Invalid surrogate pair in string.");
+  ExpectFailure("{\"optionalString\": \"a\nb\"}", &message,
+                "1:20: Control characters must be escaped in strings.");
+  ExpectFailure("{\"optionalString\": \"abc", &message,
+                "1:20: Unterminated string.");
+  ExpectFailure("{\"optionalBytes\": \"a\"}", &message,
+                "1:19: Invalid base64 data for field \"optional_bytes\".");
+  ExpectFailure("{\"optionalNestedEnum\": \"QUX\"}", &message,
+                "1:24: Unknown enumeration value of \"QUX\" for field "
+                "\"optional_nested_enum\".");
+  ExpectFailure("{\"repeatedInt32\": 1}", &message,
+                "1:19: Expected \"[\".");
+  ExpectFailure("{\"optionalNestedMessage\": []}", &message,
+                "1:27: Expected \"{\".");
+}
+
+TEST(JsonFormatTest, DeepNesting) {
+  string json;
+  for (int i = 0; i < 200; i++) json += "{\"a\":";
+  json += "{}";
+  for (int i = 0; i < 200; i++) json += "}";
+
+  unittest::TestRecursiveMessage message;
+  JsonFormat::Parser parser;
+  MockErrorCollector error_collector;
+  parser.RecordErrorsTo(&error_collector);
+  EXPECT_FALSE(parser.ParseFromString(json, &message));
+  EXPECT_NE(string::npos,
+            error_collector.text_.find("Message is nested too deeply."));
+}
+
+}  // namespace
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,192 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include <google/protobuf/lazy_field.h>
+
+#include <algorithm>
+
+#include <google/protobuf/arena.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/message_lite.h>
+#include <google/protobuf/wire_format_lite_inl.h>
+
+namespace google {
+namespace protobuf {
+namespace internal {
+
+void LazyField::Destroy() {
+  delete message_;
+  delete bytes_;
+}
+
+void LazyField::ParseBytes(ParseArgs* args) {
+  const LazyField* field = args->field;
+  if (field->message_ == NULL) {
+    // Fields with bytes never belong to messages on an arena.
+    field->message_ = args->prototype->New();
+  } else {
+    field->message_->Clear();
+  }
+  field->message_->ParsePartialFromString(*field->bytes_);
+}
+
+MessageLite* LazyField::Mutable(const MessageLite& prototype, Arena* arena) {
+  if (bytes_ != NULL) {
+    Get(prototype);
+    delete bytes_;
+    bytes_ = NULL;
+    once_ = GOOGLE_PROTOBUF_ONCE_INIT;
+  } else if (message_ == NULL) {
+    message_ = prototype.New(arena);
+  }
+  return message_;
+}
+
+void LazyField::Clear() {
+  if (message_ != NULL) {
+    message_->Clear();
+  }
+  if (bytes_ != NULL) {
+    bytes_->clear();
+    once_ = GOOGLE_PROTOBUF_ONCE_INIT;
+  }
+}
+
+bool LazyField::MergeFromCodedStream(io::CodedInputStream* input,
+                                     const MessageLite& prototype,
+                                     Arena* arena) {
+  if (arena != NULL || (bytes_ == NULL && message_ != NULL)) {
+    return WireFormatLite::ReadMessage(input, Mutable(prototype, arena));
+  }
+
+  uint32 length;
+  if (!input->ReadVarint32(&length)) return false;
+  if (bytes_ == NULL) {
+    bytes_ = new string;
+  }
+  once_ = GOOGLE_PROTOBUF_ONCE_INIT;
+  if (bytes_->empty()) {
+    return input->ReadString(bytes_, length);
+  }
+  // Concatenating two encoded messages merges them.
+  string more;
+  if (!input->ReadString(&more, length)) return false;
+  bytes_->append(more);
+  return true;
+}
+
+void LazyField::MergeFrom(const LazyField& from, const MessageLite& prototype,
+                          Arena* arena) {
+  if (arena == NULL && from.bytes_ != NULL &&
+      (bytes_ != NULL || message_ == NULL)) {
+    if (bytes_ == NULL) {
+      bytes_ = new string(*from.bytes_);
+    } else {
+      bytes_->append(*from.bytes_);
+    }
+    once_ = GOOGLE_PROTOBUF_ONCE_INIT;
+  } else {
+    Mutable(prototype, arena)->CheckTypeAndMergeFrom(from.Get(prototype));
+  }
+}
+
+int LazyField::MessageSize() const {
+  int size;
+  if (bytes_ != NULL) {
+    size = static_cast<int>(bytes_->size());
+  } else if (message_ != NULL) {
+    size = message_->ByteSize();
+  } else {
+    size = 0;
+  }
+  return WireFormatLite::LengthDelimitedSize(size);
+}
+
+void LazyField::WriteMessage(int field_number,
+                             io::CodedOutputStream* output) const {
+  if (bytes_ != NULL) {
+    WireFormatLite::WriteBytes(field_number, *bytes_, output);
+  } else if (message_ != NULL) {
+    WireFormatLite::WriteMessageMaybeToArray(field_number, *message_, output);
+  } else {
+    WireFormatLite::WriteTag(field_number,
+                             WireFormatLite::WIRETYPE_LENGTH_DELIMITED, output);
+    output->WriteVarint32(0);
+  }
+}
+
+uint8* LazyField::WriteMessageToArray(int field_number, uint8* target) const {
+  if (bytes_ != NULL) {
+    return WireFormatLite::WriteBytesToArray(field_number, *bytes_, target);
+  } else if (message_ != NULL) {
+    return WireFormatLite::WriteMessageToArray(field_number, *message_,
+                                               target);
+  } else {
+    target = WireFormatLite::WriteTagToArray(
+        field_number, WireFormatLite::WIRETYPE_LENGTH_DELIMITED, target);
+    return io::CodedOutputStream::WriteVarint32ToArray(0, target);
+  }
+}
+
+MessageLite* LazyField::Release(const MessageLite& prototype, Arena* arena) {
+  if (message_ == NULL && bytes_ == NULL) {
+    return NULL;
+  }
+  MessageLite* result = Mutable(prototype, arena);
+  message_ = NULL;
+  if (arena != NULL) {
+    // The arena still owns result; give the caller a heap copy.
+    MessageLite* copy = result->New();
+    copy->CheckTypeAndMergeFrom(*result);
+    result = copy;
+  }
+  return result;
+}
+
+void LazyField::SetAllocated(MessageLite* value, Arena* arena) {
+  if (arena == NULL) {
+    delete message_;
+    delete bytes_;
+  } else if (value != NULL) {
+    arena->Own(value);
+  }
+  message_ = value;
+  bytes_ = NULL;
+  once_ = GOOGLE_PROTOBUF_ONCE_INIT;
+}
+
+void LazyField::Swap(LazyField* other) {
+  std::swap(message_, other->message_);
+  std::swap(bytes_, other->bytes_);
+  std::swap(once_, other->once_);
+}
+
+}  // namespace internal
+}  // namespace protobuf
+}  // namespace google
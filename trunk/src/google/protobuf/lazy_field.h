@@ -0,0 +1,174 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// This file defines LazyField, the in-memory representation of singular
+// message fields declared with [lazy=true].  It is used by generated code and
+// should not be used directly by users.
+//
+// A LazyField parsed from the wire keeps the sub-message's encoded bytes
+// instead of parsing them.  The bytes are parsed the first time the
+// sub-message is accessed, and are kept alongside the parsed message until
+// the message is modified through a mutable accessor.  Until then, the field
+// serializes by copying the bytes, so a message which is parsed and
+// re-serialized without touching the field never parses it at all.
+//
+// Parsing on first access happens inside const accessors, so it is guarded by
+// a once-flag: as with any other field, const accessors may be called from
+// several threads at once.  An Arena may not be used from several threads at
+// once, so a LazyField whose message lives on an arena never keeps bytes: it
+// parses its sub-message eagerly.
+//
+// Since the bytes are not parsed until they are needed, a malformed
+// sub-message is not detected when the outer message is parsed.  Accessing
+// it yields whatever could be parsed, as ParsePartialFromString() would.
+// Required fields of a lazy sub-message are still checked by IsInitialized(),
+// which parses the sub-message to do so.
+
+#ifndef GOOGLE_PROTOBUF_LAZY_FIELD_H__
+#define GOOGLE_PROTOBUF_LAZY_FIELD_H__
+
+#include <string>
+
+#include <google/protobuf/stubs/common.h>
+#include <google/protobuf/stubs/once.h>
+
+namespace google {
+namespace protobuf {
+
+class Arena;        // arena.h
+class MessageLite;  // message_lite.h
+namespace io {
+  class CodedInputStream;   // coded_stream.h
+  class CodedOutputStream;  // coded_stream.h
+}
+
+namespace internal {
+
+// Generated message classes initialize and destroy their LazyFields
+// explicitly from SharedCtor() and SharedDtor(), like their other fields, so
+// this class has no constructor or destructor.  Methods taking a prototype
+// expect the default instance of the field's type.
+class LIBPROTOBUF_EXPORT LazyField {
+ public:
+  // Makes the field empty.
+  void Init() {
+    message_ = NULL;
+    bytes_ = NULL;
+    once_ = GOOGLE_PROTOBUF_ONCE_INIT;
+  }
+
+  // Initializes the field of a default instance, which refers to (but does
+  // not own) the default instance of the field's type.
+  void InitAsDefault(const MessageLite* prototype) {
+    Init();
+    message_ = const_cast<MessageLite*>(prototype);
+  }
+
+  // Deletes the field's message and bytes.  Not called for messages on an
+  // arena, which owns them instead, or for default instances.
+  void Destroy();
+
+  // Returns the field's message, parsing its bytes first if necessary, or
+  // prototype if the field is empty.
+  const MessageLite& Get(const MessageLite& prototype) const {
+    if (bytes_ != NULL) {
+      ParseArgs args = { this, &prototype };
+      GoogleOnceInit(&once_, &ParseBytes, &args);
+    }
+    if (message_ == NULL) return prototype;
+    return *message_;
+  }
+
+  // Returns the field's message for modification, allocating it on arena (or
+  // the heap, if arena is NULL) if the field is empty.  The field's bytes are
+  // parsed and discarded.
+  MessageLite* Mutable(const MessageLite& prototype, Arena* arena);
+
+  // Clears the field's message and bytes, keeping both for reuse.
+  void Clear();
+
+  // Reads a length-delimited sub-message and merges it into the field.  The
+  // bytes are stored unparsed unless arena is non-NULL or the field's message
+  // has been modified.
+  bool MergeFromCodedStream(io::CodedInputStream* input,
+                            const MessageLite& prototype, Arena* arena);
+
+  // Merges from's contents into the field.  Unparsed bytes are merged by
+  // concatenation when possible.
+  void MergeFrom(const LazyField& from, const MessageLite& prototype,
+                 Arena* arena);
+
+  // Returns the size of the field's sub-message on the wire, excluding the
+  // tag but including its length prefix, and caches the sizes of the
+  // sub-message's parts like MessageLite::ByteSize().
+  int MessageSize() const;
+
+  // Writes the field (tag, length and sub-message) using the sizes cached by
+  // MessageSize().
+  void WriteMessage(int field_number, io::CodedOutputStream* output) const;
+  uint8* WriteMessageToArray(int field_number, uint8* target) const;
+
+  // Returns NULL if the field is empty.  Otherwise empties the field and
+  // returns its message, which is heap-allocated and owned by the caller.
+  MessageLite* Release(const MessageLite& prototype, Arena* arena);
+
+  // Makes value (which must be heap-allocated, or NULL) the field's message,
+  // handing it to arena if that is not NULL.
+  void SetAllocated(MessageLite* value, Arena* arena);
+
+  // Both fields must belong to messages on the same arena, or both to heap
+  // messages.
+  void Swap(LazyField* other);
+
+  // For Reflection::SpaceUsed(): the field's message and encoded bytes, each
+  // NULL if the field has none.
+  const MessageLite* message() const { return message_; }
+  const string* bytes() const { return bytes_; }
+
+ private:
+  struct ParseArgs {
+    const LazyField* field;
+    const MessageLite* prototype;
+  };
+  static void ParseBytes(ParseArgs* args);
+
+  // The parsed message, or NULL.  Written by Get() under once_.
+  mutable MessageLite* message_;
+  // The sub-message's encoded bytes, or NULL.  When non-NULL these are the
+  // field's value, and message_ is a parsed copy of them once once_ is done.
+  string* bytes_;
+  // Guards parsing bytes_ into message_.  Reset whenever bytes_ changes.
+  mutable ProtobufOnceType once_;
+};
+
+}  // namespace internal
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_LAZY_FIELD_H__
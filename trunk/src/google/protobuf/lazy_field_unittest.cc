@@ -0,0 +1,296 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// Tests for message fields declared with [lazy=true], which are stored as a
+// LazyField and keep their encoded bytes until first accessed.
+
+#include <google/protobuf/lazy_field.h>
+
+#include <google/protobuf/arena.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/dynamic_message.h>
+#include <google/protobuf/unittest.pb.h>
+#include <google/protobuf/unittest_lite.pb.h>
+#include <google/protobuf/unittest_table_driven.pb.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
+#include <google/protobuf/stubs/common.h>
+#include <gtest/gtest.h>
+
+namespace google {
+namespace protobuf {
+namespace {
+
+using protobuf_unittest::TestAllTypes;
+using protobuf_unittest::TestLazyMessage;
+
+// An encoding of a TestAllTypes (or a TestAllTypes.NestedMessage) which
+// does not survive a parse/serialize round trip: field 1 appears twice, and
+// parsing keeps only the last value, 2.
+const char kNonCanonical[] = "\x08\x01\x08\x02";
+
+// Returns a length-delimited field with the given tag and payload.
+string LengthDelimited(const string& tag, const string& payload) {
+  return tag + string(1, static_cast<char>(payload.size())) + payload;
+}
+
+// Returns a TestLazyMessage whose sub_message has the given encoding.
+string LazyMessageWith(const string& sub_message) {
+  return LengthDelimited("\x0a", sub_message);
+}
+
+TEST(LazyFieldTest, ReserializesUntouchedBytes) {
+  string data = LazyMessageWith(kNonCanonical);
+  TestLazyMessage message;
+  ASSERT_TRUE(message.ParseFromString(data));
+  EXPECT_TRUE(message.has_sub_message());
+  EXPECT_EQ(static_cast<int>(data.size()), message.ByteSize());
+  EXPECT_EQ(data, message.SerializeAsString());
+
+  // The array and stream serializers agree.
+  string via_stream;
+  {
+    io::StringOutputStream output(&via_stream);
+    io::CodedOutputStream coded_output(&output);
+    message.SerializeWithCachedSizes(&coded_output);
+  }
+  EXPECT_EQ(data, via_stream);
+}
+
+TEST(LazyFieldTest, ParsesOnFirstAccess) {
+  string data = LazyMessageWith(kNonCanonical);
+  TestLazyMessage message;
+  ASSERT_TRUE(message.ParseFromString(data));
+  EXPECT_EQ(2, message.sub_message().optional_int32());
+  EXPECT_FALSE(message.sub_message().has_optional_int64());
+
+  // Reading the field does not modify it, so its bytes are still used.
+  EXPECT_EQ(data, message.SerializeAsString());
+}
+
+TEST(LazyFieldTest, MutableDiscardsBytes) {
+  TestLazyMessage message;
+  ASSERT_TRUE(message.ParseFromString(LazyMessageWith(kNonCanonical)));
+  message.mutable_sub_message()->set_optional_int64(3);
+
+  TestLazyMessage expected;
+  expected.mutable_sub_message()->set_optional_int32(2);
+  expected.mutable_sub_message()->set_optional_int64(3);
+  EXPECT_EQ(expected.SerializeAsString(), message.SerializeAsString());
+
+  // Once modified, the field parses eagerly.
+  string more = LazyMessageWith("\x18\x04");
+  io::CodedInputStream input(reinterpret_cast<const uint8*>(more.data()),
+                             more.size());
+  ASSERT_TRUE(message.MergeFromCodedStream(&input));
+  EXPECT_EQ(4, message.sub_message().optional_uint32());
+  EXPECT_EQ(2, message.sub_message().optional_int32());
+}
+
+TEST(LazyFieldTest, MergesRepeatedOccurrences) {
+  string data = LazyMessageWith("\x08\x01") + LazyMessageWith("\x10\x05");
+  TestLazyMessage message;
+  ASSERT_TRUE(message.ParseFromString(data));
+  EXPECT_EQ(1, message.sub_message().optional_int32());
+  EXPECT_EQ(5, message.sub_message().optional_int64());
+
+  // Both occurrences are kept unparsed, as one field.
+  EXPECT_EQ(LazyMessageWith("\x08\x01\x10\x05"), message.SerializeAsString());
+}
+
+TEST(LazyFieldTest, CopiesKeepBytes) {
+  string data = LazyMessageWith(kNonCanonical);
+  TestLazyMessage message;
+  ASSERT_TRUE(message.ParseFromString(data));
+
+  TestLazyMessage copy(message);
+  EXPECT_EQ(data, copy.SerializeAsString());
+  EXPECT_EQ(2, copy.sub_message().optional_int32());
+
+  TestLazyMessage merged;
+  merged.MergeFrom(message);
+  merged.MergeFrom(message);
+  EXPECT_EQ(LazyMessageWith(string(kNonCanonical) + kNonCanonical),
+            merged.SerializeAsString());
+
+  // Merging into a modified field parses the source.
+  TestLazyMessage modified;
+  modified.mutable_sub_message()->set_optional_int64(3);
+  modified.MergeFrom(message);
+  EXPECT_EQ(2, modified.sub_message().optional_int32());
+  EXPECT_EQ(3, modified.sub_message().optional_int64());
+}
+
+TEST(LazyFieldTest, ClearAndReuse) {
+  TestLazyMessage message;
+  ASSERT_TRUE(message.ParseFromString(LazyMessageWith(kNonCanonical)));
+  EXPECT_EQ(2, message.sub_message().optional_int32());
+
+  message.Clear();
+  EXPECT_FALSE(message.has_sub_message());
+  EXPECT_FALSE(message.sub_message().has_optional_int32());
+  EXPECT_EQ(0, message.ByteSize());
+
+  string data = LazyMessageWith("\x10\x05");
+  ASSERT_TRUE(message.ParseFromString(data));
+  EXPECT_EQ(data, message.SerializeAsString());
+  EXPECT_FALSE(message.sub_message().has_optional_int32());
+  EXPECT_EQ(5, message.sub_message().optional_int64());
+}
+
+TEST(LazyFieldTest, ReleaseAndSetAllocated) {
+  TestLazyMessage message;
+  EXPECT_TRUE(message.release_sub_message() == NULL);
+
+  ASSERT_TRUE(message.ParseFromString(LazyMessageWith(kNonCanonical)));
+  scoped_ptr<TestAllTypes> released(message.release_sub_message());
+  ASSERT_TRUE(released != NULL);
+  EXPECT_FALSE(message.has_sub_message());
+  EXPECT_EQ(2, released->optional_int32());
+  EXPECT_EQ(0, message.ByteSize());
+
+  message.set_allocated_sub_message(released.release());
+  EXPECT_TRUE(message.has_sub_message());
+  EXPECT_EQ(2, message.sub_message().optional_int32());
+  EXPECT_EQ(LazyMessageWith("\x08\x02"), message.SerializeAsString());
+
+  message.set_allocated_sub_message(NULL);
+  EXPECT_FALSE(message.has_sub_message());
+}
+
+TEST(LazyFieldTest, Swap) {
+  string data1 = LazyMessageWith(kNonCanonical);
+  string data2 = LazyMessageWith("\x10\x05");
+  TestLazyMessage message1;
+  TestLazyMessage message2;
+  ASSERT_TRUE(message1.ParseFromString(data1));
+  ASSERT_TRUE(message2.ParseFromString(data2));
+  EXPECT_EQ(2, message1.sub_message().optional_int32());
+
+  message1.Swap(&message2);
+  EXPECT_EQ(data2, message1.SerializeAsString());
+  EXPECT_EQ(data1, message2.SerializeAsString());
+  EXPECT_EQ(5, message1.sub_message().optional_int64());
+  EXPECT_EQ(2, message2.sub_message().optional_int32());
+}
+
+TEST(LazyFieldTest, Arena) {
+  // Messages on an arena parse lazy fields eagerly.
+  Arena arena;
+  TestLazyMessage* message = Arena::CreateMessage<TestLazyMessage>(&arena);
+  ASSERT_TRUE(message->ParseFromString(LazyMessageWith(kNonCanonical)));
+  EXPECT_EQ(2, message->sub_message().optional_int32());
+  EXPECT_EQ(LazyMessageWith("\x08\x02"), message->SerializeAsString());
+
+  TestLazyMessage heap_message;
+  ASSERT_TRUE(heap_message.ParseFromString(LazyMessageWith("\x10\x05")));
+  message->MergeFrom(heap_message);
+  EXPECT_EQ(5, message->sub_message().optional_int64());
+
+  scoped_ptr<TestAllTypes> released(message->release_sub_message());
+  EXPECT_EQ(2, released->optional_int32());
+  EXPECT_FALSE(message->has_sub_message());
+}
+
+TEST(LazyFieldTest, Reflection) {
+  string data = LazyMessageWith(kNonCanonical);
+  TestLazyMessage message;
+  ASSERT_TRUE(message.ParseFromString(data));
+  const Reflection* reflection = message.GetReflection();
+  const FieldDescriptor* field =
+      TestLazyMessage::descriptor()->FindFieldByName("sub_message");
+
+  EXPECT_TRUE(reflection->HasField(message, field));
+  int unparsed_space_used = message.SpaceUsed();
+  EXPECT_LT(static_cast<int>(sizeof(message)), unparsed_space_used);
+  const Message& sub_message = reflection->GetMessage(message, field);
+  EXPECT_EQ(&message.sub_message(), &sub_message);
+  EXPECT_EQ(2, message.sub_message().optional_int32());
+  EXPECT_LT(unparsed_space_used, message.SpaceUsed());
+  EXPECT_EQ(data, message.SerializeAsString());
+
+  down_cast<TestAllTypes*>(reflection->MutableMessage(&message, field))
+      ->set_optional_int64(3);
+  EXPECT_EQ(3, message.sub_message().optional_int64());
+
+  scoped_ptr<Message> released(reflection->ReleaseMessage(&message, field));
+  EXPECT_FALSE(reflection->HasField(message, field));
+  reflection->SetAllocatedMessage(&message, released.release(), field);
+  EXPECT_EQ(3, message.sub_message().optional_int64());
+
+  reflection->ClearField(&message, field);
+  EXPECT_FALSE(message.has_sub_message());
+  EXPECT_EQ(0, message.sub_message().optional_int64());
+}
+
+TEST(LazyFieldTest, DynamicMessage) {
+  DynamicMessageFactory factory;
+  scoped_ptr<Message> message(
+      factory.GetPrototype(TestLazyMessage::descriptor())->New());
+  ASSERT_TRUE(message->ParseFromString(LazyMessageWith(kNonCanonical)));
+
+  const Reflection* reflection = message->GetReflection();
+  const FieldDescriptor* field =
+      message->GetDescriptor()->FindFieldByName("sub_message");
+  const Message& sub_message = reflection->GetMessage(*message, field);
+  EXPECT_EQ(2, sub_message.GetReflection()->GetInt32(
+      sub_message, sub_message.GetDescriptor()->FindFieldByName(
+          "optional_int32")));
+  EXPECT_EQ(LazyMessageWith("\x08\x02"), message->SerializeAsString());
+
+  scoped_ptr<Message> copy(message->New());
+  copy->CopyFrom(*message);
+  EXPECT_EQ(message->SerializeAsString(), copy->SerializeAsString());
+  message->Clear();
+  EXPECT_FALSE(reflection->HasField(*message, field));
+}
+
+TEST(LazyFieldTest, Lite) {
+  // TestAllTypesLite.optional_lazy_message is field 27.
+  string data = LengthDelimited("\xda\x01", kNonCanonical);
+  protobuf_unittest::TestAllTypesLite message;
+  ASSERT_TRUE(message.ParseFromString(data));
+  EXPECT_EQ(data, message.SerializeAsString());
+  EXPECT_EQ(2, message.optional_lazy_message().bb());
+  EXPECT_EQ(data, message.SerializeAsString());
+}
+
+TEST(LazyFieldTest, TableDriven) {
+  // TestAllTypes.optional_lazy_message is field 27.
+  string data = LengthDelimited("\xda\x01", kNonCanonical);
+  protobuf_unittest_table_driven::TestAllTypes message;
+  ASSERT_TRUE(message.ParseFromString(data));
+  EXPECT_EQ(data, message.SerializeAsString());
+  EXPECT_EQ(2, message.optional_lazy_message().bb());
+}
+
+}  // namespace
+}  // namespace protobuf
+}  // namespace google
@@ -38,6 +38,7 @@
 
 #include <google/protobuf/message.h>
 
+#include <google/protobuf/arena.h>
 #include <google/protobuf/stubs/common.h>
 #include <google/protobuf/stubs/once.h>
 #include <google/protobuf/io/coded_stream.h>
@@ -46,6 +47,7 @@
 #include <google/protobuf/descriptor.h>
 #include <google/protobuf/generated_message_util.h>
 #include <google/protobuf/reflection_ops.h>
+#include <google/protobuf/repeated_field.h>
 #include <google/protobuf/wire_format.h>
 #include <google/protobuf/stubs/strutil.h>
 #include <google/protobuf/stubs/map_util.h>
@@ -59,6 +61,14 @@ using internal::ReflectionOps;
 
 Message::~Message() {}
 
+Message* Message::New(Arena* arena) const {
+  Message* message = New();
+  if (arena != NULL) {
+    arena->Own(message);
+  }
+  return message;
+}
+
 void Message::MergeFrom(const Message& from) {
   const Descriptor* descriptor = GetDescriptor();
   GOOGLE_CHECK_EQ(from.GetDescriptor(), descriptor)
@@ -353,6 +363,13 @@ void MessageFactory::InternalRegisterGeneratedMessage(
   GeneratedMessageFactory::singleton()->RegisterType(descriptor, prototype);
 }
 
+namespace internal {
+template <>
+Message* GenericTypeHandler<Message>::NewFromPrototype(
+    const Message* prototype, Arena* arena) {
+  return prototype->New(arena);
+}
+}  // namespace internal
 
 }  // namespace protobuf
 }  // namespace google
@@ -138,6 +138,10 @@ namespace io {
   class CodedInputStream;      // coded_stream.h
   class CodedOutputStream;     // coded_stream.h
 }
+namespace internal {
+  struct FieldLayout;          // field_accessor.h
+  class FieldAccessorBase;     // field_accessor.h
+}
 
 
 template<typename T>
@@ -174,6 +178,10 @@ class LIBPROTOBUF_EXPORT Message : public MessageLite {
   // for return-type covariance.)
   virtual Message* New() const = 0;
 
+  // Construct a new instance on the given arena.  (Also defined in
+  // MessageLite; redeclared here for return-type covariance.)
+  virtual Message* New(Arena* arena) const;
+
   // Make this message into a copy of the given message.  The given message
   // must have the same descriptor, but need not necessarily be the same class.
   // By default this is just implemented as "Clear(); MergeFrom(from);".
@@ -705,7 +713,18 @@ class LIBPROTOBUF_EXPORT Reflection {
       Message* message, const FieldDescriptor* field, FieldDescriptor::CppType,
       int ctype, const Descriptor* message_type) const = 0;
 
+  // Describes where the given field is stored in message objects, so that
+  // FieldAccessor (field_accessor.h) can read and write it directly.
+  // Returns false if the field's storage is not one FieldAccessor knows
+  // how to use, which is the default.
+  virtual bool GetFieldLayout(const FieldDescriptor* field,
+                              internal::FieldLayout* layout) const {
+    return false;
+  }
+
  private:
+  friend class internal::FieldAccessorBase;
+
   // Special version for specialized implementations of string.  We can't call
   // MutableRawRepeatedField directly here because we don't have access to
   // FieldOptions::* which are defined in descriptor.pb.h.  Including that
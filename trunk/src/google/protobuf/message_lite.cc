@@ -35,7 +35,9 @@
 
 #include <google/protobuf/message_lite.h>
 #include <string>
+#include <google/protobuf/arena.h>
 #include <google/protobuf/stubs/common.h>
+#include <google/protobuf/io/backward_output_buffer.h>
 #include <google/protobuf/io/coded_stream.h>
 #include <google/protobuf/io/zero_copy_stream_impl_lite.h>
 #include <google/protobuf/stubs/stl_util.h>
@@ -45,6 +47,14 @@ namespace protobuf {
 
 MessageLite::~MessageLite() {}
 
+MessageLite* MessageLite::New(Arena* arena) const {
+  MessageLite* message = New();
+  if (arena != NULL) {
+    arena->Own(message);
+  }
+  return message;
+}
+
 string MessageLite::InitializationErrorString() const {
   return "(cannot determine missing fields for lite message)";
 }
@@ -313,6 +323,28 @@ bool MessageLite::SerializePartialToArray(void* data, int size) const {
   return true;
 }
 
+bool MessageLite::SerializeToStringSinglePass(string* output) const {
+  GOOGLE_DCHECK(IsInitialized()) << InitializationErrorMessage("serialize", *this);
+  return SerializePartialToStringSinglePass(output);
+}
+
+bool MessageLite::SerializePartialToStringSinglePass(string* output) const {
+  io::BackwardOutputBuffer buffer;
+  SerializeBackward(&buffer);
+  output->assign(reinterpret_cast<const char*>(buffer.data()),
+                 buffer.ByteCount());
+  return true;
+}
+
+void MessageLite::SerializeBackward(io::BackwardOutputBuffer* buffer) const {
+  int byte_size = ByteSize();
+  uint8* start = buffer->Prepend(byte_size);
+  uint8* end = SerializeWithCachedSizesToArray(start);
+  if (end - start != byte_size) {
+    ByteSizeConsistencyError(byte_size, ByteSize(), end - start);
+  }
+}
+
 string MessageLite::SerializeAsString() const {
   // If the compiler implements the (Named) Return Value Optimization,
   // the local variable 'result' will not actually reside on the stack
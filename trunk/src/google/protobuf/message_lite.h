@@ -44,7 +44,10 @@
 namespace google {
 namespace protobuf {
 
+class Arena;
+
 namespace io {
+  class BackwardOutputBuffer;
   class CodedInputStream;
   class CodedOutputStream;
   class ZeroCopyInputStream;
@@ -88,6 +91,17 @@ class LIBPROTOBUF_EXPORT MessageLite {
   // caller.
   virtual MessageLite* New() const = 0;
 
+  // Construct a new instance of the same type on the given arena (see
+  // arena.h).  If arena is NULL, ownership is passed to the caller as with
+  // New().  Classes generated with arena support construct the whole object
+  // on the arena; the default implementation allocates on the heap and has
+  // the arena take ownership.
+  virtual MessageLite* New(Arena* arena) const;
+
+  // Returns the arena this message was constructed on, or NULL if it was
+  // allocated on the heap.  Messages on an arena must not be deleted.
+  virtual Arena* GetArena() const { return NULL; }
+
   // Clear all fields of the message and set them to their default values.
   // Clear() avoids freeing memory, assuming that any memory allocated
   // to hold parts of the message will be needed again to hold the next
@@ -208,6 +222,16 @@ class LIBPROTOBUF_EXPORT MessageLite {
   // Like AppendToString(), but allows missing required fields.
   bool AppendPartialToString(string* output) const;
 
+  // Like SerializeToString(), but encodes the message in a single pass from
+  // its last field to its first, so that the size of each sub-message is
+  // known once it has been written, rather than computing all the sizes
+  // with ByteSize() first.  This is faster for deep trees of small messages.
+  // The output is identical to that of SerializeToString().  Cached sizes
+  // are neither used nor updated.
+  bool SerializeToStringSinglePass(string* output) const;
+  // Like SerializeToStringSinglePass(), but allows missing required fields.
+  bool SerializePartialToStringSinglePass(string* output) const;
+
   // Computes the serialized size of the message.  This recursively calls
   // ByteSize() on all embedded messages.  If a subclass does not override
   // this, it MUST override SetCachedSize().
@@ -224,6 +248,12 @@ class LIBPROTOBUF_EXPORT MessageLite {
   // must point at a byte array of at least ByteSize() bytes.
   virtual uint8* SerializeWithCachedSizesToArray(uint8* target) const;
 
+  // Writes the message in front of the contents of *buffer, without using
+  // cached sizes.  Used by SerializeToStringSinglePass().  Generated code
+  // overrides this when optimizing for speed; the default implementation
+  // calls ByteSize() and SerializeWithCachedSizesToArray().
+  virtual void SerializeBackward(io::BackwardOutputBuffer* buffer) const;
+
   // Returns the result of the last call to ByteSize().  An embedded message's
   // size is needed both to serialize it (because embedded messages are
   // length-delimited) and to compute the outer message's size.  Caching
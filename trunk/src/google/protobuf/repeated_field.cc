@@ -42,21 +42,60 @@ namespace protobuf {
 
 namespace internal {
 
+bool ArrayStartsAt(const void* array, const void* address) {
+  return array == address;
+}
+
 void RepeatedPtrFieldBase::Reserve(int new_size) {
   if (total_size_ >= new_size) return;
 
   void** old_elements = elements_;
   total_size_ = max(kMinRepeatedFieldAllocationSize,
                     max(total_size_ * 2, new_size));
-  elements_ = new void*[total_size_];
+  elements_ = Arena::CreateArray<void*>(arena_, total_size_);
+  if (elements_ == inline_elements()) {
+    // The new array directly follows this object, so it would be taken for
+    // an inline array.  Allocate another one while still holding this one.
+    void** misplaced_elements = elements_;
+    elements_ = Arena::CreateArray<void*>(arena_, total_size_);
+    if (arena_ == NULL) {
+      delete [] misplaced_elements;
+    }
+  }
   if (old_elements != NULL) {
     memcpy(elements_, old_elements, allocated_size_ * sizeof(elements_[0]));
-    delete [] old_elements;
+    if (arena_ == NULL && old_elements != inline_elements()) {
+      delete [] old_elements;
+    }
   }
 }
 
 void RepeatedPtrFieldBase::Swap(RepeatedPtrFieldBase* other) {
   if (this == other) return;
+  if (elements_ == inline_elements() ||
+      elements_ == other->inline_elements() ||
+      other->elements_ == other->inline_elements() ||
+      other->elements_ == inline_elements()) {
+    // An inline array cannot change hands, so exchange the pointers it holds
+    // instead, including those to cleared objects.
+    int this_allocated_size = allocated_size_;
+    int other_allocated_size = other->allocated_size_;
+    Reserve(other_allocated_size);
+    other->Reserve(this_allocated_size);
+    int common_size = min(this_allocated_size, other_allocated_size);
+    std::swap_ranges(elements_, elements_ + common_size, other->elements_);
+    if (this_allocated_size < other_allocated_size) {
+      memcpy(elements_ + common_size, other->elements_ + common_size,
+             (other_allocated_size - common_size) * sizeof(elements_[0]));
+    } else {
+      memcpy(other->elements_ + common_size, elements_ + common_size,
+             (this_allocated_size - common_size) * sizeof(elements_[0]));
+    }
+    std::swap(current_size_, other->current_size_);
+    std::swap(allocated_size_, other->allocated_size_);
+    return;
+  }
+
   void** swap_elements       = elements_;
   int    swap_current_size   = current_size_;
   int    swap_allocated_size = allocated_size_;
@@ -76,6 +115,9 @@ void RepeatedPtrFieldBase::Swap(RepeatedPtrFieldBase* other) {
 string* StringTypeHandlerBase::New() {
   return new string;
 }
+string* StringTypeHandlerBase::New(Arena* arena) {
+  return Arena::Create<string>(arena);
+}
 void StringTypeHandlerBase::Delete(string* value) {
   delete value;
 }
@@ -55,6 +55,7 @@
 #include <iterator>
 #include <google/protobuf/stubs/common.h>
 #include <google/protobuf/stubs/type_traits.h>
+#include <google/protobuf/arena.h>
 #include <google/protobuf/generated_message_util.h>
 #include <google/protobuf/message_lite.h>
 
@@ -77,6 +78,11 @@ static const int kMinRepeatedFieldAllocationSize = 4;
 // A utility function for logging that doesn't need any template types.
 void LogIndexOutOfBounds(int index, int size);
 
+// Whether an array returned by new[] starts at the given address.  This is
+// not inline, so that compilers don't take an array deleted because it does
+// for one that is not on the heap.
+LIBPROTOBUF_EXPORT bool ArrayStartsAt(const void* array, const void* address);
+
 template <typename Iter>
 inline int CalculateReserve(Iter begin, Iter end, std::forward_iterator_tag) {
   return std::distance(begin, end);
@@ -194,6 +200,11 @@ class RepeatedField {
   // sizeof(*this)
   int SpaceUsedExcludingSelf() const;
 
+ protected:
+  // Used by InlinedRepeatedField:  starts out with the array of inline_size
+  // elements which directly follows this object.
+  explicit RepeatedField(int inline_size);
+
  private:
   static const int kInitialSize = 0;
 
@@ -201,6 +212,13 @@ class RepeatedField {
   int      current_size_;
   int      total_size_;
 
+  // Returns the address at which an InlinedRepeatedField keeps its inline
+  // array, right after the RepeatedField.  elements_ points there only while
+  // an InlinedRepeatedField is using its inline array:  Reserve() and Swap()
+  // never let an array from elsewhere end up at that address, so this can
+  // be told apart from an array which has to be deleted.
+  Element* inline_elements() const;
+
   // Move the contents of |from| into |to|, possibly clobbering |from| in the
   // process.  For primitive types this is just a memcpy(), but it could be
   // specialized for non-primitive types to, say, swap each element instead.
@@ -239,7 +257,8 @@ namespace internal {
 //   class TypeHandler {
 //    public:
 //     typedef MyType Type;
-//     static Type* New();
+//     static Type* New(Arena* arena);
+//     static Type* NewFromPrototype(const Type* prototype, Arena* arena);
 //     static void Delete(Type*);
 //     static void Clear(Type*);
 //     static void Merge(const Type& from, Type* to);
@@ -261,11 +280,19 @@ class LIBPROTOBUF_EXPORT RepeatedPtrFieldBase {
   // use of AddFromCleared(), which is not part of the public interface.
   friend class ExtensionSet;
 
+  // The table-driven parser adds elements to repeated message fields without
+  // knowing their type, like ExtensionSet.
+  friend class MergePartialFromCodedStreamHelper;
+
   // To parse directly into a proto2 generated class, the upb class GMR_Handlers
   // needs to be able to modify a RepeatedPtrFieldBase directly.
   friend class LIBPROTOBUF_EXPORT upb::google_opensource::GMR_Handlers;
 
   RepeatedPtrFieldBase();
+  explicit RepeatedPtrFieldBase(Arena* arena);
+  // Used by InlinedRepeatedPtrField:  starts out with the array of
+  // inline_size pointers which directly follows this object.
+  RepeatedPtrFieldBase(Arena* arena, int inline_size);
 
   // Must be called from destructor.
   template <typename TypeHandler>
@@ -310,7 +337,11 @@ class LIBPROTOBUF_EXPORT RepeatedPtrFieldBase {
   template <typename TypeHandler>
   const typename TypeHandler::Type* const* data() const;
 
+  // Swaps the pointer arrays.  Only valid if both fields are on the same
+  // arena; otherwise use SwapFallback(), which copies.
   void Swap(RepeatedPtrFieldBase* other);
+  template <typename TypeHandler>
+  void SwapFallback(RepeatedPtrFieldBase* other);
 
   void SwapElements(int index1, int index2);
 
@@ -326,6 +357,10 @@ class LIBPROTOBUF_EXPORT RepeatedPtrFieldBase {
 
   template <typename TypeHandler>
   void AddAllocated(typename TypeHandler::Type* value);
+  // Like AddAllocated(), but value must already be owned by this field's
+  // arena (or be heap-allocated if there is no arena).
+  template <typename TypeHandler>
+  void UnsafeArenaAddAllocated(typename TypeHandler::Type* value);
   template <typename TypeHandler>
   typename TypeHandler::Type* ReleaseLast();
 
@@ -335,6 +370,14 @@ class LIBPROTOBUF_EXPORT RepeatedPtrFieldBase {
   template <typename TypeHandler>
   typename TypeHandler::Type* ReleaseCleared();
 
+  // Returns a heap-allocated copy of value.  Used to hand arena-owned
+  // elements to callers which expect to take ownership.
+  template <typename TypeHandler>
+  static typename TypeHandler::Type* CopyToHeap(
+      const typename TypeHandler::Type* value);
+
+  inline Arena* GetArenaNoVirtual() const { return arena_; }
+
  private:
   static const int kInitialSize = 0;
 
@@ -342,6 +385,17 @@ class LIBPROTOBUF_EXPORT RepeatedPtrFieldBase {
   int    current_size_;
   int    allocated_size_;
   int    total_size_;
+  // If non-NULL, the pointer array and all elements are owned by this arena.
+  Arena* arena_;
+
+  // Returns the address at which an InlinedRepeatedPtrField keeps its inline
+  // pointer array, right after the RepeatedPtrFieldBase.  As with
+  // RepeatedField::inline_elements(), elements_ points there only while an
+  // InlinedRepeatedPtrField is using its inline array.
+  void** inline_elements() const {
+    return reinterpret_cast<void**>(
+        const_cast<RepeatedPtrFieldBase*>(this) + 1);
+  }
 
   template <typename TypeHandler>
   static inline typename TypeHandler::Type* cast(void* element) {
@@ -360,6 +414,13 @@ class GenericTypeHandler {
  public:
   typedef GenericType Type;
   static GenericType* New() { return new GenericType; }
+  static GenericType* New(Arena* arena) {
+    return Arena::CreateMaybeMessage<GenericType>(arena);
+  }
+  static GenericType* NewFromPrototype(const GenericType* prototype,
+                                       Arena* arena) {
+    return New(arena);
+  }
   static void Delete(GenericType* value) { delete value; }
   static void Clear(GenericType* value) { value->Clear(); }
   static void Merge(const GenericType& from, GenericType* to) {
@@ -369,6 +430,18 @@ class GenericTypeHandler {
   static const Type& default_instance() { return Type::default_instance(); }
 };
 
+// The abstract message types can only be instantiated through a prototype.
+template <>
+inline MessageLite* GenericTypeHandler<MessageLite>::NewFromPrototype(
+    const MessageLite* prototype, Arena* arena) {
+  return prototype->New(arena);
+}
+
+// Defined in message.cc, since Message is incomplete here.
+template <>
+LIBPROTOBUF_EXPORT Message* GenericTypeHandler<Message>::NewFromPrototype(
+    const Message* prototype, Arena* arena);
+
 template <>
 inline void GenericTypeHandler<MessageLite>::Merge(
     const MessageLite& from, MessageLite* to) {
@@ -406,6 +479,10 @@ class LIBPROTOBUF_EXPORT StringTypeHandlerBase {
  public:
   typedef string Type;
   static string* New();
+  static string* New(Arena* arena);
+  static string* NewFromPrototype(const string* prototype, Arena* arena) {
+    return New(arena);
+  }
   static void Delete(string* value);
   static void Clear(string* value) { value->clear(); }
   static void Merge(const string& from, string* to) { *to = from; }
@@ -430,6 +507,9 @@ template <typename Element>
 class RepeatedPtrField : public internal::RepeatedPtrFieldBase {
  public:
   RepeatedPtrField();
+  // Constructs a field whose pointer array and elements are allocated on
+  // the given arena.  Used by generated classes with arena support.
+  explicit RepeatedPtrField(Arena* arena);
   RepeatedPtrField(const RepeatedPtrField& other);
   template <typename Iter>
   RepeatedPtrField(Iter begin, const Iter& end);
@@ -469,12 +549,16 @@ class RepeatedPtrField : public internal::RepeatedPtrFieldBase {
   Element** mutable_data();
   const Element* const* data() const;
 
-  // Swap entire contents with "other".
+  // Swap entire contents with "other".  If the two fields are on different
+  // arenas, the contents are copied instead.
   void Swap(RepeatedPtrField* other);
 
   // Swap two elements.
   void SwapElements(int index1, int index2);
 
+  // Returns the arena the elements are allocated on, or NULL.
+  Arena* GetArena() const { return GetArenaNoVirtual(); }
+
   // STL-like iterator support
   typedef internal::RepeatedPtrIterator<Element> iterator;
   typedef internal::RepeatedPtrIterator<const Element> const_iterator;
@@ -527,15 +611,18 @@ class RepeatedPtrField : public internal::RepeatedPtrFieldBase {
   // does here at Google -- the following methods may be useful.
 
   // Add an already-allocated object, passing ownership to the
-  // RepeatedPtrField.
+  // RepeatedPtrField.  If the field is on an arena, the arena takes
+  // ownership, so value must have been allocated on the heap.
   void AddAllocated(Element* value);
   // Remove the last element and return it, passing ownership to the caller.
+  // If the field is on an arena, a heap-allocated copy is returned instead.
   // Requires:  size() > 0
   Element* ReleaseLast();
 
   // Extract elements with indices in the range "[start .. start+num-1]".
   // The caller assumes ownership of the extracted elements and is responsible
-  // for deleting them when they are no longer needed.
+  // for deleting them when they are no longer needed.  If the field is on an
+  // arena, the caller receives heap-allocated copies.
   // If "elements" is non-NULL, then pointers to the extracted elements
   // are stored in "elements[0 .. num-1]" for the convenience of the caller.
   // If "elements" is NULL, then the caller must use some other mechanism
@@ -571,6 +658,55 @@ class RepeatedPtrField : public internal::RepeatedPtrFieldBase {
   //   methods on RepeatedPtrFieldBase.
   class TypeHandler;
 
+  // Used by InlinedRepeatedPtrField.
+  RepeatedPtrField(Arena* arena, int inline_size);
+};
+
+// InlinedRepeatedField and InlinedRepeatedPtrField keep room for the first N
+// elements inside the object, so that they only allocate once they grow
+// beyond N.  Generated classes use them for repeated fields declared with
+// [inline_capacity = N], which suits fields that usually hold a few
+// elements.  An InlinedRepeatedPtrField only keeps the element pointers
+// inline; the elements themselves are allocated as usual.
+//
+// Both can be used wherever a RepeatedField or RepeatedPtrField can,
+// including through reflection.  Swapping with a field whose elements are
+// inline exchanges the elements (or pointers) one by one, rather than the
+// arrays.
+template <typename Element, int N>
+class InlinedRepeatedField : public RepeatedField<Element> {
+ public:
+  InlinedRepeatedField();
+  InlinedRepeatedField(const InlinedRepeatedField& other);
+  ~InlinedRepeatedField() {}
+
+  InlinedRepeatedField& operator=(const InlinedRepeatedField& other);
+
+ private:
+  // Must directly follow the RepeatedField; see
+  // RepeatedField::inline_elements().
+  Element inline_elements_[N];
+
+  GOOGLE_COMPILE_ASSERT(N > 0, inline_capacity_must_be_positive);
+};
+
+template <typename Element, int N>
+class InlinedRepeatedPtrField : public RepeatedPtrField<Element> {
+ public:
+  InlinedRepeatedPtrField();
+  // Constructs a field whose elements are allocated on the given arena.
+  explicit InlinedRepeatedPtrField(Arena* arena);
+  InlinedRepeatedPtrField(const InlinedRepeatedPtrField& other);
+  ~InlinedRepeatedPtrField() {}
+
+  InlinedRepeatedPtrField& operator=(const InlinedRepeatedPtrField& other);
+
+ private:
+  // Must directly follow the RepeatedPtrFieldBase; see
+  // RepeatedPtrFieldBase::inline_elements().
+  void* inline_elements_[N];
+
+  GOOGLE_COMPILE_ASSERT(N > 0, inline_capacity_must_be_positive);
 };
 
 // implementation ====================================================
@@ -609,9 +745,16 @@ inline RepeatedField<Element>::RepeatedField(Iter begin, const Iter& end)
   }
 }
 
+template <typename Element>
+inline RepeatedField<Element>::RepeatedField(int inline_size)
+  : elements_(inline_elements()),
+    current_size_(0),
+    total_size_(inline_size) {
+}
+
 template <typename Element>
 RepeatedField<Element>::~RepeatedField() {
-  delete [] elements_;
+  if (elements_ != inline_elements()) delete [] elements_;
 }
 
 template <typename Element>
@@ -755,6 +898,29 @@ inline const Element* RepeatedField<Element>::data() const {
 template <typename Element>
 void RepeatedField<Element>::Swap(RepeatedField* other) {
   if (this == other) return;
+  if (elements_ == inline_elements() ||
+      elements_ == other->inline_elements() ||
+      other->elements_ == other->inline_elements() ||
+      other->elements_ == inline_elements()) {
+    // An inline array cannot change hands, so exchange the elements instead.
+    int this_size = current_size_;
+    int other_size = other->current_size_;
+    Reserve(other_size);
+    other->Reserve(this_size);
+    int common_size = min(this_size, other_size);
+    std::swap_ranges(elements_, elements_ + common_size, other->elements_);
+    if (this_size < other_size) {
+      CopyArray(elements_ + common_size, other->elements_ + common_size,
+                other_size - common_size);
+    } else {
+      CopyArray(other->elements_ + common_size, elements_ + common_size,
+                this_size - common_size);
+    }
+    current_size_ = other_size;
+    other->current_size_ = this_size;
+    return;
+  }
+
   Element* swap_elements     = elements_;
   int      swap_current_size = current_size_;
   int      swap_total_size   = total_size_;
@@ -797,7 +963,8 @@ RepeatedField<Element>::end() const {
 
 template <typename Element>
 inline int RepeatedField<Element>::SpaceUsedExcludingSelf() const {
-  return (elements_ != NULL) ? total_size_ * sizeof(elements_[0]) : 0;
+  return (elements_ != NULL && elements_ != inline_elements()) ?
+      total_size_ * sizeof(elements_[0]) : 0;
 }
 
 // Avoid inlining of Reserve(): new, copy, and delete[] lead to a significant
@@ -810,9 +977,16 @@ void RepeatedField<Element>::Reserve(int new_size) {
   total_size_ = max(google::protobuf::internal::kMinRepeatedFieldAllocationSize,
                     max(total_size_ * 2, new_size));
   elements_ = new Element[total_size_];
+  if (internal::ArrayStartsAt(elements_, inline_elements())) {
+    // The new array directly follows this object, so it would be taken for
+    // an inline array.  Allocate another one while still holding this one.
+    Element* misplaced_elements = elements_;
+    elements_ = new Element[total_size_];
+    delete [] misplaced_elements;
+  }
   if (old_elements != NULL) {
     MoveArray(elements_, old_elements, current_size_);
-    delete [] old_elements;
+    if (old_elements != inline_elements()) delete [] old_elements;
   }
 }
 
@@ -822,6 +996,18 @@ inline void RepeatedField<Element>::Truncate(int new_size) {
   current_size_ = new_size;
 }
 
+template <typename Element>
+inline Element* RepeatedField<Element>::inline_elements() const {
+  // InlinedRepeatedField's array starts at the first offset past the
+  // RepeatedField that is suitably aligned for Element.
+  struct Aligner { char c; Element e; };
+  const size_t alignment = sizeof(Aligner) - sizeof(Element);
+  const size_t offset =
+      (sizeof(RepeatedField) + alignment - 1) / alignment * alignment;
+  return reinterpret_cast<Element*>(
+      reinterpret_cast<char*>(const_cast<RepeatedField*>(this)) + offset);
+}
+
 template <typename Element>
 inline void RepeatedField<Element>::MoveArray(
     Element to[], Element from[], int array_size) {
@@ -860,15 +1046,35 @@ inline RepeatedPtrFieldBase::RepeatedPtrFieldBase()
   : elements_(NULL),
     current_size_(0),
     allocated_size_(0),
-    total_size_(kInitialSize) {
+    total_size_(kInitialSize),
+    arena_(NULL) {
+}
+
+inline RepeatedPtrFieldBase::RepeatedPtrFieldBase(Arena* arena)
+  : elements_(NULL),
+    current_size_(0),
+    allocated_size_(0),
+    total_size_(kInitialSize),
+    arena_(arena) {
+}
+
+inline RepeatedPtrFieldBase::RepeatedPtrFieldBase(Arena* arena,
+                                                  int inline_size)
+  : elements_(inline_elements()),
+    current_size_(0),
+    allocated_size_(0),
+    total_size_(inline_size),
+    arena_(arena) {
 }
 
 template <typename TypeHandler>
 void RepeatedPtrFieldBase::Destroy() {
+  // Everything is freed along with the arena.
+  if (arena_ != NULL) return;
   for (int i = 0; i < allocated_size_; i++) {
     TypeHandler::Delete(cast<TypeHandler>(elements_[i]));
   }
-  delete [] elements_;
+  if (elements_ != inline_elements()) delete [] elements_;
 }
 
 inline bool RepeatedPtrFieldBase::empty() const {
@@ -902,7 +1108,7 @@ inline typename TypeHandler::Type* RepeatedPtrFieldBase::Add() {
     return cast<TypeHandler>(elements_[current_size_++]);
   }
   if (allocated_size_ == total_size_) Reserve(total_size_ + 1);
-  typename TypeHandler::Type* result = TypeHandler::New();
+  typename TypeHandler::Type* result = TypeHandler::New(arena_);
   ++allocated_size_;
   elements_[current_size_++] = result;
   return result;
@@ -973,7 +1179,8 @@ inline void RepeatedPtrFieldBase::SwapElements(int index1, int index2) {
 template <typename TypeHandler>
 inline int RepeatedPtrFieldBase::SpaceUsedExcludingSelf() const {
   int allocated_bytes =
-      (elements_ != NULL) ? total_size_ * sizeof(elements_[0]) : 0;
+      (elements_ != NULL && elements_ != inline_elements()) ?
+      total_size_ * sizeof(elements_[0]) : 0;
   for (int i = 0; i < allocated_size_; ++i) {
     allocated_bytes += TypeHandler::SpaceUsed(*cast<TypeHandler>(elements_[i]));
   }
@@ -990,7 +1197,14 @@ inline typename TypeHandler::Type* RepeatedPtrFieldBase::AddFromCleared() {
 }
 
 template <typename TypeHandler>
-void RepeatedPtrFieldBase::AddAllocated(
+inline void RepeatedPtrFieldBase::AddAllocated(
+    typename TypeHandler::Type* value) {
+  if (arena_ != NULL) arena_->Own(value);
+  UnsafeArenaAddAllocated<TypeHandler>(value);
+}
+
+template <typename TypeHandler>
+void RepeatedPtrFieldBase::UnsafeArenaAddAllocated(
     typename TypeHandler::Type* value) {
   // Make room for the new pointer.
   if (current_size_ == total_size_) {
@@ -1001,8 +1215,10 @@ void RepeatedPtrFieldBase::AddAllocated(
     // There is no more space in the pointer array because it contains some
     // cleared objects awaiting reuse.  We don't want to grow the array in this
     // case because otherwise a loop calling AddAllocated() followed by Clear()
-    // would leak memory.
-    TypeHandler::Delete(cast<TypeHandler>(elements_[current_size_]));
+    // would leak memory.  (Objects on an arena are simply abandoned.)
+    if (arena_ == NULL) {
+      TypeHandler::Delete(cast<TypeHandler>(elements_[current_size_]));
+    }
   } else if (current_size_ < allocated_size_) {
     // We have some cleared objects.  We don't care about their order, so we
     // can just move the first one to the end to make space.
@@ -1027,6 +1243,9 @@ inline typename TypeHandler::Type* RepeatedPtrFieldBase::ReleaseLast() {
     // with the last allocated element.
     elements_[current_size_] = elements_[allocated_size_];
   }
+  if (arena_ != NULL) {
+    return CopyToHeap<TypeHandler>(result);
+  }
   return result;
 }
 
@@ -1038,13 +1257,43 @@ template <typename TypeHandler>
 inline void RepeatedPtrFieldBase::AddCleared(
     typename TypeHandler::Type* value) {
   if (allocated_size_ == total_size_) Reserve(total_size_ + 1);
+  if (arena_ != NULL) arena_->Own(value);
   elements_[allocated_size_++] = value;
 }
 
 template <typename TypeHandler>
 inline typename TypeHandler::Type* RepeatedPtrFieldBase::ReleaseCleared() {
   GOOGLE_DCHECK_GT(allocated_size_, current_size_);
-  return cast<TypeHandler>(elements_[--allocated_size_]);
+  typename TypeHandler::Type* result =
+      cast<TypeHandler>(elements_[--allocated_size_]);
+  if (arena_ != NULL) {
+    // The caller wants an object it can delete; the cleared one stays with
+    // the arena.
+    return TypeHandler::NewFromPrototype(result, NULL);
+  }
+  return result;
+}
+
+template <typename TypeHandler>
+inline typename TypeHandler::Type* RepeatedPtrFieldBase::CopyToHeap(
+    const typename TypeHandler::Type* value) {
+  typename TypeHandler::Type* result =
+      TypeHandler::NewFromPrototype(value, NULL);
+  TypeHandler::Merge(*value, result);
+  return result;
+}
+
+template <typename TypeHandler>
+void RepeatedPtrFieldBase::SwapFallback(RepeatedPtrFieldBase* other) {
+  // The two fields own their elements through different arenas, so the
+  // element pointers cannot be exchanged.  Copy instead, building other's new
+  // contents on other's arena.
+  RepeatedPtrFieldBase temp(other->arena_);
+  temp.MergeFrom<TypeHandler>(*this);
+  this->Clear<TypeHandler>();
+  this->MergeFrom<TypeHandler>(*other);
+  other->Swap(&temp);
+  temp.Destroy<TypeHandler>();
 }
 
 }  // namespace internal
@@ -1065,6 +1314,15 @@ class RepeatedPtrField<string>::TypeHandler
 template <typename Element>
 inline RepeatedPtrField<Element>::RepeatedPtrField() {}
 
+template <typename Element>
+inline RepeatedPtrField<Element>::RepeatedPtrField(Arena* arena)
+    : RepeatedPtrFieldBase(arena) {}
+
+template <typename Element>
+inline RepeatedPtrField<Element>::RepeatedPtrField(Arena* arena,
+                                                   int inline_size)
+    : RepeatedPtrFieldBase(arena, inline_size) {}
+
 template <typename Element>
 inline RepeatedPtrField<Element>::RepeatedPtrField(
     const RepeatedPtrField& other)
@@ -1134,8 +1392,10 @@ inline void RepeatedPtrField<Element>::DeleteSubrange(int start, int num) {
   GOOGLE_DCHECK_GE(start, 0);
   GOOGLE_DCHECK_GE(num, 0);
   GOOGLE_DCHECK_LE(start + num, size());
-  for (int i = 0; i < num; ++i)
-    delete RepeatedPtrFieldBase::Mutable<TypeHandler>(start + i);
+  if (GetArenaNoVirtual() == NULL) {
+    for (int i = 0; i < num; ++i)
+      delete RepeatedPtrFieldBase::Mutable<TypeHandler>(start + i);
+  }
   ExtractSubrange(start, num, NULL);
 }
 
@@ -1149,8 +1409,14 @@ inline void RepeatedPtrField<Element>::ExtractSubrange(
   if (num > 0) {
     // Save the values of the removed elements if requested.
     if (elements != NULL) {
-      for (int i = 0; i < num; ++i)
-        elements[i] = RepeatedPtrFieldBase::Mutable<TypeHandler>(i + start);
+      if (GetArenaNoVirtual() != NULL) {
+        for (int i = 0; i < num; ++i)
+          elements[i] = CopyToHeap<TypeHandler>(
+              RepeatedPtrFieldBase::Mutable<TypeHandler>(i + start));
+      } else {
+        for (int i = 0; i < num; ++i)
+          elements[i] = RepeatedPtrFieldBase::Mutable<TypeHandler>(i + start);
+      }
     }
     CloseGap(start, num);
   }
@@ -1185,7 +1451,11 @@ inline const Element* const* RepeatedPtrField<Element>::data() const {
 
 template <typename Element>
 void RepeatedPtrField<Element>::Swap(RepeatedPtrField* other) {
-  RepeatedPtrFieldBase::Swap(other);
+  if (GetArenaNoVirtual() == other->GetArenaNoVirtual()) {
+    RepeatedPtrFieldBase::Swap(other);
+  } else {
+    RepeatedPtrFieldBase::SwapFallback<TypeHandler>(other);
+  }
 }
 
 template <typename Element>
@@ -1467,6 +1737,58 @@ RepeatedPtrField<Element>::pointer_end() const {
       const_cast<const void**>(raw_mutable_data() + size()));
 }
 
+// -------------------------------------------------------------------
+
+template <typename Element, int N>
+inline InlinedRepeatedField<Element, N>::InlinedRepeatedField()
+    : RepeatedField<Element>(N) {
+  GOOGLE_DCHECK(this->data() == inline_elements_);
+}
+
+template <typename Element, int N>
+inline InlinedRepeatedField<Element, N>::InlinedRepeatedField(
+    const InlinedRepeatedField& other)
+    : RepeatedField<Element>(N) {
+  this->CopyFrom(other);
+}
+
+template <typename Element, int N>
+inline InlinedRepeatedField<Element, N>&
+InlinedRepeatedField<Element, N>::operator=(const InlinedRepeatedField& other) {
+  // Not the implicit operator=, which would also copy inline_elements_.
+  this->CopyFrom(other);
+  return *this;
+}
+
+template <typename Element, int N>
+inline InlinedRepeatedPtrField<Element, N>::InlinedRepeatedPtrField()
+    : RepeatedPtrField<Element>(static_cast<Arena*>(NULL), N) {
+  GOOGLE_DCHECK(this->raw_data() == inline_elements_);
+}
+
+template <typename Element, int N>
+inline InlinedRepeatedPtrField<Element, N>::InlinedRepeatedPtrField(
+    Arena* arena)
+    : RepeatedPtrField<Element>(arena, N) {
+  GOOGLE_DCHECK(this->raw_data() == inline_elements_);
+}
+
+template <typename Element, int N>
+inline InlinedRepeatedPtrField<Element, N>::InlinedRepeatedPtrField(
+    const InlinedRepeatedPtrField& other)
+    : RepeatedPtrField<Element>(static_cast<Arena*>(NULL), N) {
+  this->CopyFrom(other);
+}
+
+template <typename Element, int N>
+inline InlinedRepeatedPtrField<Element, N>&
+InlinedRepeatedPtrField<Element, N>::operator=(
+    const InlinedRepeatedPtrField& other) {
+  // Not the implicit operator=, which would also copy inline_elements_.
+  this->CopyFrom(other);
+  return *this;
+}
+
 
 // Iterators and helper functions that follow the spirit of the STL
 // std::back_insert_iterator and std::back_inserter but are tailor-made
@@ -901,6 +901,167 @@ TEST(RepeatedPtrField, DeleteSubrange) {
 
 // ===================================================================
 
+// Returns true if data points into the object field.
+template <typename Field>
+bool IsInside(const void* data, const Field& field) {
+  const char* begin = reinterpret_cast<const char*>(&field);
+  return begin <= data && data < begin + sizeof(field);
+}
+
+TEST(InlinedRepeatedField, Small) {
+  InlinedRepeatedField<int, 3> field;
+  EXPECT_EQ(3, field.Capacity());
+  EXPECT_TRUE(IsInside(field.data(), field));
+
+  field.Add(5);
+  field.Add(42);
+  field.Add(7);
+  EXPECT_TRUE(IsInside(field.data(), field));
+  EXPECT_EQ(0, field.SpaceUsedExcludingSelf());
+
+  field.Add(9);
+  EXPECT_FALSE(IsInside(field.data(), field));
+  EXPECT_GT(field.SpaceUsedExcludingSelf(), 0);
+  ASSERT_EQ(4, field.size());
+  EXPECT_EQ(5, field.Get(0));
+  EXPECT_EQ(42, field.Get(1));
+  EXPECT_EQ(7, field.Get(2));
+  EXPECT_EQ(9, field.Get(3));
+}
+
+TEST(InlinedRepeatedField, Reserve) {
+  InlinedRepeatedField<double, 4> field;
+  field.Add(1.5);
+  field.Reserve(4);
+  EXPECT_TRUE(IsInside(field.data(), field));
+  field.Reserve(5);
+  EXPECT_FALSE(IsInside(field.data(), field));
+  EXPECT_LE(5, field.Capacity());
+  ASSERT_EQ(1, field.size());
+  EXPECT_EQ(1.5, field.Get(0));
+}
+
+TEST(InlinedRepeatedField, SwapInlineInline) {
+  InlinedRepeatedField<int, 4> field1;
+  InlinedRepeatedField<int, 2> field2;
+  field1.Add(1);
+  field1.Add(2);
+  field1.Add(3);
+  field2.Add(4);
+
+  field1.Swap(&field2);
+  ASSERT_EQ(1, field1.size());
+  EXPECT_EQ(4, field1.Get(0));
+  EXPECT_TRUE(IsInside(field1.data(), field1));
+  ASSERT_EQ(3, field2.size());
+  EXPECT_EQ(1, field2.Get(0));
+  EXPECT_EQ(2, field2.Get(1));
+  EXPECT_EQ(3, field2.Get(2));
+  EXPECT_FALSE(IsInside(field2.data(), field2));
+}
+
+TEST(InlinedRepeatedField, SwapWithRepeatedField) {
+  InlinedRepeatedField<int, 4> field1;
+  RepeatedField<int> field2;
+  field1.Add(5);
+  for (int i = 0; i < 16; i++) {
+    field2.Add(i * i);
+  }
+
+  // Swapping through the base class works the same way.
+  RepeatedField<int>* base1 = &field1;
+  field2.Swap(base1);
+  ASSERT_EQ(16, field1.size());
+  for (int i = 0; i < 16; i++) {
+    EXPECT_EQ(i * i, field1.Get(i));
+  }
+  ASSERT_EQ(1, field2.size());
+  EXPECT_EQ(5, field2.Get(0));
+
+  // Now neither is inline, so the arrays are exchanged.
+  const int* data1 = field1.data();
+  const int* data2 = field2.data();
+  base1->Swap(&field2);
+  EXPECT_EQ(data2, field1.data());
+  EXPECT_EQ(data1, field2.data());
+  ASSERT_EQ(1, field1.size());
+  EXPECT_EQ(5, field1.Get(0));
+  EXPECT_EQ(16, field2.size());
+}
+
+TEST(InlinedRepeatedField, CopyConstructAndAssign) {
+  InlinedRepeatedField<int, 2> source;
+  source.Add(1);
+  source.Add(2);
+
+  InlinedRepeatedField<int, 2> copy(source);
+  EXPECT_TRUE(IsInside(copy.data(), copy));
+  ASSERT_EQ(2, copy.size());
+  EXPECT_EQ(1, copy.Get(0));
+  EXPECT_EQ(2, copy.Get(1));
+
+  InlinedRepeatedField<int, 2> destination;
+  destination.Add(3);
+  destination = source;
+  EXPECT_TRUE(IsInside(destination.data(), destination));
+  ASSERT_EQ(2, destination.size());
+  EXPECT_EQ(1, destination.Get(0));
+  EXPECT_EQ(2, destination.Get(1));
+}
+
+TEST(InlinedRepeatedPtrField, Small) {
+  InlinedRepeatedPtrField<string, 2> field;
+  EXPECT_EQ(2, field.Capacity());
+  field.Add()->assign("foo");
+  field.Add()->assign("bar");
+  EXPECT_TRUE(IsInside(field.data(), field));
+
+  field.Add()->assign("baz");
+  EXPECT_FALSE(IsInside(field.data(), field));
+  ASSERT_EQ(3, field.size());
+  EXPECT_EQ("foo", field.Get(0));
+  EXPECT_EQ("bar", field.Get(1));
+  EXPECT_EQ("baz", field.Get(2));
+}
+
+TEST(InlinedRepeatedPtrField, SwapKeepsClearedElements) {
+  InlinedRepeatedPtrField<string, 4> field1;
+  RepeatedPtrField<string> field2;
+  field1.Add()->assign("foo");
+  string* bar = field1.Add();
+  bar->assign("bar");
+  field1.RemoveLast();  // Keeps bar as a cleared element.
+  for (int i = 0; i < 8; i++) {
+    field2.Add()->assign(SimpleItoa(i));
+  }
+
+  field1.Swap(&field2);
+  ASSERT_EQ(8, field1.size());
+  for (int i = 0; i < 8; i++) {
+    EXPECT_EQ(SimpleItoa(i), field1.Get(i));
+  }
+  ASSERT_EQ(1, field2.size());
+  EXPECT_EQ("foo", field2.Get(0));
+  EXPECT_EQ(1, field2.ClearedCount());
+  EXPECT_EQ(bar, field2.ReleaseCleared());
+  delete bar;
+}
+
+TEST(InlinedRepeatedPtrField, Arena) {
+  Arena arena;
+  InlinedRepeatedPtrField<string, 2> field(&arena);
+  for (int i = 0; i < 5; i++) {
+    field.Add()->assign(SimpleItoa(i));
+  }
+  EXPECT_FALSE(IsInside(field.data(), field));
+  ASSERT_EQ(5, field.size());
+  for (int i = 0; i < 5; i++) {
+    EXPECT_EQ(SimpleItoa(i), field.Get(i));
+  }
+}
+
+// ===================================================================
+
 // Iterator tests stolen from net/proto/proto-array_unittest.
 class RepeatedFieldIteratorTest : public testing::Test {
  protected:
@@ -0,0 +1,88 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <google/protobuf/string_piece_field.h>
+
+#include <google/protobuf/arena.h>
+
+namespace google {
+namespace protobuf {
+namespace internal {
+
+void StringPieceField::Set(const char* data, int size, Arena* arena) {
+  if (storage_ == NULL) {
+    storage_ = Arena::Create<string>(arena);
+  }
+  storage_->assign(data, size);
+  data_ = NULL;
+}
+
+string* StringPieceField::Mutable(Arena* arena) {
+  if (data_ != NULL) {
+    Set(data_, size_, arena);
+  }
+  return storage_;
+}
+
+string* StringPieceField::Release(const string& default_value, Arena* arena) {
+  if (data_ == default_value.data()) {
+    return NULL;
+  }
+  string* result;
+  if (data_ == NULL && arena == NULL) {
+    // Hand over our storage.
+    result = storage_;
+    storage_ = NULL;
+  } else {
+    // The arena owns our storage, or we don't own the value at all.
+    result = new string(Get().data(), Get().size());
+  }
+  ClearToDefault(default_value);
+  return result;
+}
+
+void StringPieceField::SetAllocated(string* value, const string& default_value,
+                                    Arena* arena) {
+  if (value == NULL) {
+    ClearToDefault(default_value);
+    return;
+  }
+  if (arena == NULL) {
+    delete storage_;
+  } else {
+    arena->Own(value);
+  }
+  storage_ = value;
+  data_ = NULL;
+}
+
+}  // namespace internal
+}  // namespace protobuf
+}  // namespace google
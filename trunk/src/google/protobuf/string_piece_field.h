@@ -0,0 +1,145 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// This file defines StringPieceField, the in-memory representation of
+// singular string and bytes fields declared with [ctype=STRING_PIECE].  It is
+// used by generated code and should not be used directly by users.
+//
+// Unlike an ordinary string field, a StringPiece field can refer to bytes it
+// does not own.  This happens in two ways:
+//
+// * Parsing from a CodedInputStream which reads from a flat array and has
+//   aliasing enabled (see CodedInputStream::EnableAliasing()) points the field
+//   into that array instead of copying its value.
+// * The generated set_alias_<field>() accessor points the field at a buffer
+//   supplied by the caller.
+//
+// The aliased bytes must remain valid and unmodified for as long as the field
+// refers to them.  The field stops referring to them -- it is "detached" --
+// when any other setter is called: set_<field>(), mutable_<field>(),
+// set_allocated_<field>(), clear_<field>() or Clear().  mutable_<field>() is
+// the way to detach a field while keeping its value: it copies the value into
+// storage owned by the message (or its arena).  MergeFrom() and CopyFrom()
+// always copy, so the destination of a copy never aliases.  Swap() exchanges
+// aliases along with the rest of the two messages' contents.
+
+#ifndef GOOGLE_PROTOBUF_STRING_PIECE_FIELD_H__
+#define GOOGLE_PROTOBUF_STRING_PIECE_FIELD_H__
+
+#include <algorithm>
+#include <string>
+
+#include <google/protobuf/stubs/common.h>
+#include <google/protobuf/stubs/stringpiece.h>
+
+namespace google {
+namespace protobuf {
+
+class Arena;  // arena.h
+
+namespace internal {
+
+// Generated message classes initialize and destroy their StringPieceFields
+// explicitly from SharedCtor() and SharedDtor(), like their other fields, so
+// this class has no constructor or destructor.
+class LIBPROTOBUF_EXPORT StringPieceField {
+ public:
+  // Points the field at default_value, which must outlive it.
+  void Init(const string& default_value) {
+    data_ = default_value.data();
+    size_ = static_cast<int>(default_value.size());
+    storage_ = NULL;
+  }
+
+  // Deletes the field's storage.  Not called for messages on an arena, which
+  // owns the storage instead.
+  void Destroy() { delete storage_; }
+
+  StringPiece Get() const {
+    return data_ != NULL ? StringPiece(data_, size_) : StringPiece(*storage_);
+  }
+
+  // Returns the string holding the field's value, or NULL if the field
+  // refers to bytes it does not own.
+  const string* GetOwned() const { return data_ != NULL ? NULL : storage_; }
+
+  // Copies the given bytes into the field's storage, allocating it on arena
+  // (or the heap, if arena is NULL) when the field has none yet.
+  void Set(const char* data, int size, Arena* arena);
+
+  // Points the field at the given bytes without copying them.  Any storage
+  // the field already owns is kept for reuse.
+  void SetAliased(const char* data, int size) {
+    data_ = data != NULL ? data : "";
+    size_ = size;
+  }
+
+  // Detaches the field (copying an aliased or default value into its
+  // storage) and returns its storage.
+  string* Mutable(Arena* arena);
+
+  // Points the field back at its default value.  Any storage the field owns
+  // is kept for reuse.
+  void ClearToDefault(const string& default_value) {
+    SetAliased(default_value.data(), static_cast<int>(default_value.size()));
+  }
+
+  // Returns NULL if the field is at its default value.  Otherwise resets the
+  // field to its default and returns its previous value as a heap-allocated
+  // string owned by the caller.
+  string* Release(const string& default_value, Arena* arena);
+
+  // Makes value (which must be heap-allocated) the field's storage, handing
+  // it to arena if that is not NULL.  If value is NULL, resets the field to
+  // its default value.
+  void SetAllocated(string* value, const string& default_value, Arena* arena);
+
+  // Both fields must belong to messages on the same arena, or both to heap
+  // messages.
+  void Swap(StringPieceField* other) {
+    std::swap(data_, other->data_);
+    std::swap(size_, other->size_);
+    std::swap(storage_, other->storage_);
+  }
+
+ private:
+  // Bytes the field refers to but does not own: its default value or an
+  // alias.  NULL if the field's value is *storage_.
+  const char* data_;
+  int size_;
+  // Storage owned by the field (or by its message's arena), or NULL.
+  string* storage_;
+};
+
+}  // namespace internal
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_STRING_PIECE_FIELD_H__
@@ -0,0 +1,305 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Tests for string fields declared with [ctype=STRING_PIECE], which are
+// stored as a StringPieceField and can alias the buffer they are parsed from.
+
+#include <google/protobuf/string_piece_field.h>
+
+#include <google/protobuf/arena.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/dynamic_message.h>
+#include <google/protobuf/unittest.pb.h>
+#include <google/protobuf/unittest_lite.pb.h>
+#include <google/protobuf/test_util.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
+#include <google/protobuf/stubs/common.h>
+#include <gtest/gtest.h>
+
+namespace google {
+namespace protobuf {
+namespace {
+
+using unittest::TestAllTypes;
+
+// Returns true if piece points somewhere inside buffer.
+bool PointsInto(StringPiece piece, const string& buffer) {
+  return piece.data() >= buffer.data() &&
+         piece.data() + piece.size() <= buffer.data() + buffer.size();
+}
+
+// Parses data into message through a flat-array CodedInputStream with
+// aliasing enabled.
+bool ParseAliased(const string& data, MessageLite* message) {
+  io::CodedInputStream input(reinterpret_cast<const uint8*>(data.data()),
+                             data.size());
+  input.EnableAliasing(true);
+  return message->ParseFromCodedStream(&input) &&
+         input.ConsumedEntireMessage();
+}
+
+string SerializedWithStringPiece(const string& value) {
+  TestAllTypes message;
+  message.set_optional_string_piece(value);
+  message.set_optional_int32(1);
+  return message.SerializeAsString();
+}
+
+TEST(StringPieceFieldTest, Accessors) {
+  TestAllTypes message;
+  EXPECT_FALSE(message.has_optional_string_piece());
+  EXPECT_EQ("", message.optional_string_piece());
+  EXPECT_EQ("abc", message.default_string_piece());
+
+  message.set_optional_string_piece("foo");
+  EXPECT_TRUE(message.has_optional_string_piece());
+  EXPECT_EQ("foo", message.optional_string_piece());
+
+  message.set_optional_string_piece(string("bar"));
+  EXPECT_EQ("bar", message.optional_string_piece());
+
+  message.set_optional_string_piece("bazqux", 3);
+  EXPECT_EQ("baz", message.optional_string_piece());
+
+  message.mutable_optional_string_piece()->append("!");
+  EXPECT_EQ("baz!", message.optional_string_piece());
+
+  message.mutable_default_string_piece()->append("def");
+  EXPECT_EQ("abcdef", message.default_string_piece());
+  EXPECT_EQ("abc", TestAllTypes::default_instance().default_string_piece());
+
+  message.Clear();
+  EXPECT_FALSE(message.has_optional_string_piece());
+  EXPECT_EQ("", message.optional_string_piece());
+  EXPECT_FALSE(message.has_default_string_piece());
+  EXPECT_EQ("abc", message.default_string_piece());
+}
+
+TEST(StringPieceFieldTest, ReleaseAndSetAllocated) {
+  TestAllTypes message;
+  EXPECT_TRUE(message.release_optional_string_piece() == NULL);
+
+  message.set_optional_string_piece("foo");
+  scoped_ptr<string> released(message.release_optional_string_piece());
+  ASSERT_TRUE(released != NULL);
+  EXPECT_EQ("foo", *released);
+  EXPECT_FALSE(message.has_optional_string_piece());
+  EXPECT_EQ("", message.optional_string_piece());
+
+  message.set_allocated_optional_string_piece(released.release());
+  EXPECT_TRUE(message.has_optional_string_piece());
+  EXPECT_EQ("foo", message.optional_string_piece());
+
+  message.set_allocated_optional_string_piece(NULL);
+  EXPECT_FALSE(message.has_optional_string_piece());
+  EXPECT_EQ("", message.optional_string_piece());
+}
+
+TEST(StringPieceFieldTest, ParseCopiesByDefault) {
+  string data = SerializedWithStringPiece("hello world");
+
+  TestAllTypes message;
+  ASSERT_TRUE(message.ParseFromString(data));
+  EXPECT_EQ("hello world", message.optional_string_piece());
+  EXPECT_FALSE(PointsInto(message.optional_string_piece(), data));
+
+  io::CodedInputStream input(reinterpret_cast<const uint8*>(data.data()),
+                             data.size());
+  ASSERT_TRUE(message.ParseFromCodedStream(&input));
+  EXPECT_FALSE(PointsInto(message.optional_string_piece(), data));
+}
+
+TEST(StringPieceFieldTest, ParseAliasesFlatArray) {
+  string data = SerializedWithStringPiece("hello world");
+
+  TestAllTypes message;
+  ASSERT_TRUE(ParseAliased(data, &message));
+  EXPECT_EQ("hello world", message.optional_string_piece());
+  EXPECT_TRUE(PointsInto(message.optional_string_piece(), data));
+  EXPECT_EQ(1, message.optional_int32());
+
+  // Serializing an aliased field writes the aliased bytes.
+  EXPECT_EQ(data, message.SerializeAsString());
+  EXPECT_EQ(data.size(), message.ByteSize());
+
+  // Ordinary string fields are still copied.
+  TestAllTypes other;
+  other.set_optional_string("copied");
+  string other_data = other.SerializeAsString();
+  ASSERT_TRUE(ParseAliased(other_data, &other));
+  EXPECT_FALSE(PointsInto(other.optional_string(), other_data));
+}
+
+TEST(StringPieceFieldTest, ZeroCopyInputStreamIsNotAliased) {
+  string data = SerializedWithStringPiece("hello world");
+
+  io::ArrayInputStream raw_input(data.data(), data.size());
+  io::CodedInputStream input(&raw_input);
+  input.EnableAliasing(true);
+  TestAllTypes message;
+  ASSERT_TRUE(message.ParseFromCodedStream(&input));
+  EXPECT_EQ("hello world", message.optional_string_piece());
+  EXPECT_FALSE(PointsInto(message.optional_string_piece(), data));
+}
+
+TEST(StringPieceFieldTest, Detach) {
+  string data = SerializedWithStringPiece("hello world");
+
+  TestAllTypes message;
+  ASSERT_TRUE(ParseAliased(data, &message));
+  ASSERT_TRUE(PointsInto(message.optional_string_piece(), data));
+
+  // mutable_*() copies the value out of the buffer, which can then go away.
+  message.mutable_optional_string_piece();
+  EXPECT_FALSE(PointsInto(message.optional_string_piece(), data));
+  data.assign(data.size(), 'x');
+  EXPECT_EQ("hello world", message.optional_string_piece());
+}
+
+TEST(StringPieceFieldTest, CopiesDoNotAlias) {
+  string data = SerializedWithStringPiece("hello world");
+
+  TestAllTypes message;
+  ASSERT_TRUE(ParseAliased(data, &message));
+
+  TestAllTypes copy(message);
+  EXPECT_EQ("hello world", copy.optional_string_piece());
+  EXPECT_FALSE(PointsInto(copy.optional_string_piece(), data));
+
+  TestAllTypes merged;
+  merged.MergeFrom(message);
+  EXPECT_FALSE(PointsInto(merged.optional_string_piece(), data));
+
+  // Swapping moves the alias along.
+  TestAllTypes swapped;
+  swapped.Swap(&message);
+  EXPECT_TRUE(PointsInto(swapped.optional_string_piece(), data));
+  EXPECT_FALSE(message.has_optional_string_piece());
+}
+
+TEST(StringPieceFieldTest, SetAlias) {
+  string buffer = "some bytes";
+  TestAllTypes message;
+  message.set_alias_optional_string_piece(buffer.data(), 4);
+  EXPECT_TRUE(message.has_optional_string_piece());
+  EXPECT_EQ("some", message.optional_string_piece());
+  EXPECT_EQ(buffer.data(), message.optional_string_piece().data());
+
+  // Setting a new value stops aliasing.
+  message.set_optional_string_piece("other");
+  buffer[0] = 'S';
+  EXPECT_EQ("other", message.optional_string_piece());
+}
+
+TEST(StringPieceFieldTest, Arena) {
+  string data = SerializedWithStringPiece("hello world");
+
+  Arena arena;
+  TestAllTypes* message = Arena::CreateMessage<TestAllTypes>(&arena);
+  ASSERT_TRUE(ParseAliased(data, message));
+  EXPECT_TRUE(PointsInto(message->optional_string_piece(), data));
+
+  message->mutable_optional_string_piece()->append("!");
+  EXPECT_EQ("hello world!", message->optional_string_piece());
+
+  scoped_ptr<string> released(message->release_optional_string_piece());
+  EXPECT_EQ("hello world!", *released);
+}
+
+TEST(StringPieceFieldTest, Reflection) {
+  string data = SerializedWithStringPiece("hello world");
+
+  TestAllTypes message;
+  ASSERT_TRUE(ParseAliased(data, &message));
+  const Reflection* reflection = message.GetReflection();
+  const FieldDescriptor* field =
+      message.GetDescriptor()->FindFieldByName("optional_string_piece");
+
+  string scratch;
+  EXPECT_TRUE(reflection->HasField(message, field));
+  EXPECT_EQ("hello world", reflection->GetString(message, field));
+  EXPECT_EQ("hello world",
+            reflection->GetStringReference(message, field, &scratch));
+  EXPECT_LT(message.SpaceUsed(), TestAllTypes(message).SpaceUsed());
+
+  reflection->SetString(&message, field, "set");
+  EXPECT_EQ("set", message.optional_string_piece());
+  EXPECT_FALSE(PointsInto(message.optional_string_piece(), data));
+
+  reflection->ClearField(&message, field);
+  EXPECT_FALSE(message.has_optional_string_piece());
+  EXPECT_EQ("", message.optional_string_piece());
+
+  // STRING_PIECE fields in a oneof keep the ordinary string representation.
+  unittest::TestOneof2 oneof;
+  const FieldDescriptor* oneof_field =
+      oneof.GetDescriptor()->FindFieldByName("foo_string_piece");
+  oneof.GetReflection()->SetString(&oneof, oneof_field, "in oneof");
+  EXPECT_EQ("in oneof",
+            oneof.GetReflection()->GetString(oneof, oneof_field));
+}
+
+TEST(StringPieceFieldTest, DynamicMessage) {
+  DynamicMessageFactory factory;
+  scoped_ptr<Message> message(
+      factory.GetPrototype(TestAllTypes::descriptor())->New());
+  const Reflection* reflection = message->GetReflection();
+  const Descriptor* descriptor = message->GetDescriptor();
+
+  EXPECT_EQ("abc", reflection->GetString(
+      *message, descriptor->FindFieldByName("default_string_piece")));
+
+  TestUtil::ReflectionTester tester(descriptor);
+  tester.SetAllFieldsViaReflection(message.get());
+  tester.ExpectAllFieldsSetViaReflection(*message);
+
+  TestAllTypes generated;
+  ASSERT_TRUE(generated.ParseFromString(message->SerializeAsString()));
+  TestUtil::ExpectAllFieldsSet(generated);
+}
+
+TEST(StringPieceFieldTest, Lite) {
+  unittest::TestAllTypesLite message;
+  message.set_optional_string_piece("lite");
+  message.set_optional_int32(1);
+  string data = message.SerializeAsString();
+
+  unittest::TestAllTypesLite parsed;
+  ASSERT_TRUE(ParseAliased(data, &parsed));
+  EXPECT_EQ("lite", parsed.optional_string_piece());
+  EXPECT_TRUE(PointsInto(parsed.optional_string_piece(), data));
+  EXPECT_EQ(data, parsed.SerializeAsString());
+}
+
+}  // namespace
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,129 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <google/protobuf/stubs/parallel.h>
+
+#include <algorithm>
+
+#include "config.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN  // We only need minimal includes
+#include <windows.h>
+#elif defined(HAVE_PTHREAD)
+#include <pthread.h>
+#endif
+
+namespace google {
+namespace protobuf {
+namespace internal {
+
+namespace {
+
+// The closures, and the index of the next one to start.  Every thread,
+// including the caller's, loops taking the next closure until none are left.
+class TaskList {
+ public:
+  explicit TaskList(const vector<Closure*>& closures)
+      : closures_(closures), next_(0) {}
+
+  void RunAll() {
+    while (true) {
+      Closure* closure;
+      {
+        MutexLock lock(&mutex_);
+        if (next_ == closures_.size()) return;
+        closure = closures_[next_++];
+      }
+      closure->Run();
+    }
+  }
+
+ private:
+  const vector<Closure*>& closures_;
+  Mutex mutex_;
+  int next_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(TaskList);
+};
+
+#ifdef _WIN32
+DWORD WINAPI StartThread(LPVOID arg) {
+  reinterpret_cast<TaskList*>(arg)->RunAll();
+  return 0;
+}
+#elif defined(HAVE_PTHREAD)
+void* StartThread(void* arg) {
+  reinterpret_cast<TaskList*>(arg)->RunAll();
+  return NULL;
+}
+#endif
+
+}  // namespace
+
+void RunInParallel(const vector<Closure*>& closures, int num_threads) {
+  TaskList tasks(closures);
+
+  // There is no point in starting more threads than there are closures.
+  int extra_threads = min<int>(num_threads, closures.size()) - 1;
+
+#if defined(_WIN32)
+  vector<HANDLE> threads;
+  for (int i = 0; i < extra_threads; i++) {
+    HANDLE thread = CreateThread(NULL, 0, &StartThread, &tasks, 0, NULL);
+    // If we can't start a thread, the ones we have will do its share.
+    if (thread == NULL) break;
+    threads.push_back(thread);
+  }
+  tasks.RunAll();
+  for (int i = 0; i < threads.size(); i++) {
+    WaitForSingleObject(threads[i], INFINITE);
+    CloseHandle(threads[i]);
+  }
+#elif defined(HAVE_PTHREAD)
+  vector<pthread_t> threads;
+  for (int i = 0; i < extra_threads; i++) {
+    pthread_t thread;
+    // If we can't start a thread, the ones we have will do its share.
+    if (pthread_create(&thread, NULL, &StartThread, &tasks) != 0) break;
+    threads.push_back(thread);
+  }
+  tasks.RunAll();
+  for (int i = 0; i < threads.size(); i++) {
+    pthread_join(threads[i], NULL);
+  }
+#else
+  tasks.RunAll();
+#endif
+}
+
+}  // namespace internal
+}  // namespace protobuf
+}  // namespace google
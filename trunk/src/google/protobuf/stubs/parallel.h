@@ -0,0 +1,66 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// This header is intended to be included only by internal .cc files.  Users
+// should not use this directly.
+//
+// RunInParallel() runs a batch of independent tasks on a few short-lived
+// threads and returns once all of them have finished.  It is meant for
+// coarse-grained work -- whole files, large blocks of data -- where starting
+// a thread costs little next to the task itself.
+
+#ifndef GOOGLE_PROTOBUF_STUBS_PARALLEL_H__
+#define GOOGLE_PROTOBUF_STUBS_PARALLEL_H__
+
+#include <vector>
+
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+namespace internal {
+
+// Runs each of the given closures exactly once, on up to num_threads threads
+// (the calling thread counts as one of them), and returns when all of them
+// have run.  Closures are started in the order given, but may finish in any
+// order, so they must not depend on each other.  Each closure is run with
+// Run(); use NewCallback() for closures that should delete themselves
+// afterwards.
+//
+// If num_threads is 1 or less, or threads are not available on this platform,
+// the closures are simply run in order on the calling thread.
+LIBPROTOBUF_EXPORT void RunInParallel(const vector<Closure*>& closures,
+                                      int num_threads);
+
+}  // namespace internal
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_STUBS_PARALLEL_H__
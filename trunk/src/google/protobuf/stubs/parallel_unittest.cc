@@ -0,0 +1,110 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <google/protobuf/stubs/parallel.h>
+
+#include <google/protobuf/stubs/common.h>
+#include <google/protobuf/stubs/stl_util.h>
+#include <google/protobuf/testing/googletest.h>
+#include <gtest/gtest.h>
+
+namespace google {
+namespace protobuf {
+namespace internal {
+namespace {
+
+class RunInParallelTest : public testing::Test {
+ protected:
+  // Appends i to order_ and counts how often it ran.
+  void Record(int i) {
+    MutexLock lock(&mutex_);
+    order_.push_back(i);
+    ++runs_[i];
+  }
+
+  // Returns closures which each record their own index.
+  vector<Closure*> MakeClosures(int count, bool permanent) {
+    runs_.assign(count, 0);
+    order_.clear();
+    vector<Closure*> closures;
+    for (int i = 0; i < count; i++) {
+      closures.push_back(
+          permanent ? NewPermanentCallback(this, &RunInParallelTest::Record, i)
+                    : NewCallback(this, &RunInParallelTest::Record, i));
+    }
+    return closures;
+  }
+
+  Mutex mutex_;
+  vector<int> order_;
+  vector<int> runs_;
+};
+
+TEST_F(RunInParallelTest, RunsEachClosureOnce) {
+  for (int threads = 1; threads <= 8; threads *= 2) {
+    SCOPED_TRACE(threads);
+    RunInParallel(MakeClosures(100, false), threads);
+    EXPECT_EQ(100, order_.size());
+    for (int i = 0; i < runs_.size(); i++) {
+      EXPECT_EQ(1, runs_[i]) << i;
+    }
+  }
+}
+
+TEST_F(RunInParallelTest, OneThreadRunsInOrder) {
+  RunInParallel(MakeClosures(10, false), 1);
+  ASSERT_EQ(10, order_.size());
+  for (int i = 0; i < order_.size(); i++) {
+    EXPECT_EQ(i, order_[i]);
+  }
+}
+
+TEST_F(RunInParallelTest, MoreThreadsThanClosures) {
+  RunInParallel(MakeClosures(3, false), 16);
+  EXPECT_EQ(3, order_.size());
+
+  RunInParallel(MakeClosures(0, false), 16);
+  EXPECT_EQ(0, order_.size());
+}
+
+TEST_F(RunInParallelTest, PermanentClosuresAreNotDeleted) {
+  vector<Closure*> closures = MakeClosures(10, true);
+  RunInParallel(closures, 4);
+  RunInParallel(closures, 4);
+  for (int i = 0; i < runs_.size(); i++) {
+    EXPECT_EQ(2, runs_[i]) << i;
+  }
+  STLDeleteElements(&closures);
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,165 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// A hash map which can be read without locking while a single writer, which
+// holds a lock of its own, adds to it.  DynamicMessageFactory and
+// DescriptorPool use it so that looking up something they have already
+// built never blocks.
+
+#ifndef GOOGLE_PROTOBUF_STUBS_PUBLISHED_MAP_H__
+#define GOOGLE_PROTOBUF_STUBS_PUBLISHED_MAP_H__
+
+#include <functional>
+#include <vector>
+
+#include <google/protobuf/stubs/common.h>
+#include <google/protobuf/stubs/atomicops.h>
+#include <google/protobuf/stubs/stl_util.h>
+
+namespace google {
+namespace protobuf {
+namespace internal {
+
+// Key must be a pointer type, and NULL is not a valid key.  HashFcn and
+// EqualKey are function objects over keys, like the ones hash_map takes.
+// Values are copied into the map and must be default-constructible.
+//
+// The map is an open-addressed hash table with linear probing.  The only
+// change ever made to a table is filling an empty slot, and a slot's key is
+// stored (with release semantics) after its value, so a reader which sees
+// the key also sees the value.  When a table becomes half full, a copy
+// twice its size replaces it.  Readers may still be probing the old table,
+// so every table is kept until the map is destroyed; this at most doubles
+// the memory used.
+template <typename Key, typename Value, typename HashFcn,
+          typename EqualKey = std::equal_to<Key> >
+class PublishedMap {
+ public:
+  PublishedMap() {
+    tables_.push_back(new Table(kInitialCapacity));
+    table_ = reinterpret_cast<Word>(tables_.back());
+  }
+  ~PublishedMap() {
+    STLDeleteElements(&tables_);
+  }
+
+  // Returns the value inserted for key, or NULL if there is none.  May be
+  // called concurrently with Insert() and does not lock.
+  const Value* Find(const Key& key) const {
+    const Table* table = reinterpret_cast<const Table*>(Load(&table_));
+    for (int i = Bucket(key, table->capacity); ;
+         i = (i + 1) & (table->capacity - 1)) {
+      Word slot_key = Load(&table->keys[i]);
+      if (slot_key == 0) {
+        return NULL;
+      } else if (equal_(reinterpret_cast<Key>(slot_key), key)) {
+        return &table->values[i];
+      }
+    }
+  }
+
+  // Adds key, which must not already be present.  Calls to Insert() must be
+  // serialized by the caller.
+  void Insert(const Key& key, const Value& value) {
+    Table* table = tables_.back();
+    if ((table->size + 1) * 2 > table->capacity) {
+      Table* bigger = new Table(table->capacity * 2);
+      for (int i = 0; i < table->capacity; i++) {
+        if (table->keys[i] != 0) {
+          InsertInto(bigger, reinterpret_cast<Key>(table->keys[i]),
+                     table->values[i]);
+        }
+      }
+      tables_.push_back(bigger);
+      Store(&table_, reinterpret_cast<Word>(bigger));
+      table = bigger;
+    }
+    InsertInto(table, key, value);
+  }
+
+ private:
+#ifdef GOOGLE_PROTOBUF_NO_THREAD_SAFETY
+  typedef intptr_t Word;
+  static Word Load(const Word* ptr) { return *ptr; }
+  static void Store(Word* ptr, Word value) { *ptr = value; }
+#else
+  typedef AtomicWord Word;
+  static Word Load(const Word* ptr) { return Acquire_Load(ptr); }
+  static void Store(Word* ptr, Word value) { Release_Store(ptr, value); }
+#endif
+
+  static const int kInitialCapacity = 16;
+
+  struct Table {
+    explicit Table(int capacity_arg)
+      : capacity(capacity_arg), size(0),
+        keys(new Word[capacity_arg]()),
+        values(new Value[capacity_arg]) {}
+    ~Table() {
+      delete [] keys;
+      delete [] values;
+    }
+
+    int capacity;  // A power of two.
+    int size;
+    Word* keys;    // Key, or 0 if the slot is empty.
+    Value* values;
+  };
+
+  int Bucket(const Key& key, int capacity) const {
+    // The hash of a pointer is often the pointer itself, whose low bits are
+    // always zero, so mix the high bits in.
+    size_t hash = hasher_(key);
+    hash ^= (hash >> 3) ^ (hash >> 11) ^ (hash >> 19);
+    return static_cast<int>(hash & (capacity - 1));
+  }
+
+  void InsertInto(Table* table, const Key& key, const Value& value) {
+    int i = Bucket(key, table->capacity);
+    while (table->keys[i] != 0) {
+      i = (i + 1) & (table->capacity - 1);
+    }
+    table->values[i] = value;
+    Store(&table->keys[i], reinterpret_cast<Word>(key));
+    ++table->size;
+  }
+
+  HashFcn hasher_;
+  EqualKey equal_;
+  Word table_;            // The current Table*.
+  vector<Table*> tables_;  // Every table ever used.  The last is current.
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(PublishedMap);
+};
+
+}  // namespace internal
+}  // namespace protobuf
+}  // namespace google
+
+#endif  // GOOGLE_PROTOBUF_STUBS_PUBLISHED_MAP_H__
@@ -0,0 +1,123 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// A StringPiece points to part or all of a string, or to a range of bytes
+// owned by someone else.  It is what generated accessors return for string
+// fields declared with [ctype=STRING_PIECE]; see string_piece_field.h.
+//
+// A StringPiece does not own the bytes it points to, so it is only valid as
+// long as they are.  Use ToString() to make a copy which outlives them.
+
+#ifndef GOOGLE_PROTOBUF_STUBS_STRINGPIECE_H__
+#define GOOGLE_PROTOBUF_STUBS_STRINGPIECE_H__
+
+#include <string.h>
+#include <ostream>
+#include <string>
+
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+
+class StringPiece {
+ public:
+  typedef const char* const_iterator;
+
+  StringPiece() : ptr_(NULL), length_(0) {}
+  StringPiece(const char* str)  // NOLINT(runtime/explicit)
+      : ptr_(str), length_(str == NULL ? 0 : static_cast<int>(strlen(str))) {}
+  StringPiece(const string& str)  // NOLINT(runtime/explicit)
+      : ptr_(str.data()), length_(static_cast<int>(str.size())) {}
+  StringPiece(const char* data, int length) : ptr_(data), length_(length) {}
+
+  // data() may return a pointer to a buffer with embedded NULs, and the
+  // returned buffer may or may not be null terminated.
+  const char* data() const { return ptr_; }
+  int size() const { return length_; }
+  int length() const { return length_; }
+  bool empty() const { return length_ == 0; }
+
+  char operator[](int i) const { return ptr_[i]; }
+
+  const_iterator begin() const { return ptr_; }
+  const_iterator end() const { return ptr_ + length_; }
+
+  string ToString() const {
+    return ptr_ == NULL ? string() : string(ptr_, length_);
+  }
+  void CopyToString(string* target) const {
+    target->assign(ptr_ == NULL ? "" : ptr_, length_);
+  }
+
+  // Returns <0, 0 or >0 like memcmp(), ordering bytes as unsigned chars.
+  int compare(const StringPiece& x) const {
+    int min_length = length_ < x.length_ ? length_ : x.length_;
+    if (min_length > 0) {
+      int r = memcmp(ptr_, x.ptr_, min_length);
+      if (r != 0) return r;
+    }
+    return length_ < x.length_ ? -1 : (length_ > x.length_ ? 1 : 0);
+  }
+
+ private:
+  const char* ptr_;
+  int length_;
+};
+
+inline bool operator==(const StringPiece& x, const StringPiece& y) {
+  return x.size() == y.size() &&
+         (x.size() == 0 || memcmp(x.data(), y.data(), x.size()) == 0);
+}
+inline bool operator!=(const StringPiece& x, const StringPiece& y) {
+  return !(x == y);
+}
+inline bool operator<(const StringPiece& x, const StringPiece& y) {
+  return x.compare(y) < 0;
+}
+inline bool operator>(const StringPiece& x, const StringPiece& y) {
+  return y < x;
+}
+inline bool operator<=(const StringPiece& x, const StringPiece& y) {
+  return !(y < x);
+}
+inline bool operator>=(const StringPiece& x, const StringPiece& y) {
+  return !(x < y);
+}
+
+// Allows StringPieces to be used with gtest's EXPECT_EQ() and with logging.
+inline ::std::ostream& operator<<(::std::ostream& o, const StringPiece& piece) {
+  o.write(piece.data(), piece.size());
+  return o;
+}
+
+}  // namespace protobuf
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_STUBS_STRINGPIECE_H__
@@ -51,7 +51,9 @@
 #include <google/protobuf/descriptor.pb.h>
 #include <google/protobuf/io/tokenizer.h>
 #include <google/protobuf/stubs/strutil.h>
+#include <google/protobuf/stubs/hash.h>
 #include <google/protobuf/stubs/map_util.h>
+#include <google/protobuf/stubs/once.h>
 #include <google/protobuf/stubs/stl_util.h>
 
 namespace google {
@@ -69,6 +71,54 @@ inline bool IsOctNumber(const string& str) {
           (str[1] >= '0' && str[1] < '8'));
 }
 
+// Appends the value of a string token to output, like
+// io::Tokenizer::ParseStringAppend(), but copying strings without escape
+// sequences in one go.
+void AppendStringToken(const string& text, string* output) {
+  const size_t size = text.size();
+  if (size >= 2 && text[size - 1] == text[0] &&
+      memchr(text.data(), '\\', size) == NULL) {
+    output->append(text, 1, size - 2);
+  } else {
+    io::Tokenizer::ParseStringAppend(text, output);
+  }
+}
+
+// Returns the value of a float token, like io::Tokenizer::ParseFloat().
+// Plain decimals such as "12.375", with at most 15 digits, take a
+// shortcut:  the digits make an integer which a double holds exactly, as
+// it does the power of ten to divide by, so one division gives the
+// correctly rounded value, which is what strtod() returns.
+double ParseFloatToken(const string& text) {
+  const int kMaxDigits = 15;
+  static const double kPowersOfTen[kMaxDigits + 1] = {
+    1e0, 1e1, 1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+    1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15
+  };
+
+  int64 digits = 0;
+  int digit_count = 0;
+  int fraction_digits = -1;  // -1 until the decimal point.
+  const char* p = text.c_str();
+  for (;; ++p) {
+    if (*p >= '0' && *p <= '9') {
+      if (++digit_count > kMaxDigits) return io::Tokenizer::ParseFloat(text);
+      digits = digits * 10 + (*p - '0');
+      if (fraction_digits >= 0) ++fraction_digits;
+    } else if (*p == '.' && fraction_digits < 0) {
+      fraction_digits = 0;
+    } else {
+      break;
+    }
+  }
+  // For backwards-compatibility with proto1, floats may end in 'f'.
+  if (*p == 'f' || *p == 'F') ++p;
+  if (*p != '\0' || digit_count == 0) return io::Tokenizer::ParseFloat(text);
+
+  return static_cast<double>(digits) /
+         kPowersOfTen[fraction_digits < 0 ? 0 : fraction_digits];
+}
+
 }  // namespace
 
 string Message::DebugString() const {
@@ -178,12 +228,540 @@ TextFormat::ParseInfoTree* TextFormat::ParseInfoTree::GetTreeForNested(
 }
 
 
+// ===========================================================================
+// Internal class for splitting text format into tokens.
+
+namespace {
+
+// Character classes used by TextTokenizer.
+enum {
+  kWhitespace   = 0x01,  // ' ', '\n', '\t', '\r', '\v', '\f'
+  kLetter       = 0x02,  // [A-Za-z_]
+  kDigit        = 0x04,  // [0-9]
+  kHexDigit     = 0x08,  // [0-9A-Fa-f]
+  kOctalDigit   = 0x10,  // [0-7]
+  kPlainInString = 0x20,  // Anything but '\0', '\n', '\t', '\\', '"' or '\''.
+  kBlank        = 0x40   // Whitespace other than '\n' and '\t'.
+};
+
+static const uint8 kCharClasses[256] = {
+  0x00, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x01, 0x01, 0x61, 0x61, 0x61, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x61, 0x20, 0x00, 0x20, 0x20, 0x20, 0x20, 0x00,   //  !"#$%&'
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,   // ()*+,-./
+  0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c,   // 01234567
+  0x2c, 0x2c, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,   // 89:;<=>?
+  0x20, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x22,   // @ABCDEFG
+  0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,   // HIJKLMNO
+  0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,   // PQRSTUVW
+  0x22, 0x22, 0x22, 0x20, 0x00, 0x20, 0x20, 0x22,   // XYZ[\]^_
+  0x20, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x22,   // `abcdefg
+  0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,   // hijklmno
+  0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,   // pqrstuvw
+  0x22, 0x22, 0x22, 0x20, 0x20, 0x20, 0x20, 0x20,   // xyz{|}~
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+};
+
+inline bool InClass(char c, int char_class) {
+  return (kCharClasses[static_cast<uint8>(c)] & char_class) != 0;
+}
+
+// Splits text format into the tokens io::Tokenizer would produce with the
+// settings the parser uses:  '#' starts a comment, floats may end in 'f',
+// and with relaxed whitespace, numbers need no space after them and strings
+// may span lines.  Errors are reported with the same messages and at the
+// same positions.
+//
+// io::Tokenizer handles every grammar through one character at a time;
+// this class only handles the one grammar, and is faster for it.  It
+// classifies characters by table lookup, scans runs of identifier, digit
+// and string characters in a tight loop, appending each run to the token
+// text at once, and keeps no copy of the previous token.  The token text
+// is kept in the same string throughout, so once it has grown to the
+// longest token, no token allocates.
+class TextTokenizer {
+ public:
+  TextTokenizer(io::ZeroCopyInputStream* input,
+                io::ErrorCollector* error_collector,
+                bool allow_relaxed_whitespace)
+      : input_(input),
+        error_collector_(error_collector),
+        require_space_after_number_(!allow_relaxed_whitespace),
+        allow_multiline_strings_(allow_relaxed_whitespace),
+        pos_(NULL),
+        end_(NULL),
+        current_char_('\0'),
+        read_error_(false),
+        line_(0),
+        column_(0),
+        recording_(false),
+        record_start_(NULL),
+        previous_type_(io::Tokenizer::TYPE_START),
+        previous_line_(0),
+        previous_end_column_(0) {
+    current_.line = 0;
+    current_.column = 0;
+    current_.end_column = 0;
+    current_.type = io::Tokenizer::TYPE_START;
+
+    Refresh();
+  }
+
+  ~TextTokenizer() {
+    // Give back whatever was not read, so that someone else can read it.
+    if (pos_ < end_) input_->BackUp(end_ - pos_);
+  }
+
+  const io::Tokenizer::Token& current() const { return current_; }
+
+  // Reads the next token, returning false at the end of the input.
+  bool Next() {
+    previous_type_ = current_.type;
+    previous_line_ = current_.line;
+    previous_end_column_ = current_.end_column;
+
+    while (!read_error_) {
+      while (InClass(current_char_, kWhitespace)) {
+        if (InClass(current_char_, kBlank)) {
+          ConsumeRun(kBlank);
+        } else {
+          NextChar();
+        }
+      }
+
+      if (current_char_ == '#') {
+        // A comment, to the end of the line.
+        while (current_char_ != '\0' && current_char_ != '\n') NextChar();
+        TryConsume('\n');
+        continue;
+      }
+
+      // Check for EOF before continuing.
+      if (read_error_) break;
+
+      if ((current_char_ < ' ' && current_char_ > '\0') ||
+          current_char_ == '\0') {
+        AddError("Invalid control characters encountered in text.");
+        NextChar();
+        // Skip more unprintable characters, too.  '\0' is also what
+        // current_char_ holds at the end of the input, so it only counts
+        // while there is more input.
+        while ((current_char_ < ' ' && current_char_ > '\0') ||
+               (!read_error_ && current_char_ == '\0')) {
+          NextChar();
+        }
+      } else {
+        StartToken();
+
+        if (InClass(current_char_, kLetter)) {
+          ConsumeRun(kLetter | kDigit);
+          current_.type = io::Tokenizer::TYPE_IDENTIFIER;
+        } else if (TryConsume('0')) {
+          current_.type = ConsumeNumber(true, false);
+        } else if (TryConsume('.')) {
+          // This could be the beginning of a floating-point number, or it
+          // could just be a '.' symbol.
+          if (InClass(current_char_, kDigit)) {
+            NextChar();
+            // We don't accept syntax like "blah.123".
+            if (previous_type_ == io::Tokenizer::TYPE_IDENTIFIER &&
+                current_.line == previous_line_ &&
+                current_.column == previous_end_column_) {
+              error_collector_->AddError(line_, column_ - 2,
+                "Need space between identifier and decimal point.");
+            }
+            current_.type = ConsumeNumber(false, true);
+          } else {
+            current_.type = io::Tokenizer::TYPE_SYMBOL;
+          }
+        } else if (InClass(current_char_, kDigit)) {
+          NextChar();
+          current_.type = ConsumeNumber(false, false);
+        } else if (current_char_ == '\"' || current_char_ == '\'') {
+          char delimiter = current_char_;
+          NextChar();
+          ConsumeString(delimiter);
+          current_.type = io::Tokenizer::TYPE_STRING;
+        } else {
+          // Check if the high order bit is set.
+          if (current_char_ & 0x80) {
+            error_collector_->AddError(line_, column_,
+                "Interpreting non ascii codepoint " +
+                SimpleItoa(static_cast<unsigned char>(current_char_)) + ".");
+          }
+          NextChar();
+          current_.type = io::Tokenizer::TYPE_SYMBOL;
+        }
+
+        EndToken();
+        return true;
+      }
+    }
+
+    // EOF
+    current_.type = io::Tokenizer::TYPE_END;
+    current_.text.clear();
+    current_.line = line_;
+    current_.column = column_;
+    current_.end_column = column_;
+    return false;
+  }
+
+ private:
+  static const int kTabWidth = 8;
+
+  void AddError(const string& message) {
+    error_collector_->AddError(line_, column_, message);
+  }
+
+  // Consumes the current character.
+  inline void NextChar() {
+    if (current_char_ == '\n') {
+      ++line_;
+      column_ = 0;
+    } else if (current_char_ == '\t') {
+      column_ += kTabWidth - column_ % kTabWidth;
+    } else {
+      ++column_;
+    }
+
+    if (++pos_ < end_) {
+      current_char_ = *pos_;
+    } else {
+      Refresh();
+    }
+  }
+
+  inline bool TryConsume(char c) {
+    if (current_char_ != c) return false;
+    NextChar();
+    return true;
+  }
+
+  // Consumes characters for as long as they are in char_class, which must
+  // contain neither '\n' nor '\t'.
+  inline void ConsumeRun(int char_class) {
+    while (true) {
+      const char* run_end = pos_;
+      while (run_end < end_ && InClass(*run_end, char_class)) ++run_end;
+      column_ += run_end - pos_;
+      pos_ = run_end;
+      if (pos_ < end_) {
+        current_char_ = *pos_;
+        return;
+      }
+      if (read_error_) return;
+      Refresh();
+    }
+  }
+
+  // Consumes one or more characters of char_class, or reports error.
+  void ConsumeOneOrMore(int char_class, const char* error) {
+    if (!InClass(current_char_, char_class)) {
+      AddError(error);
+    } else {
+      ConsumeRun(char_class);
+    }
+  }
+
+  // Fetches the next buffer from the input, saving the part of the token
+  // in the old one.
+  void Refresh() {
+    if (read_error_) {
+      current_char_ = '\0';
+      return;
+    }
+
+    if (recording_ && record_start_ < end_) {
+      current_.text.append(record_start_, end_ - record_start_);
+    }
+
+    const void* data = NULL;
+    int size;
+    do {
+      if (!input_->Next(&data, &size)) {
+        // end of stream (or read error)
+        pos_ = end_ = record_start_ = NULL;
+        read_error_ = true;
+        current_char_ = '\0';
+        return;
+      }
+    } while (size == 0);
+
+    pos_ = record_start_ = static_cast<const char*>(data);
+    end_ = pos_ + size;
+    current_char_ = *pos_;
+  }
+
+  inline void StartToken() {
+    current_.type = io::Tokenizer::TYPE_START;
+    current_.text.clear();
+    current_.line = line_;
+    current_.column = column_;
+    recording_ = true;
+    record_start_ = pos_;
+  }
+
+  inline void EndToken() {
+    if (pos_ != record_start_) {
+      current_.text.append(record_start_, pos_ - record_start_);
+    }
+    recording_ = false;
+    current_.end_column = column_;
+  }
+
+  // Reads the rest of a number, after its first character.
+  io::Tokenizer::TokenType ConsumeNumber(bool started_with_zero,
+                                         bool started_with_dot) {
+    bool is_float = false;
+
+    if (started_with_zero && (TryConsume('x') || TryConsume('X'))) {
+      // A hex number (started with "0x").
+      ConsumeOneOrMore(kHexDigit, "\"0x\" must be followed by hex digits.");
+
+    } else if (started_with_zero && InClass(current_char_, kDigit)) {
+      // An octal number (had a leading zero).
+      ConsumeRun(kOctalDigit);
+      if (InClass(current_char_, kDigit)) {
+        AddError("Numbers starting with leading zero must be in octal.");
+        ConsumeRun(kDigit);
+      }
+
+    } else {
+      // A decimal number.
+      if (started_with_dot) {
+        is_float = true;
+        ConsumeRun(kDigit);
+      } else {
+        ConsumeRun(kDigit);
+
+        if (TryConsume('.')) {
+          is_float = true;
+          ConsumeRun(kDigit);
+        }
+      }
+
+      if (TryConsume('e') || TryConsume('E')) {
+        is_float = true;
+        TryConsume('-') || TryConsume('+');
+        ConsumeOneOrMore(kDigit, "\"e\" must be followed by exponent.");
+      }
+
+      // For backwards-compatibility with proto1, floats may end in 'f'.
+      if (TryConsume('f') || TryConsume('F')) {
+        is_float = true;
+      }
+    }
+
+    if (InClass(current_char_, kLetter) && require_space_after_number_) {
+      AddError("Need space between number and identifier.");
+    } else if (current_char_ == '.') {
+      if (is_float) {
+        AddError(
+          "Already saw decimal point or exponent; can't have another one.");
+      } else {
+        AddError("Hex and octal numbers must be integers.");
+      }
+    }
+
+    return is_float ? io::Tokenizer::TYPE_FLOAT : io::Tokenizer::TYPE_INTEGER;
+  }
+
+  // Reads the rest of a string, after its opening delimiter.
+  void ConsumeString(char delimiter) {
+    while (true) {
+      switch (current_char_) {
+        case '\0':
+          AddError("Unexpected end of string.");
+          return;
+
+        case '\n': {
+          if (!allow_multiline_strings_) {
+            AddError("String literals cannot cross line boundaries.");
+            return;
+          }
+          NextChar();
+          break;
+        }
+
+        case '\\': {
+          // An escape sequence.
+          NextChar();
+          if (IsEscape(current_char_)) {
+            // Valid escape sequence.
+            NextChar();
+          } else if (InClass(current_char_, kOctalDigit)) {
+            // Possibly followed by two more octal digits, but these will
+            // just be consumed by the main loop anyway.
+            NextChar();
+          } else if (TryConsume('x') || TryConsume('X')) {
+            if (!TryConsumeOne(kHexDigit)) {
+              AddError("Expected hex digits for escape sequence.");
+            }
+          } else if (TryConsume('u')) {
+            if (!TryConsumeOne(kHexDigit) ||
+                !TryConsumeOne(kHexDigit) ||
+                !TryConsumeOne(kHexDigit) ||
+                !TryConsumeOne(kHexDigit)) {
+              AddError("Expected four hex digits for \\u escape sequence.");
+            }
+          } else if (TryConsume('U')) {
+            // We expect 8 hex digits; but only the range up to 0x10ffff is
+            // legal.
+            if (!TryConsume('0') ||
+                !TryConsume('0') ||
+                !(TryConsume('0') || TryConsume('1')) ||
+                !TryConsumeOne(kHexDigit) ||
+                !TryConsumeOne(kHexDigit) ||
+                !TryConsumeOne(kHexDigit) ||
+                !TryConsumeOne(kHexDigit) ||
+                !TryConsumeOne(kHexDigit)) {
+              AddError("Expected eight hex digits up to 10ffff for \\U "
+                       "escape sequence");
+            }
+          } else {
+            AddError("Invalid escape sequence in string literal.");
+          }
+          break;
+        }
+
+        default: {
+          if (current_char_ == delimiter) {
+            NextChar();
+            return;
+          }
+          if (InClass(current_char_, kPlainInString)) {
+            ConsumeRun(kPlainInString);
+          } else {
+            NextChar();
+          }
+          break;
+        }
+      }
+    }
+  }
+
+  inline bool TryConsumeOne(int char_class) {
+    if (!InClass(current_char_, char_class)) return false;
+    NextChar();
+    return true;
+  }
+
+  static inline bool IsEscape(char c) {
+    switch (c) {
+      case 'a': case 'b': case 'f': case 'n': case 'r': case 't': case 'v':
+      case '\\': case '?': case '\'': case '\"':
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  io::ZeroCopyInputStream* const input_;
+  io::ErrorCollector* const error_collector_;
+  const bool require_space_after_number_;
+  const bool allow_multiline_strings_;
+
+  // The position of current_char_ in the current buffer, and the buffer's
+  // end.
+  const char* pos_;
+  const char* end_;
+  char current_char_;
+  bool read_error_;
+
+  int line_;
+  int column_;
+
+  // While reading a token, the start of its text in the current buffer.
+  bool recording_;
+  const char* record_start_;
+
+  io::Tokenizer::Token current_;
+  // What Next() needs to know of the previous token.
+  io::Tokenizer::TokenType previous_type_;
+  int previous_line_;
+  int previous_end_column_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(TextTokenizer);
+};
+
+// The fields of a message type by the names they have in text format:  the
+// field name, or for groups, the name of the group's type.
+typedef hash_map<string, const FieldDescriptor*> FieldsByName;
+
+// FieldsByName for each message type, computed when first needed.
+class FieldNameTables {
+ public:
+  FieldNameTables() {}
+  ~FieldNameTables() { STLDeleteValues(&tables_); }
+
+  const FieldsByName* Get(const Descriptor* descriptor) {
+    MutexLock lock(&mutex_);
+    FieldsByName*& fields = tables_[descriptor];
+    if (fields == NULL) {
+      fields = new FieldsByName;
+      for (int i = 0; i < descriptor->field_count(); i++) {
+        const FieldDescriptor* field = descriptor->field(i);
+        if (field->type() != FieldDescriptor::TYPE_GROUP) {
+          (*fields)[field->name()] = field;
+        }
+      }
+      // A field name takes precedence over a group type name.
+      for (int i = 0; i < descriptor->field_count(); i++) {
+        const FieldDescriptor* field = descriptor->field(i);
+        if (field->type() == FieldDescriptor::TYPE_GROUP) {
+          fields->insert(make_pair(field->message_type()->name(), field));
+        }
+      }
+    }
+    return fields;
+  }
+
+ private:
+  Mutex mutex_;
+  hash_map<const Descriptor*, FieldsByName*> tables_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(FieldNameTables);
+};
+
+FieldNameTables* field_name_tables_ = NULL;
+GOOGLE_PROTOBUF_DECLARE_ONCE(field_name_tables_once_);
+
+void DeleteFieldNameTables() {
+  delete field_name_tables_;
+  field_name_tables_ = NULL;
+}
+
+void InitFieldNameTables() {
+  field_name_tables_ = new FieldNameTables;
+  internal::OnShutdown(&DeleteFieldNameTables);
+}
+
+}  // namespace
+
 // ===========================================================================
 // Internal class for parsing an ASCII representation of a Protocol Message.
-// This class makes use of the Protocol Message compiler's tokenizer found
-// in //google/protobuf/io/tokenizer.h. Note that class's Parse
-// method is *not* thread-safe and should only be used in a single thread at
-// a time.
+// This class uses TextTokenizer, above, which splits the input the way the
+// Protocol Message compiler's tokenizer in //google/protobuf/io/tokenizer.h
+// would. Note that class's Parse method is *not* thread-safe and should only
+// be used in a single thread at a time.
 
 // Makes code slightly more readable.  The meaning of "DO(foo)" is
 // "Execute foo and fail if it fails.", where failure is indicated by
@@ -217,26 +795,17 @@ class TextFormat::Parser::ParserImpl {
       finder_(finder),
       parse_info_tree_(parse_info_tree),
       tokenizer_error_collector_(this),
-      tokenizer_(input_stream, &tokenizer_error_collector_),
+      tokenizer_(input_stream, &tokenizer_error_collector_,
+                 allow_relaxed_whitespace),
       root_message_type_(root_message_type),
       singular_overwrite_policy_(singular_overwrite_policy),
       allow_case_insensitive_field_(allow_case_insensitive_field),
       allow_unknown_field_(allow_unknown_field),
       allow_unknown_enum_(allow_unknown_enum),
       allow_field_number_(allow_field_number),
-      had_errors_(false) {
-    // For backwards-compatibility with proto1, we need to allow the 'f' suffix
-    // for floats.
-    tokenizer_.set_allow_f_after_float(true);
-
-    // '#' starts a comment.
-    tokenizer_.set_comment_style(io::Tokenizer::SH_COMMENT_STYLE);
-
-    if (allow_relaxed_whitespace) {
-      tokenizer_.set_require_space_after_number(false);
-      tokenizer_.set_allow_multiline_strings(true);
-    }
-
+      had_errors_(false),
+      last_descriptor_(NULL),
+      last_fields_(NULL) {
     // Consume the starting token.
     tokenizer_.Next();
   }
@@ -322,7 +891,7 @@ class TextFormat::Parser::ParserImpl {
   // Consumes the specified message with the given starting delimeter.
   // This method checks to see that the end delimeter at the conclusion of
   // the consumption matches the starting delimeter passed in here.
-  bool ConsumeMessage(Message* message, const string delimeter) {
+  bool ConsumeMessage(Message* message, const char* delimeter) {
     while (!LookingAt(">") &&  !LookingAt("}")) {
       DO(ConsumeField(message));
     }
@@ -384,24 +953,12 @@ class TextFormat::Parser::ParserImpl {
           field = descriptor->FindFieldByNumber(field_number);
         }
       } else {
-        field = descriptor->FindFieldByName(field_name);
         // Group names are expected to be capitalized as they appear in the
         // .proto file, which actually matches their type names, not their
-        // field names.
-        if (field == NULL) {
-          string lower_field_name = field_name;
-          LowerString(&lower_field_name);
-          field = descriptor->FindFieldByName(lower_field_name);
-          // If the case-insensitive match worked but the field is NOT a group,
-          if (field != NULL && field->type() != FieldDescriptor::TYPE_GROUP) {
-            field = NULL;
-          }
-        }
-        // Again, special-case group names as described above.
-        if (field != NULL && field->type() == FieldDescriptor::TYPE_GROUP
-            && field->message_type()->name() != field_name) {
-          field = NULL;
-        }
+        // field names.  The table maps groups by their type names.
+        const FieldsByName* fields = GetFieldsByName(descriptor);
+        FieldsByName::const_iterator it = fields->find(field_name);
+        if (it != fields->end()) field = it->second;
 
         if (field == NULL && allow_case_insensitive_field_) {
           string lower_field_name = field_name;
@@ -551,7 +1108,7 @@ class TextFormat::Parser::ParserImpl {
       parse_info_tree_ = CreateNested(parent, field);
     }
 
-    string delimeter;
+    const char* delimeter;
     if (TryConsume("<")) {
       delimeter = ">";
     } else {
@@ -574,7 +1131,7 @@ class TextFormat::Parser::ParserImpl {
   // Skips the whole body of a message including the begining delimeter and
   // the ending delimeter.
   bool SkipFieldMessage() {
-    string delimeter;
+    const char* delimeter;
     if (TryConsume("<")) {
       delimeter = ">";
     } else {
@@ -646,9 +1203,8 @@ class TextFormat::Parser::ParserImpl {
       }
 
       case FieldDescriptor::CPPTYPE_STRING: {
-        string value;
-        DO(ConsumeString(&value));
-        SET_FIELD(String, value);
+        DO(ConsumeString(&string_value_));
+        SET_FIELD(String, string_value_);
         break;
       }
 
@@ -776,8 +1332,11 @@ class TextFormat::Parser::ParserImpl {
   }
 
   // Returns true if the current token's text is equal to that specified.
-  bool LookingAt(const string& text) {
-    return tokenizer_.current().text == text;
+  bool LookingAt(const char* text) {
+    // Comparing the first characters rules out most tokens cheaply.  (The
+    // text of the end token is empty, and its [0] is '\0'.)
+    const string& current = tokenizer_.current().text;
+    return current[0] == text[0] && current.compare(text) == 0;
   }
 
   // Returns true if the current token's type is equal to that specified.
@@ -817,7 +1376,7 @@ class TextFormat::Parser::ParserImpl {
 
     text->clear();
     while (LookingAtType(io::Tokenizer::TYPE_STRING)) {
-      io::Tokenizer::ParseStringAppend(tokenizer_.current().text, text);
+      AppendStringToken(tokenizer_.current().text, text);
 
       tokenizer_.Next();
     }
@@ -916,7 +1475,7 @@ class TextFormat::Parser::ParserImpl {
       *value = static_cast<double>(integer_value);
     } else if (LookingAtType(io::Tokenizer::TYPE_FLOAT)) {
       // We have found a float value for the double.
-      *value = io::Tokenizer::ParseFloat(tokenizer_.current().text);
+      *value = ParseFloatToken(tokenizer_.current().text);
 
       // Mark the current token as consumed.
       tokenizer_.Next();
@@ -949,12 +1508,10 @@ class TextFormat::Parser::ParserImpl {
   // Consumes a token and confirms that it matches that specified in the
   // value parameter. Returns false if the token found does not match that
   // which was specified.
-  bool Consume(const string& value) {
-    const string& current_value = tokenizer_.current().text;
-
-    if (current_value != value) {
-      ReportError("Expected \"" + value + "\", found \"" + current_value
-                  + "\".");
+  bool Consume(const char* value) {
+    if (!LookingAt(value)) {
+      ReportError(string("Expected \"") + value + "\", found \"" +
+                  tokenizer_.current().text + "\".");
       return false;
     }
 
@@ -965,8 +1522,8 @@ class TextFormat::Parser::ParserImpl {
 
   // Attempts to consume the supplied value. Returns false if a the
   // token found does not match the value specified.
-  bool TryConsume(const string& value) {
-    if (tokenizer_.current().text == value) {
+  bool TryConsume(const char* value) {
+    if (LookingAt(value)) {
       tokenizer_.Next();
       return true;
     } else {
@@ -974,6 +1531,23 @@ class TextFormat::Parser::ParserImpl {
     }
   }
 
+  // Returns the fields of the given type by name, taking them from the
+  // shared tables the first time each type is seen.
+  const FieldsByName* GetFieldsByName(const Descriptor* descriptor) {
+    // Consecutive fields are usually in the same message.
+    if (descriptor == last_descriptor_) return last_fields_;
+
+    const FieldsByName*& fields = fields_by_name_[descriptor];
+    if (fields == NULL) {
+      ::google::protobuf::GoogleOnceInit(&field_name_tables_once_,
+                                         &InitFieldNameTables);
+      fields = field_name_tables_->Get(descriptor);
+    }
+    last_descriptor_ = descriptor;
+    last_fields_ = fields;
+    return fields;
+  }
+
   // An internal instance of the Tokenizer's error collector, used to
   // collect any base-level parse errors and feed them to the ParserImpl.
   class ParserErrorCollector : public io::ErrorCollector {
@@ -1000,7 +1574,7 @@ class TextFormat::Parser::ParserImpl {
   TextFormat::Finder* finder_;
   ParseInfoTree* parse_info_tree_;
   ParserErrorCollector tokenizer_error_collector_;
-  io::Tokenizer tokenizer_;
+  TextTokenizer tokenizer_;
   const Descriptor* root_message_type_;
   SingularOverwritePolicy singular_overwrite_policy_;
   const bool allow_case_insensitive_field_;
@@ -1008,6 +1582,13 @@ class TextFormat::Parser::ParserImpl {
   const bool allow_unknown_enum_;
   const bool allow_field_number_;
   bool had_errors_;
+
+  // Field tables of the types seen so far, and the last one looked up.
+  hash_map<const Descriptor*, const FieldsByName*> fields_by_name_;
+  const Descriptor* last_descriptor_;
+  const FieldsByName* last_fields_;
+  // Holds the value of a string field while it is parsed.
+  string string_value_;
 };
 
 #undef DO
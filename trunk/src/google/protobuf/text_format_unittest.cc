@@ -614,6 +614,38 @@ TEST_F(TextFormatTest, ParseFloatWithSuffix) {
   EXPECT_EQ(1.0, proto_.optional_float());
 }
 
+TEST_F(TextFormatTest, ParseDecimalFloats) {
+  // Short decimals are converted without strtod(); the results must be the
+  // same.
+  const char* kValues[] = {
+    "0.1", "0.3", "2.675", "123.456", "1.", ".5", "0.000001", "1e10",
+    "999999999999999.9", "0.1234567890123456789", "3.4028235e+38",
+    "0.0000000000000000000001", "123456789012345"
+  };
+  for (int i = 0; i < GOOGLE_ARRAYSIZE(kValues); i++) {
+    string parse_string = string("optional_double: ") + kValues[i] + "\n";
+    ASSERT_TRUE(TextFormat::ParseFromString(parse_string, &proto_))
+        << kValues[i];
+    EXPECT_EQ(strtod(kValues[i], NULL), proto_.optional_double())
+        << kValues[i];
+  }
+}
+
+TEST_F(TextFormatTest, ParseAcrossBufferBoundaries) {
+  // Tokens may be split across the buffers of the input stream.
+  unittest::TestAllTypes message;
+  TestUtil::SetAllFields(&message);
+  string parse_string = "# A comment.\n\t" + message.DebugString();
+
+  for (int block_size = 1; block_size < 8; block_size++) {
+    io::ArrayInputStream input_stream(parse_string.data(),
+                                      parse_string.size(), block_size);
+    unittest::TestAllTypes parsed;
+    EXPECT_TRUE(TextFormat::Parse(&input_stream, &parsed)) << block_size;
+    TestUtil::ExpectAllFieldsSet(parsed);
+  }
+}
+
 TEST_F(TextFormatTest, ParseShortRepeatedForm) {
   string parse_string =
       // Mixed short-form and long-form are simply concatenated.
@@ -1198,6 +1230,13 @@ TEST_F(TextFormatParserTest, InvalidToken) {
   ExpectFailure("\"some string\"", "Expected identifier.", 1, 1);
 }
 
+TEST_F(TextFormatParserTest, ErrorPositionAfterTabs) {
+  // Tabs advance the column to the next multiple of 8.
+  ExpectFailure("optional_bool: true\n\t \tno_such_field: 1\n",
+                "Message type \"protobuf_unittest.TestAllTypes\" has no field "
+                "named \"no_such_field\".", 2, 30);
+}
+
 TEST_F(TextFormatParserTest, InvalidFieldName) {
   ExpectFailure(
       "invalid_field: somevalue\n",
@@ -35,6 +35,7 @@
 #include <google/protobuf/unknown_field_set.h>
 
 #include <google/protobuf/stubs/common.h>
+#include <google/protobuf/stubs/once.h>
 #include <google/protobuf/io/coded_stream.h>
 #include <google/protobuf/io/zero_copy_stream.h>
 #include <google/protobuf/io/zero_copy_stream_impl.h>
@@ -44,8 +45,17 @@
 namespace google {
 namespace protobuf {
 
+struct UnknownFieldSet::SerializedFields {
+  SerializedFields() : parse_once(GOOGLE_PROTOBUF_ONCE_INIT) {}
+
+  string bytes;
+  // Guards the expansion of |bytes| into fields_.
+  ProtobufOnceType parse_once;
+};
+
 UnknownFieldSet::UnknownFieldSet()
-    : fields_(NULL) {}
+    : fields_(NULL),
+      serialized_(NULL) {}
 
 UnknownFieldSet::~UnknownFieldSet() {
   Clear();
@@ -53,7 +63,11 @@ UnknownFieldSet::~UnknownFieldSet() {
 }
 
 void UnknownFieldSet::ClearFallback() {
-  GOOGLE_DCHECK(fields_ != NULL);
+  if (serialized_ != NULL) {
+    delete serialized_;
+    serialized_ = NULL;
+  }
+  if (fields_ == NULL) return;
   for (int i = 0; i < fields_->size(); i++) {
     (*fields_)[i].Delete();
   }
@@ -61,23 +75,75 @@ void UnknownFieldSet::ClearFallback() {
 }
 
 void UnknownFieldSet::ClearAndFreeMemory() {
-  if (fields_ != NULL) {
-    Clear();
-    delete fields_;
-    fields_ = NULL;
+  Clear();
+  delete fields_;
+  fields_ = NULL;
+}
+
+void UnknownFieldSet::ParseSerializedFields() const {
+  GoogleOnceInit(&serialized_->parse_once, &ParseSerializedFieldsOnce, this);
+}
+
+void UnknownFieldSet::ParseSerializedFieldsOnce(const UnknownFieldSet* set) {
+  // The bytes were validated as they were appended, so this cannot fail.
+  UnknownFieldSet parsed;
+  const string& bytes = set->serialized_->bytes;
+  io::CodedInputStream input(reinterpret_cast<const uint8*>(bytes.data()),
+                             bytes.size());
+  internal::WireFormat::SkipMessage(&input, &parsed);
+  // fields_ is logically part of the serialized state, which is unchanged.
+  std::swap(const_cast<UnknownFieldSet*>(set)->fields_, parsed.fields_);
+}
+
+void UnknownFieldSet::DiscardSerializedFields() {
+  GOOGLE_DCHECK(serialized_ != NULL);
+  ParseSerializedFields();
+  delete serialized_;
+  serialized_ = NULL;
+}
+
+string* UnknownFieldSet::MutableSerializedFields() {
+  if (serialized_ == NULL) {
+    if (fields_ != NULL && !fields_->empty()) return NULL;
+    serialized_ = new SerializedFields;
+  } else if (fields_ != NULL && !fields_->empty()) {
+    // Throw away the expanded copy; the bytes are about to change.
+    for (int i = 0; i < fields_->size(); i++) {
+      (*fields_)[i].Delete();
+    }
+    fields_->clear();
+    serialized_->parse_once = GOOGLE_PROTOBUF_ONCE_INIT;
   }
+  return &serialized_->bytes;
+}
+
+const string* UnknownFieldSet::SerializedBytes() const {
+  return serialized_ == NULL ? NULL : &serialized_->bytes;
 }
 
 void UnknownFieldSet::MergeFrom(const UnknownFieldSet& other) {
+  if (other.serialized_ != NULL) {
+    // Keep the fields serialized if this set can stay serialized too.
+    string* bytes = MutableSerializedFields();
+    if (bytes != NULL) {
+      bytes->append(other.serialized_->bytes);
+      return;
+    }
+  }
   for (int i = 0; i < other.field_count(); i++) {
     AddField(other.field(i));
   }
 }
 
 int UnknownFieldSet::SpaceUsedExcludingSelf() const {
-  if (fields_ == NULL) return 0;
+  int total_size = 0;
+  if (serialized_ != NULL) {
+    total_size += sizeof(*serialized_) +
+                  internal::StringSpaceUsedExcludingSelf(serialized_->bytes);
+  }
+  if (fields_ == NULL) return total_size;
 
-  int total_size = sizeof(*fields_) + sizeof(UnknownField) * fields_->size();
+  total_size += sizeof(*fields_) + sizeof(UnknownField) * fields_->size();
   for (int i = 0; i < fields_->size(); i++) {
     const UnknownField& field = (*fields_)[i];
     switch (field.type()) {
@@ -101,6 +167,7 @@ int UnknownFieldSet::SpaceUsed() const {
 }
 
 void UnknownFieldSet::AddVarint(int number, uint64 value) {
+  if (serialized_ != NULL) DiscardSerializedFields();
   if (fields_ == NULL) fields_ = new vector<UnknownField>;
   UnknownField field;
   field.number_ = number;
@@ -110,6 +177,7 @@ void UnknownFieldSet::AddVarint(int number, uint64 value) {
 }
 
 void UnknownFieldSet::AddFixed32(int number, uint32 value) {
+  if (serialized_ != NULL) DiscardSerializedFields();
   if (fields_ == NULL) fields_ = new vector<UnknownField>;
   UnknownField field;
   field.number_ = number;
@@ -119,6 +187,7 @@ void UnknownFieldSet::AddFixed32(int number, uint32 value) {
 }
 
 void UnknownFieldSet::AddFixed64(int number, uint64 value) {
+  if (serialized_ != NULL) DiscardSerializedFields();
   if (fields_ == NULL) fields_ = new vector<UnknownField>;
   UnknownField field;
   field.number_ = number;
@@ -128,6 +197,7 @@ void UnknownFieldSet::AddFixed64(int number, uint64 value) {
 }
 
 string* UnknownFieldSet::AddLengthDelimited(int number) {
+  if (serialized_ != NULL) DiscardSerializedFields();
   if (fields_ == NULL) fields_ = new vector<UnknownField>;
   UnknownField field;
   field.number_ = number;
@@ -139,6 +209,7 @@ string* UnknownFieldSet::AddLengthDelimited(int number) {
 
 
 UnknownFieldSet* UnknownFieldSet::AddGroup(int number) {
+  if (serialized_ != NULL) DiscardSerializedFields();
   if (fields_ == NULL) fields_ = new vector<UnknownField>;
   UnknownField field;
   field.number_ = number;
@@ -149,12 +220,14 @@ UnknownFieldSet* UnknownFieldSet::AddGroup(int number) {
 }
 
 void UnknownFieldSet::AddField(const UnknownField& field) {
+  if (serialized_ != NULL) DiscardSerializedFields();
   if (fields_ == NULL) fields_ = new vector<UnknownField>;
   fields_->push_back(field);
   fields_->back().DeepCopy();
 }
 
 void UnknownFieldSet::DeleteSubrange(int start, int num) {
+  if (serialized_ != NULL) DiscardSerializedFields();
   GOOGLE_DCHECK(fields_ != NULL);
   // Delete the specified fields.
   for (int i = 0; i < num; ++i) {
@@ -171,6 +244,7 @@ void UnknownFieldSet::DeleteSubrange(int start, int num) {
 }
 
 void UnknownFieldSet::DeleteByNumber(int number) {
+  if (serialized_ != NULL) DiscardSerializedFields();
   if (fields_ == NULL) return;
   int left = 0;  // The number of fields left after deletion.
   for (int i = 0; i < fields_->size(); ++i) {
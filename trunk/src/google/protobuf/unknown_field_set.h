@@ -71,6 +71,14 @@ class UnknownField;                 // below
 //
 // This class is necessarily tied to the protocol buffer wire format, unlike
 // the Reflection interface which is independent of any serialization scheme.
+//
+// Messages generated with the "unknown_fields_as_bytes" option of the C++
+// code generator keep the unknown fields they parse as a single buffer of
+// serialized bytes, which is written out again verbatim when the message is
+// serialized.  The buffer is expanded into individual UnknownFields the first
+// time field_count() or field() is called, which is safe to do concurrently
+// from multiple threads.  Any modification of the set also expands it and
+// discards the buffer.
 class LIBPROTOBUF_EXPORT UnknownFieldSet {
  public:
   UnknownFieldSet();
@@ -143,9 +151,29 @@ class LIBPROTOBUF_EXPORT UnknownFieldSet {
 
  private:
 
+  friend class internal::WireFormat;
+  struct SerializedFields;
+
   void ClearFallback();
 
+  // Expands serialized_ into fields_ if that has not been done yet.  Safe to
+  // call from multiple threads at once.
+  void ParseSerializedFields() const;
+  static void ParseSerializedFieldsOnce(const UnknownFieldSet* set);
+  // Expands serialized_, then frees it so that fields_ may be modified.
+  void DiscardSerializedFields();
+  // Returns the buffer to which serialized fields should be appended, or NULL
+  // if the set already contains fields which were not added this way.  Used
+  // by WireFormat::SkipFieldAsBytes().
+  string* MutableSerializedFields();
+  // Returns the serialized bytes, or NULL if the set does not hold any.
+  const string* SerializedBytes() const;
+
   vector<UnknownField>* fields_;
+  // If non-NULL, holds the contents of the set as serialized bytes.  fields_
+  // is then either empty or a copy of those bytes expanded by
+  // ParseSerializedFields().
+  SerializedFields* serialized_;
 
   GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(UnknownFieldSet);
 };
@@ -222,26 +250,31 @@ class LIBPROTOBUF_EXPORT UnknownField {
 // inline implementations
 
 inline void UnknownFieldSet::Clear() {
-  if (fields_ != NULL) {
+  if (fields_ != NULL || serialized_ != NULL) {
     ClearFallback();
   }
 }
 
 inline bool UnknownFieldSet::empty() const {
-  return fields_ == NULL || fields_->empty();
+  // serialized_ is never left holding an empty buffer.
+  return serialized_ == NULL && (fields_ == NULL || fields_->empty());
 }
 
 inline void UnknownFieldSet::Swap(UnknownFieldSet* x) {
   std::swap(fields_, x->fields_);
+  std::swap(serialized_, x->serialized_);
 }
 
 inline int UnknownFieldSet::field_count() const {
+  if (serialized_ != NULL) ParseSerializedFields();
   return (fields_ == NULL) ? 0 : fields_->size();
 }
 inline const UnknownField& UnknownFieldSet::field(int index) const {
+  if (serialized_ != NULL) ParseSerializedFields();
   return (*fields_)[index];
 }
 inline UnknownField* UnknownFieldSet::mutable_field(int index) {
+  if (serialized_ != NULL) DiscardSerializedFields();
   return &(*fields_)[index];
 }
 
@@ -41,6 +41,8 @@
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 #include <google/protobuf/wire_format.h>
 #include <google/protobuf/unittest.pb.h>
+#include <google/protobuf/unittest_unknown_fields_as_bytes.pb.h>
+#include <google/protobuf/unittest_unknown_fields_as_bytes_table_driven.pb.h>
 #include <google/protobuf/test_util.h>
 
 #include <google/protobuf/stubs/common.h>
@@ -593,6 +595,122 @@ TEST_F(UnknownFieldSetTest, DeleteByNumber) {
                       MAKE_VECTOR(kExpectedFieldNumbers5));
 }
 #undef MAKE_VECTOR
+
+// Checks a message type generated with the unknown_fields_as_bytes option.
+template <typename FewFields, typename Extension>
+void CheckUnknownFieldsAsBytes(const unittest::TestAllTypes& all_fields,
+                               const Extension& extension) {
+  // Without fields 1 and 14, none of the fields are known to FewFields, so
+  // it must write back exactly the bytes it parsed.
+  unittest::TestAllTypes unknown_only(all_fields);
+  unknown_only.clear_optional_int32();
+  unknown_only.clear_optional_string();
+  string data = unknown_only.SerializeAsString();
+
+  FewFields message;
+  ASSERT_TRUE(message.ParseFromString(data));
+  EXPECT_FALSE(message.has_optional_int32());
+  EXPECT_EQ(data.size(), message.ByteSize());
+  EXPECT_EQ(data, message.SerializeAsString());
+  string stream_data;
+  {
+    io::StringOutputStream raw_output(&stream_data);
+    io::CodedOutputStream output(&raw_output);
+    message.SerializeWithCachedSizes(&output);
+  }
+  EXPECT_EQ(data, stream_data);
+
+  // The bytes take less space than the same fields parsed individually.
+  unittest::TestEmptyMessage empty_message;
+  ASSERT_TRUE(empty_message.ParseFromString(data));
+  EXPECT_LT(message.unknown_fields().SpaceUsed(),
+            empty_message.unknown_fields().SpaceUsed());
+
+  // Looking at the fields expands them, without changing the output.
+  const UnknownFieldSet& expected = empty_message.unknown_fields();
+  const UnknownFieldSet& unknown_fields =
+      message.GetReflection()->GetUnknownFields(message);
+  ASSERT_EQ(expected.field_count(), unknown_fields.field_count());
+  for (int i = 0; i < expected.field_count(); i++) {
+    EXPECT_EQ(expected.field(i).number(), unknown_fields.field(i).number());
+    EXPECT_EQ(expected.field(i).type(), unknown_fields.field(i).type());
+  }
+  EXPECT_EQ(data, message.SerializeAsString());
+
+  // Copying and merging keep the fields as bytes.
+  FewFields copy(message);
+  EXPECT_EQ(data, copy.SerializeAsString());
+  copy.MergeFrom(message);
+  EXPECT_EQ(data + data, copy.SerializeAsString());
+  copy.Swap(&message);
+  EXPECT_EQ(data, copy.SerializeAsString());
+  EXPECT_EQ(data + data, message.SerializeAsString());
+
+  // Known fields are parsed as usual, and the unknown ones can be modified.
+  ASSERT_TRUE(message.ParseFromString(all_fields.SerializeAsString()));
+  EXPECT_EQ(all_fields.optional_int32(), message.optional_int32());
+  EXPECT_EQ(all_fields.optional_string(), message.optional_string());
+  message.mutable_unknown_fields()->AddVarint(500, 1);
+  unittest::TestAllTypes reparsed;
+  ASSERT_TRUE(reparsed.ParseFromString(message.SerializeAsString()));
+  TestUtil::ExpectAllFieldsSet(reparsed);
+  ASSERT_EQ(1, reparsed.unknown_fields().field_count());
+  EXPECT_EQ(500, reparsed.unknown_fields().field(0).number());
+
+  // Extensions are still recognized.
+  unittest::TestEmptyMessage with_extension;
+  with_extension.mutable_unknown_fields()->AddVarint(1000, 7);
+  with_extension.mutable_unknown_fields()->AddVarint(2000, 8);
+  ASSERT_TRUE(message.ParseFromString(with_extension.SerializeAsString()));
+  EXPECT_EQ(7, message.GetExtension(extension));
+  ASSERT_EQ(1, message.unknown_fields().field_count());
+  EXPECT_EQ(2000, message.unknown_fields().field(0).number());
+
+  EXPECT_FALSE(message.ParseFromString(data.substr(0, data.size() - 1)));
+  message.Clear();
+  EXPECT_TRUE(message.unknown_fields().empty());
+  EXPECT_EQ(0, message.ByteSize());
+}
+
+TEST_F(UnknownFieldSetTest, UnknownFieldsAsBytes) {
+  CheckUnknownFieldsAsBytes<
+      protobuf_unittest_unknown_fields_as_bytes::TestFewFields>(
+          all_fields_,
+          protobuf_unittest_unknown_fields_as_bytes::optional_int32_extension);
+}
+
+TEST_F(UnknownFieldSetTest, UnknownFieldsAsBytesTableDriven) {
+  CheckUnknownFieldsAsBytes<
+      protobuf_unittest_unknown_fields_as_bytes_table_driven::TestFewFields>(
+          all_fields_,
+          protobuf_unittest_unknown_fields_as_bytes_table_driven::
+              optional_int32_extension);
+}
+
+TEST_F(UnknownFieldSetTest, SerializedFieldsAreExpandedForModification) {
+  protobuf_unittest_unknown_fields_as_bytes::TestFewFields message;
+  ASSERT_TRUE(message.ParseFromString(all_fields_data_));
+  UnknownFieldSet* unknown_fields = message.mutable_unknown_fields();
+  int field_count = unknown_fields->field_count();
+  ASSERT_GT(field_count, 2);
+
+  unknown_fields->DeleteSubrange(0, 1);
+  EXPECT_EQ(field_count - 1, unknown_fields->field_count());
+  unknown_fields->mutable_field(0)->set_varint(12345);
+
+  // Structured fields are not turned back into bytes by later merges.
+  protobuf_unittest_unknown_fields_as_bytes::TestFewFields other;
+  ASSERT_TRUE(other.ParseFromString(all_fields_data_));
+  message.MergeFrom(other);
+  EXPECT_EQ(2 * field_count - 1, unknown_fields->field_count());
+  EXPECT_EQ(12345, unknown_fields->field(0).varint());
+
+  // The two known fields are written first.
+  unittest::TestEmptyMessage reparsed;
+  ASSERT_TRUE(reparsed.ParseFromString(message.SerializeAsString()));
+  EXPECT_EQ(2 * field_count + 1, reparsed.unknown_fields().field_count());
+  EXPECT_EQ(12345, reparsed.unknown_fields().field(2).varint());
+}
 }  // namespace
 
 }  // namespace protobuf
@@ -43,6 +43,7 @@
 #include <google/protobuf/descriptor.h>
 #include <google/protobuf/wire_format_lite_inl.h>
 #include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/io/backward_output_buffer.h>
 #include <google/protobuf/io/coded_stream.h>
 #include <google/protobuf/io/zero_copy_stream.h>
 #include <google/protobuf/io/zero_copy_stream_impl.h>
@@ -139,6 +140,83 @@ bool WireFormat::SkipField(io::CodedInputStream* input, uint32 tag,
   }
 }
 
+bool WireFormat::SkipFieldAsBytes(io::CodedInputStream* input, uint32 tag,
+                                  UnknownFieldSet* unknown_fields) {
+  string* bytes = unknown_fields->MutableSerializedFields();
+  if (bytes == NULL) return SkipField(input, tag, unknown_fields);
+
+  // Fields are re-encoded the same way WireFormatLite::SkipField() copies
+  // them, so that the buffer only ever holds complete, valid fields.
+  // Room for a tag followed by the longest possible varint.
+  uint8 buffer[5 + 10];
+  uint8* end = io::CodedOutputStream::WriteVarint32ToArray(tag, buffer);
+  int old_size = bytes->size();
+  bool success = true;
+
+  switch (WireFormatLite::GetTagWireType(tag)) {
+    case WireFormatLite::WIRETYPE_VARINT: {
+      uint64 value;
+      success = input->ReadVarint64(&value);
+      end = io::CodedOutputStream::WriteVarint64ToArray(value, end);
+      bytes->append(reinterpret_cast<char*>(buffer), end - buffer);
+      break;
+    }
+    case WireFormatLite::WIRETYPE_FIXED64: {
+      uint64 value;
+      success = input->ReadLittleEndian64(&value);
+      end = io::CodedOutputStream::WriteLittleEndian64ToArray(value, end);
+      bytes->append(reinterpret_cast<char*>(buffer), end - buffer);
+      break;
+    }
+    case WireFormatLite::WIRETYPE_LENGTH_DELIMITED: {
+      uint32 length;
+      if (!input->ReadVarint32(&length)) {
+        success = false;
+        break;
+      }
+      end = io::CodedOutputStream::WriteVarint32ToArray(length, end);
+      bytes->append(reinterpret_cast<char*>(buffer), end - buffer);
+      const void* data;
+      int size;
+      if (input->GetDirectBufferPointer(&data, &size) && size >= length) {
+        // Common case:  the whole value is in the current buffer.
+        bytes->append(reinterpret_cast<const char*>(data), length);
+        input->Skip(length);
+      } else {
+        string value;
+        success = input->ReadString(&value, length);
+        bytes->append(value);
+      }
+      break;
+    }
+    case WireFormatLite::WIRETYPE_START_GROUP: {
+      io::StringOutputStream output_stream(bytes);
+      io::CodedOutputStream output(&output_stream);
+      success = WireFormatLite::SkipField(input, tag, &output);
+      break;
+    }
+    case WireFormatLite::WIRETYPE_FIXED32: {
+      uint32 value;
+      success = input->ReadLittleEndian32(&value);
+      end = io::CodedOutputStream::WriteLittleEndian32ToArray(value, end);
+      bytes->append(reinterpret_cast<char*>(buffer), end - buffer);
+      break;
+    }
+    default: {
+      // WIRETYPE_END_GROUP or an invalid wire type.
+      success = false;
+      break;
+    }
+  }
+
+  if (!success) {
+    // Drop the partial field, and the buffer too if it is now empty.
+    bytes->resize(old_size);
+    if (bytes->empty()) unknown_fields->Clear();
+  }
+  return success;
+}
+
 bool WireFormat::SkipMessage(io::CodedInputStream* input,
                              UnknownFieldSet* unknown_fields) {
   while(true) {
@@ -161,6 +239,11 @@ bool WireFormat::SkipMessage(io::CodedInputStream* input,
 
 void WireFormat::SerializeUnknownFields(const UnknownFieldSet& unknown_fields,
                                         io::CodedOutputStream* output) {
+  const string* bytes = unknown_fields.SerializedBytes();
+  if (bytes != NULL) {
+    output->WriteString(*bytes);
+    return;
+  }
   for (int i = 0; i < unknown_fields.field_count(); i++) {
     const UnknownField& field = unknown_fields.field(i);
     switch (field.type()) {
@@ -200,6 +283,10 @@ void WireFormat::SerializeUnknownFields(const UnknownFieldSet& unknown_fields,
 uint8* WireFormat::SerializeUnknownFieldsToArray(
     const UnknownFieldSet& unknown_fields,
     uint8* target) {
+  const string* bytes = unknown_fields.SerializedBytes();
+  if (bytes != NULL) {
+    return io::CodedOutputStream::WriteStringToArray(*bytes, target);
+  }
   for (int i = 0; i < unknown_fields.field_count(); i++) {
     const UnknownField& field = unknown_fields.field(i);
 
@@ -290,8 +377,17 @@ uint8* WireFormat::SerializeUnknownMessageSetItemsToArray(
   return target;
 }
 
+void WireFormat::PrependUnknownFields(const UnknownFieldSet& unknown_fields,
+                                      io::BackwardOutputBuffer* buffer) {
+  SerializeUnknownFieldsToArray(
+      unknown_fields,
+      buffer->Prepend(ComputeUnknownFieldsSize(unknown_fields)));
+}
+
 int WireFormat::ComputeUnknownFieldsSize(
     const UnknownFieldSet& unknown_fields) {
+  const string* bytes = unknown_fields.SerializedBytes();
+  if (bytes != NULL) return bytes->size();
   int size = 0;
   for (int i = 0; i < unknown_fields.field_count(); i++) {
     const UnknownField& field = unknown_fields.field(i);
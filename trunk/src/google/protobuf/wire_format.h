@@ -54,6 +54,7 @@
 namespace google {
 namespace protobuf {
   namespace io {
+    class BackwardOutputBuffer;  // backward_output_buffer.h
     class CodedInputStream;      // coded_stream.h
     class CodedOutputStream;     // coded_stream.h
   }
@@ -133,6 +134,12 @@ class LIBPROTOBUF_EXPORT WireFormat {
   static bool SkipField(io::CodedInputStream* input, uint32 tag,
                         UnknownFieldSet* unknown_fields);
 
+  // Like SkipField(), but if unknown_fields holds nothing but serialized
+  // bytes, appends the field to them instead of adding an UnknownField.
+  // Used by messages generated with the "unknown_fields_as_bytes" option.
+  static bool SkipFieldAsBytes(io::CodedInputStream* input, uint32 tag,
+                               UnknownFieldSet* unknown_fields);
+
   // Reads and ignores a message from the input.  If unknown_fields is non-NULL,
   // the contents will be added to it.
   static bool SkipMessage(io::CodedInputStream* input,
@@ -149,6 +156,9 @@ class LIBPROTOBUF_EXPORT WireFormat {
   static uint8* SerializeUnknownFieldsToArray(
       const UnknownFieldSet& unknown_fields,
       uint8* target);
+  // Same as above, except writing in front of the contents of *buffer.
+  static void PrependUnknownFields(const UnknownFieldSet& unknown_fields,
+                                   io::BackwardOutputBuffer* buffer);
 
   // Same thing except for messages that have the message_set_wire_format
   // option.
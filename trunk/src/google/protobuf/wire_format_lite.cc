@@ -404,6 +404,16 @@ void WireFormatLite::WriteBytesMaybeAliased(
 }
 
 
+void WireFormatLite::WriteStringPiece(int field_number,
+                                      const StringPieceField& value,
+                                      io::CodedOutputStream* output) {
+  WriteTag(field_number, WIRETYPE_LENGTH_DELIMITED, output);
+  StringPiece piece = value.Get();
+  output->WriteVarint32(piece.size());
+  output->WriteRawMaybeAliased(piece.data(), piece.size());
+}
+
+
 void WireFormatLite::WriteGroup(int field_number,
                                 const MessageLite& value,
                                 io::CodedOutputStream* output) {
@@ -465,6 +475,17 @@ bool WireFormatLite::ReadBytes(io::CodedInputStream* input,
   if (!input->ReadVarint32(&length)) return false;
   return input->InternalReadStringInline(value, length);
 }
+bool WireFormatLite::ReadStringPiece(io::CodedInputStream* input,
+                                     StringPieceField* value, Arena* arena) {
+  uint32 length;
+  if (!input->ReadVarint32(&length)) return false;
+  const void* data;
+  if (input->ReadAliasedRaw(&data, length)) {
+    value->SetAliased(static_cast<const char*>(data), length);
+    return true;
+  }
+  return input->InternalReadStringInline(value->Mutable(arena), length);
+}
 
 }  // namespace internal
 }  // namespace protobuf
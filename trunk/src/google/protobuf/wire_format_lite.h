@@ -52,9 +52,10 @@ namespace protobuf {
 }
 
 namespace protobuf {
+class Arena;  // arena.h
 namespace internal {
 
-class StringPieceField;
+class StringPieceField;  // string_piece_field.h
 
 // This class is for internal use by the protocol buffer library and by
 // protocol-complier-generated message classes.  It must not be called
@@ -299,6 +300,12 @@ class LIBPROTOBUF_EXPORT WireFormatLite {
 
   static bool ReadString(input, string* value);
   static bool ReadBytes (input, string* value);
+  // Reads a string or bytes field declared with [ctype=STRING_PIECE].  If
+  // the stream has aliasing enabled (see CodedInputStream::EnableAliasing()),
+  // the field is pointed into the stream's buffer instead of copying the
+  // value; otherwise the value is copied into storage allocated on arena
+  // (or the heap, if arena is NULL).
+  static bool ReadStringPiece(input, StringPieceField* value, Arena* arena);
 
   static inline bool ReadGroup  (field_number, input, MessageLite* value);
   static inline bool ReadMessage(input, MessageLite* value);
@@ -355,6 +362,11 @@ class LIBPROTOBUF_EXPORT WireFormatLite {
       field_number, const string& value, output);
   static void WriteBytesMaybeAliased(
       field_number, const string& value, output);
+  // Writes a string or bytes field declared with [ctype=STRING_PIECE].  Like
+  // the *MaybeAliased() methods, this avoids a copy if the output stream
+  // allows aliasing.
+  static void WriteStringPiece(
+      field_number, const StringPieceField& value, output);
 
   static void WriteGroup(
     field_number, const MessageLite& value, output);
@@ -433,6 +445,8 @@ class LIBPROTOBUF_EXPORT WireFormatLite {
     field_number, const string& value, output) INL;
   static inline uint8* WriteBytesToArray(
     field_number, const string& value, output) INL;
+  static inline uint8* WriteStringPieceToArray(
+    field_number, const StringPieceField& value, output) INL;
 
   static inline uint8* WriteGroupToArray(
       field_number, const MessageLite& value, output) INL;
@@ -453,6 +467,19 @@ class LIBPROTOBUF_EXPORT WireFormatLite {
 #undef input
 #undef INL
 
+  // Write a group or message in front of the contents of a
+  // BackwardOutputBuffer, without using cached sizes.  Used by the generated
+  // SerializeBackward() methods.  The call to SerializeBackward() is
+  // de-virtualized as for WriteMessageNoVirtualToArray().
+  template<typename MessageType>
+  static inline void PrependGroupNoVirtual(
+      field_number, const MessageType& value,
+      io::BackwardOutputBuffer* buffer);
+  template<typename MessageType>
+  static inline void PrependMessageNoVirtual(
+      field_number, const MessageType& value,
+      io::BackwardOutputBuffer* buffer);
+
 #undef field_number
 
   // Compute the byte size of a field.  The XxSize() functions do NOT include
@@ -478,6 +505,7 @@ class LIBPROTOBUF_EXPORT WireFormatLite {
 
   static inline int StringSize(const string& value);
   static inline int BytesSize (const string& value);
+  static inline int StringPieceSize(const StringPieceField& value);
 
   static inline int GroupSize  (const MessageLite& value);
   static inline int MessageSize(const MessageLite& value);
@@ -511,6 +539,22 @@ class LIBPROTOBUF_EXPORT WireFormatLite {
       google::protobuf::io::CodedInputStream* input,
       RepeatedField<CType>* value) GOOGLE_ATTRIBUTE_ALWAYS_INLINE;
 
+  // Reads the contents of a packed varint field, up to the current limit.
+  // Most values are bulk-decoded with CodedInputStream::ReadVarint64Batch();
+  // kept out of line so that the batch buffer does not enlarge the stack
+  // frames of generated parsing code.
+  template <typename CType, enum FieldType DeclaredType>
+  static bool ReadPackedVarintPrimitive(
+      google::protobuf::io::CodedInputStream* input,
+      RepeatedField<CType>* value);
+
+  // Converts a varint decoded by ReadVarint64Batch() to the value that
+  // ReadPrimitive() would have produced from the same bytes.
+  template <typename CType, enum FieldType DeclaredType>
+  static inline CType VarintToPrimitive(uint64 value);
+
+  static const int kPackedVarintBatchSize = 64;
+
   static const CppType kFieldTypeToCppTypeMap[];
   static const WireFormatLite::WireType kWireTypeForFieldType[];
 
@@ -45,7 +45,9 @@
 #include <google/protobuf/stubs/common.h>
 #include <google/protobuf/message_lite.h>
 #include <google/protobuf/repeated_field.h>
+#include <google/protobuf/string_piece_field.h>
 #include <google/protobuf/wire_format_lite.h>
+#include <google/protobuf/io/backward_output_buffer.h>
 #include <google/protobuf/io/coded_stream.h>
 
 
@@ -324,21 +326,82 @@ bool WireFormatLite::ReadRepeatedPrimitiveNoInline(
       tag_size, tag, input, value);
 }
 
+template <>
+inline int32 WireFormatLite::VarintToPrimitive<
+    int32, WireFormatLite::TYPE_INT32>(uint64 value) {
+  return static_cast<int32>(value);
+}
+template <>
+inline int64 WireFormatLite::VarintToPrimitive<
+    int64, WireFormatLite::TYPE_INT64>(uint64 value) {
+  return static_cast<int64>(value);
+}
+template <>
+inline uint32 WireFormatLite::VarintToPrimitive<
+    uint32, WireFormatLite::TYPE_UINT32>(uint64 value) {
+  return static_cast<uint32>(value);
+}
+template <>
+inline uint64 WireFormatLite::VarintToPrimitive<
+    uint64, WireFormatLite::TYPE_UINT64>(uint64 value) {
+  return value;
+}
+template <>
+inline int32 WireFormatLite::VarintToPrimitive<
+    int32, WireFormatLite::TYPE_SINT32>(uint64 value) {
+  return ZigZagDecode32(static_cast<uint32>(value));
+}
+template <>
+inline int64 WireFormatLite::VarintToPrimitive<
+    int64, WireFormatLite::TYPE_SINT64>(uint64 value) {
+  return ZigZagDecode64(value);
+}
+template <>
+inline bool WireFormatLite::VarintToPrimitive<
+    bool, WireFormatLite::TYPE_BOOL>(uint64 value) {
+  return value != 0;
+}
+template <>
+inline int WireFormatLite::VarintToPrimitive<
+    int, WireFormatLite::TYPE_ENUM>(uint64 value) {
+  return static_cast<int>(value);
+}
+
 template <typename CType, enum WireFormatLite::FieldType DeclaredType>
 inline bool WireFormatLite::ReadPackedPrimitive(io::CodedInputStream* input,
                                                 RepeatedField<CType>* values) {
   uint32 length;
   if (!input->ReadVarint32(&length)) return false;
   io::CodedInputStream::Limit limit = input->PushLimit(length);
-  while (input->BytesUntilLimit() > 0) {
-    CType value;
-    if (!ReadPrimitive<CType, DeclaredType>(input, &value)) return false;
-    values->Add(value);
+  if (!ReadPackedVarintPrimitive<CType, DeclaredType>(input, values)) {
+    return false;
   }
   input->PopLimit(limit);
   return true;
 }
 
+template <typename CType, enum WireFormatLite::FieldType DeclaredType>
+bool WireFormatLite::ReadPackedVarintPrimitive(io::CodedInputStream* input,
+                                               RepeatedField<CType>* values) {
+  uint64 batch[kPackedVarintBatchSize];
+  while (input->BytesUntilLimit() > 0) {
+    int count = input->ReadVarint64Batch(batch, kPackedVarintBatchSize);
+    if (count == 0) {
+      // The next value crosses the end of the buffer (or is malformed).
+      CType value;
+      if (!ReadPrimitive<CType, DeclaredType>(input, &value)) return false;
+      values->Add(value);
+      continue;
+    }
+    values->Reserve(values->size() + count);
+    for (int i = 0; i < count; i++) {
+      values->AddAlreadyReserved(
+          VarintToPrimitive<CType, DeclaredType>(batch[i]));
+    }
+  }
+  return true;
+}
+
 template <typename CType, enum WireFormatLite::FieldType DeclaredType>
 inline bool WireFormatLite::ReadPackedFixedSizePrimitive(
     io::CodedInputStream* input, RepeatedField<CType>* values) {
@@ -754,6 +817,14 @@ inline uint8* WireFormatLite::WriteBytesToArray(int field_number,
   target = WriteTagToArray(field_number, WIRETYPE_LENGTH_DELIMITED, target);
   return io::CodedOutputStream::WriteStringWithSizeToArray(value, target);
 }
+inline uint8* WireFormatLite::WriteStringPieceToArray(
+    int field_number, const StringPieceField& value, uint8* target) {
+  target = WriteTagToArray(field_number, WIRETYPE_LENGTH_DELIMITED, target);
+  StringPiece piece = value.Get();
+  target = io::CodedOutputStream::WriteVarint32ToArray(piece.size(), target);
+  return io::CodedOutputStream::WriteRawToArray(piece.data(), piece.size(),
+                                                target);
+}
 
 
 inline uint8* WireFormatLite::WriteGroupToArray(int field_number,
@@ -794,6 +865,24 @@ inline uint8* WireFormatLite::WriteMessageNoVirtualToArray(
       ::SerializeWithCachedSizesToArray(target);
 }
 
+template<typename MessageType_WorkAroundCppLookupDefect>
+inline void WireFormatLite::PrependGroupNoVirtual(
+    int field_number, const MessageType_WorkAroundCppLookupDefect& value,
+    io::BackwardOutputBuffer* buffer) {
+  buffer->PrependVarint32(MakeTag(field_number, WIRETYPE_END_GROUP));
+  value.MessageType_WorkAroundCppLookupDefect::SerializeBackward(buffer);
+  buffer->PrependVarint32(MakeTag(field_number, WIRETYPE_START_GROUP));
+}
+template<typename MessageType_WorkAroundCppLookupDefect>
+inline void WireFormatLite::PrependMessageNoVirtual(
+    int field_number, const MessageType_WorkAroundCppLookupDefect& value,
+    io::BackwardOutputBuffer* buffer) {
+  int end = buffer->ByteCount();
+  value.MessageType_WorkAroundCppLookupDefect::SerializeBackward(buffer);
+  buffer->PrependVarint32(buffer->ByteCount() - end);
+  buffer->PrependVarint32(MakeTag(field_number, WIRETYPE_LENGTH_DELIMITED));
+}
+
 // ===================================================================
 
 inline int WireFormatLite::Int32Size(int32 value) {
@@ -826,6 +915,9 @@ inline int WireFormatLite::BytesSize(const string& value) {
   return io::CodedOutputStream::VarintSize32(value.size()) +
          value.size();
 }
+inline int WireFormatLite::StringPieceSize(const StringPieceField& value) {
+  return LengthDelimitedSize(value.Get().size());
+}
 
 
 inline int WireFormatLite::GroupSize(const MessageLite& value) {
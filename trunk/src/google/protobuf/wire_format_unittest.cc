@@ -158,6 +158,36 @@ TEST(WireFormatTest, ParseUnpackedFromPacked) {
   TestUtil::ExpectUnpackedFieldsSet(dest);
 }
 
+TEST(WireFormatTest, ParseLongPackedVarints) {
+  // Runs of values long enough for the bulk varint decoder, read through
+  // several buffer sizes so that values also straddle buffer boundaries.
+  unittest::TestPackedTypes source;
+  for (int i = 0; i < 500; i++) {
+    int64 value = (i % 4 == 0) ? i % 100 : (GOOGLE_LONGLONG(1) << (i % 63)) + i;
+    if (i % 3 == 0) value = -value;
+    source.add_packed_int32(static_cast<int32>(value));
+    source.add_packed_int64(value);
+    source.add_packed_uint32(static_cast<uint32>(value));
+    source.add_packed_uint64(static_cast<uint64>(value));
+    source.add_packed_sint32(static_cast<int32>(value));
+    source.add_packed_sint64(value);
+    source.add_packed_bool(value % 2 != 0);
+    source.add_packed_enum(unittest::ForeignEnum_IsValid(value % 3 + 4) ?
+                           static_cast<unittest::ForeignEnum>(value % 3 + 4) :
+                           unittest::FOREIGN_FOO);
+  }
+  string data = source.SerializeAsString();
+
+  const int kBlockSizes[] = {1, 7, 64, 8192};
+  for (int i = 0; i < GOOGLE_ARRAYSIZE(kBlockSizes); i++) {
+    unittest::TestPackedTypes dest;
+    io::ArrayInputStream raw_input(data.data(), data.size(), kBlockSizes[i]);
+    io::CodedInputStream input(&raw_input);
+    ASSERT_TRUE(dest.MergeFromCodedStream(&input));
+    EXPECT_EQ(source.DebugString(), dest.DebugString());
+  }
+}
+
 TEST(WireFormatTest, ParsePackedExtensions) {
   unittest::TestPackedExtensions source, dest;
   string data;
@@ -12,28 +12,40 @@ copy ..\src\google\protobuf\stubs\atomicops_internals_x86_msvc.h include\google\
 copy ..\src\google\protobuf\stubs\common.h include\google\protobuf\stubs\common.h
 copy ..\src\google\protobuf\stubs\once.h include\google\protobuf\stubs\once.h
 copy ..\src\google\protobuf\stubs\platform_macros.h include\google\protobuf\stubs\platform_macros.h
+copy ..\src\google\protobuf\stubs\stringpiece.h include\google\protobuf\stubs\stringpiece.h
 copy ..\src\google\protobuf\stubs\template_util.h include\google\protobuf\stubs\template_util.h
 copy ..\src\google\protobuf\stubs\type_traits.h include\google\protobuf\stubs\type_traits.h
+copy ..\src\google\protobuf\arena.h include\google\protobuf\arena.h
 copy ..\src\google\protobuf\descriptor.h include\google\protobuf\descriptor.h
 copy ..\src\google\protobuf\descriptor.pb.h include\google\protobuf\descriptor.pb.h
 copy ..\src\google\protobuf\descriptor_database.h include\google\protobuf\descriptor_database.h
 copy ..\src\google\protobuf\dynamic_message.h include\google\protobuf\dynamic_message.h
 copy ..\src\google\protobuf\extension_set.h include\google\protobuf\extension_set.h
+copy ..\src\google\protobuf\field_accessor.h include\google\protobuf\field_accessor.h
+copy ..\src\google\protobuf\field_projection.h include\google\protobuf\field_projection.h
 copy ..\src\google\protobuf\generated_enum_reflection.h include\google\protobuf\generated_enum_reflection.h
 copy ..\src\google\protobuf\generated_message_util.h include\google\protobuf\generated_message_util.h
 copy ..\src\google\protobuf\generated_message_reflection.h include\google\protobuf\generated_message_reflection.h
+copy ..\src\google\protobuf\generated_message_table_driven.h include\google\protobuf\generated_message_table_driven.h
+copy ..\src\google\protobuf\json_format.h include\google\protobuf\json_format.h
+copy ..\src\google\protobuf\lazy_field.h include\google\protobuf\lazy_field.h
 copy ..\src\google\protobuf\message.h include\google\protobuf\message.h
 copy ..\src\google\protobuf\message_lite.h include\google\protobuf\message_lite.h
 copy ..\src\google\protobuf\reflection_ops.h include\google\protobuf\reflection_ops.h
 copy ..\src\google\protobuf\repeated_field.h include\google\protobuf\repeated_field.h
+copy ..\src\google\protobuf\string_piece_field.h include\google\protobuf\string_piece_field.h
 copy ..\src\google\protobuf\service.h include\google\protobuf\service.h
 copy ..\src\google\protobuf\text_format.h include\google\protobuf\text_format.h
 copy ..\src\google\protobuf\unknown_field_set.h include\google\protobuf\unknown_field_set.h
 copy ..\src\google\protobuf\wire_format.h include\google\protobuf\wire_format.h
 copy ..\src\google\protobuf\wire_format_lite.h include\google\protobuf\wire_format_lite.h
 copy ..\src\google\protobuf\wire_format_lite_inl.h include\google\protobuf\wire_format_lite_inl.h
+copy ..\src\google\protobuf\io\backward_output_buffer.h include\google\protobuf\io\backward_output_buffer.h
+copy ..\src\google\protobuf\io\chained_output_stream.h include\google\protobuf\io\chained_output_stream.h
 copy ..\src\google\protobuf\io\coded_stream.h include\google\protobuf\io\coded_stream.h
+copy ..\src\google\protobuf\io\delimited_message_stream.h include\google\protobuf\io\delimited_message_stream.h
 copy ..\src\google\protobuf\io\gzip_stream.h include\google\protobuf\io\gzip_stream.h
+copy ..\src\google\protobuf\io\mmap_input_stream.h include\google\protobuf\io\mmap_input_stream.h
 copy ..\src\google\protobuf\io\printer.h include\google\protobuf\io\printer.h
 copy ..\src\google\protobuf\io\strtod.h include\google\protobuf\io\strtod.h
 copy ..\src\google\protobuf\io\tokenizer.h include\google\protobuf\io\tokenizer.h